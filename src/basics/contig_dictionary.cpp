@@ -0,0 +1,107 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "contig_dictionary.hpp"
+
+#include <stdexcept>
+#include <cassert>
+
+namespace octopus {
+
+ContigDictionary::ContigDictionary()
+: chunks_ {}
+, size_ {0}
+, ids_ {}
+, mutex_ {}
+{
+    for (auto& chunk : chunks_) chunk.store(nullptr, std::memory_order_relaxed);
+    insert("");
+}
+
+ContigDictionary::~ContigDictionary()
+{
+    for (auto& chunk : chunks_) delete chunk.load(std::memory_order_relaxed);
+}
+
+ContigDictionary::ContigId ContigDictionary::intern(const ContigName& name)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto itr = ids_.find(name);
+    if (itr != std::cend(ids_)) return itr->second;
+    return insert(name);
+}
+
+void ContigDictionary::intern(const std::vector<ContigName>& names)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    for (const auto& name : names) {
+        if (ids_.count(name) == 0) insert(name);
+    }
+}
+
+bool ContigDictionary::contains(const ContigName& name) const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return ids_.count(name) == 1;
+}
+
+const ContigDictionary::ContigName& ContigDictionary::name(const ContigId id) const noexcept
+{
+    assert(id < size());
+    const auto chunk = chunks_[id >> chunkBits_].load(std::memory_order_acquire);
+    return (*chunk)[id & (chunkSize_ - 1)];
+}
+
+std::size_t ContigDictionary::size() const noexcept
+{
+    return size_.load(std::memory_order_acquire);
+}
+
+// private methods
+
+ContigDictionary::ContigId ContigDictionary::insert(const ContigName& name)
+{
+    const auto id = size_.load(std::memory_order_relaxed);
+    if (id == chunkSize_ * maxChunks_) {
+        throw std::length_error {"ContigDictionary: too many contigs"};
+    }
+    auto& slot = chunks_[id >> chunkBits_];
+    auto chunk = slot.load(std::memory_order_relaxed);
+    if (!chunk) chunk = new Chunk {};
+    (*chunk)[id & (chunkSize_ - 1)] = name;
+    slot.store(chunk, std::memory_order_release);
+    ids_.emplace(name, static_cast<ContigId>(id));
+    size_.store(id + 1, std::memory_order_release);
+    return static_cast<ContigId>(id);
+}
+
+// non-member methods
+
+ContigDictionary& contig_dictionary()
+{
+    static ContigDictionary result {};
+    return result;
+}
+
+ContigDictionary::ContigId intern_contig(const ContigDictionary::ContigName& name)
+{
+    // Most regions are constructed from the contig of the previous region
+    thread_local const ContigDictionary::ContigName* last_name {nullptr};
+    thread_local ContigDictionary::ContigId last_id {0};
+    if (last_name && (last_name == &name || *last_name == name)) return last_id;
+    last_id = contig_dictionary().intern(name);
+    last_name = &resolve_contig(last_id);
+    return last_id;
+}
+
+void register_contigs(const std::vector<ContigDictionary::ContigName>& names)
+{
+    contig_dictionary().intern(names);
+}
+
+const ContigDictionary::ContigName& resolve_contig(const ContigDictionary::ContigId id) noexcept
+{
+    return contig_dictionary().name(id);
+}
+
+} // namespace octopus
@@ -0,0 +1,79 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef contig_dictionary_hpp
+#define contig_dictionary_hpp
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+
+namespace octopus {
+
+/**
+    ContigDictionary maps contig names to small integer ids. Ids are assigned in order of first
+    insertion and are never removed, so an id (and a reference to the name it resolves to) remains
+    valid for the lifetime of the dictionary.
+
+    Resolving an id to a name does not lock; interning a name that is not yet in the dictionary does.
+    The empty name is always interned with id 0.
+*/
+class ContigDictionary
+{
+public:
+    using ContigName = std::string;
+    using ContigId   = std::uint32_t;
+
+    ContigDictionary();
+
+    ContigDictionary(const ContigDictionary&)            = delete;
+    ContigDictionary& operator=(const ContigDictionary&) = delete;
+    ContigDictionary(ContigDictionary&&)                 = delete;
+    ContigDictionary& operator=(ContigDictionary&&)      = delete;
+
+    ~ContigDictionary();
+
+    ContigId intern(const ContigName& name);
+    void intern(const std::vector<ContigName>& names);
+
+    bool contains(const ContigName& name) const;
+    const ContigName& name(ContigId id) const noexcept;
+
+    std::size_t size() const noexcept;
+
+private:
+    static constexpr unsigned chunkBits_ {10};
+    static constexpr std::size_t chunkSize_ {std::size_t {1} << chunkBits_};
+    static constexpr std::size_t maxChunks_ {4096};
+
+    using Chunk = std::array<ContigName, chunkSize_>;
+
+    std::array<std::atomic<Chunk*>, maxChunks_> chunks_;
+    std::atomic<std::size_t> size_;
+    std::unordered_map<ContigName, ContigId> ids_;
+    mutable std::mutex mutex_;
+
+    ContigId insert(const ContigName& name);
+};
+
+// The dictionary used by GenomicRegion
+
+ContigDictionary& contig_dictionary();
+
+// Interns name in the global dictionary. Repeated calls with the same contig are cheap.
+ContigDictionary::ContigId intern_contig(const ContigDictionary::ContigName& name);
+
+// Registers contigs in the global dictionary, e.g. from a reference or BAM header, so that
+// they receive ids in header order.
+void register_contigs(const std::vector<ContigDictionary::ContigName>& names);
+
+const ContigDictionary::ContigName& resolve_contig(ContigDictionary::ContigId id) noexcept;
+
+} // namespace octopus
+
+#endif
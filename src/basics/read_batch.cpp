@@ -0,0 +1,412 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_batch.hpp"
+
+#include <utility>
+#include <cassert>
+
+namespace octopus {
+
+namespace {
+
+enum FlagBit : unsigned
+{
+    allSegmentsInReadAligned,
+    multipleSegmentTemplate,
+    unmapped,
+    reverseMapped,
+    secondaryAlignment,
+    qcFail,
+    duplicate,
+    supplementaryAlignment,
+    firstTemplateSegment,
+    lastTemplateSegment,
+    nextSegmentUnmapped,
+    nextSegmentReverseMapped
+};
+
+template <typename T>
+constexpr T bit(const FlagBit b) noexcept
+{
+    return static_cast<T>(1u << b);
+}
+
+} // namespace
+
+// ReadBatch public
+
+ReadBatch::ReadBatch(const ContigName& contig)
+: contig_ {intern_contig(contig)}
+{}
+
+const ReadBatch::ContigName& ReadBatch::contig_name() const noexcept
+{
+    return resolve_contig(contig_);
+}
+
+ReadBatch::ContigId ReadBatch::contig_id() const noexcept
+{
+    return contig_;
+}
+
+ReadBatch::size_type ReadBatch::size() const noexcept
+{
+    return records_.size();
+}
+
+bool ReadBatch::empty() const noexcept
+{
+    return records_.empty();
+}
+
+ReadBatch::size_type ReadBatch::num_bases() const noexcept
+{
+    return sequences_.size();
+}
+
+void ReadBatch::reserve(const size_type num_reads, const size_type num_bases)
+{
+    records_.reserve(num_reads);
+    names_.reserve(32 * num_reads);
+    sequences_.reserve(num_bases);
+    qualities_.reserve(num_bases);
+    cigars_.reserve(2 * num_reads);
+}
+
+void ReadBatch::shrink_to_fit()
+{
+    records_.shrink_to_fit();
+    names_.shrink_to_fit();
+    sequences_.shrink_to_fit();
+    qualities_.shrink_to_fit();
+    cigars_.shrink_to_fit();
+}
+
+void ReadBatch::clear() noexcept
+{
+    records_.clear();
+    names_.clear();
+    sequences_.clear();
+    qualities_.clear();
+    cigars_.clear();
+}
+
+AlignedReadView ReadBatch::operator[](const size_type n) const noexcept
+{
+    return AlignedReadView {*this, n};
+}
+
+ReadBatch::const_iterator ReadBatch::begin() const noexcept
+{
+    return const_iterator {*this, 0};
+}
+
+ReadBatch::const_iterator ReadBatch::end() const noexcept
+{
+    return const_iterator {*this, records_.size()};
+}
+
+ReadBatch::const_iterator ReadBatch::cbegin() const noexcept
+{
+    return begin();
+}
+
+ReadBatch::const_iterator ReadBatch::cend() const noexcept
+{
+    return end();
+}
+
+void ReadBatch::push_back(const AlignedRead& read)
+{
+    if (records_.empty() && contig_ == 0) {
+        contig_ = mapped_region(read).contig_id();
+    }
+    assert(mapped_region(read).contig_id() == contig_);
+    const auto& sequence = read.sequence();
+    const auto& qualities = read.base_qualities();
+    const auto& cigar = read.cigar();
+    if (read.has_other_segment()) {
+        const auto& next_segment = read.next_segment();
+        AlignedRead::Segment::Flags next_segment_flags {};
+        next_segment_flags.unmapped = next_segment.is_marked_unmapped();
+        next_segment_flags.reverse_mapped = next_segment.is_marked_reverse_mapped();
+        emplace_back(read.name(), mapped_begin(read), std::cbegin(sequence), std::cbegin(qualities), sequence.size(),
+                     std::cbegin(cigar), std::cend(cigar), read.mapping_quality(), read.flags(),
+                     next_segment.contig_name(), next_segment.begin(), next_segment.inferred_template_length(),
+                     next_segment_flags);
+    } else {
+        emplace_back(read.name(), mapped_begin(read), std::cbegin(sequence), std::cbegin(qualities), sequence.size(),
+                     std::cbegin(cigar), std::cend(cigar), read.mapping_quality(), read.flags());
+    }
+}
+
+void ReadBatch::push_back(const AlignedReadView& read)
+{
+    assert(read.batch_->contig_ == contig_);
+    if (read.batch_ == this) {
+        // The view points into our own arenas, which may be reallocated by the append
+        ReadBatch tmp {contig_name()};
+        tmp.push_back(read);
+        append(tmp);
+        return;
+    }
+    const auto source = *read.record_;
+    const auto seq = read.sequence();
+    const auto quals = read.base_qualities();
+    const auto ops = read.cigar();
+    auto& record = append_record(read.name(), source.begin, seq.begin(), quals.begin(), seq.size(),
+                                 ops.begin(), ops.end(), source.mapping_quality, Flags {});
+    record.flags = source.flags;
+    record.next_segment_contig = source.next_segment_contig;
+    record.next_segment_begin = source.next_segment_begin;
+    record.inferred_template_length = source.inferred_template_length;
+}
+
+void ReadBatch::append(const ReadBatch& other)
+{
+    if (other.empty()) return;
+    if (&other == this) {
+        const ReadBatch tmp {other};
+        append(tmp);
+        return;
+    }
+    if (empty() && contig_ == 0) contig_ = other.contig_;
+    assert(other.contig_ == contig_);
+    const auto name_shift = names_.size(), sequence_shift = sequences_.size(), cigar_shift = cigars_.size();
+    names_ += other.names_;
+    sequences_ += other.sequences_;
+    qualities_.insert(std::end(qualities_), std::cbegin(other.qualities_), std::cend(other.qualities_));
+    cigars_.insert(std::end(cigars_), std::cbegin(other.cigars_), std::cend(other.cigars_));
+    records_.reserve(records_.size() + other.records_.size());
+    for (auto record : other.records_) {
+        record.name_offset += name_shift;
+        record.sequence_offset += sequence_shift;
+        record.cigar_offset += cigar_shift;
+        records_.push_back(record);
+    }
+}
+
+std::size_t ReadBatch::footprint() const noexcept
+{
+    return sizeof(ReadBatch) + records_.capacity() * sizeof(Record) + names_.capacity() + sequences_.capacity()
+           + qualities_.capacity() * sizeof(BaseQuality) + cigars_.capacity() * sizeof(CigarOperation);
+}
+
+// ReadBatch private
+
+ReadBatch::FlagBits ReadBatch::compress(const Flags& flags) noexcept
+{
+    FlagBits result {0};
+    if (flags.all_segments_in_read_aligned) result |= bit<FlagBits>(allSegmentsInReadAligned);
+    if (flags.multiple_segment_template)    result |= bit<FlagBits>(multipleSegmentTemplate);
+    if (flags.unmapped)                     result |= bit<FlagBits>(unmapped);
+    if (flags.reverse_mapped)               result |= bit<FlagBits>(reverseMapped);
+    if (flags.secondary_alignment)          result |= bit<FlagBits>(secondaryAlignment);
+    if (flags.qc_fail)                      result |= bit<FlagBits>(qcFail);
+    if (flags.duplicate)                    result |= bit<FlagBits>(duplicate);
+    if (flags.supplementary_alignment)      result |= bit<FlagBits>(supplementaryAlignment);
+    if (flags.first_template_segment)       result |= bit<FlagBits>(firstTemplateSegment);
+    if (flags.last_template_segment)        result |= bit<FlagBits>(lastTemplateSegment);
+    return result;
+}
+
+ReadBatch::FlagBits ReadBatch::compress(const SegmentFlags& flags) noexcept
+{
+    FlagBits result {0};
+    if (flags.unmapped)       result |= bit<FlagBits>(nextSegmentUnmapped);
+    if (flags.reverse_mapped) result |= bit<FlagBits>(nextSegmentReverseMapped);
+    return result;
+}
+
+// AlignedReadView public
+
+AlignedReadView::AlignedReadView(const ReadBatch& batch, const std::size_t index) noexcept
+: batch_ {&batch}
+, record_ {&batch.records_[index]}
+{}
+
+boost::string_ref AlignedReadView::name() const noexcept
+{
+    return boost::string_ref {batch_->names_.data() + record_->name_offset, record_->name_length};
+}
+
+GenomicRegion AlignedReadView::mapped_region() const
+{
+    return GenomicRegion {batch_->contig_, record_->begin, record_->end};
+}
+
+ContigRegion AlignedReadView::contig_region() const noexcept
+{
+    return ContigRegion {record_->begin, record_->end};
+}
+
+AlignedReadView::SequenceView AlignedReadView::sequence() const noexcept
+{
+    return SequenceView {batch_->sequences_.data() + record_->sequence_offset, record_->sequence_length};
+}
+
+AlignedReadView::BaseQualityRange AlignedReadView::base_qualities() const noexcept
+{
+    const auto first = batch_->qualities_.data() + record_->sequence_offset;
+    return BaseQualityRange {first, first + record_->sequence_length};
+}
+
+AlignedReadView::CigarRange AlignedReadView::cigar() const noexcept
+{
+    const auto first = batch_->cigars_.data() + record_->cigar_offset;
+    return CigarRange {first, first + record_->cigar_length};
+}
+
+AlignedReadView::MappingQuality AlignedReadView::mapping_quality() const noexcept
+{
+    return record_->mapping_quality;
+}
+
+AlignedReadView::Direction AlignedReadView::direction() const noexcept
+{
+    return is_marked_reverse_mapped() ? Direction::reverse : Direction::forward;
+}
+
+bool AlignedReadView::has_other_segment() const noexcept
+{
+    return record_->next_segment_contig != ReadBatch::noNextSegment_;
+}
+
+AlignedReadView::Flags AlignedReadView::flags() const noexcept
+{
+    Flags result {};
+    result.all_segments_in_read_aligned = flag(allSegmentsInReadAligned);
+    result.multiple_segment_template    = flag(multipleSegmentTemplate);
+    result.unmapped                     = flag(unmapped);
+    result.reverse_mapped               = flag(reverseMapped);
+    result.secondary_alignment          = flag(secondaryAlignment);
+    result.qc_fail                      = flag(qcFail);
+    result.duplicate                    = flag(duplicate);
+    result.supplementary_alignment      = flag(supplementaryAlignment);
+    result.first_template_segment       = flag(firstTemplateSegment);
+    result.last_template_segment        = flag(lastTemplateSegment);
+    return result;
+}
+
+bool AlignedReadView::is_marked_all_segments_in_read_aligned() const noexcept
+{
+    return flag(allSegmentsInReadAligned);
+}
+
+bool AlignedReadView::is_marked_multiple_segment_template() const noexcept
+{
+    return flag(multipleSegmentTemplate);
+}
+
+bool AlignedReadView::is_marked_unmapped() const noexcept
+{
+    return flag(unmapped);
+}
+
+bool AlignedReadView::is_marked_reverse_mapped() const noexcept
+{
+    return flag(reverseMapped);
+}
+
+bool AlignedReadView::is_marked_secondary_alignment() const noexcept
+{
+    return flag(secondaryAlignment);
+}
+
+bool AlignedReadView::is_marked_qc_fail() const noexcept
+{
+    return flag(qcFail);
+}
+
+bool AlignedReadView::is_marked_duplicate() const noexcept
+{
+    return flag(duplicate);
+}
+
+bool AlignedReadView::is_marked_supplementary_alignment() const noexcept
+{
+    return flag(supplementaryAlignment);
+}
+
+AlignedRead AlignedReadView::materialise() const
+{
+    const auto seq = sequence();
+    const auto quals = base_qualities();
+    const auto ops = cigar();
+    if (has_other_segment()) {
+        AlignedRead::Segment::Flags next_segment_flags {};
+        next_segment_flags.unmapped = flag(nextSegmentUnmapped);
+        next_segment_flags.reverse_mapped = flag(nextSegmentReverseMapped);
+        return AlignedRead {
+            name().to_string(),
+            mapped_region(),
+            AlignedRead::NucleotideSequence {seq.begin(), seq.end()},
+            AlignedRead::BaseQualityVector {quals.begin(), quals.end()},
+            CigarString {ops.begin(), ops.end()},
+            mapping_quality(),
+            flags(),
+            resolve_contig(record_->next_segment_contig),
+            record_->next_segment_begin,
+            record_->inferred_template_length,
+            next_segment_flags
+        };
+    } else {
+        return AlignedRead {
+            name().to_string(),
+            mapped_region(),
+            AlignedRead::NucleotideSequence {seq.begin(), seq.end()},
+            AlignedRead::BaseQualityVector {quals.begin(), quals.end()},
+            CigarString {ops.begin(), ops.end()},
+            mapping_quality(),
+            flags()
+        };
+    }
+}
+
+// AlignedReadView private
+
+bool AlignedReadView::flag(const unsigned n) const noexcept
+{
+    return (record_->flags & (1u << n)) != 0;
+}
+
+// non-member methods
+
+std::vector<AlignedRead> materialise(const ReadBatch& batch)
+{
+    std::vector<AlignedRead> result {};
+    result.reserve(batch.size());
+    for (const auto& read : batch) {
+        result.push_back(read.materialise());
+    }
+    return result;
+}
+
+ReadBatch merge(const ReadBatch& lhs, const ReadBatch& rhs)
+{
+    if (lhs.empty()) return rhs;
+    if (rhs.empty()) return lhs;
+    ReadBatch result {lhs.contig_name()};
+    result.reserve(lhs.size() + rhs.size(), lhs.num_bases() + rhs.num_bases());
+    std::vector<std::pair<const ReadBatch*, std::size_t>> order {};
+    order.reserve(lhs.size() + rhs.size());
+    for (std::size_t i {0}; i < lhs.size(); ++i) order.emplace_back(&lhs, i);
+    const auto middle = order.size();
+    for (std::size_t i {0}; i < rhs.size(); ++i) order.emplace_back(&rhs, i);
+    std::inplace_merge(std::begin(order), std::next(std::begin(order), middle), std::end(order),
+                       [] (const auto& a, const auto& b) {
+                           return (*a.first)[a.second].contig_region() < (*b.first)[b.second].contig_region();
+                       });
+    for (const auto& p : order) {
+        result.push_back((*p.first)[p.second]);
+    }
+    return result;
+}
+
+std::size_t sequence_size(const AlignedReadView& read) noexcept
+{
+    return read.sequence().size();
+}
+
+} // namespace octopus
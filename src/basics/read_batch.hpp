@@ -0,0 +1,330 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_batch_hpp
+#define read_batch_hpp
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+#include <boost/utility/string_ref.hpp>
+#include <boost/range/iterator_range_core.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "concepts/mappable.hpp"
+#include "genomic_region.hpp"
+#include "contig_region.hpp"
+#include "cigar_string.hpp"
+#include "aligned_read.hpp"
+#include "utils/packed_sequence.hpp"
+
+namespace octopus {
+
+class AlignedReadView;
+
+/*
+    ReadBatch is a columnar (structure-of-arrays) store for the reads fetched from a single
+    contig region. Rather than allocating a name, sequence, quality vector and cigar string for
+    every read, all of these are appended into a handful of contiguous arenas that are owned by
+    the batch, and reads are accessed through the lightweight AlignedReadView type.
+
+    Reads are stored in the order they are added; sources that add reads in mapped order (e.g.
+    indexed BAM iterators) therefore produce sorted batches.
+ */
+class ReadBatch
+{
+public:
+    using ContigName         = GenomicRegion::ContigName;
+    using ContigId           = GenomicRegion::ContigId;
+    using Position           = GenomicRegion::Position;
+    using Size               = GenomicRegion::Size;
+    using BaseQuality        = AlignedRead::BaseQuality;
+    using MappingQuality     = AlignedRead::MappingQuality;
+    using Flags              = AlignedRead::Flags;
+    using SegmentFlags       = AlignedRead::Segment::Flags;
+    using size_type          = std::size_t;
+
+    class const_iterator;
+    using iterator = const_iterator;
+
+    ReadBatch() = default;
+
+    ReadBatch(const ContigName& contig);
+
+    ReadBatch(const ReadBatch&)            = default;
+    ReadBatch& operator=(const ReadBatch&) = default;
+    ReadBatch(ReadBatch&&)                 = default;
+    ReadBatch& operator=(ReadBatch&&)      = default;
+
+    ~ReadBatch() = default;
+
+    const ContigName& contig_name() const noexcept;
+    ContigId contig_id() const noexcept;
+
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+    size_type num_bases() const noexcept;
+
+    void reserve(size_type num_reads, size_type num_bases);
+    void shrink_to_fit();
+    void clear() noexcept;
+
+    AlignedReadView operator[](size_type n) const noexcept;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    // Appends a read without a next segment. SequenceIt must dereference to char, or be a
+    // utils::PackedSequenceView which is decoded straight into the batch, and QualityIt must
+    // dereference to BaseQuality; both ranges have length sequence_length.
+    template <typename SequenceIt, typename QualityIt, typename CigarIt>
+    void emplace_back(boost::string_ref name, Position begin,
+                      SequenceIt sequence_first, QualityIt quality_first, std::size_t sequence_length,
+                      CigarIt cigar_first, CigarIt cigar_last,
+                      MappingQuality mapping_quality, const Flags& flags);
+
+    // Appends a read with a next segment
+    template <typename SequenceIt, typename QualityIt, typename CigarIt>
+    void emplace_back(boost::string_ref name, Position begin,
+                      SequenceIt sequence_first, QualityIt quality_first, std::size_t sequence_length,
+                      CigarIt cigar_first, CigarIt cigar_last,
+                      MappingQuality mapping_quality, const Flags& flags,
+                      const ContigName& next_segment_contig_name, Position next_segment_begin,
+                      Size inferred_template_length, const SegmentFlags& next_segment_flags);
+
+    void push_back(const AlignedRead& read);
+    void push_back(const AlignedReadView& read); // read may belong to this or another batch on the same contig
+
+    // Appends all reads in other, which must be on the same contig (other may be this batch)
+    void append(const ReadBatch& other);
+
+    std::size_t footprint() const noexcept; // approximate bytes used
+
+private:
+    using FlagBits = std::uint16_t;
+    using Offset   = std::uint32_t;
+
+    static constexpr ContigId noNextSegment_ {std::numeric_limits<ContigId>::max()};
+
+    struct Record
+    {
+        std::size_t name_offset, sequence_offset, cigar_offset;
+        Position begin, end;
+        Position next_segment_begin;
+        Size inferred_template_length;
+        Offset name_length, sequence_length, cigar_length;
+        ContigId next_segment_contig;
+        FlagBits flags;
+        MappingQuality mapping_quality;
+    };
+
+    ContigId contig_ = 0;
+    std::vector<Record> records_;
+    std::string names_;
+    std::string sequences_;
+    std::vector<BaseQuality> qualities_;
+    std::vector<CigarOperation> cigars_;
+
+    template <typename SequenceIt, typename QualityIt, typename CigarIt>
+    Record& append_record(boost::string_ref name, Position begin,
+                          SequenceIt sequence_first, QualityIt quality_first, std::size_t sequence_length,
+                          CigarIt cigar_first, CigarIt cigar_last,
+                          MappingQuality mapping_quality, const Flags& flags);
+
+    template <typename SequenceIt>
+    static void copy_sequence(SequenceIt first, std::size_t n, char* result);
+    static void copy_sequence(const utils::PackedSequenceView& sequence, std::size_t n, char* result) noexcept;
+    
+    static FlagBits compress(const Flags& flags) noexcept;
+    static FlagBits compress(const SegmentFlags& flags) noexcept;
+
+    friend AlignedReadView;
+};
+
+/*
+    A non-owning view of a single read in a ReadBatch. Views are only valid while the batch
+    they refer to is alive and unmodified.
+ */
+class AlignedReadView : public Mappable<AlignedReadView>
+{
+public:
+    using MappingDomain      = GenomicRegion;
+    using MappingQuality     = AlignedRead::MappingQuality;
+    using BaseQuality        = AlignedRead::BaseQuality;
+    using Direction          = AlignedRead::Direction;
+    using Flags              = AlignedRead::Flags;
+    using SequenceView       = boost::string_ref;
+    using BaseQualityRange   = boost::iterator_range<const BaseQuality*>;
+    using CigarRange         = boost::iterator_range<const CigarOperation*>;
+
+    AlignedReadView() = delete;
+
+    AlignedReadView(const ReadBatch& batch, std::size_t index) noexcept;
+
+    AlignedReadView(const AlignedReadView&)            = default;
+    AlignedReadView& operator=(const AlignedReadView&) = default;
+    AlignedReadView(AlignedReadView&&)                 = default;
+    AlignedReadView& operator=(AlignedReadView&&)      = default;
+
+    ~AlignedReadView() = default;
+
+    boost::string_ref name() const noexcept;
+    GenomicRegion mapped_region() const;
+    ContigRegion contig_region() const noexcept;
+    SequenceView sequence() const noexcept;
+    BaseQualityRange base_qualities() const noexcept;
+    CigarRange cigar() const noexcept;
+    MappingQuality mapping_quality() const noexcept;
+    Direction direction() const noexcept;
+    bool has_other_segment() const noexcept;
+    Flags flags() const noexcept;
+
+    bool is_marked_all_segments_in_read_aligned() const noexcept;
+    bool is_marked_multiple_segment_template() const noexcept;
+    bool is_marked_unmapped() const noexcept;
+    bool is_marked_reverse_mapped() const noexcept;
+    bool is_marked_secondary_alignment() const noexcept;
+    bool is_marked_qc_fail() const noexcept;
+    bool is_marked_duplicate() const noexcept;
+    bool is_marked_supplementary_alignment() const noexcept;
+
+    AlignedRead materialise() const;
+
+private:
+    const ReadBatch* batch_;
+    const ReadBatch::Record* record_;
+
+    bool flag(unsigned n) const noexcept;
+    
+    friend ReadBatch;
+};
+
+class ReadBatch::const_iterator
+: public boost::iterator_facade<const_iterator, AlignedReadView, std::random_access_iterator_tag, AlignedReadView>
+{
+public:
+    const_iterator() = default;
+    const_iterator(const ReadBatch& batch, std::size_t index) noexcept : batch_ {&batch}, index_ {index} {}
+
+private:
+    friend class boost::iterator_core_access;
+
+    const ReadBatch* batch_ = nullptr;
+    std::size_t index_ = 0;
+
+    AlignedReadView dereference() const noexcept { return (*batch_)[index_]; }
+    bool equal(const const_iterator& other) const noexcept { return index_ == other.index_; }
+    void increment() noexcept { ++index_; }
+    void decrement() noexcept { --index_; }
+    void advance(std::ptrdiff_t n) noexcept { index_ += n; }
+    std::ptrdiff_t distance_to(const const_iterator& other) const noexcept
+    {
+        return static_cast<std::ptrdiff_t>(other.index_) - static_cast<std::ptrdiff_t>(index_);
+    }
+};
+
+// ReadBatch template members
+
+template <typename SequenceIt>
+void ReadBatch::copy_sequence(SequenceIt first, const std::size_t n, char* result)
+{
+    std::copy_n(first, n, result);
+}
+
+inline void ReadBatch::copy_sequence(const utils::PackedSequenceView& sequence, std::size_t, char* result) noexcept
+{
+    utils::decode(sequence, result);
+}
+
+template <typename SequenceIt, typename QualityIt, typename CigarIt>
+ReadBatch::Record&
+ReadBatch::append_record(const boost::string_ref name, const Position begin,
+                         SequenceIt sequence_first, QualityIt quality_first, const std::size_t sequence_length,
+                         CigarIt cigar_first, CigarIt cigar_last,
+                         const MappingQuality mapping_quality, const Flags& flags)
+{
+    Record record {};
+    record.name_offset = names_.size();
+    record.name_length = static_cast<Offset>(name.size());
+    names_.append(name.data(), name.size());
+    record.sequence_offset = sequences_.size();
+    record.sequence_length = static_cast<Offset>(sequence_length);
+    sequences_.resize(sequences_.size() + sequence_length);
+    copy_sequence(sequence_first, sequence_length, &sequences_[record.sequence_offset]);
+    qualities_.resize(qualities_.size() + sequence_length);
+    std::copy_n(quality_first, sequence_length, std::next(std::begin(qualities_), record.sequence_offset));
+    record.cigar_offset = cigars_.size();
+    cigars_.insert(std::end(cigars_), cigar_first, cigar_last);
+    record.cigar_length = static_cast<Offset>(cigars_.size() - record.cigar_offset);
+    record.begin = begin;
+    record.end = begin + std::accumulate(std::next(std::cbegin(cigars_), record.cigar_offset), std::cend(cigars_), Position {0},
+                                         [] (const Position curr, const CigarOperation& op) {
+                                             return curr + (op.advances_reference() ? op.size() : 0);
+                                         });
+    record.next_segment_begin = 0;
+    record.inferred_template_length = 0;
+    record.next_segment_contig = noNextSegment_;
+    record.flags = compress(flags);
+    record.mapping_quality = mapping_quality;
+    records_.push_back(record);
+    return records_.back();
+}
+
+template <typename SequenceIt, typename QualityIt, typename CigarIt>
+void ReadBatch::emplace_back(const boost::string_ref name, const Position begin,
+                             SequenceIt sequence_first, QualityIt quality_first, const std::size_t sequence_length,
+                             CigarIt cigar_first, CigarIt cigar_last,
+                             const MappingQuality mapping_quality, const Flags& flags)
+{
+    append_record(name, begin, sequence_first, quality_first, sequence_length,
+                  cigar_first, cigar_last, mapping_quality, flags);
+}
+
+template <typename SequenceIt, typename QualityIt, typename CigarIt>
+void ReadBatch::emplace_back(const boost::string_ref name, const Position begin,
+                             SequenceIt sequence_first, QualityIt quality_first, const std::size_t sequence_length,
+                             CigarIt cigar_first, CigarIt cigar_last,
+                             const MappingQuality mapping_quality, const Flags& flags,
+                             const ContigName& next_segment_contig_name, const Position next_segment_begin,
+                             const Size inferred_template_length, const SegmentFlags& next_segment_flags)
+{
+    auto& record = append_record(name, begin, sequence_first, quality_first, sequence_length,
+                                 cigar_first, cigar_last, mapping_quality, flags);
+    record.next_segment_contig = intern_contig(next_segment_contig_name);
+    record.next_segment_begin = next_segment_begin;
+    record.inferred_template_length = inferred_template_length;
+    record.flags |= compress(next_segment_flags);
+}
+
+// non-member methods
+
+std::vector<AlignedRead> materialise(const ReadBatch& batch);
+
+template <typename Range>
+ReadBatch make_read_batch(const Range& reads)
+{
+    if (reads.empty()) return ReadBatch {};
+    ReadBatch result {contig_name(*std::cbegin(reads))};
+    std::size_t num_bases {0};
+    for (const AlignedRead& read : reads) num_bases += sequence_size(read);
+    result.reserve(reads.size(), num_bases);
+    for (const AlignedRead& read : reads) result.push_back(read);
+    return result;
+}
+
+// Merges two position sorted batches into a single position sorted batch
+ReadBatch merge(const ReadBatch& lhs, const ReadBatch& rhs);
+
+std::size_t sequence_size(const AlignedReadView& read) noexcept;
+
+} // namespace octopus
+
+#endif
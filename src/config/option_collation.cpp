@@ -241,7 +241,7 @@ boost::optional<unsigned> get_num_threads(const OptionMap& options)
 ExecutionPolicy get_thread_execution_policy(const OptionMap& options)
 {
     if (is_set("threads", options)) {
-        if (options.at("threads").as<int>() == 0) {
+        if (options.at("threads").as<int>() != 1) {
             return ExecutionPolicy::par;
         } else {
             return ExecutionPolicy::seq;
@@ -274,6 +274,15 @@ boost::optional<fs::path> get_trace_log_file_name(const OptionMap& options)
     }
 }
 
+boost::optional<fs::path> get_profile_file_name(const OptionMap& options)
+{
+    if (is_set("profile", options)) {
+        return resolve_path(options.at("profile").as<fs::path>(), options);
+    } else {
+        return boost::none;
+    }
+}
+
 bool is_fast_mode(const OptionMap& options)
 {
     return options.at("fast").as<bool>() || options.at("very-fast").as<bool>();
@@ -1539,6 +1548,13 @@ bool keep_unfiltered_calls(const OptionMap& options) noexcept
     return options.at("keep-unfiltered-calls").as<bool>();
 }
 
+bool fuse_call_filtering(const OptionMap& options) noexcept
+{
+    // There are no unfiltered calls to keep or re-filter when calls are filtered as they are made
+    return is_call_filtering_requested(options) && options.at("fused-filtering").as<bool>()
+           && !keep_unfiltered_calls(options) && !is_set("filter-vcf", options);
+}
+
 ReadPipe make_default_filter_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples)
 {
     using std::make_unique;
@@ -32,6 +32,7 @@ bool is_trace_mode(const OptionMap& options);
 
 boost::optional<fs::path> get_debug_log_file_name(const OptionMap& options);
 boost::optional<fs::path> get_trace_log_file_name(const OptionMap& options);
+boost::optional<fs::path> get_profile_file_name(const OptionMap& options);
 
 boost::optional<unsigned> get_num_threads(const OptionMap& options);
 
@@ -66,6 +67,8 @@ bool use_calling_read_pipe_for_call_filtering(const OptionMap& options) noexcept
 
 bool keep_unfiltered_calls(const OptionMap& options) noexcept;
 
+bool fuse_call_filtering(const OptionMap& options) noexcept;
+
 ReadPipe make_call_filter_read_pipe(ReadManager& read_manager, std::vector<SampleName> samples,
                                     const OptionMap& options);
 
@@ -62,6 +62,10 @@ OptionMap parse_options(const int argc, const char** argv)
      po::value<fs::path>()->implicit_value("octopus_trace.log"),
      "Writes very verbose debug information to trace.log in the working directory")
     
+    ("profile",
+     po::value<fs::path>()->implicit_value("octopus_profile.json"),
+     "Writes a JSON breakdown of the time spent in each calling stage, for every contig and calling task")
+    
     ("fast",
      po::bool_switch()->default_value(false),
      "Turns off some features to improve runtime, at the cost of decreased calling accuracy."
@@ -577,6 +581,11 @@ OptionMap parse_options(const int argc, const char** argv)
      po::bool_switch()->default_value(false),
      "Keep a copy of unfiltered calls")
     
+    ("fused-filtering",
+     po::bool_switch()->default_value(false),
+     "Filter calls as they are made using the reads they were called from, rather than in a second pass"
+     " over the reads. Implies --use-calling-reads-for-filtering")
+    
     ("csr-training",
      po::value<std::vector<std::string>>()->multitoken(),
      "Activates CSR training mode with the given measures - outputs all calls as PASS and annotates output VCF with measure values")
@@ -132,10 +132,15 @@ auto convert_to_vcf(std::deque<CallWrapper>&& calls, const VcfRecordFactory& fac
 
 std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const
 {
-    resume(init_timer);
     ReadMap reads;
+    return call(call_region, progress_meter, reads);
+}
+
+std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMeter& progress_meter, ReadMap& reads) const
+{
+    reads.clear();
     if (candidate_generator_.requires_reads()) {
-        reads = read_pipe_.get().fetch_reads(expand(call_region, 100));
+        reads = read_pipe_.get().fetch_reads(read_fetch_region(call_region));
         add_reads(reads, candidate_generator_);
         if (!refcalls_requested() && all_empty(reads)) {
             if (debug_log_) stream(*debug_log_) << "Stopping early as no reads found in call region " << call_region;
@@ -154,7 +159,6 @@ std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMet
         // as we didn't fetch them earlier
         reads = read_pipe_.get().fetch_reads(extract_regions(candidates));
     }
-    pause(init_timer);
     auto calls = call_variants(call_region, candidates, reads, progress_meter);
     candidates.clear();
     candidates.shrink_to_fit();
@@ -164,6 +168,11 @@ std::deque<VcfRecord> Caller::call(const GenomicRegion& call_region, ProgressMet
     return convert_to_vcf(std::move(calls), record_factory, call_region);
 }
     
+GenomicRegion Caller::read_fetch_region(const GenomicRegion& call_region)
+{
+    return expand(call_region, 100);
+}
+
 std::vector<VcfRecord> Caller::regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const
 {
     return {}; // TODO
@@ -303,9 +312,10 @@ Caller::call_variants(const GenomicRegion& call_region, const MappableFlatSet<Va
         }
         auto has_removal_impact = filter_haplotypes(haplotypes, haplotype_generator, haplotype_likelihoods, protected_haplotypes);
         if (haplotypes.empty()) continue;
-        resume(latent_timer);
-        const auto caller_latents = infer_latents(haplotypes, haplotype_likelihoods);
-        pause(latent_timer);
+        const auto caller_latents = [&] () {
+            profiling::StageTimer timer {profiling::Stage::latents};
+            return infer_latents(haplotypes, haplotype_likelihoods);
+        }();
         if (trace_log_) {
             debug::print_haplotype_posteriors(stream(*trace_log_), *caller_latents->haplotype_posteriors(), -1);
         } else if (debug_log_) {
@@ -625,9 +635,7 @@ void Caller::call_variants(const GenomicRegion& active_region,
         std::vector<GenomicRegion> called_regions;
         if (!active_candidates.empty()) {
             if (debug_log_) stream(*debug_log_) << "Calling variants in region " << uncalled_region;
-            resume(calling_timer);
             auto variant_calls = wrap(call_variants(active_candidates, latents));
-            pause(calling_timer);
             if (!variant_calls.empty()) {
                 set_model_posteriors(variant_calls, latents, haplotypes, haplotype_likelihoods);
                 called_regions = extract_covered_regions(variant_calls);
@@ -678,9 +686,10 @@ void Caller::set_model_posteriors(std::vector<CallWrapper>& calls, const Latents
                                   const HaplotypeLikelihoodCache& haplotype_likelihoods) const
 {
     if (parameters_.allow_model_filtering || requires_model_evaluation(calls)) {
-        resume(latent_timer);
-        const auto mp = calculate_model_posterior(haplotypes, haplotype_likelihoods, latents);
-        pause(latent_timer);
+        const auto mp = [&] () {
+            profiling::StageTimer timer {profiling::Stage::latents};
+            return calculate_model_posterior(haplotypes, haplotype_likelihoods, latents);
+        }();
         if (mp) {
             for (auto& call : calls) {
                 call->set_model_posterior(probability_to_phred(1 - *mp));
@@ -743,10 +752,11 @@ void Caller::set_phasing(std::vector<CallWrapper>& calls, const Latents& latents
                          const std::vector<Haplotype>& haplotypes,
                          const GenomicRegion& call_region) const
 {
-    resume(phasing_timer);
-    const auto phase = phaser_.force_phase(haplotypes, *latents.genotype_posteriors(),
-                                           extract_regions(calls), get_genotype_calls(latents));
-    pause(phasing_timer);
+    const auto phase = [&] () {
+        profiling::StageTimer timer {profiling::Stage::phasing};
+        return phaser_.force_phase(haplotypes, *latents.genotype_posteriors(),
+                                   extract_regions(calls), get_genotype_calls(latents));
+    }();
     if (debug_log_) debug::print_phase_sets(stream(*debug_log_), phase);
     octopus::set_phasing(calls, phase, call_region);
 }
@@ -769,6 +779,7 @@ bool check_reference(const std::vector<Variant>& variants, const ReferenceGenome
 MappableFlatSet<Variant> Caller::generate_candidate_variants(const GenomicRegion& region) const
 {
     if (debug_log_) stream(*debug_log_) << "Generating candidate variants in region " << region;
+    profiling::StageTimer timer {profiling::Stage::candidate_generation};
     auto raw_candidates = candidate_generator_.generate(region);
     if (debug_log_) debug::print_left_aligned_candidates(stream(*debug_log_), raw_candidates, reference_);
     auto final_candidates = unique_left_align(std::move(raw_candidates), reference_);
@@ -854,9 +865,8 @@ bool Caller::populate(HaplotypeLikelihoodCache& haplotype_likelihoods,
         }
     }
     try {
-        resume(haplotype_likelihood_timer);
+        profiling::StageTimer timer {profiling::Stage::likelihoods};
         haplotype_likelihoods.populate(active_reads, haplotypes, std::move(flank_state));
-        pause(haplotype_likelihood_timer);
     } catch(const HaplotypeLikelihoodModel::ShortHaplotypeError& e) {
         if (debug_log_) {
             stream(*debug_log_) << "Skipping " << active_region << " as a haplotype was too short by "
@@ -65,6 +65,12 @@ public:
     
     std::deque<VcfRecord> call(const GenomicRegion& call_region, ProgressMeter& progress_meter) const;
     
+    // As above, but also gives back the reads used for calling so they can be reused (e.g. for filtering)
+    std::deque<VcfRecord> call(const GenomicRegion& call_region, ProgressMeter& progress_meter, ReadMap& reads) const;
+    
+    // The region reads are fetched from when calling call_region
+    static GenomicRegion read_fetch_region(const GenomicRegion& call_region);
+    
     std::vector<VcfRecord> regenotype(const std::vector<Variant>& variants, ProgressMeter& progress_meter) const;
     
 protected:
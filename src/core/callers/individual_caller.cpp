@@ -13,10 +13,12 @@
 #include <utility>
 #include <stdexcept>
 #include <iostream>
+#include <cassert>
 
 #include "basics/genomic_region.hpp"
 #include "core/types/allele.hpp"
 #include "core/types/variant.hpp"
+#include "core/types/genotype_index.hpp"
 #include "utils/maths.hpp"
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
@@ -57,18 +59,19 @@ IndividualCaller::CallTypeSet IndividualCaller::do_call_types() const
 
 IndividualCaller::Latents::Latents(const SampleName& sample,
                                    const std::vector<Haplotype>& haplotypes,
-                                   std::vector<Genotype<Haplotype>>&& genotypes,
-                                   ModelInferences&& inferences)
-: genotype_posteriors_ {}
+                                   GenotypeIndexVector&& genotypes,
+                                   ModelInferences&& inferences,
+                                   std::unique_ptr<GenotypePriorModel> prior_model)
+: haplotypes_ {make_shared_haplotypes(haplotypes)}
+, genotypes_ {std::move(genotypes)}
+, genotype_probabilities_ {std::move(inferences.posteriors.genotype_probabilities)}
+, prior_model_ {std::move(prior_model)}
+, genotype_posteriors_ {}
 , haplotype_posteriors_ {}
 , model_log_evidence_ {inferences.log_evidence}
 {
-    GenotypeProbabilityMap genotype_posteriors {
-        std::make_move_iterator(std::begin(genotypes)),
-        std::make_move_iterator(std::end(genotypes))
-    };
-    insert_sample(sample, inferences.posteriors.genotype_probabilities, genotype_posteriors);
-    genotype_posteriors_  = std::make_shared<GenotypeProbabilityMap>(std::move(genotype_posteriors));
+    assert(genotypes_.size() == genotype_probabilities_.size());
+    genotype_posteriors_  = std::make_shared<GenotypeProbabilityMap>(materialise_probable_genotypes(sample));
     haplotype_posteriors_ = std::make_shared<HaplotypeProbabilityMap>(calculate_haplotype_posteriors(haplotypes));
 }
 
@@ -87,19 +90,46 @@ IndividualCaller::Latents::genotype_posteriors() const noexcept
 // IndividualCaller::Latents private methods
 
 IndividualCaller::Latents::HaplotypeProbabilityMap
-IndividualCaller::Latents::calculate_haplotype_posteriors(const std::vector<Haplotype>& haplotypes)
-{
-    assert(genotype_posteriors_ != nullptr);
+IndividualCaller::Latents::calculate_haplotype_posteriors(const std::vector<Haplotype>& haplotypes) const
+{
+    std::vector<double> posteriors(haplotypes.size(), 0.0);
+    for (std::size_t i {0}; i < genotypes_.size(); ++i) {
+        const auto genotype = genotypes_[i];
+        // Genotype indices are sorted, so each unique haplotype is counted once
+        for (auto itr = std::cbegin(genotype); itr != std::cend(genotype); ++itr) {
+            if (itr == std::cbegin(genotype) || *itr != *std::prev(itr)) {
+                posteriors[*itr] += genotype_probabilities_[i];
+            }
+        }
+    }
     HaplotypeProbabilityMap result {haplotypes.size()};
-    for (const auto& haplotype : haplotypes) {
-        result.emplace(haplotype, 0.0);
+    for (std::size_t i {0}; i < haplotypes.size(); ++i) {
+        result.emplace(haplotypes[i], posteriors[i]);
     }
-    const auto& sample = std::cbegin(*genotype_posteriors_)->first;
-    for (const auto& p : (*genotype_posteriors_)[sample]) {
-        for (const auto& haplotype : p.first.copy_unique_ref()) {
-            result.at(haplotype) += p.second;
+    return result;
+}
+
+IndividualCaller::Latents::GenotypeProbabilityMap
+IndividualCaller::Latents::materialise_probable_genotypes(const SampleName& sample) const
+{
+    // Genotypes below this posterior have no noticeable effect on the phase scores made from this map
+    static constexpr double minMaterialisedPosterior {1e-15};
+    assert(!genotype_probabilities_.empty());
+    const auto map_itr = std::max_element(std::cbegin(genotype_probabilities_), std::cend(genotype_probabilities_));
+    const auto map_index = static_cast<std::size_t>(std::distance(std::cbegin(genotype_probabilities_), map_itr));
+    std::vector<Genotype<Haplotype>> genotypes {};
+    GenotypeProbabilityVector probabilities {};
+    for (std::size_t i {0}; i < genotypes_.size(); ++i) {
+        if (genotype_probabilities_[i] >= minMaterialisedPosterior || i == map_index) {
+            genotypes.push_back(materialise(genotypes_[i], haplotypes_));
+            probabilities.push_back(genotype_probabilities_[i]);
         }
     }
+    GenotypeProbabilityMap result {
+        std::make_move_iterator(std::begin(genotypes)),
+        std::make_move_iterator(std::end(genotypes))
+    };
+    insert_sample(sample, probabilities, result);
     return result;
 }
 
@@ -107,13 +137,15 @@ std::unique_ptr<IndividualCaller::Caller::Latents>
 IndividualCaller::infer_latents(const std::vector<Haplotype>& haplotypes,
                                 const HaplotypeLikelihoodCache& haplotype_likelihoods) const
 {
-    auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidy);
+    auto genotypes = generate_all_genotype_indices(static_cast<unsigned>(haplotypes.size()), parameters_.ploidy);
     if (debug_log_) stream(*debug_log_) << "There are " << genotypes.size() << " candidate genotypes";
-    const auto prior_model = make_prior_model(haplotypes);
+    auto prior_model = make_prior_model(haplotypes);
+    prior_model->prime(haplotypes);
     const model::IndividualModel model {*prior_model, debug_log_};
     haplotype_likelihoods.prime(sample());
-    auto inferences = model.evaluate(genotypes, haplotype_likelihoods);
-    return std::make_unique<Latents>(sample(), haplotypes, std::move(genotypes), std::move(inferences));
+    auto inferences = model.evaluate(haplotypes, genotypes, haplotype_likelihoods);
+    return std::make_unique<Latents>(sample(), haplotypes, std::move(genotypes), std::move(inferences),
+                                     std::move(prior_model));
 }
 
 boost::optional<double>
@@ -140,11 +172,11 @@ IndividualCaller::calculate_model_posterior(const std::vector<Haplotype>& haplot
                                             const HaplotypeLikelihoodCache& haplotype_likelihoods,
                                             const Latents& latents) const
 {
-    const auto genotypes = generate_all_genotypes(haplotypes, parameters_.ploidy + 1);
-    const auto prior_model = make_prior_model(haplotypes);
-    const model::IndividualModel model {*prior_model, debug_log_};
+    const auto genotypes = generate_all_genotype_indices(static_cast<unsigned>(haplotypes.size()), parameters_.ploidy + 1);
+    // The latents' prior model is already primed with these haplotypes
+    const model::IndividualModel model {*latents.prior_model_, debug_log_};
     haplotype_likelihoods.prime(sample());
-    const auto inferences = model.evaluate(genotypes, haplotype_likelihoods);
+    const auto inferences = model.evaluate(haplotypes, genotypes, haplotype_likelihoods);
     return octopus::calculate_model_posterior(latents.model_log_evidence_, inferences.log_evidence);
 }
 
@@ -192,19 +224,43 @@ struct GenotypeCall
 
 using GenotypeCalls = std::vector<GenotypeCall>;
 
+// Genotype posteriors stay indexed by haplotype, so each query of a haplotype is made once
+// rather than once per genotype containing it
+
+struct GenotypePosteriors
+{
+    const std::vector<std::shared_ptr<Haplotype>>& haplotypes;
+    const GenotypeIndexVector& genotypes;
+    const std::vector<double>& probabilities;
+};
+
+template <typename UnaryPredicate>
+auto evaluate_each_haplotype(const GenotypePosteriors& genotype_posteriors, UnaryPredicate pred)
+{
+    std::vector<char> result(genotype_posteriors.haplotypes.size());
+    std::transform(std::cbegin(genotype_posteriors.haplotypes), std::cend(genotype_posteriors.haplotypes),
+                   std::begin(result), [&pred] (const auto& haplotype) { return pred(*haplotype); });
+    return result;
+}
+
 // allele posterior calculations
 
-auto compute_posterior(const Allele& allele, const GenotypeProbabilityMap& genotype_posteriors)
+auto compute_posterior(const Allele& allele, const GenotypePosteriors& genotype_posteriors)
 {
-    auto p = std::accumulate(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors),
-                             0.0, [&allele] (const auto curr, const auto& p) {
-                                 return curr + (contains(p.first, allele) ? 0.0 : p.second);
-                             });
+    const auto contained = evaluate_each_haplotype(genotype_posteriors,
+                                                   [&allele] (const auto& haplotype) { return haplotype.contains(allele); });
+    double p {0};
+    for (std::size_t i {0}; i < genotype_posteriors.genotypes.size(); ++i) {
+        const auto genotype = genotype_posteriors.genotypes[i];
+        if (std::none_of(std::cbegin(genotype), std::cend(genotype), [&contained] (auto h) { return contained[h]; })) {
+            p += genotype_posteriors.probabilities[i];
+        }
+    }
     return probability_to_phred(p);
 }
 
 auto compute_candidate_posteriors(const std::vector<Variant>& candidates,
-                                  const GenotypeProbabilityMap& genotype_posteriors)
+                                  const GenotypePosteriors& genotype_posteriors)
 {
     VariantPosteriorVector result {};
     result.reserve(candidates.size());
@@ -245,58 +301,82 @@ VariantCalls call_candidates(const VariantPosteriorVector& candidate_posteriors,
 
 // variant genotype calling
 
-template <typename PairIterator>
-PairIterator find_map(PairIterator first, PairIterator last)
+bool is_homozygous_reference(const GenotypeIndex& genotype, const GenotypePosteriors& genotype_posteriors)
 {
-    return std::max_element(first, last, [] (const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+    return genotype.is_homozygous() && is_reference(*genotype_posteriors.haplotypes[genotype[0]]);
 }
 
-template <typename T>
-bool is_homozygous_reference(const Genotype<T>& g)
+// Returns the index of the called genotype
+std::size_t call_genotype(const GenotypePosteriors& genotype_posteriors, const bool ignore_hom_ref = false)
 {
-    return is_reference(g[0]) && g.is_homozygous();
+    const auto& probabilities = genotype_posteriors.probabilities;
+    assert(!probabilities.empty());
+    const auto map_itr = std::max_element(std::cbegin(probabilities), std::cend(probabilities));
+    const auto map_index = static_cast<std::size_t>(std::distance(std::cbegin(probabilities), map_itr));
+    if (!ignore_hom_ref || !is_homozygous_reference(genotype_posteriors.genotypes[map_index], genotype_posteriors)) {
+        return map_index;
+    }
+    // Otherwise call the next most probable genotype, preferring the first of any ties
+    boost::optional<std::size_t> result {};
+    for (std::size_t i {0}; i < probabilities.size(); ++i) {
+        if (i != map_index && (!result || probabilities[i] > probabilities[*result])) {
+            result = i;
+        }
+    }
+    return result ? *result : map_index;
 }
 
-auto call_genotype(const GenotypeProbabilityMap& genotype_posteriors, const bool ignore_hom_ref = false)
+// Labels each haplotype with the index of its allele in region; haplotypes with equal alleles share a label
+auto label_alleles(const GenotypePosteriors& genotype_posteriors, const GenomicRegion& region)
 {
-    const auto map_itr = find_map(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors));
-    assert(map_itr != std::cend(genotype_posteriors));
-    if (!ignore_hom_ref || !is_homozygous_reference(map_itr->first)) {
-        return map_itr->first;
-    } else {
-        const auto lhs_map_itr = find_map(std::cbegin(genotype_posteriors), map_itr);
-        const auto rhs_map_itr = find_map(std::next(map_itr), std::cend(genotype_posteriors));
-        if (lhs_map_itr != map_itr) {
-            if (rhs_map_itr != std::cend(genotype_posteriors)) {
-                return lhs_map_itr->second < rhs_map_itr->second ? rhs_map_itr->first : lhs_map_itr->first;
-            } else {
-                return lhs_map_itr->first;
-            }
-        } else {
-            return rhs_map_itr->first;
-        }
+    std::vector<Allele> alleles {};
+    std::vector<unsigned> result {};
+    result.reserve(genotype_posteriors.haplotypes.size());
+    for (const auto& haplotype : genotype_posteriors.haplotypes) {
+        auto allele = copy<Allele>(*haplotype, region);
+        const auto allele_itr = std::find(std::cbegin(alleles), std::cend(alleles), allele);
+        result.push_back(static_cast<unsigned>(std::distance(std::cbegin(alleles), allele_itr)));
+        if (allele_itr == std::cend(alleles)) alleles.push_back(std::move(allele));
     }
+    return result;
 }
 
-auto compute_posterior(const Genotype<Allele>& genotype, const GenotypeProbabilityMap& genotype_posteriors)
+void label_genotype(const GenotypeIndex& genotype, const std::vector<unsigned>& allele_labels,
+                    std::vector<unsigned>& result)
 {
-    auto p = std::accumulate(std::cbegin(genotype_posteriors), std::cend(genotype_posteriors), 0.0,
-                             [&genotype] (const double curr, const auto& p) {
-                                 return curr + (contains(p.first, genotype) ? 0.0 : p.second);
-                             });
+    result.resize(genotype.ploidy());
+    std::transform(std::cbegin(genotype), std::cend(genotype), std::begin(result),
+                   [&allele_labels] (auto h) { return allele_labels[h]; });
+    std::sort(std::begin(result), std::end(result));
+}
+
+// The posterior that the genotype in region is the chunk of the called genotype
+auto compute_posterior(const GenotypeIndex& genotype_call, const GenomicRegion& region,
+                       const GenotypePosteriors& genotype_posteriors)
+{
+    const auto allele_labels = label_alleles(genotype_posteriors, region);
+    std::vector<unsigned> called_labels {}, labels {};
+    label_genotype(genotype_call, allele_labels, called_labels);
+    double p {0};
+    for (std::size_t i {0}; i < genotype_posteriors.genotypes.size(); ++i) {
+        label_genotype(genotype_posteriors.genotypes[i], allele_labels, labels);
+        if (labels != called_labels) {
+            p += genotype_posteriors.probabilities[i];
+        }
+    }
     return probability_to_phred(p);
 }
 
-GenotypeCalls call_genotypes(const Genotype<Haplotype>& genotype_call,
-                             const GenotypeProbabilityMap& genotype_posteriors,
+GenotypeCalls call_genotypes(const GenotypeIndex& genotype_call_index,
+                             const Genotype<Haplotype>& genotype_call,
+                             const GenotypePosteriors& genotype_posteriors,
                              const std::vector<GenomicRegion>& variant_regions)
 {
     GenotypeCalls result {};
     result.reserve(variant_regions.size());
     for (const auto& region : variant_regions) {
-        auto genotype_chunk = copy<Allele>(genotype_call, region);
-        const auto posterior = compute_posterior(genotype_chunk, genotype_posteriors);
-        result.emplace_back(std::move(genotype_chunk), posterior);
+        const auto posterior = compute_posterior(genotype_call_index, region, genotype_posteriors);
+        result.emplace_back(copy<Allele>(genotype_call, region), posterior);
     }
     return result;
 }
@@ -363,15 +443,16 @@ IndividualCaller::call_variants(const std::vector<Variant>& candidates,
                                 const Latents& latents) const
 {
     if (parameters_.ploidy == 0) return {};
-    const auto& genotype_posteriors = (*latents.genotype_posteriors_)[sample()];
-    debug::log(genotype_posteriors, debug_log_, trace_log_);
+    debug::log((*latents.genotype_posteriors_)[sample()], debug_log_, trace_log_);
+    const GenotypePosteriors genotype_posteriors {latents.haplotypes_, latents.genotypes_, latents.genotype_probabilities_};
     const auto candidate_posteriors = compute_candidate_posteriors(candidates, genotype_posteriors);
     debug::log(candidate_posteriors, debug_log_, trace_log_, parameters_.min_variant_posterior);
     const bool force_call_non_ref {has_callable(candidate_posteriors, parameters_.min_variant_posterior)};
-    const auto genotype_call = octopus::call_genotype(genotype_posteriors, force_call_non_ref);
+    const auto genotype_call_index = latents.genotypes_[octopus::call_genotype(genotype_posteriors, force_call_non_ref)];
+    const auto genotype_call = materialise(genotype_call_index, latents.haplotypes_);
     auto variant_calls = call_candidates(candidate_posteriors, genotype_call, parameters_.min_variant_posterior);
     const auto called_regions = extract_regions(variant_calls);
-    auto genotype_calls = call_genotypes(genotype_call, genotype_posteriors, called_regions);
+    auto genotype_calls = call_genotypes(genotype_call_index, genotype_call, genotype_posteriors, called_regions);
     return transform_calls(sample(), std::move(variant_calls), std::move(genotype_calls));
 }
 
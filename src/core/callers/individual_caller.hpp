@@ -14,6 +14,7 @@
 #include "basics/phred.hpp"
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index.hpp"
 #include "core/models/mutation/coalescent_model.hpp"
 #include "core/models/genotype/genotype_prior_model.hpp"
 #include "core/models/genotype/individual_model.hpp"
@@ -97,6 +98,7 @@ class IndividualCaller::Latents : public Caller::Latents
 {
 public:
     using ModelInferences = model::IndividualModel::InferredLatents;
+    using GenotypeProbabilityVector = model::IndividualModel::Latents::GenotypeProbabilityVector;
     
     using Caller::Latents::HaplotypeProbabilityMap;
     using Caller::Latents::GenotypeProbabilityMap;
@@ -105,18 +107,28 @@ public:
     
     Latents() = delete;
     
+    // The prior model must be primed with haplotypes; it is kept for calculate_model_posterior
     Latents(const SampleName& sample, const std::vector<Haplotype>& haplotypes,
-            std::vector<Genotype<Haplotype>>&& genotypes, ModelInferences&& latents);
+            GenotypeIndexVector&& genotypes, ModelInferences&& latents,
+            std::unique_ptr<GenotypePriorModel> prior_model);
     
     std::shared_ptr<HaplotypeProbabilityMap> haplotype_posteriors() const noexcept override;
+    // Only genotypes with non-negligible posterior probability (and the MAP genotype) are included
     std::shared_ptr<GenotypeProbabilityMap> genotype_posteriors() const noexcept override;
     
 private:
+    // The genotype posteriors are kept as indices into haplotypes_, so calling only has to
+    // make real genotypes for the few it reports
+    std::vector<std::shared_ptr<Haplotype>> haplotypes_;
+    GenotypeIndexVector genotypes_;
+    GenotypeProbabilityVector genotype_probabilities_;
+    std::unique_ptr<GenotypePriorModel> prior_model_;
     std::shared_ptr<GenotypeProbabilityMap> genotype_posteriors_;
     std::shared_ptr<HaplotypeProbabilityMap> haplotype_posteriors_;
     double model_log_evidence_;
     
-    HaplotypeProbabilityMap calculate_haplotype_posteriors(const std::vector<Haplotype>& haplotypes);
+    HaplotypeProbabilityMap calculate_haplotype_posteriors(const std::vector<Haplotype>& haplotypes) const;
+    GenotypeProbabilityMap materialise_probable_genotypes(const SampleName& sample) const;
 };
 
 } // namespace octopus
@@ -134,6 +134,11 @@ const VariantCallFilterFactory& GenomeCallingComponents::call_filter_factory() c
     return *components_.call_filter_factory;
 }
 
+bool GenomeCallingComponents::fused_filtering() const noexcept
+{
+    return components_.fused_filtering;
+}
+
 ReadPipe& GenomeCallingComponents::filter_read_pipe() noexcept
 {
     return components_.filter_read_pipe ? *components_.filter_read_pipe : read_pipe();
@@ -457,6 +462,7 @@ GenomeCallingComponents::Components::Components(ReferenceGenome&& reference, Rea
 , read_pipe {options::make_read_pipe(this->read_manager, this->samples, options)}
 , caller_factory {options::make_caller_factory(this->reference, this->read_pipe, this->regions, options)}
 , call_filter_factory {options::make_call_filter_factory(this->reference, this->read_pipe, options)}
+, fused_filtering {this->call_filter_factory && options::fuse_call_filtering(options)}
 , filter_read_pipe {}
 , output {std::move(output)}
 , num_threads {options::get_num_threads(options)}
@@ -502,7 +508,7 @@ void GenomeCallingComponents::Components::set_read_buffer_size(const options::Op
 
 void GenomeCallingComponents::Components::setup_writers(const options::OptionMap& options)
 {
-    if (call_filter_factory) {
+    if (call_filter_factory && !fused_filtering) {
         const auto final_output_path = output.path();
         filtered_output = std::move(output);
         fs::path prefilter_path;
@@ -528,7 +534,7 @@ void GenomeCallingComponents::Components::setup_writers(const options::OptionMap
 
 void GenomeCallingComponents::Components::setup_filter_read_pipe(const options::OptionMap& options)
 {
-    if (!options::use_calling_read_pipe_for_call_filtering(options)) {
+    if (!fused_filtering && !options::use_calling_read_pipe_for_call_filtering(options)) {
         filter_read_pipe = options::make_call_filter_read_pipe(read_manager, samples, options);
     }
 }
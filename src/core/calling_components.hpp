@@ -21,6 +21,7 @@
 #include "readpipe/read_pipe_fwd.hpp"
 #include "core/callers/caller_factory.hpp"
 #include "core/csr/filters/variant_call_filter_factory.hpp"
+#include "core/csr/filters/single_pass_variant_call_filter.hpp"
 #include "logging/progress_meter.hpp"
 
 namespace octopus {
@@ -59,6 +60,7 @@ public:
     boost::optional<VcfWriter&> filtered_output() noexcept;
     boost::optional<const VcfWriter&> filtered_output() const noexcept;
     const VariantCallFilterFactory& call_filter_factory() const;
+    bool fused_filtering() const noexcept;
     ReadPipe& filter_read_pipe() noexcept;
     const ReadPipe& filter_read_pipe() const noexcept;
     ProgressMeter& progress_meter() noexcept;
@@ -89,6 +91,7 @@ private:
         ReadPipe read_pipe;
         CallerFactory caller_factory;
         std::unique_ptr<VariantCallFilterFactory> call_filter_factory;
+        bool fused_filtering;
         boost::optional<ReadPipe> filter_read_pipe;
         VcfWriter output;
         boost::optional<unsigned> num_threads;
@@ -127,6 +130,7 @@ struct ContigCallingComponents
     std::size_t read_buffer_size;
     std::reference_wrapper<VcfWriter> output;
     std::reference_wrapper<ProgressMeter> progress_meter;
+    boost::optional<const SinglePassVariantCallFilter&> call_filter = boost::none; // set for fused filtering
     
     ContigCallingComponents() = delete;
     
@@ -8,7 +8,6 @@
 #include <algorithm>
 #include <iterator>
 #include <array>
-#include <future>
 #include <cassert>
 
 #include "exceptions/program_error.hpp"
@@ -59,17 +58,42 @@ public:
 
 FacetWrapper FacetFactory::make(const std::string& name, const CallBlock& block) const
 {
-    const auto block_data = make_block_data({name}, block);
+    const auto block_data = make_block_data({name}, block, read_pipe_);
     return make(name, block_data);
 }
 
 FacetFactory::FacetBlock FacetFactory::make(const std::vector<std::string>& names, const CallBlock& block) const
 {
     if (names.empty()) return {};
-    const auto block_data = make_block_data(names, block);
+    const auto block_data = make_block_data(names, block, read_pipe_);
     return make(names, block_data);
 }
 
+FacetFactory::FacetBlock FacetFactory::make(const std::vector<std::string>& names, const CallBlock& block,
+                                            const ReadMap& reads) const
+{
+    if (names.empty()) return {};
+    const auto block_data = make_block_data(names, block, read_pipe_, reads);
+    return make(names, block_data);
+}
+
+FacetFactory::FacetBlock FacetFactory::make(const std::vector<std::string>& names, const CallBlock& block,
+                                            const BufferedReadPipe& read_pipe) const
+{
+    if (names.empty()) return {};
+    const auto block_data = make_block_data(names, block, read_pipe);
+    return make(names, block_data);
+}
+
+BufferedReadPipe FacetFactory::make_read_pipe(const unsigned num_concurrent_pipes) const
+{
+    auto config = read_pipe_.config();
+    config.max_buffer_size /= std::max(num_concurrent_pipes, 1u);
+    // Concurrent pipes already overlap fetching with measuring
+    config.prefetch = false;
+    return BufferedReadPipe {read_pipe_.source(), config, read_pipe_.hints()};
+}
+
 namespace {
 
 template <typename Facet>
@@ -103,47 +127,6 @@ bool requires_genotypes(const std::vector<std::string>& facets) noexcept
 
 } // namespace
 
-std::vector<FacetFactory::FacetBlock> FacetFactory::make(const std::vector<std::string>& names,
-                                                         const std::vector<CallBlock>& blocks,
-                                                         ThreadPool& workers) const
-{
-    if (blocks.empty()) return {};
-    std::vector<FacetBlock> result {};
-    result.reserve(blocks.size());
-    if (blocks.size() > 1 && !workers.empty()) {
-        std::vector<std::future<FacetBlock>> futures {};
-        futures.reserve(blocks.size());
-        const auto fetch_reads = requires_reads(names);
-        const auto fetch_genotypes = requires_genotypes(names);
-        const auto& samples = read_pipe_.source().samples();
-        for (const auto& block : blocks) {
-            // It's faster to fetch reads serially from left to right, so do this outside the thread pool
-            BlockData data {};
-            if (!block.empty()) {
-                data.region = encompassing_region(block);
-                if (fetch_reads) {
-                    data.reads = read_pipe_.fetch_reads(*data.region);
-                }
-            }
-            futures.push_back(workers.push([this, &names, data {std::move(data)}, &block, &samples, fetch_genotypes] () mutable {
-                if (fetch_genotypes) {
-                    data.genotypes = extract_genotypes(block, samples, reference_);
-                }
-                return this->make(names, data);
-            }));
-        }
-        for (auto& fut : futures) {
-            result.push_back(fut.get());
-        }
-    } else {
-        for (const auto& block : blocks) {
-            const auto data = make_block_data(names, block);
-            result.push_back(make(names, data));
-        }
-    }
-    return result;
-}
-
 // private methods
 
 void FacetFactory::setup_facet_makers()
@@ -192,14 +175,20 @@ FacetFactory::FacetBlock FacetFactory::make(const std::vector<std::string>& name
     return result;
 }
 
-FacetFactory::BlockData FacetFactory::make_block_data(const std::vector<std::string>& names, const CallBlock& block) const
+FacetFactory::BlockData FacetFactory::make_block_data(const std::vector<std::string>& names, const CallBlock& block,
+                                                      const BufferedReadPipe& read_pipe,
+                                                      boost::optional<const ReadMap&> reads) const
 {
     BlockData result {};
     assert(!names.empty());
     if (!block.empty()) {
         result.region = encompassing_region(block);
         if (requires_reads(names)) {
-            result.reads = read_pipe_.fetch_reads(*result.region);
+            if (reads) {
+                result.reads = copy_overlapped(*reads, *result.region);
+            } else {
+                result.reads = read_pipe.fetch_reads(*result.region);
+            }
         }
         if (requires_genotypes(names)) {
             result.genotypes = extract_genotypes(block, read_pipe_.source().samples(), reference_);
@@ -16,7 +16,6 @@
 #include "io/reference/reference_genome.hpp"
 #include "readpipe/buffered_read_pipe.hpp"
 #include "utils/genotype_reader.hpp"
-#include "utils/thread_pool.hpp"
 #include "facet.hpp"
 
 namespace octopus { namespace csr {
@@ -40,8 +39,14 @@ public:
     
     FacetWrapper make(const std::string& name, const CallBlock& block) const;
     FacetBlock make(const std::vector<std::string>& names, const CallBlock& block) const;
-    std::vector<FacetBlock> make(const std::vector<std::string>& names, const std::vector<CallBlock>& blocks,
-                                 ThreadPool& workers) const;
+    // Uses the given reads, which must cover the block, rather than fetching them from the read pipe
+    FacetBlock make(const std::vector<std::string>& names, const CallBlock& block, const ReadMap& reads) const;
+    // Fetches reads through the given read pipe, which should come from make_read_pipe
+    FacetBlock make(const std::vector<std::string>& names, const CallBlock& block, const BufferedReadPipe& read_pipe) const;
+    
+    // Makes a read pipe with its own buffer, so facets can be made on several threads at once. The
+    // read buffer budget is shared between num_concurrent_pipes pipes. Hints are copied to the new pipe.
+    BufferedReadPipe make_read_pipe(unsigned num_concurrent_pipes) const;
 
 private:
     struct BlockData
@@ -59,7 +64,8 @@ private:
     void setup_facet_makers();
     FacetWrapper make(const std::string& name, const BlockData& block) const;
     FacetBlock make(const std::vector<std::string>& names, const BlockData& block) const;
-    BlockData make_block_data(const std::vector<std::string>& names, const CallBlock& block) const;
+    BlockData make_block_data(const std::vector<std::string>& names, const CallBlock& block,
+                              const BufferedReadPipe& read_pipe, boost::optional<const ReadMap&> reads = boost::none) const;
 };
 
 } // namespace csr
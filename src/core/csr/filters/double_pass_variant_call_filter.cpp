@@ -45,6 +45,12 @@ void DoublePassVariantCallFilter::make_registration_pass(const VcfReader& source
         auto p = source.iterate();
         std::size_t idx {0};
         std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { record(call, idx++); });
+    } else if (can_measure_multiple_blocks()) {
+        std::size_t idx {0};
+        measure_chunks(source, samples, [&] (const VcfRecord& call, const MeasureVector& measures) {
+            record(idx++, measures);
+            log_progress(mapped_region(call));
+        });
     } else {
         std::size_t idx {0};
         for (auto p = source.iterate(); p.first != p.second;) {
@@ -25,14 +25,38 @@ SinglePassVariantCallFilter::SinglePassVariantCallFilter(FacetFactory facet_fact
 , annotate_measures_ {output_config.annotate_measures}
 {}
 
+std::deque<VcfRecord> SinglePassVariantCallFilter::filter(std::deque<VcfRecord> calls, const ReadMap& reads,
+                                                          const std::vector<SampleName>& samples) const
+{
+    std::deque<VcfRecord> result {};
+    for (const auto& block : make_blocks(std::move(calls), samples)) {
+        const auto measures = measure(block, reads);
+        assert(measures.size() == block.size());
+        for (auto tup : boost::combine(block, measures)) {
+            const VcfRecord& call {tup.get<0>()};
+            const MeasureVector& call_measures {tup.get<1>()};
+            if (annotate_measures_) {
+                auto annotation_builder = VcfRecord::Builder {call};
+                annotate(annotation_builder, call_measures);
+                write(annotation_builder.build_once(), classify(call_measures), result);
+            } else {
+                write(call, classify(call_measures), result);
+            }
+        }
+    }
+    return result;
+}
+
+// private methods
+
 void SinglePassVariantCallFilter::filter(const VcfReader& source, VcfWriter& dest, const SampleList& samples) const
 {
     assert(dest.is_header_written());
     if (progress_) progress_->start();
     if (can_measure_multiple_blocks()) {
-        for (auto p = source.iterate(); p.first != p.second;) {
-            filter(read_next_blocks(p.first, p.second, samples), dest);
-        }
+        measure_chunks(source, samples, [&] (const VcfRecord& call, const MeasureVector& measures) {
+            filter(call, measures, dest);
+        });
     } else if (can_measure_single_call()) {
         auto p = source.iterate();
         std::for_each(std::move(p.first), std::move(p.second), [&] (const VcfRecord& call) { filter(call, dest); });
@@ -54,15 +78,6 @@ void SinglePassVariantCallFilter::filter(const CallBlock& block, VcfWriter& dest
     filter(block, measure(block), dest);
 }
 
-void SinglePassVariantCallFilter::filter(const std::vector<CallBlock>& blocks, VcfWriter& dest) const
-{
-    const auto measures = measure(blocks);
-    assert(measures.size() == blocks.size());
-    for (auto tup : boost::combine(blocks, measures)) {
-        filter(tup.get<0>(), tup.get<1>(), dest);
-    }
-}
-
 void SinglePassVariantCallFilter::filter(const CallBlock& block, const MeasureBlock& measures, VcfWriter& dest) const
 {
     assert(measures.size() == block.size());
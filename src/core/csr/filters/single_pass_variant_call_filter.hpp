@@ -5,6 +5,7 @@
 #define single_pass_variant_call_filter_hpp
 
 #include <vector>
+#include <deque>
 
 #include <boost/optional.hpp>
 
@@ -32,6 +33,11 @@ public:
     
     virtual ~SinglePassVariantCallFilter() override = default;
     
+    // Filters calls that are still in memory using the reads they were called from, so the reads
+    // do not have to be fetched again. Safe to call concurrently, e.g. from calling tasks.
+    std::deque<VcfRecord> filter(std::deque<VcfRecord> calls, const ReadMap& reads,
+                                 const std::vector<SampleName>& samples) const;
+    
 protected:
     std::vector<std::string> measure_names_;
     
@@ -46,13 +52,15 @@ private:
     
     void filter(const VcfRecord& call, VcfWriter& dest) const;
     void filter(const CallBlock& block, VcfWriter& dest) const;
-    void filter(const std::vector<CallBlock>& blocks, VcfWriter& dest) const;
     void filter(const CallBlock& block, const MeasureBlock & measures, VcfWriter& dest) const;
     void filter(const VcfRecord& call, const MeasureVector& measures, VcfWriter& dest) const;
     void log_progress(const GenomicRegion& region) const;
 };
 
 } // namespace csr
+
+using csr::SinglePassVariantCallFilter;
+
 } // namespace octopus
 
 #endif
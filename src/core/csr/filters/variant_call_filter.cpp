@@ -10,6 +10,7 @@
 #include <numeric>
 #include <cmath>
 #include <thread>
+#include <cassert>
 
 #include <boost/range/combine.hpp>
 
@@ -24,13 +25,15 @@
 #include "utils/string_utils.hpp"
 #include "utils/genotype_reader.hpp"
 #include "utils/append.hpp"
-#include "utils/parallel_transform.hpp"
 #include "io/variant/vcf_writer.hpp"
 
 namespace octopus { namespace csr {
 
 namespace {
 
+// Chunks are big enough that each read pipe can buffer reads for many blocks at once
+constexpr std::size_t maxCallsPerChunk {2'000};
+
 unsigned get_pool_size(VariantCallFilter::ConcurrencyPolicy policy)
 {
     const auto num_cores = std::thread::hardware_concurrency();
@@ -57,6 +60,11 @@ auto get_facets(const std::vector<MeasureWrapper>& measures)
     return result;
 }
 
+void add_info(const MeasureWrapper& measure, VcfHeader::Builder& builder)
+{
+    builder.add_info(measure.name(), "1", "String", "CSR measure");
+}
+
 } // namespace
 
 // public methods
@@ -71,17 +79,45 @@ VariantCallFilter::VariantCallFilter(FacetFactory facet_factory,
 , measures_ {std::move(measures)}
 , output_config_ {output_config}
 , workers_ {get_pool_size(threading)}
-{}
+, worker_read_pipes_ {}
+, free_worker_read_pipes_ {}
+, worker_read_pipes_mutex_ {}
+{
+    const auto num_workers = static_cast<unsigned>(workers_.size());
+    worker_read_pipes_.reserve(num_workers);
+    for (unsigned i {0}; i < num_workers; ++i) {
+        worker_read_pipes_.push_back(facet_factory_.make_read_pipe(num_workers));
+        free_worker_read_pipes_.push_back(i);
+    }
+}
 
 void VariantCallFilter::filter(const VcfReader& source, VcfWriter& dest) const
 {
     if (!dest.is_header_written()) {
-        dest << make_header(source);
+        dest << make_header(source.fetch_header());
     }
     const auto samples = source.fetch_header().samples();
     filter(source, dest, samples);
 }
 
+VcfHeader VariantCallFilter::make_header(const VcfHeader& source) const
+{
+    VcfHeader::Builder builder {source};
+    if (output_config_.emit_sites_only) {
+        builder.clear_format();
+    }
+    if (output_config_.clear_info) {
+        builder.clear_info();
+    }
+    if (output_config_.annotate_measures) {
+        for (const auto& measure : measures_) {
+            add_info(measure, builder);
+        }
+    }
+    annotate(builder);
+    return builder.build_once();
+}
+
 // protected methods
 
 bool VariantCallFilter::can_measure_single_call() const noexcept
@@ -144,19 +180,19 @@ VariantCallFilter::read_next_block(VcfIterator& first, const VcfIterator& last,
 }
 
 std::vector<VariantCallFilter::CallBlock>
-VariantCallFilter::read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const
-{
-    std::vector<VariantCallFilter::CallBlock> result {};
-    if (can_measure_multiple_blocks()) {
-        const auto max_blocks = max_concurrent_blocks();
-        result.reserve(max_blocks);
-        while (result.size() < max_blocks) {
-            result.push_back(read_next_block(first, last, samples));
-            if (first == last || !is_same_contig(*first, result.back().front())) break;
+VariantCallFilter::make_blocks(std::deque<VcfRecord>&& calls, const SampleList& samples) const
+{
+    std::vector<CallBlock> result {};
+    boost::optional<GenomicRegion> block_phase_region {};
+    for (auto& call : calls) {
+        auto call_phase_region = get_phase_region(call, samples);
+        if (!block_phase_region || !overlaps(*block_phase_region, call_phase_region)) {
+            result.emplace_back();
         }
-    } else {
-        result.push_back(read_next_block(first, last, samples));
+        block_phase_region = std::move(call_phase_region);
+        result.back().push_back(std::move(call));
     }
+    calls.clear();
     return result;
 }
 
@@ -174,25 +210,38 @@ VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& bloc
     return measure(block, facets);
 }
 
-std::vector<VariantCallFilter::MeasureBlock> VariantCallFilter::measure(const std::vector<CallBlock>& blocks) const
+VariantCallFilter::MeasureBlock VariantCallFilter::measure(const CallBlock& block, const ReadMap& reads) const
+{
+    const auto facets = compute_facets(block, reads);
+    return measure(block, facets);
+}
+
+void VariantCallFilter::measure_chunks(const VcfReader& source, const SampleList& samples,
+                                       const CallMeasureVisitor& visit) const
 {
-    std::vector<MeasureBlock> result {};
-    result.reserve(blocks.size());
-    if (is_multithreaded()) {
-        const auto facets = compute_facets(blocks);
-        if (debug_log_) {
-            stream(*debug_log_) << "Measuring " << blocks.size() << " blocks with " << workers_.size() << " threads";
+    assert(is_multithreaded());
+    std::deque<std::future<MeasuredChunk>> chunks {};
+    const auto max_chunks = max_concurrent_chunks();
+    for (auto p = source.iterate(); p.first != p.second || !chunks.empty();) {
+        while (p.first != p.second && chunks.size() < max_chunks) {
+            auto chunk = read_next_chunk(p.first, p.second, samples);
+            if (debug_log_) {
+                stream(*debug_log_) << "Measuring chunk " << encompassing_region(chunk.front().front(), chunk.back().back())
+                                    << " containing " << chunk.size() << " blocks";
+            }
+            chunks.push_back(workers_.push([this, chunk {std::move(chunk)}] () mutable {
+                return this->measure(std::move(chunk)); }));
         }
-        transform(std::cbegin(blocks), std::cend(blocks), std::cbegin(facets), std::back_inserter(result),
-                  [this] (const auto& block, const auto& block_facets) {
-                      return this->measure(block, block_facets);
-                  }, workers_);
-    } else {
-        for (const CallBlock& block : blocks) {
-            result.push_back(measure(block));
+        const auto measured = chunks.front().get();
+        chunks.pop_front();
+        assert(measured.blocks.size() == measured.measures.size());
+        for (auto block : boost::combine(measured.blocks, measured.measures)) {
+            assert(block.get<0>().size() == block.get<1>().size());
+            for (auto tup : boost::combine(block.get<0>(), block.get<1>())) {
+                visit(tup.get<0>(), tup.get<1>());
+            }
         }
     }
-    return result;
 }
 
 void VariantCallFilter::write(const VcfRecord& call, const Classification& classification, VcfWriter& dest) const
@@ -204,6 +253,15 @@ void VariantCallFilter::write(const VcfRecord& call, const Classification& class
     }
 }
 
+void VariantCallFilter::write(const VcfRecord& call, const Classification& classification, std::deque<VcfRecord>& dest) const
+{
+    if (classification.category != Classification::Category::hard_filtered) {
+        auto filtered_call = construct_template(call);
+        annotate(filtered_call, classification);
+        dest.push_back(filtered_call.build_once());
+    }
+}
+
 void VariantCallFilter::annotate(VcfRecord::Builder& call, const MeasureVector& measures) const
 {
     if (output_config_.clear_info) {
@@ -218,29 +276,6 @@ void VariantCallFilter::annotate(VcfRecord::Builder& call, const MeasureVector&
 
 // private methods
 
-void add_info(const MeasureWrapper& measure, VcfHeader::Builder& builder)
-{
-    builder.add_info(measure.name(), "1", "String", "CSR measure");
-}
-
-VcfHeader VariantCallFilter::make_header(const VcfReader& source) const
-{
-    VcfHeader::Builder builder {source.fetch_header()};
-    if (output_config_.emit_sites_only) {
-        builder.clear_format();
-    }
-    if (output_config_.clear_info) {
-        builder.clear_info();
-    }
-    if (output_config_.annotate_measures) {
-        for (const auto& measure : measures_) {
-            add_info(measure, builder);
-        }
-    }
-    annotate(builder);
-    return builder.build_once();
-}
-
 VcfRecord::Builder VariantCallFilter::construct_template(const VcfRecord& call) const
 {
     VcfRecord::Builder result {call};
@@ -278,14 +313,60 @@ Measure::FacetMap VariantCallFilter::compute_facets(const CallBlock& block) cons
     return make_map(facet_names_, facet_factory_.make(facet_names_, block));
 }
 
-std::vector<Measure::FacetMap> VariantCallFilter::compute_facets(const std::vector<CallBlock>& blocks) const
+Measure::FacetMap VariantCallFilter::compute_facets(const CallBlock& block, const ReadMap& reads) const
+{
+    return make_map(facet_names_, facet_factory_.make(facet_names_, block, reads));
+}
+
+Measure::FacetMap VariantCallFilter::compute_facets(const CallBlock& block, const BufferedReadPipe& read_pipe) const
+{
+    return make_map(facet_names_, facet_factory_.make(facet_names_, block, read_pipe));
+}
+
+std::vector<VariantCallFilter::CallBlock>
+VariantCallFilter::read_next_chunk(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const
+{
+    std::vector<CallBlock> result {};
+    std::size_t num_calls {0};
+    while (first != last && num_calls < maxCallsPerChunk) {
+        result.push_back(read_next_block(first, last, samples));
+        num_calls += result.back().size();
+        if (first != last && !is_same_contig(*first, result.back().front())) break;
+    }
+    return result;
+}
+
+VariantCallFilter::MeasuredChunk VariantCallFilter::measure(std::vector<CallBlock> chunk) const
+{
+    // No more chunks run at once than there are workers, so there is always a free pipe
+    std::unique_lock<std::mutex> lock {worker_read_pipes_mutex_};
+    assert(!free_worker_read_pipes_.empty());
+    const auto pipe_index = free_worker_read_pipes_.back();
+    free_worker_read_pipes_.pop_back();
+    lock.unlock();
+    const auto release_pipe = [&] () {
+        std::lock_guard<std::mutex> release_lock {worker_read_pipes_mutex_};
+        free_worker_read_pipes_.push_back(pipe_index);
+    };
+    try {
+        auto result = measure(std::move(chunk), worker_read_pipes_[pipe_index]);
+        release_pipe();
+        return result;
+    } catch (...) {
+        release_pipe();
+        throw;
+    }
+}
+
+VariantCallFilter::MeasuredChunk VariantCallFilter::measure(std::vector<CallBlock> chunk, const BufferedReadPipe& read_pipe) const
 {
-    auto facets = facet_factory_.make(facet_names_, blocks, workers_);
-    std::vector<Measure::FacetMap> result {};
-    result.reserve(blocks.size());
-    for (auto& block : facets) {
-        result.push_back(make_map(facet_names_, std::move(block)));
+    // Reads are fetched left to right within the chunk, so a buffered pipe serves most blocks from memory
+    MeasuredChunk result {};
+    result.measures.reserve(chunk.size());
+    for (const auto& block : chunk) {
+        result.measures.push_back(measure(block, compute_facets(block, read_pipe)));
     }
+    result.blocks = std::move(chunk);
     return result;
 }
 
@@ -325,13 +406,10 @@ bool VariantCallFilter::is_multithreaded() const noexcept
     return !workers_.empty();
 }
 
-unsigned VariantCallFilter::max_concurrent_blocks() const noexcept
+unsigned VariantCallFilter::max_concurrent_chunks() const noexcept
 {
-    if (is_multithreaded()) {
-        return std::min(100 * workers_.size(), std::size_t {10'000});
-    } else {
-        return 1;
-    }
+    // Keep a chunk queued for each worker so workers don't wait while completed chunks are written
+    return is_multithreaded() ? 2 * static_cast<unsigned>(workers_.size()) : 1;
 }
 
 } // namespace csr
@@ -5,11 +5,13 @@
 #define variant_call_filter_hpp
 
 #include <vector>
+#include <deque>
 #include <string>
 #include <cstddef>
 #include <type_traits>
 #include <functional>
 #include <future>
+#include <mutex>
 
 #include <boost/optional.hpp>
 
@@ -65,6 +67,8 @@ public:
     
     void filter(const VcfReader& source, VcfWriter& dest) const;
     
+    VcfHeader make_header(const VcfHeader& source) const;
+    
 protected:
     using SampleList    = std::vector<SampleName>;
     using MeasureVector = std::vector<Measure::ResultType>;
@@ -81,32 +85,52 @@ protected:
     
     mutable boost::optional<logging::DebugLogger> debug_log_;
     
+    using CallMeasureVisitor = std::function<void(const VcfRecord&, const MeasureVector&)>;
+    
     bool can_measure_single_call() const noexcept;
     bool can_measure_multiple_blocks() const noexcept;
     CallBlock read_next_block(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
-    std::vector<CallBlock> read_next_blocks(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
+    std::vector<CallBlock> make_blocks(std::deque<VcfRecord>&& calls, const SampleList& samples) const;
     MeasureVector measure(const VcfRecord& call) const;
     MeasureBlock measure(const CallBlock& block) const;
-    std::vector<MeasureBlock> measure(const std::vector<CallBlock>& blocks) const;
+    MeasureBlock measure(const CallBlock& block, const ReadMap& reads) const;
+    // Measures every call in source in chunks of consecutive blocks, one chunk per worker, each fetching
+    // reads through that worker's read pipe. visit is called on this thread with each call, in source order.
+    // Requires is_multithreaded().
+    void measure_chunks(const VcfReader& source, const SampleList& samples, const CallMeasureVisitor& visit) const;
     void write(const VcfRecord& call, const Classification& classification, VcfWriter& dest) const;
+    void write(const VcfRecord& call, const Classification& classification, std::deque<VcfRecord>& dest) const;
     void annotate(VcfRecord::Builder& call, const MeasureVector& measures) const;
     
 private:
     using FacetNameSet = std::vector<std::string>;
     
+    struct MeasuredChunk
+    {
+        std::vector<CallBlock> blocks;
+        std::vector<MeasureBlock> measures;
+    };
+    
     FacetFactory facet_factory_;
     FacetNameSet facet_names_;
     std::vector<MeasureWrapper> measures_;
     OutputOptions output_config_;
     
     mutable ThreadPool workers_;
+    // One read pipe per worker, kept between chunks so buffered reads are reused
+    std::vector<BufferedReadPipe> worker_read_pipes_;
+    mutable std::vector<std::size_t> free_worker_read_pipes_;
+    mutable std::mutex worker_read_pipes_mutex_;
     
     virtual void annotate(VcfHeader::Builder& header) const = 0;
     virtual void filter(const VcfReader& source, VcfWriter& dest, const SampleList& samples) const = 0;
     
-    VcfHeader make_header(const VcfReader& source) const;
     Measure::FacetMap compute_facets(const CallBlock& block) const;
-    std::vector<Measure::FacetMap> compute_facets(const std::vector<CallBlock>& blocks) const;
+    Measure::FacetMap compute_facets(const CallBlock& block, const ReadMap& reads) const;
+    Measure::FacetMap compute_facets(const CallBlock& block, const BufferedReadPipe& read_pipe) const;
+    std::vector<CallBlock> read_next_chunk(VcfIterator& first, const VcfIterator& last, const SampleList& samples) const;
+    MeasuredChunk measure(std::vector<CallBlock> chunk) const;
+    MeasuredChunk measure(std::vector<CallBlock> chunk, const BufferedReadPipe& read_pipe) const;
     MeasureBlock measure(const CallBlock& block, const Measure::FacetMap& facets) const;
     MeasureVector measure(const VcfRecord& call, const Measure::FacetMap& facets) const;
     VcfRecord::Builder construct_template(const VcfRecord& call) const;
@@ -114,7 +138,7 @@ private:
     void pass(VcfRecord::Builder& call) const;
     void fail(VcfRecord::Builder& call, std::vector<std::string> reasons) const;
     bool is_multithreaded() const noexcept;
-    unsigned max_concurrent_blocks() const noexcept;
+    unsigned max_concurrent_chunks() const noexcept;
 };
 
 } // namespace csr
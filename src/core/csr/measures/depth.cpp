@@ -24,7 +24,7 @@ Measure::ResultType Depth::do_evaluate(const VcfRecord& call, const FacetMap& fa
         const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
         return static_cast<std::size_t>(count_overlapped(reads, call));
     } else {
-        return static_cast<std::size_t>(std::stoull(call.info_value(vcfspec::info::combinedReadDepth).front()));
+        return static_cast<std::size_t>(call.info_value(vcfspec::info::combinedReadDepth).front().as_integer());
     }
 }
 
@@ -24,7 +24,7 @@ Measure::ResultType MappingQualityZeroCount::do_evaluate(const VcfRecord& call,
         const auto& reads = get_value<OverlappingReads>(facets.at("OverlappingReads"));
         return count_mapq_zero(reads);
     } else {
-        return static_cast<std::size_t>(std::stoull(call.info_value("MQ0").front()));
+        return static_cast<std::size_t>(call.info_value("MQ0").front().as_integer());
     }
 }
 
@@ -27,7 +27,7 @@ Measure::ResultType MaxGenotypeQuality::do_evaluate(const VcfRecord& call, const
     for (const auto& sample : samples) {
         static const std::string gq_field {vcfspec::format::conditionalQuality};
         if (call.has_format(gq_field)) {
-            const auto sample_gq = std::stod(call.get_sample_value(sample, gq_field).front());
+            const auto sample_gq = call.get_sample_value(sample, gq_field).front().as_real();
             if (result) {
                 result = std::max(sample_gq, *result);
             } else {
@@ -36,6 +36,10 @@ private:
     {
         return model_.evaluate(genotype);
     }
+    double do_evaluate(const GenotypeIndex& genotype) const override
+    {
+        return model_.evaluate(genotype);
+    }
     void do_prime(const std::vector<Haplotype>& haplotypes) override
     {
         model_.prime(haplotypes);
@@ -7,22 +7,60 @@
 #include <cmath>
 #include <iterator>
 #include <algorithm>
-#include <numeric>
 #include <array>
 #include <limits>
 #include <cassert>
 
-#include "utils/maths.hpp"
+#include "log_sum_exp_kernels.hpp"
 
 namespace octopus { namespace model {
 
 GermlineLikelihoodModel::GermlineLikelihoodModel(const HaplotypeLikelihoodCache& likelihoods)
 : likelihoods_ {likelihoods}
+, haplotype_indices_ {}
 {}
 
+GermlineLikelihoodModel::GermlineLikelihoodModel(const HaplotypeLikelihoodCache& likelihoods,
+                                                 const std::vector<Haplotype>& haplotypes)
+: likelihoods_ {likelihoods}
+, haplotype_indices_ {}
+{
+    haplotype_indices_.reserve(haplotypes.size());
+    for (const auto& haplotype : haplotypes) {
+        haplotype_indices_.push_back(likelihoods_.index_of(haplotype));
+    }
+}
+
 // ln p(read | genotype)  = ln sum {haplotype in genotype} p(read | haplotype) - ln ploidy
 // ln p(reads | genotype) = sum {read in reads} ln p(read | genotype)
 double GermlineLikelihoodModel::evaluate(const Genotype<Haplotype>& genotype) const
+{
+    return do_evaluate(genotype);
+}
+
+double GermlineLikelihoodModel::evaluate(const GenotypeIndex& genotype) const
+{
+    assert(std::all_of(std::cbegin(genotype), std::cend(genotype),
+                       [this] (auto index) { return index < haplotype_indices_.size(); }));
+    return do_evaluate(genotype);
+}
+
+// private methods
+
+const GermlineLikelihoodModel::LikelihoodVector&
+GermlineLikelihoodModel::get_likelihoods(const Genotype<Haplotype>& genotype, const unsigned n) const
+{
+    return likelihoods_[genotype[n]];
+}
+
+const GermlineLikelihoodModel::LikelihoodVector&
+GermlineLikelihoodModel::get_likelihoods(const GenotypeIndex& genotype, const unsigned n) const
+{
+    return likelihoods_[haplotype_indices_[genotype[n]]];
+}
+
+template <typename G>
+double GermlineLikelihoodModel::do_evaluate(const G& genotype) const
 {
     assert(likelihoods_.is_primed());
     // These cases are just for optimisation
@@ -36,15 +74,12 @@ double GermlineLikelihoodModel::evaluate(const Genotype<Haplotype>& genotype) co
         case 3:
             return evaluate_triploid(genotype);
         case 4:
-            return evaluate_polyploid(genotype);
-            //return log_likelihood_tetraploid(sample, genotype);
+            return evaluate_tetraploid(genotype);
         default:
             return evaluate_polyploid(genotype);
     }
 }
 
-// private methods
-
 namespace {
 
 template <typename T = double>
@@ -68,133 +103,90 @@ static constexpr auto ln(const unsigned n)
     
 } // namespace
 
-double GermlineLikelihoodModel::evaluate_haploid(const Genotype<Haplotype>& genotype) const
+template <typename G>
+double GermlineLikelihoodModel::evaluate_haploid(const G& genotype) const
 {
-    const auto& log_likelihoods = likelihoods_[genotype[0]];
-    return std::accumulate(std::cbegin(log_likelihoods), std::cend(log_likelihoods), 0.0);
+    const auto& log_likelihoods = get_likelihoods(genotype, 0);
+    return simd::sum(log_likelihoods.data(), log_likelihoods.size());
 }
 
-double GermlineLikelihoodModel::evaluate_diploid(const Genotype<Haplotype>& genotype) const
+template <typename G>
+double GermlineLikelihoodModel::evaluate_diploid(const G& genotype) const
 {
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
+    const auto& log_likelihoods1 = get_likelihoods(genotype, 0);
     if (genotype.is_homozygous()) {
-        return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), 0.0);
+        return simd::sum(log_likelihoods1.data(), log_likelihoods1.size());
     }
-    const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-    return std::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                              std::cbegin(log_likelihoods2), 0.0, std::plus<> {},
-                              [] (const auto a, const auto b) -> double {
-                                  return maths::log_sum_exp(a, b) - ln<>(2);
-                              });
+    const auto& log_likelihoods2 = get_likelihoods(genotype, 1);
+    const std::array<const double*, 2> log_likelihoods {log_likelihoods1.data(), log_likelihoods2.data()};
+    const std::array<double, 2> log_weights {-ln<>(2), -ln<>(2)};
+    return simd::sum_log_sum_exp(log_likelihoods.data(), log_weights.data(), 2, log_likelihoods1.size());
 }
 
-double GermlineLikelihoodModel::evaluate_triploid(const Genotype<Haplotype>& genotype) const
+template <typename G>
+double GermlineLikelihoodModel::evaluate_triploid(const G& genotype) const
 {
-    using std::cbegin; using std::cend;
-    
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
+    const auto& log_likelihoods1 = get_likelihoods(genotype, 0);
     if (genotype.is_homozygous()) {
-        return std::accumulate(cbegin(log_likelihoods1), cend(log_likelihoods1), 0.0);
-    }
-    if (genotype.zygosity() == 3) {
-        const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-        const auto& log_likelihoods3 = likelihoods_[genotype[2]];
-        return maths::inner_product(cbegin(log_likelihoods1), cend(log_likelihoods1),
-                                    cbegin(log_likelihoods2), cbegin(log_likelihoods3),
-                                    0.0, std::plus<> {},
-                                    [] (const auto a, const auto b, const auto c) -> double {
-                                        return maths::log_sum_exp(a, b, c) - ln<>(3);
-                                    });
-    }
-    if (genotype[0] != genotype[1]) {
-        const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-        return std::inner_product(cbegin(log_likelihoods1), cend(log_likelihoods1),
-                                  cbegin(log_likelihoods2), 0.0, std::plus<> {},
-                                  [] (const auto a, const auto b) -> double {
-                                      return maths::log_sum_exp(a, ln<>(2) + b) - ln<>(3);
-                                  });
+        return simd::sum(log_likelihoods1.data(), log_likelihoods1.size());
     }
-    const auto& log_likelihoods3 = likelihoods_[genotype[2]];
-    return std::inner_product(cbegin(log_likelihoods1), cend(log_likelihoods1),
-                              cbegin(log_likelihoods3), 0.0, std::plus<> {},
-                              [] (const auto a, const auto b) -> double {
-                                  return maths::log_sum_exp(ln<>(2) + a, b) - ln<>(3);
-                              });
+    return evaluate_mixture<3>(genotype);
 }
 
-double GermlineLikelihoodModel::evaluate_tetraploid(const Genotype<Haplotype>& genotype) const
+template <typename G>
+double GermlineLikelihoodModel::evaluate_tetraploid(const G& genotype) const
 {
-    const auto z = genotype.zygosity();
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
-    if (z == 1) {
-        return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), 0.0);
+    const auto& log_likelihoods1 = get_likelihoods(genotype, 0);
+    if (genotype.is_homozygous()) {
+        return simd::sum(log_likelihoods1.data(), log_likelihoods1.size());
     }
-    if (z == 4) {
-        const auto& log_likelihoods2 = likelihoods_[genotype[1]];
-        const auto& log_likelihoods3 = likelihoods_[genotype[2]];
-        const auto& log_likelihoods4 = likelihoods_[genotype[3]];
-        return maths::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                                    std::cbegin(log_likelihoods2), std::cbegin(log_likelihoods3),
-                                    std::cbegin(log_likelihoods4), 0.0, std::plus<> {},
-                                    [] (const auto a, const auto b, const auto c, const auto d) -> double {
-                                        return maths::log_sum_exp({a, b, c, d}) - ln<>(4);
-                                    });
+    return evaluate_mixture<4>(genotype);
+}
+
+template <typename G>
+double GermlineLikelihoodModel::evaluate_polyploid(const G& genotype) const
+{
+    const auto& log_likelihoods1 = get_likelihoods(genotype, 0);
+    if (genotype.is_homozygous()) {
+        return simd::sum(log_likelihoods1.data(), log_likelihoods1.size());
     }
-    
-    // TODO
-    
-    return 0;
+    const auto ploidy = genotype.ploidy();
+    std::vector<const double*> log_likelihoods {};
+    std::vector<double> log_weights {};
+    log_likelihoods.reserve(ploidy);
+    log_weights.reserve(ploidy);
+    const auto num_unique = count_unique(genotype, std::back_inserter(log_likelihoods), std::back_inserter(log_weights));
+    return simd::sum_log_sum_exp(log_likelihoods.data(), log_weights.data(), num_unique, log_likelihoods1.size());
 }
 
-double GermlineLikelihoodModel::evaluate_polyploid(const Genotype<Haplotype>& genotype) const
+template <unsigned Ploidy, typename G>
+double GermlineLikelihoodModel::evaluate_mixture(const G& genotype) const
+{
+    assert(genotype.ploidy() == Ploidy);
+    std::array<const double*, Ploidy> log_likelihoods;
+    std::array<double, Ploidy> log_weights;
+    const auto num_unique = count_unique(genotype, std::begin(log_likelihoods), std::begin(log_weights));
+    return simd::sum_log_sum_exp(log_likelihoods.data(), log_weights.data(), num_unique, get_likelihoods(genotype, 0).size());
+}
+
+// Writes the likelihoods of each unique haplotype in the genotype and the log of the haplotype's
+// frequency in the genotype, which is the haplotype's mixture weight. Genotypes are sorted so
+// copies of a haplotype are adjacent.
+template <typename G, typename OutputIt1, typename OutputIt2>
+std::size_t GermlineLikelihoodModel::count_unique(const G& genotype,
+                                                 OutputIt1 log_likelihoods, OutputIt2 log_weights) const
 {
     const auto ploidy = genotype.ploidy();
-    const auto z = genotype.zygosity();
-    const auto& log_likelihoods1 = likelihoods_[genotype[0]];
-    
-    if (z == 1) {
-        return std::accumulate(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1), 0.0);
-    }
-    if (z == 2) {
-        const double lnpm1 {std::log(ploidy - 1)};
-        const auto unique_haplotypes = genotype.copy_unique_ref();
-        const auto& log_likelihoods2 = likelihoods_[unique_haplotypes.back()];
-        
-        if (genotype.count(unique_haplotypes.front()) == 1) {
-            return std::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                                      std::cbegin(log_likelihoods2), 0.0, std::plus<> {},
-                                      [ploidy, lnpm1] (const auto a, const auto b) -> double {
-                                          return maths::log_sum_exp(a, lnpm1 + b) - ln<>(ploidy);
-                                      });
-        }
-        return std::inner_product(std::cbegin(log_likelihoods1), std::cend(log_likelihoods1),
-                                  std::cbegin(log_likelihoods2), 0.0, std::plus<> {},
-                                  [ploidy, lnpm1] (const auto a, const auto b) -> double {
-                                      return maths::log_sum_exp(lnpm1 + a, b) - ln<>(ploidy);
-                                  });
+    const auto ln_ploidy = std::log(static_cast<double>(ploidy));
+    std::size_t result {0};
+    for (unsigned i {0}; i < ploidy;) {
+        unsigned j {i + 1};
+        while (j < ploidy && genotype[j] == genotype[i]) ++j;
+        *log_likelihoods++ = get_likelihoods(genotype, i).data();
+        *log_weights++ = (j - i < 11 ? ln<>(j - i) : std::log(static_cast<double>(j - i))) - ln_ploidy;
+        ++result;
+        i = j;
     }
-    
-    std::vector<HaplotypeLikelihoodCache::LikelihoodVectorRef> ln_likelihoods {};
-    ln_likelihoods.reserve(ploidy);
-    
-    std::transform(std::cbegin(genotype), std::cend(genotype), std::back_inserter(ln_likelihoods),
-                   [this] (const auto& haplotype)
-                        -> const HaplotypeLikelihoodCache::LikelihoodVector& {
-                       return likelihoods_[haplotype];
-                   });
-    
-    std::vector<double> tmp(ploidy);
-    double result {0};
-    const auto num_likelihoods = ln_likelihoods.front().get().size();
-    
-    for (std::size_t i {0}; i < num_likelihoods; ++i) {
-        std::transform(std::cbegin(ln_likelihoods), std::cend(ln_likelihoods), std::begin(tmp),
-                       [i] (const auto& likelihoods) {
-                           return likelihoods.get()[i];
-                       });
-        result += maths::log_sum_exp(tmp) - ln<>(ploidy);
-    }
-    
     return result;
 }
 
@@ -4,8 +4,12 @@
 #ifndef germline_likelihood_model_hpp
 #define germline_likelihood_model_hpp
 
+#include <vector>
+#include <cstddef>
+
 #include "core/types/haplotype.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index.hpp"
 #include "core/models/haplotype_likelihood_cache.hpp"
 
 namespace octopus { namespace model {
@@ -17,6 +21,9 @@ public:
     
     GermlineLikelihoodModel(const HaplotypeLikelihoodCache& likelihoods);
     
+    // GenotypeIndex genotypes are indices into haplotypes
+    GermlineLikelihoodModel(const HaplotypeLikelihoodCache& likelihoods, const std::vector<Haplotype>& haplotypes);
+    
     GermlineLikelihoodModel(const GermlineLikelihoodModel&)            = default;
     GermlineLikelihoodModel& operator=(const GermlineLikelihoodModel&) = default;
     GermlineLikelihoodModel(GermlineLikelihoodModel&&)                 = default;
@@ -25,16 +32,30 @@ public:
     ~GermlineLikelihoodModel() = default;
     
     double evaluate(const Genotype<Haplotype>& genotype) const;
+    double evaluate(const GenotypeIndex& genotype) const;
     
 private:
+    using LikelihoodVector = HaplotypeLikelihoodCache::LikelihoodVector;
+    
     const HaplotypeLikelihoodCache& likelihoods_;
+    std::vector<HaplotypeLikelihoodCache::HaplotypeIndex> haplotype_indices_;
+    
+    const LikelihoodVector& get_likelihoods(const Genotype<Haplotype>& genotype, unsigned n) const;
+    const LikelihoodVector& get_likelihoods(const GenotypeIndex& genotype, unsigned n) const;
+    
+    template <typename G> double do_evaluate(const G& genotype) const;
     
     // These are just for optimisation
-    double evaluate_haploid(const Genotype<Haplotype>& genotype) const;
-    double evaluate_diploid(const Genotype<Haplotype>& genotype) const;
-    double evaluate_triploid(const Genotype<Haplotype>& genotype) const;
-    double evaluate_tetraploid(const Genotype<Haplotype>& genotype) const;
-    double evaluate_polyploid(const Genotype<Haplotype>& genotype) const;
+    template <typename G> double evaluate_haploid(const G& genotype) const;
+    template <typename G> double evaluate_diploid(const G& genotype) const;
+    template <typename G> double evaluate_triploid(const G& genotype) const;
+    template <typename G> double evaluate_tetraploid(const G& genotype) const;
+    template <typename G> double evaluate_polyploid(const G& genotype) const;
+    
+    template <unsigned Ploidy, typename G>
+    double evaluate_mixture(const G& genotype) const;
+    template <typename G, typename OutputIt1, typename OutputIt2>
+    std::size_t count_unique(const G& genotype, OutputIt1 log_likelihoods, OutputIt2 log_weights) const;
 };
 
 } // namespace model
@@ -65,6 +65,20 @@ auto compute_likelihoods(const std::vector<Genotype<Haplotype>>& genotypes,
     return result;
 }
 
+auto compute_likelihoods(const std::vector<Haplotype>& haplotypes,
+                         const GenotypeIndexVector& genotypes,
+                         const HaplotypeLikelihoodCache& haplotype_likelihoods)
+{
+    assert(haplotype_likelihoods.is_primed());
+    const GermlineLikelihoodModel likelihood_model {haplotype_likelihoods, haplotypes};
+    ProbabilityVector result(genotypes.size());
+    std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(result),
+                   [&likelihood_model] (const auto& genotype) {
+                       return likelihood_model.evaluate(genotype);
+                   });
+    return result;
+}
+
 template <typename Container>
 void add_priors(const Container& genotypes,
                 ProbabilityVector& genotype_likelihoods,
@@ -105,6 +119,21 @@ IndividualModel::evaluate(const std::vector<Genotype<Haplotype>>& genotypes,
     return {{std::move(result)}, log_evidence};
 }
 
+IndividualModel::InferredLatents
+IndividualModel::evaluate(const std::vector<Haplotype>& haplotypes,
+                          const GenotypeIndexVector& genotypes,
+                          const HaplotypeLikelihoodCache& haplotype_likelihoods) const
+{
+    assert(!genotypes.empty());
+    auto result = compute_likelihoods(haplotypes, genotypes, haplotype_likelihoods);
+    if (debug_log_ || trace_log_) {
+        debug::log_genotype_likelihoods(debug_log_, trace_log_, materialise(genotypes, haplotypes), result);
+    }
+    add_priors(genotypes, result, genotype_prior_model_);
+    const auto log_evidence = maths::normalise_exp(result);
+    return {{std::move(result)}, log_evidence};
+}
+
 namespace debug {
 
 using octopus::debug::print_variant_alleles;
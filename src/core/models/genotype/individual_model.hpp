@@ -12,6 +12,7 @@
 #include "core/types/haplotype.hpp"
 #include "core/models/haplotype_likelihood_cache.hpp"
 #include "core/types/genotype.hpp"
+#include "core/types/genotype_index.hpp"
 #include "logging/logging.hpp"
 
 namespace octopus { namespace model {
@@ -53,6 +54,11 @@ public:
                              const std::vector<std::vector<unsigned>>& genotype_indices,
                              const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
     
+    // The genotypes index haplotypes, which the prior model must be primed with
+    InferredLatents evaluate(const std::vector<Haplotype>& haplotypes,
+                             const GenotypeIndexVector& genotypes,
+                             const HaplotypeLikelihoodCache& haplotype_likelihoods) const;
+    
 private:
     const GenotypePriorModel& genotype_prior_model_;
     
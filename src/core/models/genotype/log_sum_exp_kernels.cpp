@@ -0,0 +1,120 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include "log_sum_exp_kernels.hpp"
+
+#include <cassert>
+
+#include <emmintrin.h>
+
+#include "log_sum_exp_kernels_impl.hpp"
+
+namespace octopus { namespace model { namespace simd {
+
+namespace {
+
+struct Sse2
+{
+    using Vec = __m128d;
+
+    static constexpr std::size_t width {2};
+
+    static Vec zero() noexcept { return _mm_setzero_pd(); }
+    static Vec set1(const double a) noexcept { return _mm_set1_pd(a); }
+    static Vec load(const double* a) noexcept { return _mm_loadu_pd(a); }
+    static Vec add(const Vec a, const Vec b) noexcept { return _mm_add_pd(a, b); }
+    static Vec sub(const Vec a, const Vec b) noexcept { return _mm_sub_pd(a, b); }
+    static Vec mul(const Vec a, const Vec b) noexcept { return _mm_mul_pd(a, b); }
+    static Vec div(const Vec a, const Vec b) noexcept { return _mm_div_pd(a, b); }
+    static Vec max(const Vec a, const Vec b) noexcept { return _mm_max_pd(a, b); }
+    static Vec fmadd(const Vec a, const Vec b, const Vec c) noexcept { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static Vec cmpgt(const Vec a, const Vec b) noexcept { return _mm_cmpgt_pd(a, b); }
+    static Vec select(const Vec mask, const Vec a, const Vec b) noexcept
+    {
+        return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    }
+    static double reduce_add(const Vec a) noexcept
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+    }
+    static Vec pow2(const Vec t) noexcept
+    {
+        auto n = _mm_sub_epi64(_mm_castpd_si128(t), _mm_castpd_si128(_mm_set1_pd(detail::expMagic)));
+        n = _mm_add_epi64(n, _mm_set1_epi64x(1023));
+        return _mm_castsi128_pd(_mm_slli_epi64(n, 52));
+    }
+    static Vec exponent(const Vec a) noexcept
+    {
+        // The biased exponent is placed in the mantissa of 2^52
+        const auto two52 = _mm_set1_pd(4503599627370496.0);
+        const auto e = _mm_srli_epi64(_mm_castpd_si128(a), 52);
+        return _mm_sub_pd(_mm_or_pd(_mm_castsi128_pd(e), two52), two52);
+    }
+    static Vec mantissa(const Vec a) noexcept
+    {
+        const auto bits = _mm_and_si128(_mm_castpd_si128(a), _mm_set1_epi64x(0x000FFFFFFFFFFFFF));
+        return _mm_castsi128_pd(_mm_or_si128(bits, _mm_set1_epi64x(0x3FF0000000000000)));
+    }
+};
+
+InstructionSet detect_instruction_set() noexcept
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return InstructionSet::avx2;
+    return InstructionSet::sse2;
+}
+
+} // namespace
+
+InstructionSet best_instruction_set() noexcept
+{
+    static const auto result = detect_instruction_set();
+    return result;
+}
+
+bool is_supported(const InstructionSet isa) noexcept
+{
+    return static_cast<int>(isa) <= static_cast<int>(best_instruction_set());
+}
+
+double sum(const double* values, const std::size_t n) noexcept
+{
+    return sum(values, n, best_instruction_set());
+}
+
+double sum(const double* values, const std::size_t n, const InstructionSet isa) noexcept
+{
+    assert(is_supported(isa));
+    switch (isa) {
+        case InstructionSet::avx2: return detail::sum_avx2(values, n);
+        default: return detail::sum<Sse2>(values, n);
+    }
+}
+
+double sum_log_sum_exp(const double* const* log_likelihoods, const double* log_weights,
+                       const std::size_t num_components, const std::size_t n) noexcept
+{
+    return sum_log_sum_exp(log_likelihoods, log_weights, num_components, n, best_instruction_set());
+}
+
+double sum_log_sum_exp(const double* const* log_likelihoods, const double* log_weights,
+                       const std::size_t num_components, const std::size_t n,
+                       const InstructionSet isa) noexcept
+{
+    assert(num_components > 0);
+    assert(is_supported(isa));
+    switch (isa) {
+        case InstructionSet::avx2:
+            return detail::sum_log_sum_exp_avx2(log_likelihoods, log_weights, num_components, n);
+        default:
+            return detail::sum_log_sum_exp<Sse2>(log_likelihoods, log_weights, num_components, n);
+    }
+}
+
+} // namespace simd
+} // namespace model
+} // namespace octopus
@@ -0,0 +1,49 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef log_sum_exp_kernels_hpp
+#define log_sum_exp_kernels_hpp
+
+#include <cstddef>
+
+namespace octopus { namespace model { namespace simd {
+
+/*
+    Vectorised kernels for the read likelihood sums used by the genotype models.
+
+    The exp and log used inside the kernels are polynomial approximations rather than the
+    library functions. Each has relative error below 1e-13 over the range it is used on, so
+    a kernel result differs from the scalar computation by less than 1e-13 per read.
+ */
+
+enum class InstructionSet { sse2, avx2 };
+
+// The widest instruction set supported by the running CPU; detected once
+InstructionSet best_instruction_set() noexcept;
+
+bool is_supported(InstructionSet isa) noexcept;
+
+// Returns values[0] + ... + values[n - 1]
+double sum(const double* values, std::size_t n) noexcept;
+double sum(const double* values, std::size_t n, InstructionSet isa) noexcept;
+
+// Returns sum {i < n} ln sum {k < num_components} exp(log_weights[k] + log_likelihoods[k][i]),
+// i.e. the log likelihood of n independent reads given a mixture of the components.
+double sum_log_sum_exp(const double* const* log_likelihoods, const double* log_weights,
+                       std::size_t num_components, std::size_t n) noexcept;
+double sum_log_sum_exp(const double* const* log_likelihoods, const double* log_weights,
+                       std::size_t num_components, std::size_t n, InstructionSet isa) noexcept;
+
+namespace detail {
+
+double sum_avx2(const double* values, std::size_t n) noexcept;
+double sum_log_sum_exp_avx2(const double* const* log_likelihoods, const double* log_weights,
+                            std::size_t num_components, std::size_t n) noexcept;
+
+} // namespace detail
+
+} // namespace simd
+} // namespace model
+} // namespace octopus
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// This translation unit is compiled with AVX2 and FMA enabled and must only be called on CPUs supporting them
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include "log_sum_exp_kernels.hpp"
+
+#include <immintrin.h>
+
+#include "log_sum_exp_kernels_impl.hpp"
+
+namespace octopus { namespace model { namespace simd {
+
+namespace {
+
+struct Avx2
+{
+    using Vec = __m256d;
+
+    static constexpr std::size_t width {4};
+
+    static Vec zero() noexcept { return _mm256_setzero_pd(); }
+    static Vec set1(const double a) noexcept { return _mm256_set1_pd(a); }
+    static Vec load(const double* a) noexcept { return _mm256_loadu_pd(a); }
+    static Vec add(const Vec a, const Vec b) noexcept { return _mm256_add_pd(a, b); }
+    static Vec sub(const Vec a, const Vec b) noexcept { return _mm256_sub_pd(a, b); }
+    static Vec mul(const Vec a, const Vec b) noexcept { return _mm256_mul_pd(a, b); }
+    static Vec div(const Vec a, const Vec b) noexcept { return _mm256_div_pd(a, b); }
+    static Vec max(const Vec a, const Vec b) noexcept { return _mm256_max_pd(a, b); }
+    static Vec fmadd(const Vec a, const Vec b, const Vec c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+    static Vec cmpgt(const Vec a, const Vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static Vec select(const Vec mask, const Vec a, const Vec b) noexcept { return _mm256_blendv_pd(b, a, mask); }
+    static double reduce_add(const Vec a) noexcept
+    {
+        const auto b = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(b, _mm_unpackhi_pd(b, b)));
+    }
+    static Vec pow2(const Vec t) noexcept
+    {
+        auto n = _mm256_sub_epi64(_mm256_castpd_si256(t), _mm256_castpd_si256(_mm256_set1_pd(detail::expMagic)));
+        n = _mm256_add_epi64(n, _mm256_set1_epi64x(1023));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(n, 52));
+    }
+    static Vec exponent(const Vec a) noexcept
+    {
+        // The biased exponent is placed in the mantissa of 2^52
+        const auto two52 = _mm256_set1_pd(4503599627370496.0);
+        const auto e = _mm256_srli_epi64(_mm256_castpd_si256(a), 52);
+        return _mm256_sub_pd(_mm256_or_pd(_mm256_castsi256_pd(e), two52), two52);
+    }
+    static Vec mantissa(const Vec a) noexcept
+    {
+        const auto bits = _mm256_and_si256(_mm256_castpd_si256(a), _mm256_set1_epi64x(0x000FFFFFFFFFFFFF));
+        return _mm256_castsi256_pd(_mm256_or_si256(bits, _mm256_set1_epi64x(0x3FF0000000000000)));
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+double sum_avx2(const double* values, const std::size_t n) noexcept
+{
+    return sum<Avx2>(values, n);
+}
+
+double sum_log_sum_exp_avx2(const double* const* log_likelihoods, const double* log_weights,
+                            const std::size_t num_components, const std::size_t n) noexcept
+{
+    return sum_log_sum_exp<Avx2>(log_likelihoods, log_weights, num_components, n);
+}
+
+} // namespace detail
+
+} // namespace simd
+} // namespace model
+} // namespace octopus
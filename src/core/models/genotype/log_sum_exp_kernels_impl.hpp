@@ -0,0 +1,172 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef log_sum_exp_kernels_impl_hpp
+#define log_sum_exp_kernels_impl_hpp
+
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+
+/*
+    The kernels are written once against an Ops policy supplying the vector operations of one
+    instruction set. Ops must provide:
+
+    Vec                        a vector of doubles
+    width                      the number of doubles in a Vec
+    zero, set1, load           load must accept unaligned addresses
+    add, sub, mul, div, max
+    fmadd(a, b, c)             a * b + c
+    cmpgt(a, b), select(m, a, b)
+    reduce_add(a)              the sum of the elements of a
+    pow2(t)                    2^n, where t = n + expMagic and n is an integer in [-1022, 1023]
+    exponent(a)                the biased exponent of each (normal) element as a double
+    mantissa(a)                the mantissa of each (normal) element, in [1, 2)
+
+    This header is included by translation units compiled with different instruction set flags.
+    Everything here has internal linkage, and no library templates are used, so code generated
+    for one instruction set can never be linked into a caller built for another.
+ */
+
+namespace octopus { namespace model { namespace simd { namespace detail {
+
+namespace {
+
+// Adding this to |x| < 2^51 rounds x to the nearest integer, which can be read from the low bits
+constexpr double expMagic {6755399441055744.0}; // 2^52 + 2^51
+
+constexpr double log2e {1.4426950408889634074};
+constexpr double ln2 {0.6931471805599453094};
+constexpr double ln2Hi {0.693145751953125};
+constexpr double ln2Lo {1.42860682030941723212e-6};
+constexpr double sqrt2 {1.4142135623730950488};
+constexpr double minExpArgument {-708.0};
+
+// exp(x) for x <= 0. Results below the smallest normal double are flushed towards zero.
+// The degree 11 Taylor polynomial on |r| <= ln(2) / 2 has relative error below 1e-14.
+template <typename Ops>
+typename Ops::Vec fast_exp(typename Ops::Vec x) noexcept
+{
+    x = Ops::max(x, Ops::set1(minExpArgument));
+    const auto t = Ops::fmadd(x, Ops::set1(log2e), Ops::set1(expMagic));
+    const auto n = Ops::sub(t, Ops::set1(expMagic));
+    auto r = Ops::fmadd(n, Ops::set1(-ln2Hi), x);
+    r = Ops::fmadd(n, Ops::set1(-ln2Lo), r);
+    auto p = Ops::set1(1.0 / 39916800);
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 3628800));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 362880));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 40320));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 5040));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 720));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 120));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 24));
+    p = Ops::fmadd(p, r, Ops::set1(1.0 / 6));
+    p = Ops::fmadd(p, r, Ops::set1(0.5));
+    p = Ops::fmadd(p, r, Ops::set1(1.0));
+    p = Ops::fmadd(p, r, Ops::set1(1.0));
+    return Ops::mul(p, Ops::pow2(t));
+}
+
+// ln(y) for normal y >= 1. With y = 2^e * m and m in [sqrt(2) / 2, sqrt(2)),
+// ln(m) = 2 atanh(s) with s = (m - 1) / (m + 1), |s| <= 0.172. The series is truncated
+// after the s^15 term, so the absolute error is below 1e-13.
+template <typename Ops>
+typename Ops::Vec fast_log(const typename Ops::Vec y) noexcept
+{
+    auto m = Ops::mantissa(y);
+    auto e = Ops::sub(Ops::exponent(y), Ops::set1(1023.0));
+    const auto is_large = Ops::cmpgt(m, Ops::set1(sqrt2));
+    m = Ops::select(is_large, Ops::mul(m, Ops::set1(0.5)), m);
+    e = Ops::select(is_large, Ops::add(e, Ops::set1(1.0)), e);
+    const auto one = Ops::set1(1.0);
+    const auto s = Ops::div(Ops::sub(m, one), Ops::add(m, one));
+    const auto z = Ops::mul(s, s);
+    auto p = Ops::set1(1.0 / 15);
+    p = Ops::fmadd(p, z, Ops::set1(1.0 / 13));
+    p = Ops::fmadd(p, z, Ops::set1(1.0 / 11));
+    p = Ops::fmadd(p, z, Ops::set1(1.0 / 9));
+    p = Ops::fmadd(p, z, Ops::set1(1.0 / 7));
+    p = Ops::fmadd(p, z, Ops::set1(1.0 / 5));
+    p = Ops::fmadd(p, z, Ops::set1(1.0 / 3));
+    p = Ops::fmadd(p, z, one);
+    return Ops::fmadd(e, Ops::set1(ln2), Ops::mul(Ops::add(s, s), p));
+}
+
+template <typename Ops>
+double sum(const double* values, const std::size_t n) noexcept
+{
+    constexpr auto width = Ops::width;
+    auto acc1 = Ops::zero(), acc2 = Ops::zero();
+    std::size_t i {0};
+    for (; i + 2 * width <= n; i += 2 * width) {
+        acc1 = Ops::add(acc1, Ops::load(values + i));
+        acc2 = Ops::add(acc2, Ops::load(values + i + width));
+    }
+    if (i + width <= n) {
+        acc1 = Ops::add(acc1, Ops::load(values + i));
+        i += width;
+    }
+    auto result = Ops::reduce_add(Ops::add(acc1, acc2));
+    for (; i < n; ++i) result += values[i];
+    return result;
+}
+
+// NumComponents is either std::size_t or a std::integral_constant, in which case the
+// loops over components can be unrolled
+template <typename Ops, typename NumComponents>
+double sum_log_sum_exp_impl(const double* const* log_likelihoods, const double* log_weights,
+                            const NumComponents num_components, const std::size_t n) noexcept
+{
+    constexpr auto width = Ops::width;
+    auto acc = Ops::zero();
+    std::size_t i {0};
+    for (; i + width <= n; i += width) {
+        auto max = Ops::add(Ops::load(log_likelihoods[0] + i), Ops::set1(log_weights[0]));
+        for (std::size_t k {1}; k < num_components; ++k) {
+            max = Ops::max(max, Ops::add(Ops::load(log_likelihoods[k] + i), Ops::set1(log_weights[k])));
+        }
+        auto exp_sum = Ops::zero();
+        for (std::size_t k {0}; k < num_components; ++k) {
+            const auto x = Ops::add(Ops::load(log_likelihoods[k] + i), Ops::set1(log_weights[k]));
+            exp_sum = Ops::add(exp_sum, fast_exp<Ops>(Ops::sub(x, max)));
+        }
+        acc = Ops::add(acc, Ops::add(max, fast_log<Ops>(exp_sum)));
+    }
+    auto result = Ops::reduce_add(acc);
+    for (; i < n; ++i) {
+        auto max = log_likelihoods[0][i] + log_weights[0];
+        for (std::size_t k {1}; k < num_components; ++k) {
+            const auto x = log_likelihoods[k][i] + log_weights[k];
+            max = x > max ? x : max;
+        }
+        double exp_sum {0};
+        for (std::size_t k {0}; k < num_components; ++k) {
+            exp_sum += std::exp(log_likelihoods[k][i] + log_weights[k] - max);
+        }
+        result += max + std::log(exp_sum);
+    }
+    return result;
+}
+
+template <typename Ops>
+double sum_log_sum_exp(const double* const* log_likelihoods, const double* log_weights,
+                       const std::size_t num_components, const std::size_t n) noexcept
+{
+    // Genotypes of ploidy up to four are by far the most common
+    switch (num_components) {
+        case 1: return sum_log_sum_exp_impl<Ops>(log_likelihoods, log_weights, std::integral_constant<std::size_t, 1> {}, n);
+        case 2: return sum_log_sum_exp_impl<Ops>(log_likelihoods, log_weights, std::integral_constant<std::size_t, 2> {}, n);
+        case 3: return sum_log_sum_exp_impl<Ops>(log_likelihoods, log_weights, std::integral_constant<std::size_t, 3> {}, n);
+        case 4: return sum_log_sum_exp_impl<Ops>(log_likelihoods, log_weights, std::integral_constant<std::size_t, 4> {}, n);
+        default: return sum_log_sum_exp_impl<Ops>(log_likelihoods, log_weights, num_components, n);
+    }
+}
+
+} // namespace
+
+} // namespace detail
+} // namespace simd
+} // namespace model
+} // namespace octopus
+
+#endif
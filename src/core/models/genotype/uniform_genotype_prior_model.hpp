@@ -23,6 +23,7 @@ public:
 private:
     virtual double do_evaluate(const Genotype<Haplotype>& genotype) const override { return 1.0; }
     virtual double do_evaluate(const std::vector<unsigned>& genotype) const override { return 1.0; }
+    virtual double do_evaluate(const GenotypeIndex& genotype) const override { return 1.0; }
     bool check_is_primed() const noexcept override { return true; }
 };
 
@@ -4,6 +4,8 @@
 #include "haplotype_likelihood_cache.hpp"
 
 #include <utility>
+#include <limits>
+#include <stdexcept>
 #include <cassert>
 
 #include <iostream> // DEBUG
@@ -15,20 +17,24 @@ namespace octopus {
 
 HaplotypeLikelihoodCache::HaplotypeLikelihoodCache(const unsigned max_haplotypes,
                                                    const std::vector<SampleName>& samples)
-: cache_ {max_haplotypes}
+: haplotype_indices_ {max_haplotypes}
 , sample_indices_ {samples.size()}
+, sample_likelihoods_ {}
 {
-    mapping_positions_.resize(maxMappingPositions);
+    sample_likelihoods_.reserve(samples.size());
+    mapping_positions_.reserve(maxMappingPositions);
 }
 
 HaplotypeLikelihoodCache::HaplotypeLikelihoodCache(HaplotypeLikelihoodModel likelihood_model,
                                                    unsigned max_haplotypes,
                                                    const std::vector<SampleName>& samples)
 : likelihood_model_ {std::move(likelihood_model)}
-, cache_ {max_haplotypes}
+, haplotype_indices_ {max_haplotypes}
 , sample_indices_ {samples.size()}
+, sample_likelihoods_ {}
 {
-    mapping_positions_.resize(maxMappingPositions);
+    sample_likelihoods_.reserve(samples.size());
+    mapping_positions_.reserve(maxMappingPositions);
 }
 
 HaplotypeLikelihoodCache::ReadPacket::ReadPacket(Iterator first, Iterator last)
@@ -37,19 +43,45 @@ HaplotypeLikelihoodCache::ReadPacket::ReadPacket(Iterator first, Iterator last)
 , num_reads {static_cast<std::size_t>(std::distance(first, last))}
 {}
 
+namespace {
+
+auto leftmost_begin_position(const ReadMap& reads) noexcept
+{
+    auto result = std::numeric_limits<ContigRegion::Position>::max();
+    for (const auto& p : reads) {
+        if (!p.second.empty()) {
+            result = std::min(result, static_cast<ContigRegion::Position>(mapped_begin(p.second.front())));
+        }
+    }
+    return result;
+}
+
+} // namespace
+
 void HaplotypeLikelihoodCache::populate(const ReadMap& reads,
                                         const std::vector<Haplotype>& haplotypes,
                                         boost::optional<FlankState> flank_state)
 {
     // This code is not very pretty because it is a bottleneck for the entire application.
     // We want to try a minimise memory allocations for the mapping.
-    cache_.clear();
-    if (cache_.bucket_count() < haplotypes.size()) {
-        cache_.rehash(haplotypes.size());
+    haplotype_indices_.clear();
+    if (haplotype_indices_.bucket_count() < haplotypes.size()) {
+        haplotype_indices_.rehash(haplotypes.size());
     }
+    num_haplotype_indices_ = haplotypes.size();
     set_read_iterators_and_sample_indices(reads);
     assert(reads.size() == read_iterators_.size());
     const auto num_samples = reads.size();
+    sample_likelihoods_.resize(num_samples);
+    for (std::size_t s {0}; s < num_samples; ++s) {
+        sample_likelihoods_[s].resize(read_iterators_[s].num_reads, haplotypes.size());
+    }
+    // Likelihoods of reads to the left of these reads will not be needed again
+    if (memo_.size() > maxMemoSize) {
+        memo_.clear();
+    } else {
+        memo_.evict_before(leftmost_begin_position(reads));
+    }
     // Precompute all read hashes so we don't have to recompute for each haplotype
     std::vector<std::vector<KmerPerfectHashes>> read_hashes {};
     read_hashes.reserve(num_samples);
@@ -61,28 +93,29 @@ void HaplotypeLikelihoodCache::populate(const ReadMap& reads,
         read_hashes.emplace_back(std::move(sample_read_hashes));
     }
     auto haplotype_hashes = init_kmer_hash_table<mapperKmerSize>();
-    const auto first_mapping_position = std::begin(mapping_positions_);
-    for (const auto& haplotype : haplotypes) {
+    for (HaplotypeIndex h {0}; h < haplotypes.size(); ++h) {
+        const auto& haplotype = haplotypes[h];
+        haplotype_indices_.emplace(haplotype, h);
         populate_kmer_hash_table<mapperKmerSize>(haplotype.sequence(), haplotype_hashes);
         auto haplotype_mapping_counts = init_mapping_counts(haplotype_hashes);
-        auto itr = std::begin(cache_.emplace(std::piecewise_construct,
-                                             std::forward_as_tuple(haplotype),
-                                             std::forward_as_tuple(num_samples)).first->second);
+        auto sample_itr = std::begin(sample_likelihoods_);
         likelihood_model_.reset(haplotype, flank_state);
         auto read_hash_itr = std::cbegin(read_hashes);
         for (const auto& t : read_iterators_) { // for each sample
-            *itr = std::vector<double>(t.num_reads);
-            std::transform(t.first, t.last, std::cbegin(*read_hash_itr), std::begin(*itr),
-                           [&] (const AlignedRead& read, const auto& read_hashes) {
-                               const auto last_mapping_position = map_query_to_target(read_hashes, haplotype_hashes,
-                                                                                      haplotype_mapping_counts,
-                                                                                      first_mapping_position,
-                                                                                      maxMappingPositions);
-                               reset_mapping_counts(haplotype_mapping_counts);
-                               return likelihood_model_.evaluate(read, first_mapping_position, last_mapping_position);
-                           });
+            // Map all the reads first so the likelihood model can align them together
+            mapping_positions_.clear();
+            mapping_position_offsets_.assign(1, 0);
+            for (const auto& hashes : *read_hash_itr) {
+                map_query_to_target(hashes, haplotype_hashes, haplotype_mapping_counts,
+                                    std::back_inserter(mapping_positions_), maxMappingPositions);
+                reset_mapping_counts(haplotype_mapping_counts);
+                mapping_position_offsets_.push_back(mapping_positions_.size());
+            }
+            likelihood_model_.evaluate(t.first, t.last, mapping_positions_, mapping_position_offsets_, read_likelihoods_, &memo_);
+            assert(read_likelihoods_.size() == sample_itr->num_reads);
+            std::copy(std::cbegin(read_likelihoods_), std::cend(read_likelihoods_), sample_itr->column(h));
             ++read_hash_itr;
-            ++itr;
+            ++sample_itr;
         }
         clear_kmer_hash_table(haplotype_hashes);
     }
@@ -92,49 +125,76 @@ void HaplotypeLikelihoodCache::populate(const ReadMap& reads,
 
 std::size_t HaplotypeLikelihoodCache::num_likelihoods(const SampleName& sample) const
 {
-    return std::cbegin(cache_)->second.at(sample_indices_.at(sample)).size();
+    return sample_likelihoods_[sample_indices_.at(sample)].num_reads;
 }
 
 const HaplotypeLikelihoodCache::LikelihoodVector&
 HaplotypeLikelihoodCache::operator()(const SampleName& sample, const Haplotype& haplotype) const
 {
-    return cache_.at(haplotype)[sample_indices_.at(sample)];
+    return (*this)(sample, index_of(haplotype));
 }
 
 const HaplotypeLikelihoodCache::LikelihoodVector&
 HaplotypeLikelihoodCache::operator[](const Haplotype& haplotype) const
 {
-    return cache_.at(haplotype)[*primed_sample_];
+    return (*this)[index_of(haplotype)];
+}
+
+const HaplotypeLikelihoodCache::LikelihoodVector&
+HaplotypeLikelihoodCache::operator()(const SampleName& sample, const HaplotypeIndex haplotype) const
+{
+    return sample_likelihoods_[sample_indices_.at(sample)].haplotype_likelihoods.at(haplotype);
+}
+
+const HaplotypeLikelihoodCache::LikelihoodVector&
+HaplotypeLikelihoodCache::operator[](const HaplotypeIndex haplotype) const
+{
+    return sample_likelihoods_[*primed_sample_].haplotype_likelihoods[haplotype];
+}
+
+HaplotypeLikelihoodCache::HaplotypeIndex HaplotypeLikelihoodCache::index_of(const Haplotype& haplotype) const
+{
+    return haplotype_indices_.at(haplotype);
 }
 
 HaplotypeLikelihoodCache::SampleLikelihoodMap
 HaplotypeLikelihoodCache::extract_sample(const SampleName& sample) const
 {
-    const auto sample_index = sample_indices_.at(sample);
-    SampleLikelihoodMap result {cache_.size()};
-    for (const auto& p : cache_) {
-        result.emplace(p.first, p.second[sample_index]);
+    const auto& likelihoods = sample_likelihoods_[sample_indices_.at(sample)].haplotype_likelihoods;
+    SampleLikelihoodMap result {haplotype_indices_.size()};
+    for (const auto& p : haplotype_indices_) {
+        result.emplace(p.first, likelihoods[p.second]);
     }
     return result;
 }
 
 bool HaplotypeLikelihoodCache::contains(const Haplotype& haplotype) const noexcept
 {
-    return cache_.count(haplotype) == 1;
+    return haplotype_indices_.count(haplotype) == 1;
 }
 
 bool HaplotypeLikelihoodCache::is_empty() const noexcept
 {
-    return cache_.empty();
+    return haplotype_indices_.empty();
 }
 
 void HaplotypeLikelihoodCache::clear() noexcept
 {
-    cache_.clear();
+    haplotype_indices_.clear();
+    num_haplotype_indices_ = 0;
     sample_indices_.clear();
+    // Keep the sample blocks so their memory can be reused
+    for (auto& sample : sample_likelihoods_) {
+        sample.clear();
+    }
     unprime();
 }
 
+void HaplotypeLikelihoodCache::clear_memo() noexcept
+{
+    memo_.clear();
+}
+
 bool HaplotypeLikelihoodCache::is_primed() const noexcept
 {
     return static_cast<bool>(primed_sample_);
@@ -152,6 +212,89 @@ void HaplotypeLikelihoodCache::unprime() const noexcept
 
 // private methods
 
+namespace {
+
+// So each haplotype's likelihoods start on a new cache line
+constexpr std::size_t likelihoodsPerCacheLine {64 / sizeof(double)};
+
+std::size_t pad(const std::size_t num_likelihoods) noexcept
+{
+    return (num_likelihoods + likelihoodsPerCacheLine - 1) / likelihoodsPerCacheLine * likelihoodsPerCacheLine;
+}
+
+} // namespace
+
+HaplotypeLikelihoodCache::SampleLikelihoods::SampleLikelihoods(const SampleLikelihoods& other)
+: num_reads {other.num_reads}
+, stride {other.stride}
+, likelihoods {other.likelihoods}
+, haplotype_likelihoods {}
+{
+    haplotype_likelihoods.resize(other.haplotype_likelihoods.size());
+    reset_views();
+}
+
+HaplotypeLikelihoodCache::SampleLikelihoods&
+HaplotypeLikelihoodCache::SampleLikelihoods::operator=(const SampleLikelihoods& other)
+{
+    if (this != &other) {
+        num_reads = other.num_reads;
+        stride = other.stride;
+        likelihoods = other.likelihoods;
+        haplotype_likelihoods.resize(other.haplotype_likelihoods.size());
+        reset_views();
+    }
+    return *this;
+}
+
+void HaplotypeLikelihoodCache::SampleLikelihoods::resize(const std::size_t num_reads, const std::size_t num_haplotypes)
+{
+    const auto new_stride = pad(num_reads);
+    if (new_stride != stride) likelihoods.clear(); // existing columns are not relocated
+    this->num_reads = num_reads;
+    stride = new_stride;
+    likelihoods.resize(num_haplotypes * stride);
+    haplotype_likelihoods.resize(num_haplotypes);
+    reset_views();
+}
+
+void HaplotypeLikelihoodCache::SampleLikelihoods::clear() noexcept
+{
+    num_reads = 0;
+    stride = 0;
+    likelihoods.clear();
+    haplotype_likelihoods.clear();
+}
+
+double* HaplotypeLikelihoodCache::SampleLikelihoods::column(const HaplotypeIndex haplotype) noexcept
+{
+    return likelihoods.data() + haplotype * stride;
+}
+
+void HaplotypeLikelihoodCache::SampleLikelihoods::reset_views()
+{
+    for (std::size_t h {0}; h < haplotype_likelihoods.size(); ++h) {
+        haplotype_likelihoods[h] = LikelihoodVector {likelihoods.data() + h * stride, num_reads};
+    }
+}
+
+void HaplotypeLikelihoodCache::insert(const std::size_t sample_index, const HaplotypeIndex haplotype,
+                                      const double* likelihoods, const std::size_t num_likelihoods)
+{
+    if (sample_likelihoods_.size() <= sample_index) {
+        sample_likelihoods_.resize(sample_index + 1);
+    }
+    auto& sample = sample_likelihoods_[sample_index];
+    if (sample.haplotype_likelihoods.empty()) {
+        sample.resize(num_likelihoods, haplotype + 1);
+    } else if (num_likelihoods != sample.num_reads) {
+        throw std::invalid_argument {"HaplotypeLikelihoodCache: inserted likelihoods must have one likelihood per read"};
+    } else if (sample.haplotype_likelihoods.size() <= haplotype) {
+        sample.resize(num_likelihoods, haplotype + 1);
+    }
+    std::copy(likelihoods, likelihoods + num_likelihoods, sample.column(haplotype));
+}
+
 void HaplotypeLikelihoodCache::set_read_iterators_and_sample_indices(const ReadMap& reads)
 {
     read_iterators_.clear();
@@ -179,13 +322,12 @@ HaplotypeLikelihoodCache merge_samples(const std::vector<SampleName>& samples,
 {
     HaplotypeLikelihoodCache result {static_cast<unsigned>(haplotypes.size()), {new_sample}};
     for (const auto& haplotype : haplotypes) {
-        HaplotypeLikelihoodCache::LikelihoodVector likelihoods {};
+        std::vector<double> likelihoods {};
         for (const auto& sample : samples) {
             const auto& m = haplotype_likelihoods(sample, haplotype);
             likelihoods.insert(std::end(likelihoods), std::cbegin(m), std::cend(m));
         }
-        likelihoods.shrink_to_fit();
-        result.insert(new_sample, haplotype, std::move(likelihoods));
+        result.insert(new_sample, haplotype, likelihoods);
     }
     return result;
 }
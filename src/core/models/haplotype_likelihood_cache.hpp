@@ -8,14 +8,18 @@
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <iterator>
+#include <cstddef>
 
 #include <boost/optional.hpp>
+#include <boost/align/aligned_allocator.hpp>
 
 #include "config/common.hpp"
 #include "core/types/haplotype.hpp"
 #include "basics/aligned_read.hpp"
 #include "utils/kmer_mapper.hpp"
 #include "haplotype_likelihood_model.hpp"
+#include "read_likelihood_memo.hpp"
 
 namespace octopus {
 
@@ -25,14 +29,61 @@ namespace octopus {
  
     The matrix can be efficiently populated as the read mapping and alignment are
     done internally which allows minimal memory allocation.
+ 
+    Each sample's likelihoods are stored in one contiguous block, haplotype by haplotype,
+    so the likelihoods of all reads given a haplotype are contiguous and cache line aligned.
+    The i'th haplotype given to populate has HaplotypeIndex i; lookups by index do not need to
+    hash or compare haplotypes.
+ 
+    Read likelihoods are also memoised across calls to populate, so reads that are
+    evaluated against haplotypes that are unchanged around the read (e.g. in
+    overlapping active regions) are not re-evaluated. clear does not clear the memo.
  */
 class HaplotypeLikelihoodCache
 {
 public:
     using FlankState = HaplotypeLikelihoodModel::FlankState;
     
-    using LikelihoodVector     = std::vector<double>;
+    // A view of the likelihoods of each read in a sample given a haplotype
+    class LikelihoodVector
+    {
+    public:
+        using value_type      = double;
+        using size_type       = std::size_t;
+        using const_reference = const double&;
+        using reference       = const_reference;
+        using const_iterator  = const double*;
+        using iterator        = const_iterator;
+        
+        LikelihoodVector() = default;
+        
+        LikelihoodVector(const double* likelihoods, size_type size) noexcept : likelihoods_ {likelihoods}, size_ {size} {}
+        
+        LikelihoodVector(const LikelihoodVector&)            = default;
+        LikelihoodVector& operator=(const LikelihoodVector&) = default;
+        LikelihoodVector(LikelihoodVector&&)                 = default;
+        LikelihoodVector& operator=(LikelihoodVector&&)      = default;
+        
+        ~LikelihoodVector() = default;
+        
+        size_type size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+        const double* data() const noexcept { return likelihoods_; }
+        const_iterator begin() const noexcept { return likelihoods_; }
+        const_iterator end() const noexcept { return likelihoods_ + size_; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        const_reference operator[](size_type n) const noexcept { return likelihoods_[n]; }
+        const_reference front() const noexcept { return likelihoods_[0]; }
+        const_reference back() const noexcept { return likelihoods_[size_ - 1]; }
+        
+    private:
+        const double* likelihoods_ = nullptr;
+        size_type size_ = 0;
+    };
+    
     using LikelihoodVectorRef  = std::reference_wrapper<const LikelihoodVector>;
+    using HaplotypeIndex       = std::size_t;
     using HaplotypeRef         = std::reference_wrapper<const Haplotype>;
     using SampleLikelihoodMap  = std::unordered_map<HaplotypeRef, LikelihoodVectorRef>;
     
@@ -58,6 +109,10 @@ public:
     
     const LikelihoodVector& operator()(const SampleName& sample, const Haplotype& haplotype) const;
     const LikelihoodVector& operator[](const Haplotype& haplotype) const; // when primed with a sample
+    const LikelihoodVector& operator()(const SampleName& sample, HaplotypeIndex haplotype) const;
+    const LikelihoodVector& operator[](HaplotypeIndex haplotype) const; // when primed with a sample
+    
+    HaplotypeIndex index_of(const Haplotype& haplotype) const;
     
     SampleLikelihoodMap extract_sample(const SampleName& sample) const;
     
@@ -71,6 +126,7 @@ public:
     bool is_empty() const noexcept;
     
     void clear() noexcept;
+    void clear_memo() noexcept;
     
     bool is_primed() const noexcept;
     void prime(const SampleName& sample) const;
@@ -79,6 +135,7 @@ public:
 private:
     static constexpr unsigned char mapperKmerSize {6};
     static constexpr std::size_t maxMappingPositions {10};
+    static constexpr std::size_t maxMemoSize {1'000'000};
     
     HaplotypeLikelihoodModel likelihood_model_;
     
@@ -90,31 +147,68 @@ private:
         std::size_t num_reads;
     };
     
-    std::unordered_map<Haplotype, std::vector<LikelihoodVector>, HaplotypeHash> cache_;
+    static constexpr std::size_t likelihoodAlignment {64};
+    
+    using LikelihoodStorage = std::vector<double, boost::alignment::aligned_allocator<double, likelihoodAlignment>>;
+    
+    // The likelihoods of haplotype h are likelihoods[h * stride] to likelihoods[h * stride + num_reads]
+    struct SampleLikelihoods
+    {
+        SampleLikelihoods() = default;
+        
+        SampleLikelihoods(const SampleLikelihoods& other);
+        SampleLikelihoods& operator=(const SampleLikelihoods& other);
+        SampleLikelihoods(SampleLikelihoods&&)            = default;
+        SampleLikelihoods& operator=(SampleLikelihoods&&) = default;
+        
+        ~SampleLikelihoods() = default;
+        
+        void resize(std::size_t num_reads, std::size_t num_haplotypes);
+        void clear() noexcept;
+        double* column(HaplotypeIndex haplotype) noexcept;
+        
+        std::size_t num_reads = 0, stride = 0;
+        LikelihoodStorage likelihoods;
+        std::vector<LikelihoodVector> haplotype_likelihoods;
+        
+    private:
+        void reset_views();
+    };
+    
+    std::unordered_map<Haplotype, HaplotypeIndex, HaplotypeHash> haplotype_indices_;
     std::unordered_map<SampleName, std::size_t> sample_indices_;
+    std::vector<SampleLikelihoods> sample_likelihoods_;
+    std::size_t num_haplotype_indices_ = 0;
     
     mutable boost::optional<std::size_t> primed_sample_;
     
+    ReadLikelihoodMemo memo_;
+    
     // Just to optimise population
     std::vector<ReadPacket> read_iterators_;
-    std::vector<std::size_t> mapping_positions_;
+    HaplotypeLikelihoodModel::MappingPositionVector mapping_positions_;
+    HaplotypeLikelihoodModel::MappingPositionOffsets mapping_position_offsets_;
+    std::vector<double> read_likelihoods_;
     
     void set_read_iterators_and_sample_indices(const ReadMap& reads);
+    void insert(std::size_t sample_index, HaplotypeIndex haplotype, const double* likelihoods, std::size_t num_likelihoods);
 };
 
 template <typename S, typename Container>
 void HaplotypeLikelihoodCache::insert(S&& sample, const Haplotype& haplotype,
                                       Container&& likelihoods)
 {
-    sample_indices_.emplace(std::forward<S>(sample), sample_indices_.size());
-    cache_[haplotype].emplace_back(std::forward<Container>(likelihoods));
+    const auto sample_index = sample_indices_.emplace(std::forward<S>(sample), sample_indices_.size()).first->second;
+    const auto p = haplotype_indices_.emplace(haplotype, num_haplotype_indices_);
+    if (p.second) ++num_haplotype_indices_;
+    insert(sample_index, p.first->second, likelihoods.data(), likelihoods.size());
 }
 
 template <typename Container>
 void HaplotypeLikelihoodCache::erase(const Container& haplotypes)
 {
     for (const auto& haplotype : haplotypes) {
-        cache_.erase(haplotype);
+        haplotype_indices_.erase(haplotype);
     }
 }
 
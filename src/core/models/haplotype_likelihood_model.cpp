@@ -167,12 +167,12 @@ double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
 
 namespace {
 
-int num_out_of_range_bases(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype) noexcept
+int num_out_of_range_bases(const std::size_t mapping_position, const std::size_t read_size, const Haplotype& haplotype) noexcept
 {
     if (mapping_position < hmm::min_flank_pad()) {
         return hmm::min_flank_pad() - mapping_position;
     }
-    const auto mapping_end = mapping_position + sequence_size(read) + hmm::min_flank_pad();
+    const auto mapping_end = mapping_position + read_size + hmm::min_flank_pad();
     if (mapping_end > sequence_size(haplotype)) {
         return static_cast<int>(sequence_size(haplotype)) - static_cast<int>(mapping_end);
     } else {
@@ -180,45 +180,66 @@ int num_out_of_range_bases(const std::size_t mapping_position, const AlignedRead
     }
 }
 
+int num_out_of_range_bases(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype) noexcept
+{
+    return num_out_of_range_bases(mapping_position, sequence_size(read), haplotype);
+}
+
+bool is_in_range(const std::size_t mapping_position, const std::size_t read_size, const Haplotype& haplotype) noexcept
+{
+    return num_out_of_range_bases(mapping_position, read_size, haplotype) == 0;
+}
+
 bool is_in_range(const std::size_t mapping_position, const AlignedRead& read, const Haplotype& haplotype) noexcept
 {
-    return num_out_of_range_bases(mapping_position, read, haplotype) == 0;
+    return is_in_range(mapping_position, sequence_size(read), haplotype);
+}
+
+double adjust_for_mapping_quality(const double ln_prob_given_mapped, const AlignedRead::MappingQuality mapping_quality)
+{
+    // This calculation is approximately
+    // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
+    //                  + p(read correctly mapped) p(read | hap, correctly mapped)
+    // = p(read correctly mapped) p(read | hap, correctly mapped)
+    //      + p(read missmapped)
+    // assuming p(read | hap, missmapped) = 1
+    using octopus::maths::constants::ln10Div10;
+    const auto ln_prob_missmapped = -ln10Div10<> * mapping_quality;
+    const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
+    return maths::log_sum_exp(ln_prob_mapped + ln_prob_given_mapped, ln_prob_missmapped);
 }
 
 } // namespace
 
-template <typename InputIt>
-double max_score(const AlignedRead& read, const Haplotype& haplotype,
-                 InputIt first_mapping_position, InputIt last_mapping_position,
-                 const hmm::MutationModel& model)
+// Calls f with each position the read should be evaluated at: the in-range mapping positions
+// and the original mapping position, or if none of these are in range, the nearest in-range
+// position to the original mapping position
+template <typename PositionType, typename InputIt, typename F>
+void for_each_evaluation_position(const std::size_t read_size, const PositionType original_mapping_position,
+                                  const Haplotype& haplotype,
+                                  InputIt first_mapping_position, InputIt last_mapping_position,
+                                  F f)
 {
-    assert(contains(haplotype, read));
-    using PositionType = typename std::iterator_traits<InputIt>::value_type;
-    const auto original_mapping_position = static_cast<PositionType>(begin_distance(haplotype, read));
-    auto max_log_probability = std::numeric_limits<double>::lowest();
     bool is_original_position_mapped {false}, has_in_range_mapping_position {false};
     std::for_each(first_mapping_position, last_mapping_position, [&] (const auto position) {
         if (position == original_mapping_position) {
             is_original_position_mapped = true;
         }
-        if (is_in_range(position, read, haplotype)) {
+        if (is_in_range(position, read_size, haplotype)) {
             has_in_range_mapping_position = true;
-            auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(), position, model);
-            max_log_probability = std::max(p, max_log_probability);
+            f(position);
         }
     });
-    if (!is_original_position_mapped && is_in_range(original_mapping_position, read, haplotype)) {
+    if (!is_original_position_mapped && is_in_range(original_mapping_position, read_size, haplotype)) {
         has_in_range_mapping_position = true;
-        auto p = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
-                               original_mapping_position, model);
-        max_log_probability = std::max(p, max_log_probability);
+        f(original_mapping_position);
     }
     if (!has_in_range_mapping_position) {
-        const auto min_shift = num_out_of_range_bases(original_mapping_position, read, haplotype);
+        const auto min_shift = num_out_of_range_bases(original_mapping_position, read_size, haplotype);
         auto final_mapping_position = original_mapping_position;
         if (min_shift > 0) {
             final_mapping_position += min_shift;
-            if (!is_in_range(final_mapping_position, read, haplotype)) {
+            if (!is_in_range(final_mapping_position, read_size, haplotype)) {
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, static_cast<unsigned>(min_shift)};
             }
         } else {
@@ -230,13 +251,38 @@ double max_score(const AlignedRead& read, const Haplotype& haplotype,
                 throw HaplotypeLikelihoodModel::ShortHaplotypeError {haplotype, required_extension};
             }
         }
-        max_log_probability = hmm::evaluate(read.sequence(), haplotype.sequence(), read.base_qualities(),
-                                            final_mapping_position, model);
+        f(final_mapping_position);
     }
+}
+
+template <typename PositionType, typename InputIt>
+double max_score(const char* read_sequence, const std::size_t read_size, const std::uint8_t* read_qualities,
+                 const PositionType original_mapping_position, const Haplotype& haplotype,
+                 InputIt first_mapping_position, InputIt last_mapping_position,
+                 const hmm::MutationModel& model)
+{
+    auto max_log_probability = std::numeric_limits<double>::lowest();
+    for_each_evaluation_position(read_size, original_mapping_position, haplotype, first_mapping_position, last_mapping_position,
+                                 [&] (const auto position) {
+        auto p = hmm::evaluate(read_sequence, read_size, haplotype.sequence(), read_qualities, position, model);
+        max_log_probability = std::max(p, max_log_probability);
+    });
     assert(max_log_probability > std::numeric_limits<double>::lowest() && max_log_probability <= 0);
     return max_log_probability;
 }
 
+template <typename InputIt>
+double max_score(const AlignedRead& read, const Haplotype& haplotype,
+                 InputIt first_mapping_position, InputIt last_mapping_position,
+                 const hmm::MutationModel& model)
+{
+    assert(contains(haplotype, read));
+    using PositionType = typename std::iterator_traits<InputIt>::value_type;
+    const auto original_mapping_position = static_cast<PositionType>(begin_distance(haplotype, read));
+    return max_score(read.sequence().data(), sequence_size(read), read.base_qualities().data(),
+                     original_mapping_position, haplotype, first_mapping_position, last_mapping_position, model);
+}
+
 double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
                                           MappingPositionItr first_mapping_position,
                                           MappingPositionItr last_mapping_position) const
@@ -244,38 +290,72 @@ double HaplotypeLikelihoodModel::evaluate(const AlignedRead& read,
     if (haplotype_ == nullptr) {
         throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
     }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    hmm::MutationModel model {
-        is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
-        is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
-        haplotype_gap_open_penalities_,
-        haplotype_gap_extension_penalty_
-    };
-    if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
-    } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
-    }
+    const auto model = make_mutation_model(!read.is_marked_reverse_mapped());
     const auto ln_prob_given_mapped = max_score(read, *haplotype_, first_mapping_position, last_mapping_position, model);
     if (use_mapping_quality_) {
-        // This calculation is approximately
-        // p(read | hap) = p(read missmapped) p(read | hap, missmapped)
-        //                  + p(read correctly mapped) p(read | hap, correctly mapped)
-        // = p(read correctly mapped) p(read | hap, correctly mapped)
-        //      + p(read missmapped)
-        // assuming p(read | hap, missmapped) = 1
-        using octopus::maths::constants::ln10Div10;
-        const auto ln_prob_missmapped = -ln10Div10<> * read.mapping_quality();
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
-        const auto result = maths::log_sum_exp(ln_prob_mapped + ln_prob_given_mapped, ln_prob_missmapped);
+        const auto result = adjust_for_mapping_quality(ln_prob_given_mapped, read.mapping_quality());
         return result > -1e-15 ? 0.0 : result;
     } else {
         return ln_prob_given_mapped  > -1e-15 ? 0.0 : ln_prob_given_mapped;
     }
 }
 
+namespace {
+
+struct ReadData
+{
+    const char* sequence;
+    std::size_t size;
+    const std::uint8_t* qualities;
+    std::size_t original_mapping_position;
+    ContigRegion::Position end;
+};
+
+ReadData get_read_data(const AlignedRead& read, const Haplotype& haplotype)
+{
+    assert(contains(haplotype, read));
+    return {read.sequence().data(), sequence_size(read), read.base_qualities().data(),
+            static_cast<std::size_t>(begin_distance(haplotype, read)), mapped_end(read)};
+}
+
+bool is_exact_match(const ReadData& read, const std::size_t mapping_position, const Haplotype& haplotype) noexcept
+{
+    return std::equal(read.sequence, read.sequence + read.size, std::next(std::cbegin(haplotype.sequence()), mapping_position));
+}
+
+// The pair HMM only looks at the truth, and the model penalties, within min_flank_pad() of the
+// target, and only compares the flank boundaries against positions in this window; so two
+// evaluations with equal windows and equal clamped flank boundaries have equal likelihoods.
+void add_evaluation_context(const ReadData& read, const std::size_t mapping_position, const Haplotype& haplotype,
+                            const hmm::MutationModel& model, ReadLikelihoodMemo::FingerprintBuilder& result) noexcept
+{
+    const auto pad = static_cast<long>(hmm::min_flank_pad());
+    const auto window_begin = mapping_position - hmm::min_flank_pad();
+    const auto window_size  = read.size + 2 * hmm::min_flank_pad();
+    assert(window_begin + window_size <= sequence_size(haplotype));
+    result.update(haplotype.sequence().data() + window_begin, window_size);
+    result.update(model.snv_mask.data() + window_begin, window_size);
+    result.update(model.snv_priors.data() + window_begin, window_size);
+    result.update(model.gap_open.data() + window_begin, window_size);
+    const auto clamp = [&] (const long position) noexcept {
+        return std::min(std::max(position, -pad - 1), static_cast<long>(read.size) + pad);
+    };
+    const auto lhs_flank_end   = static_cast<long>(model.lhs_flank_size) - static_cast<long>(mapping_position);
+    const auto rhs_flank_begin = static_cast<long>(sequence_size(haplotype) - model.rhs_flank_size) - static_cast<long>(mapping_position);
+    result.update(clamp(lhs_flank_end)).update(clamp(rhs_flank_begin));
+}
+
+} // namespace
+
+void HaplotypeLikelihoodModel::evaluate(ReadIterator first_read, ReadIterator last_read,
+                                        const MappingPositionVector& mapping_positions,
+                                        const MappingPositionOffsets& mapping_position_offsets,
+                                        std::vector<double>& result,
+                                        ReadLikelihoodMemo* memo) const
+{
+    evaluate_batch(first_read, last_read, mapping_positions, mapping_position_offsets, result, memo);
+}
+
 HaplotypeLikelihoodModel::Alignment
 HaplotypeLikelihoodModel::align(const AlignedRead& read) const
 {
@@ -356,23 +436,10 @@ HaplotypeLikelihoodModel::align(const AlignedRead& read, MappingPositionItr firs
     if (haplotype_ == nullptr) {
         throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
     }
-    const auto is_forward = !read.is_marked_reverse_mapped();
-    hmm::MutationModel model {is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
-                              is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
-                              haplotype_gap_open_penalities_, haplotype_gap_extension_penalty_};
-    if (haplotype_flank_state_) {
-        model.lhs_flank_size = haplotype_flank_state_->lhs_flank;
-        model.rhs_flank_size = haplotype_flank_state_->rhs_flank;
-    } else {
-        model.lhs_flank_size = 0;
-        model.rhs_flank_size = 0;
-    }
+    const auto model = make_mutation_model(!read.is_marked_reverse_mapped());
     auto result = compute_optimal_alignment(read, *haplotype_, first_mapping_position, last_mapping_position, model);
     if (use_mapping_quality_) {
-        using octopus::maths::constants::ln10Div10;
-        const auto ln_prob_missmapped = -ln10Div10<> * read.mapping_quality();
-        const auto ln_prob_mapped = std::log(1.0 - std::exp(ln_prob_missmapped));
-        result.likelihood = maths::log_sum_exp(ln_prob_mapped + result.likelihood, ln_prob_missmapped);
+        result.likelihood = adjust_for_mapping_quality(result.likelihood, read.mapping_quality());
         result.likelihood = result.likelihood > -1e-15 ? 0.0 : result.likelihood;
     } else {
         result.likelihood = result.likelihood > -1e-15 ? 0.0 : result.likelihood;
@@ -380,6 +447,116 @@ HaplotypeLikelihoodModel::align(const AlignedRead& read, MappingPositionItr firs
     return result;
 }
 
+// private methods
+
+template <typename ReadIt>
+void HaplotypeLikelihoodModel::evaluate_batch(ReadIt first_read, ReadIt last_read,
+                                              const MappingPositionVector& mapping_positions,
+                                              const MappingPositionOffsets& mapping_position_offsets,
+                                              std::vector<double>& result,
+                                              ReadLikelihoodMemo* memo) const
+{
+    if (haplotype_ == nullptr) {
+        throw std::runtime_error {"HaplotypeLikelihoodModel: no buffered Haplotype"};
+    }
+    const auto num_reads = static_cast<std::size_t>(std::distance(first_read, last_read));
+    assert(mapping_position_offsets.size() == num_reads + 1);
+    const auto forward_model = make_mutation_model(true), reverse_model = make_mutation_model(false);
+    // Reads that need evaluating are evaluated at one or more positions; the evaluations of the
+    // i'th such read are targets[target_offsets[i]] up to targets[target_offsets[i + 1]]
+    struct PendingRead
+    {
+        std::size_t index;
+        ReadLikelihoodMemo::Fingerprint fingerprint;
+        ContigRegion::Position end;
+    };
+    thread_local std::vector<hmm::Target> targets {};
+    thread_local std::vector<std::size_t> target_offsets {};
+    thread_local std::vector<double> target_likelihoods {};
+    thread_local std::vector<std::size_t> read_positions {};
+    thread_local std::vector<PendingRead> pending_reads {};
+    targets.clear();
+    target_offsets.assign(1, 0);
+    pending_reads.clear();
+    result.resize(num_reads);
+    std::size_t read_index {0};
+    std::for_each(first_read, last_read, [&] (const auto& read) {
+        const auto data = get_read_data(read, *haplotype_);
+        const auto& model = read.is_marked_reverse_mapped() ? reverse_model : forward_model;
+        const auto first_mapping_position = std::next(std::cbegin(mapping_positions), mapping_position_offsets[read_index]);
+        const auto last_mapping_position  = std::next(std::cbegin(mapping_positions), mapping_position_offsets[read_index + 1]);
+        read_positions.clear();
+        for_each_evaluation_position(data.size, data.original_mapping_position, *haplotype_,
+                                     first_mapping_position, last_mapping_position,
+                                     [&] (const auto position) { read_positions.push_back(position); });
+        auto& ln_prob_given_mapped = result[read_index];
+        const auto is_match = [&] (const auto position) noexcept { return is_exact_match(data, position, *haplotype_); };
+        if (std::any_of(std::cbegin(read_positions), std::cend(read_positions), is_match)) {
+            ln_prob_given_mapped = 0; // can't do better than this
+            ++read_index;
+            return;
+        }
+        PendingRead pending {read_index, {}, data.end};
+        if (memo) {
+            ReadLikelihoodMemo::FingerprintBuilder fingerprint {};
+            fingerprint.update(data.sequence, data.size).update(data.qualities, data.size)
+                       .update(model.gap_extend).update(model.nuc_prior);
+            for (const auto position : read_positions) {
+                add_evaluation_context(data, position, *haplotype_, model, fingerprint);
+            }
+            pending.fingerprint = fingerprint.fingerprint();
+            const auto memoised_likelihood = memo->find(pending.fingerprint);
+            if (memoised_likelihood) {
+                ln_prob_given_mapped = *memoised_likelihood;
+                ++read_index;
+                return;
+            }
+        }
+        for (const auto position : read_positions) {
+            targets.push_back({data.sequence, data.size, data.qualities, position, &model});
+        }
+        target_offsets.push_back(targets.size());
+        pending_reads.push_back(pending);
+        ++read_index;
+    });
+    hmm::evaluate(targets, haplotype_->sequence(), target_likelihoods);
+    for (std::size_t i {0}; i < pending_reads.size(); ++i) {
+        const auto first_likelihood = std::next(std::cbegin(target_likelihoods), target_offsets[i]);
+        const auto last_likelihood  = std::next(std::cbegin(target_likelihoods), target_offsets[i + 1]);
+        const auto& pending = pending_reads[i];
+        result[pending.index] = *std::max_element(first_likelihood, last_likelihood);
+        if (memo) memo->insert(pending.fingerprint, result[pending.index], pending.end);
+    }
+    read_index = 0;
+    std::for_each(first_read, last_read, [&] (const auto& read) {
+        auto& likelihood = result[read_index];
+        assert(likelihood > std::numeric_limits<double>::lowest() && likelihood <= 0);
+        if (use_mapping_quality_) {
+            likelihood = adjust_for_mapping_quality(likelihood, read.mapping_quality());
+        }
+        likelihood = likelihood > -1e-15 ? 0.0 : likelihood;
+        ++read_index;
+    });
+}
+
+hmm::MutationModel HaplotypeLikelihoodModel::make_mutation_model(const bool is_forward) const
+{
+    hmm::MutationModel result {
+        is_forward ? haplotype_snv_forward_mask_ : haplotype_snv_reverse_mask_,
+        is_forward ? haplotype_snv_forward_priors_ : haplotype_snv_reverse_priors_,
+        haplotype_gap_open_penalities_,
+        haplotype_gap_extension_penalty_
+    };
+    if (haplotype_flank_state_) {
+        result.lhs_flank_size = haplotype_flank_state_->lhs_flank;
+        result.rhs_flank_size = haplotype_flank_state_->rhs_flank;
+    } else {
+        result.lhs_flank_size = 0;
+        result.rhs_flank_size = 0;
+    }
+    return result;
+}
+
 HaplotypeLikelihoodModel make_haplotype_likelihood_model(const std::string sequencer, bool use_mapping_quality)
 {
     return HaplotypeLikelihoodModel {make_snv_error_model(sequencer), make_indel_error_model(sequencer), use_mapping_quality};
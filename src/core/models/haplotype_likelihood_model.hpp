@@ -22,6 +22,7 @@
 #include "core/models/error/snv_error_model.hpp"
 #include "core/models/error/indel_error_model.hpp"
 #include "pairhmm/pair_hmm.hpp"
+#include "read_likelihood_memo.hpp"
 
 #include "timers.hpp"
 
@@ -44,6 +45,8 @@ public:
     using MappingPosition       = std::size_t;
     using MappingPositionVector = std::vector<MappingPosition>;
     using MappingPositionItr    = MappingPositionVector::const_iterator;
+    using MappingPositionOffsets = std::vector<std::size_t>;
+    using ReadIterator          = ReadMap::mapped_type::const_iterator;
     
     struct Alignment
     {
@@ -90,6 +93,16 @@ public:
     double evaluate(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     double evaluate(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
     
+    // As above for many reads at once; the mapping positions of the i'th read are those in
+    // mapping_positions between mapping_position_offsets[i] and mapping_position_offsets[i + 1].
+    // The read alignments are batched so this is faster than evaluating each read in turn. If a
+    // memo is given then reads already evaluated against the same local haplotype are looked up.
+    void evaluate(ReadIterator first_read, ReadIterator last_read,
+                  const MappingPositionVector& mapping_positions,
+                  const MappingPositionOffsets& mapping_position_offsets,
+                  std::vector<double>& result,
+                  ReadLikelihoodMemo* memo = nullptr) const;
+    
     Alignment align(const AlignedRead& read) const;
     Alignment align(const AlignedRead& read, const MappingPositionVector& mapping_positions) const;
     Alignment align(const AlignedRead& read, MappingPositionItr first_mapping_position, MappingPositionItr last_mapping_position) const;
@@ -109,6 +122,14 @@ private:
     Penalty haplotype_gap_extension_penalty_;
     bool use_mapping_quality_ = true;
     bool use_flank_state_ = true;
+    
+    hmm::MutationModel make_mutation_model(bool is_forward) const;
+    template <typename ReadIt>
+    void evaluate_batch(ReadIt first_read, ReadIt last_read,
+                        const MappingPositionVector& mapping_positions,
+                        const MappingPositionOffsets& mapping_position_offsets,
+                        std::vector<double>& result,
+                        ReadLikelihoodMemo* memo) const;
 };
 
 class HaplotypeLikelihoodModel::ShortHaplotypeError : public std::runtime_error
@@ -127,6 +127,11 @@ double CoalescentModel::evaluate(const std::vector<unsigned>& haplotype_indices)
     return evaluate(count_segregating_sites(haplotype_indices));
 }
 
+double CoalescentModel::evaluate(const GenotypeIndex& haplotype_indices) const
+{
+    return evaluate(count_segregating_sites(haplotype_indices));
+}
+
 namespace {
 
 auto powm1(const unsigned i) noexcept // std::pow(-1, i)
@@ -267,6 +272,17 @@ double CoalescentModel::evaluate(const unsigned k_snp, const unsigned k_indel, c
 }
 
 void CoalescentModel::fill_site_buffer(const std::vector<unsigned>& haplotype_indices) const
+{
+    fill_site_buffer_from_index_cache(haplotype_indices);
+}
+
+void CoalescentModel::fill_site_buffer(const GenotypeIndex& haplotype_indices) const
+{
+    fill_site_buffer_from_index_cache(haplotype_indices);
+}
+
+template <typename Range>
+void CoalescentModel::fill_site_buffer_from_index_cache(const Range& haplotype_indices) const
 {
     site_buffer1_.clear();
     std::fill(std::begin(index_flag_buffer_), std::end(index_flag_buffer_), false);
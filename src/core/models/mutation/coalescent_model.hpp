@@ -20,6 +20,7 @@
 
 #include "core/types/haplotype.hpp"
 #include "core/types/variant.hpp"
+#include "core/types/genotype_index.hpp"
 
 namespace octopus {
 
@@ -58,6 +59,7 @@ public:
     double evaluate(const Container& haplotypes) const;
     
     double evaluate(const std::vector<unsigned>& haplotype_indices) const;
+    double evaluate(const GenotypeIndex& haplotype_indices) const;
     
 private:
     using VariantReference = std::reference_wrapper<const Variant>;
@@ -93,6 +95,9 @@ private:
     template <typename Container>
     void fill_site_buffer(const Container& haplotypes) const;
     void fill_site_buffer(const std::vector<unsigned>& haplotype_indices) const;
+    void fill_site_buffer(const GenotypeIndex& haplotype_indices) const;
+    template <typename Range>
+    void fill_site_buffer_from_index_cache(const Range& haplotype_indices) const;
     void fill_site_buffer_from_value_cache(const Haplotype& haplotype) const;
     void fill_site_buffer_from_address_cache(const Haplotype& haplotype) const;
     
@@ -45,18 +45,18 @@ constexpr auto make_phred_to_ln_prob_lookup() noexcept
     return make_phred_to_ln_prob_lookup<num_values<T>()>();
 }
 
-bool target_overlaps_truth_flank(const std::string& truth, const std::string& target, const std::size_t target_offset,
+bool target_overlaps_truth_flank(const std::string& truth, const std::size_t target_size, const std::size_t target_offset,
                                  const MutationModel& model) noexcept
 {
     constexpr auto pad = simd::min_flank_pad();
     return target_offset < (model.lhs_flank_size + pad)
-           || (target_offset + target.size() + pad) > (truth.size() - model.rhs_flank_size);
+           || (target_offset + target_size + pad) > (truth.size() - model.rhs_flank_size);
 }
 
-bool use_adjusted_alignment_score(const std::string& truth, const std::string& target, const std::size_t target_offset,
+bool use_adjusted_alignment_score(const std::string& truth, const std::size_t target_size, const std::size_t target_offset,
                                   const MutationModel& model) noexcept
 {
-    return target_overlaps_truth_flank(truth, target, target_offset, model);
+    return target_overlaps_truth_flank(truth, target_size, target_offset, model);
 }
 
 namespace debug {
@@ -111,23 +111,23 @@ auto make_cigar(const std::vector<char>& align1, const std::vector<char>& align2
     return result;
 }
 
-auto simd_align(const std::string& truth, const std::string& target,
-                const std::vector<std::uint8_t>& target_qualities,
+auto simd_align(const std::string& truth, const char* target, const std::size_t target_length,
+                const std::uint8_t* target_qualities,
                 const std::size_t target_offset,
                 const MutationModel& model) noexcept
 {
     constexpr auto pad = simd::min_flank_pad();
     const auto truth_size  = static_cast<int>(truth.size());
-    const auto target_size = static_cast<int>(target.size());
+    const auto target_size = static_cast<int>(target_length);
     const auto truth_alignment_size = static_cast<int>(target_size + 2 * pad - 1);
     const auto alignment_offset = std::max(0, static_cast<int>(target_offset) - pad);
     if (alignment_offset + truth_alignment_size > truth_size) {
         return std::numeric_limits<double>::lowest();
     }
-    const auto qualities = reinterpret_cast<const std::int8_t*>(target_qualities.data());
-    if (!use_adjusted_alignment_score(truth, target, target_offset, model)) {
+    const auto qualities = reinterpret_cast<const std::int8_t*>(target_qualities);
+    if (!use_adjusted_alignment_score(truth, target_length, target_offset, model)) {
         const auto score = simd::align(truth.data() + alignment_offset,
-                                       target.data(),
+                                       target,
                                        qualities,
                                        truth_alignment_size,
                                        target_size,
@@ -138,12 +138,12 @@ auto simd_align(const std::string& truth, const std::string& target,
         return -ln10Div10<> * static_cast<double>(score);
     } else {
         thread_local std::vector<char> align1 {}, align2 {};
-        const auto max_alignment_size = 2 * (target.size() + pad);
+        const auto max_alignment_size = 2 * (target_length + pad);
         align1.assign(max_alignment_size + 1, 0);
         align2.assign(max_alignment_size + 1, 0);
         int first_pos;
         const auto score = simd::align(truth.data() + alignment_offset,
-                                       target.data(),
+                                       target,
                                        qualities,
                                        truth_alignment_size,
                                        target_size,
@@ -172,7 +172,7 @@ auto simd_align(const std::string& truth, const std::string& target,
         int target_mask_size;
         auto flank_score = simd::calculate_flank_score(truth_alignment_size,
                                                        lhs_flank_size, rhs_flank_size,
-                                                       target.data(), qualities,
+                                                       target, qualities,
                                                        model.snv_mask.data() + alignment_offset,
                                                        model.snv_priors.data() + alignment_offset,
                                                        model.gap_open.data() + alignment_offset,
@@ -222,7 +222,7 @@ auto simd_align_with_cigar(const std::string& truth, const std::string& target,
                              model.gap_open.data() + alignment_offset,
                              model.gap_extend, model.nuc_prior,
                              align1.data(), align2.data(), first_pos);
-    if (use_adjusted_alignment_score(truth, target, target_offset, model)) {
+    if (use_adjusted_alignment_score(truth, target.size(), target_offset, model)) {
         auto lhs_flank_size = static_cast<int>(model.lhs_flank_size);
         if (lhs_flank_size < alignment_offset) {
             lhs_flank_size = 0;
@@ -269,59 +269,173 @@ unsigned min_flank_pad() noexcept
     return simd::min_flank_pad();
 }
 
-void validate(const std::string& truth, const std::string& target,
-              const std::vector<std::uint8_t>& target_qualities,
+void validate(const std::string& truth, const std::size_t target_size,
               const std::size_t target_offset,
               const MutationModel& model)
 {
-    if (target.size() != target_qualities.size()) {
-        throw std::invalid_argument {"PairHMM::align: target size not equal to target base_qualities length"};
-    }
     if (truth.size() != model.snv_priors.size()) {
         throw std::invalid_argument {"PairHMM::align: truth size not equal to snv priors length"};
     }
     if (truth.size() != model.gap_open.size()) {
         throw std::invalid_argument {"PairHMM::align: truth size not equal to gap open penalties length"};
     }
-    if (target_offset + target.size() > truth.size()) {
+    if (target_offset + target_size > truth.size()) {
         throw std::invalid_argument {"PairHMM::align: target is not contained by truth"};
     }
 }
 
+void validate(const std::string& truth, const std::string& target,
+              const std::vector<std::uint8_t>& target_qualities,
+              const std::size_t target_offset,
+              const MutationModel& model)
+{
+    if (target.size() != target_qualities.size()) {
+        throw std::invalid_argument {"PairHMM::align: target size not equal to target base_qualities length"};
+    }
+    validate(truth, target.size(), target_offset, model);
+}
+
 double evaluate(const std::string& target, const std::string& truth,
                 const std::vector<std::uint8_t>& target_qualities,
                 const std::size_t target_offset,
                 const MutationModel& model)
+{
+    if (target.size() != target_qualities.size()) {
+        throw std::invalid_argument {"PairHMM::align: target size not equal to target base_qualities length"};
+    }
+    return evaluate(target.data(), target.size(), truth, target_qualities.data(), target_offset, model);
+}
+
+// Handles the cases that do not need a full alignment, returning false if one is required
+bool evaluate_without_alignment(const char* target, const std::size_t target_size, const std::string& truth,
+                                const std::uint8_t* target_qualities,
+                                const std::size_t target_offset,
+                                const MutationModel& model,
+                                double& result)
 {
     using std::cbegin; using std::cend; using std::next; using std::distance;
     static constexpr auto lnProbability = make_phred_to_ln_prob_lookup<std::uint8_t>();
-    validate(truth, target, target_qualities, target_offset, model);
+    const auto target_end = target + target_size;
     const auto offsetted_truth_begin_itr = next(cbegin(truth), target_offset);
-    const auto m1 = std::mismatch(cbegin(target), cend(target), offsetted_truth_begin_itr);
-    if (m1.first == cend(target)) {
-        return 0; // sequences are equal, can't do better than this
+    const auto m1 = std::mismatch(target, target_end, offsetted_truth_begin_itr);
+    if (m1.first == target_end) {
+        result = 0; // sequences are equal, can't do better than this
+        return true;
     }
-    const auto m2 = std::mismatch(next(m1.first), cend(target), next(m1.second));
-    if (m2.first == cend(target)) {
+    const auto m2 = std::mismatch(next(m1.first), target_end, next(m1.second));
+    if (m2.first == target_end) {
         // then there is only a single base difference between the sequences, can optimise
         const auto truth_mismatch_idx = distance(offsetted_truth_begin_itr, m1.second) + target_offset;
         if (truth_mismatch_idx < model.lhs_flank_size || truth_mismatch_idx >= (truth.size() - model.rhs_flank_size)) {
-            return 0;
+            result = 0;
+            return true;
         }
-        const auto target_index = distance(cbegin(target), m1.first);
+        const auto target_index = distance(target, m1.first);
         auto mispatch_penalty = target_qualities[target_index];
         if (model.snv_mask[truth_mismatch_idx] == *m1.first) {
             mispatch_penalty = std::min(target_qualities[target_index],
                                         static_cast<std::uint8_t>(model.snv_priors[truth_mismatch_idx]));
         }
         if (mispatch_penalty <= model.gap_open[truth_mismatch_idx]
-            || !std::equal(next(m1.first), cend(target), m1.second)) {
-            return lnProbability[mispatch_penalty];
+            || !std::equal(next(m1.first), target_end, m1.second)) {
+            result = lnProbability[mispatch_penalty];
+        } else {
+            result = lnProbability[model.gap_open[truth_mismatch_idx]];
         }
-        return lnProbability[model.gap_open[truth_mismatch_idx]];
+        return true;
+    }
+    return false;
+}
+
+double evaluate(const char* target, const std::size_t target_size, const std::string& truth,
+                const std::uint8_t* target_qualities,
+                const std::size_t target_offset,
+                const MutationModel& model)
+{
+    validate(truth, target_size, target_offset, model);
+    double result;
+    if (evaluate_without_alignment(target, target_size, truth, target_qualities, target_offset, model, result)) {
+        return result;
     }
     // TODO: we should be able to optimise the alignment based of the first mismatch postition
-    return simd_align(truth, target, target_qualities, target_offset, model);
+    return simd_align(truth, target, target_size, target_qualities, target_offset, model);
+}
+
+namespace {
+
+struct PendingAlignment
+{
+    simd::AlignmentProblem problem;
+    short gap_extend, nuc_prior;
+    std::size_t target_index;
+};
+
+bool operator<(const PendingAlignment& lhs, const PendingAlignment& rhs) noexcept
+{
+    if (lhs.gap_extend != rhs.gap_extend) return lhs.gap_extend < rhs.gap_extend;
+    if (lhs.nuc_prior != rhs.nuc_prior) return lhs.nuc_prior < rhs.nuc_prior;
+    return lhs.problem.target_len < rhs.problem.target_len;
+}
+
+bool can_pack(const PendingAlignment& lhs, const PendingAlignment& rhs) noexcept
+{
+    return lhs.gap_extend == rhs.gap_extend && lhs.nuc_prior == rhs.nuc_prior;
+}
+
+} // namespace
+
+void evaluate(const std::vector<Target>& targets, const std::string& truth, std::vector<double>& result)
+{
+    constexpr auto pad = simd::min_flank_pad();
+    thread_local std::vector<PendingAlignment> pending {};
+    thread_local std::vector<simd::AlignmentProblem> problems {};
+    thread_local std::vector<int> scores {};
+    pending.clear();
+    result.resize(targets.size());
+    for (std::size_t i {0}; i < targets.size(); ++i) {
+        const auto& target = targets[i];
+        const auto& model = *target.model;
+        validate(truth, target.size, target.offset, model);
+        if (evaluate_without_alignment(target.sequence, target.size, truth, target.qualities, target.offset, model, result[i])) {
+            continue;
+        }
+        const auto truth_size  = static_cast<int>(truth.size());
+        const auto target_size = static_cast<int>(target.size);
+        const auto truth_alignment_size = static_cast<int>(target_size + 2 * pad - 1);
+        const auto alignment_offset = std::max(0, static_cast<int>(target.offset) - pad);
+        if (alignment_offset + truth_alignment_size > truth_size
+            || use_adjusted_alignment_score(truth, target.size, target.offset, model)) {
+            // Flank adjusted scores need a traceback, so are not packed
+            result[i] = simd_align(truth, target.sequence, target.size, target.qualities, target.offset, model);
+            continue;
+        }
+        simd::AlignmentProblem problem {truth.data() + alignment_offset,
+                                        target.sequence,
+                                        reinterpret_cast<const std::int8_t*>(target.qualities),
+                                        truth_alignment_size,
+                                        target_size,
+                                        model.gap_open.data() + alignment_offset,
+                                        model.snv_mask.data() + alignment_offset,
+                                        model.snv_priors.data() + alignment_offset};
+        pending.push_back({problem, model.gap_extend, model.nuc_prior, i});
+    }
+    if (pending.empty()) return;
+    std::stable_sort(std::begin(pending), std::end(pending));
+    problems.resize(pending.size());
+    scores.resize(pending.size());
+    std::transform(std::cbegin(pending), std::cend(pending), std::begin(problems),
+                   [] (const PendingAlignment& alignment) noexcept { return alignment.problem; });
+    for (auto first = std::cbegin(pending); first != std::cend(pending);) {
+        const auto last = std::find_if_not(std::next(first), std::cend(pending),
+                                           [first] (const PendingAlignment& alignment) noexcept { return can_pack(*first, alignment); });
+        const auto offset = std::distance(std::cbegin(pending), first);
+        simd::align(problems.data() + offset, std::distance(first, last),
+                    first->gap_extend, first->nuc_prior, scores.data() + offset);
+        first = last;
+    }
+    for (std::size_t i {0}; i < pending.size(); ++i) {
+        result[pending[i].target_index] = -ln10Div10<> * static_cast<double>(scores[i]);
+    }
 }
 
 std::pair<CigarString, double>
@@ -53,6 +53,29 @@ double evaluate(const std::string& target, const std::string& truth,
                 std::size_t target_offset,
                 const MutationModel& model);
 
+// As above, but the target and its qualities are given as raw arrays of length target_size,
+// so targets stored in contiguous buffers (e.g. ReadBatch) do not need to be copied.
+double evaluate(const char* target, std::size_t target_size, const std::string& truth,
+                const std::uint8_t* target_qualities,
+                std::size_t target_offset,
+                const MutationModel& model);
+
+// A target to be evaluated against a shared truth, see below. The sequence and qualities
+// both have length size, and must outlive the call to evaluate.
+struct Target
+{
+    const char* sequence;
+    std::size_t size;
+    const std::uint8_t* qualities;
+    std::size_t offset;
+    const MutationModel* model;
+};
+
+// Equivalent to calling evaluate for each target against truth, but targets that require a
+// full alignment are aligned together, as many per instruction as the CPU allows. Targets of
+// similar size are grouped so that packed alignments finish together.
+void evaluate(const std::vector<Target>& targets, const std::string& truth, std::vector<double>& result);
+
 std::pair<CigarString, double>
 align(const std::string& target, const std::string& truth,
       const std::vector<std::uint8_t>& target_qualities,
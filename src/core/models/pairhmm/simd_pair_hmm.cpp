@@ -6,6 +6,7 @@
 #endif
 
 #include "simd_pair_hmm.hpp"
+#include "simd_pair_hmm_impl.hpp"
 
 #include <vector>
 #include <algorithm>
@@ -50,10 +51,7 @@ constexpr std::size_t staticBackpointerCapacity {10000};
 template <typename T>
 using SmallVector = boost::container::small_vector<T, staticBackpointerCapacity>;
 
-constexpr short nScore {2 << 2};
-constexpr int bandSize {8};
-constexpr short inf {0x7800};
-constexpr char gap {'-'};
+namespace {
 
 auto extract_epi16(const __m128i a, const int imm) noexcept
 {
@@ -69,790 +67,170 @@ auto extract_epi16(const __m128i a, const int imm) noexcept
     }
 }
 
+struct Sse2
+{
+    using Vec = __m128i;
+    
+    static constexpr int blocks {1};
+    
+    static Vec set1(const short a) noexcept { return _mm_set1_epi16(a); }
+    static Vec load(const short* a) noexcept { return _mm_loadu_si128(reinterpret_cast<const Vec*>(a)); }
+    static Vec add(const Vec a, const Vec b) noexcept { return _mm_add_epi16(a, b); }
+    static Vec min(const Vec a, const Vec b) noexcept { return _mm_min_epi16(a, b); }
+    static Vec cmpeq(const Vec a, const Vec b) noexcept { return _mm_cmpeq_epi16(a, b); }
+    static Vec and_(const Vec a, const Vec b) noexcept { return _mm_and_si128(a, b); }
+    static Vec andnot(const Vec a, const Vec b) noexcept { return _mm_andnot_si128(a, b); }
+    static Vec or_(const Vec a, const Vec b) noexcept { return _mm_or_si128(a, b); }
+    static Vec shift_up(const Vec a) noexcept { return _mm_slli_si128(a, 2); }
+    static Vec shift_down(const Vec a) noexcept { return _mm_srli_si128(a, 2); }
+    template <int n> static Vec shift_left(const Vec a) noexcept { return _mm_slli_epi16(a, n); }
+    template <int n> static Vec shift_right(const Vec a) noexcept { return _mm_srli_epi16(a, n); }
+    static Vec insert_front(const Vec a, const short b) noexcept { return _mm_insert_epi16(a, b, 0); }
+    static Vec insert_front(const Vec a, const short* b) noexcept { return _mm_insert_epi16(a, b[0], 0); }
+    static Vec insert_back(const Vec a, const short b) noexcept { return _mm_insert_epi16(a, b, bandSize - 1); }
+    static Vec insert_back(const Vec a, const short* b) noexcept { return _mm_insert_epi16(a, b[0], bandSize - 1); }
+    static short extract(const Vec a, int, const int idx) noexcept { return extract_epi16(a, idx); }
+};
+
+auto make_problem(const char* truth, const char* target, const std::int8_t* qualities,
+                  const int truth_len, const int target_len,
+                  const std::int8_t* gap_open,
+                  const char* snv_mask = nullptr, const std::int8_t* snv_prior = nullptr) noexcept
+{
+    AlignmentProblem result {truth, target, qualities, truth_len, target_len, gap_open};
+    result.snv_mask = snv_mask;
+    result.snv_prior = snv_prior;
+    return result;
+}
+
+template <bool Snv>
+int align_with_traceback(const AlignmentProblem& problem,
+                         const short gap_extend, const short nuc_prior,
+                         char* aln1, char* aln2, int& first_pos) noexcept
+{
+    assert(aln1 != nullptr && aln2 != nullptr);
+    SmallVector<Sse2::Vec> backpointers(2 * (problem.truth_len + bandSize));
+    Traceback traceback {aln1, aln2, 0};
+    int result;
+    align_packed<Sse2, true, Snv, true>(&problem, 0, gap_extend, nuc_prior, &result, backpointers.data(), &traceback);
+    first_pos = traceback.first_pos;
+    return result;
+}
+
+InstructionSet detect_instruction_set() noexcept
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw")) return InstructionSet::avx512;
+    if (__builtin_cpu_supports("avx2")) return InstructionSet::avx2;
+    return InstructionSet::sse2;
+}
+
+} // namespace
+
 int align(const char* truth, const char* target, const std::int8_t* qualities,
-          int truth_len, int target_len,
-          short gap_open, short gap_extend, short nuc_prior) noexcept
+          const int truth_len, const int target_len,
+          const short gap_open, const short gap_extend, const short nuc_prior) noexcept
 {
-    // target is the read; the shorter of the sequences
-    // no checks for overflow are done
-    //
-    // the bottom-left and top-right corners of the DP table are just
-    // included at the extreme ends of the diagonal, which measures
-    // n=8 entries diagonally across.  This fixes the length of the
-    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
-    //
-    // the << 2's are because the lower two bits are reserved for back tracing
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    gap_open <<= 2;
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    const SimdInt _gap_open {_mm_set1_epi16(gap_open)};
-    const SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    const SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    // truth is initialized with the n-long prefix, in forward direction
-    // target is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        short score = extract_epi16(_m1, std::max(0, s / 2 - target_len));
-        if (s / 2 >= target_len) {
-            minscore = std::min(score, minscore);
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base,
-                                       bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), base == 'N' ? nScore : inf,
-                                       bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-        
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    const auto problem = make_problem(truth, target, qualities, truth_len, target_len, nullptr);
+    int result;
+    align_packed<Sse2, false, false, false>(&problem, gap_open, gap_extend, nuc_prior, &result);
+    return result;
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior) noexcept
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior) noexcept
 {
-    // target is the read; the shorter of the sequences
-    // no checks for overflow are done
-    //
-    // the bottom-left and top-right corners of the DP table are just
-    // included at the extreme ends of the diagonal, which measures
-    // n=8 entries diagonally across.  This fixes the length of the
-    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
-    //
-    // the << 2's are because the lower two bits are reserved for back tracing
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    // truth is initialized with the n-long prefix, in forward direction
-    // target is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m1, s / 2 - target_len)), minscore);
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base,
-                                       bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), base == 'N' ? nScore : inf,
-                                       bandSize - 1);
-        _gap_open   = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2),
-                                       gap_open[pos < truth_len ? pos : truth_len - 1] << 2,
-                                       bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                 _qualitieswin), _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-        
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    const auto problem = make_problem(truth, target, qualities, truth_len, target_len, gap_open);
+    int result;
+    align_packed<Sse2, true, false, false>(&problem, 0, gap_extend, nuc_prior, &result);
+    return result;
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior) noexcept
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    SimdInt _snvmaskwin  {_mm_set_epi16(snv_mask[7], snv_mask[6], snv_mask[5], snv_mask[4],
-                                        snv_mask[3], snv_mask[2], snv_mask[1], snv_mask[0])};
-    SimdInt _snv_priorwin {_mm_set_epi16(snv_prior[7] << 2, snv_prior[6] << 2, snv_prior[5] << 2, snv_prior[4] << 2,
-                                         snv_prior[3] << 2, snv_prior[2] << 2, snv_prior[1] << 2, snv_prior[0] << 2)};
-    
-    SimdInt _snvmask;
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short minscore {inf};
-    
-    for (int s {0}; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m1, s / 2 - target_len)), minscore);
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                 _mm_min_epi16(_qualitieswin,
-                                                                               _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                            _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)),
-                            _nuc_prior);
-        
-        // S odd
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {pos < truth_len ? truth[pos] : 'N'};
-        
-        _truthwin     = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2),
-                                         base,
-                                         bandSize - 1);
-        _truthnqual   = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2),
-                                         base == 'N' ? nScore : inf,
-                                         bandSize - 1);
-        _snvmaskwin   = _mm_insert_epi16(_mm_srli_si128(_snvmaskwin, 2),
-                                         pos < truth_len ? snv_mask[pos] : 'N',
-                                         bandSize - 1);
-        _snv_priorwin = _mm_insert_epi16(_mm_srli_si128(_snv_priorwin, 2),
-                                         (pos < truth_len ? snv_prior[pos] : inf) << 2,
-                                         bandSize - 1);
-        _gap_open     = _mm_insert_epi16(_mm_srli_si128(_gap_open, 2),
-                                         gap_open[pos < truth_len ? pos : truth_len - 1] << 2,
-                                         bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        if (s / 2 >= target_len) {
-            minscore = std::min(static_cast<short>(extract_epi16(_m2, s / 2 - target_len)), minscore);
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1), _gap_open)); // allow I->D
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2),
-                                                                         _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2),
-                                                                         _gap_open)),
-                                             _nuc_prior), inf, bandSize - 1);
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    const auto problem = make_problem(truth, target, qualities, truth_len, target_len, gap_open, snv_mask, snv_prior);
+    int result;
+    align_packed<Sse2, true, true, false>(&problem, 0, gap_extend, nuc_prior, &result);
+    return result;
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
           const int truth_len, const int target_len,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
           int& first_pos, char* aln1, char* aln2) noexcept
 {
-    // target is the read; the shorter of the sequences
-    // no checks for overflow are done
-    
-    // the bottom-left and top-right corners of the DP table are just
-    // included at the extreme ends of the diagonal, which measures
-    // n=8 entries diagonally across.  This fixes the length of the
-    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
-    
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    assert(aln1 != nullptr && aln2 != nullptr);
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    constexpr int matchLabel  {0};
-    constexpr int insertLabel {1};
-    constexpr int deleteLabel {3};
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    static const SimdInt _three {_mm_set1_epi16(3)};
-    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
-    
-    // sequence 1 is initialized with the n-long prefix, in forward direction
-    // sequence 2 is initialized as empty; reverse direction
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short cur_score {0}, minscore {inf}, minscoreidx {-1};
-    
-    // main loop.  Do one extra iteration, with nucs from sequence 2 just moved out
-    // of the targetwin/qual arrays, to simplify getting back pointers
-    int s;
-    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m1, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s;     // point back to the match state at this entry, so as not to
-            }                        // have to store the state at s-2
-        }
-        
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _qualitieswin), _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)), _nuc_prior);
-        
-        _backpointers[s] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m1),
-                                                     _mm_slli_epi16(_mm_and_si128(_three, _i1), 2 * insertLabel)),
-                                        _mm_slli_epi16(_mm_and_si128(_three, _d1), 2 * deleteLabel));
-        
-        // set state labels
-        _m1 = _mm_andnot_si128(_three, _m1);
-        _i1 = _mm_or_si128(_mm_andnot_si128(_three, _i1), _mm_srli_epi16(_three, 1));
-        _d1 = _mm_or_si128(_mm_andnot_si128(_three, _d1), _three);
-        
-        // S odd
-        
-        // truth needs updating; target is current
-        const char c {(bandSize + s / 2 < truth_len) ? truth[bandSize + (s / 2)] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin,   2), c, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2), (c == 'N') ? nScore : inf, bandSize - 1);
-        _gap_open   = _mm_insert_epi16(_mm_srli_si128(_gap_open,  2),
-                                       gap_open[bandSize + s / 2 < truth_len ? bandSize + s / 2 : truth_len - 1] << 2, bandSize - 1);
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m2, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s + 1;
-            }
-        }
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin), _qualitieswin),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1),  // allow I->D
-                                          _gap_open));
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2), _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2), _gap_open)),
-                                             _nuc_prior),
-                               inf, bandSize - 1);
-        _backpointers[s + 1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m2),
-                                                         _mm_slli_epi16(_mm_and_si128(_three, _i2), 2 * insertLabel)),
-                                            _mm_slli_epi16(_mm_and_si128(_three, _d2), 2 * deleteLabel));
-        
-        // set state labels
-        _m2 = _mm_andnot_si128(_three, _m2);
-        _i2 = _mm_or_si128(_mm_andnot_si128(_three, _i2), _mm_srli_epi16(_three, 1));
-        _d2 = _mm_or_si128(_mm_andnot_si128(_three, _d2), _three);
-    }
-    
-    s = minscoreidx;    // point to the dummy match transition
-    
-    auto i      = s / 2 - target_len;
-    auto y      = target_len;
-    auto x      = s - y;
-    auto alnidx = 0;
-    auto state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
-    
-    s -= 2;
-    
-    // this is 2*y (s even) or 2*y+1 (s odd)
-    while (y > 0) {
-        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
-        
-        if (state == matchLabel) {
-            s -= 2;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = target[--y];
-        } else if (state == insertLabel) {
-            i += s & 1;
-            s -= 1;
-            aln1[alnidx] = gap;
-            aln2[alnidx] = target[--y];
-        } else {
-            s -= 1;
-            i -= s & 1;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = gap;
-        }
-        state = new_state;
-        alnidx++;
-    }
-    
-    aln1[alnidx] = 0;
-    aln2[alnidx] = 0;
-    
-    first_pos = x;
-    
-    // reverse them
-    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
-        x = aln1[i];
-        y = aln2[i];
-        aln1[i] = aln1[j];
-        aln2[i] = aln2[j];
-        aln1[j] = x;
-        aln2[j] = y;
-    }
-    
-    return (minscore + 0x8000) >> 2;
+    const auto problem = make_problem(truth, target, qualities, truth_len, target_len, gap_open);
+    return align_with_traceback<false>(problem, gap_extend, nuc_prior, aln1, aln2, first_pos);
 }
 
 int align(const char* truth, const char* target, const std::int8_t* qualities,
-          int truth_len, int target_len,
+          const int truth_len, const int target_len,
           const char* snv_mask, const std::int8_t* snv_prior,
-          const std::int8_t* gap_open, short gap_extend, short nuc_prior,
+          const std::int8_t* gap_open, const short gap_extend, const short nuc_prior,
           char* aln1, char* aln2, int& first_pos) noexcept
 {
-    assert(truth_len > bandSize && (truth_len == target_len + 2 * bandSize - 1));
-    assert(aln1 != nullptr && aln2 != nullptr);
-    
-    gap_extend <<= 2;
-    nuc_prior <<= 2;
-    
-    constexpr int matchLabel  {0};
-    constexpr int insertLabel {1};
-    constexpr int deleteLabel {3};
-    
-    using SimdInt = __m128i;
-    
-    SimdInt _m1 {_mm_set1_epi16(inf)};
-    auto _i1 = _m1;
-    auto _d1 = _m1;
-    auto _m2 = _m1;
-    auto _i2 = _m1;
-    auto _d2 = _m1;
-    
-    SimdInt _gap_extend {_mm_set1_epi16(gap_extend)};
-    SimdInt _nuc_prior  {_mm_set1_epi16(nuc_prior)};
-    SimdInt _initmask   {_mm_set_epi16(0,0,0,0,0,0,0,-1)};
-    SimdInt _initmask2  {_mm_set_epi16(0,0,0,0,0,0,0,-0x8000)};
-    
-    static const SimdInt _three {_mm_set1_epi16(3)};
-    SmallVector<SimdInt> _backpointers(2 * (truth_len + bandSize));
-    
-    SimdInt _truthwin  {_mm_set_epi16(truth[7], truth[6], truth[5], truth[4],
-                                      truth[3], truth[2], truth[1], truth[0])};
-    SimdInt _targetwin  {_m1};
-    SimdInt _qualitieswin {_mm_set1_epi16(64 << 2)};
-    
-    SimdInt _snvmaskwin  {_mm_set_epi16(snv_mask[7], snv_mask[6], snv_mask[5], snv_mask[4],
-                                        snv_mask[3], snv_mask[2], snv_mask[1], snv_mask[0])};
-    SimdInt _snv_priorwin {_mm_set_epi16(snv_prior[7] << 2, snv_prior[6] << 2, snv_prior[5] << 2, snv_prior[4] << 2,
-                                         snv_prior[3] << 2, snv_prior[2] << 2, snv_prior[1] << 2, snv_prior[0] << 2)};
-    
-    SimdInt _snvmask;
-    
-    // if N, make nScore; if != N, make inf
-    SimdInt _truthnqual {_mm_add_epi16(_mm_and_si128(_mm_cmpeq_epi16(_truthwin, _mm_set1_epi16('N')),
-                                                     _mm_set1_epi16(nScore - inf)),
-                                       _mm_set1_epi16(inf))};
-    SimdInt _gap_open {_mm_set_epi16(gap_open[7] << 2,gap_open[6] << 2,gap_open[5] << 2,gap_open[4] << 2,
-                                     gap_open[3] << 2,gap_open[2] << 2,gap_open[1] << 2,gap_open[0] << 2)};
-    
-    short cur_score {0}, minscore {inf}, minscoreidx {-1};
-    
-    int s;
-    for (s = 0; s <= 2 * (target_len + bandSize); s += 2) {
-        // truth is current; target needs updating
-        _targetwin    = _mm_slli_si128(_targetwin, 2);
-        _qualitieswin = _mm_slli_si128(_qualitieswin, 2);
-        
-        if (s / 2 < target_len) {
-            _targetwin    = _mm_insert_epi16(_targetwin, target[s / 2], 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, qualities[s / 2] << 2, 0);
-        } else {
-            _targetwin    = _mm_insert_epi16(_targetwin, '0', 0);
-            _qualitieswin = _mm_insert_epi16(_qualitieswin, 64 << 2, 0);
-        }
-        
-        // S even
-        
-        // initialize to -0x8000
-        _m1 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m1));
-        _m2 = _mm_or_si128(_initmask2, _mm_andnot_si128(_initmask, _m2));
-        _m1 = _mm_min_epi16(_m1, _mm_min_epi16(_i1, _d1));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m1, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s;     // point back to the match state at this entry, so as not to
-            }                        // have to store the state at s-2
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        _m1 = _mm_add_epi16(_m1, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d1 = _mm_min_epi16(_mm_add_epi16(_d2, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m2, _i2),
-                                          _mm_srli_si128(_gap_open, 2))); // allow I->D
-        _d1 = _mm_insert_epi16(_mm_slli_si128(_d1, 2), inf, 0);
-        _i1 = _mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_i2, _gap_extend),
-                                          _mm_add_epi16(_m2, _gap_open)), _nuc_prior);
-        
-        _backpointers[s] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m1),
-                                                     _mm_slli_epi16(_mm_and_si128(_three, _i1),
-                                                                    2 * insertLabel)),
-                                        _mm_slli_epi16(_mm_and_si128(_three, _d1), 2 * deleteLabel));
-        
-        // set state labels
-        _m1 = _mm_andnot_si128(_three, _m1);
-        _i1 = _mm_or_si128(_mm_andnot_si128(_three, _i1), _mm_srli_epi16(_three, 1));
-        _d1 = _mm_or_si128(_mm_andnot_si128(_three, _d1), _three);
-        
-        // S odd
-        
-        // truth needs updating; target is current
-        const auto pos = bandSize + s / 2;
-        const char base {(pos < truth_len) ? truth[pos] : 'N'};
-        
-        _truthwin   = _mm_insert_epi16(_mm_srli_si128(_truthwin, 2), base, bandSize - 1);
-        _truthnqual = _mm_insert_epi16(_mm_srli_si128(_truthnqual, 2),
-                                       (base == 'N') ? nScore : inf, bandSize - 1);
-        _snvmaskwin   = _mm_insert_epi16(_mm_srli_si128(_snvmaskwin, 2),
-                                         pos < truth_len ? snv_mask[pos] : 'N', bandSize - 1);
-        _snv_priorwin = _mm_insert_epi16(_mm_srli_si128(_snv_priorwin, 2),
-                                         (pos < truth_len) ? snv_prior[pos] << 2 : inf << 2,
-                                         bandSize - 1);
-        _gap_open  = _mm_insert_epi16(_mm_srli_si128(_gap_open,  2),
-                                      gap_open[pos < truth_len ? pos : truth_len - 1] << 2,
-                                      bandSize - 1);
-        
-        _initmask  = _mm_slli_si128(_initmask, 2);
-        _initmask2 = _mm_slli_si128(_initmask2, 2);
-        
-        _m2 = _mm_min_epi16(_m2, _mm_min_epi16(_i2, _d2));
-        
-        // at this point, extract minimum score.  Referred-to position must
-        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
-        if (s / 2 >= target_len) {
-            cur_score = extract_epi16(_m2, s / 2 - target_len);
-            if (cur_score < minscore) {
-                minscore = cur_score;
-                minscoreidx = s + 1;
-            }
-        }
-        
-        _snvmask = _mm_cmpeq_epi16(_targetwin, _snvmaskwin);
-        
-        _m2 = _mm_add_epi16(_m2, _mm_min_epi16(_mm_andnot_si128(_mm_cmpeq_epi16(_targetwin, _truthwin),
-                                                                _mm_min_epi16(_qualitieswin,
-                                                                              _mm_or_si128(_mm_and_si128(_snvmask, _snv_priorwin),
-                                                                                           _mm_andnot_si128(_snvmask, _qualitieswin)))),
-                                               _truthnqual));
-        _d2 = _mm_min_epi16(_mm_add_epi16(_d1, _gap_extend),
-                            _mm_add_epi16(_mm_min_epi16(_m1, _i1),  // allow I->D
-                                          _gap_open));
-        _i2 = _mm_insert_epi16(_mm_add_epi16(_mm_min_epi16(_mm_add_epi16(_mm_srli_si128(_i1, 2), _gap_extend),
-                                                           _mm_add_epi16(_mm_srli_si128(_m1, 2), _gap_open)),
-                                             _nuc_prior),
-                               inf, bandSize - 1);
-        _backpointers[s + 1] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_three, _m2),
-                                                         _mm_slli_epi16(_mm_and_si128(_three, _i2), 2 * insertLabel)),
-                                            _mm_slli_epi16(_mm_and_si128(_three, _d2), 2 * deleteLabel));
-        
-        // set state labels
-        _m2 = _mm_andnot_si128(_three, _m2);
-        _i2 = _mm_or_si128(_mm_andnot_si128(_three, _i2), _mm_srli_epi16(_three, 1));
-        _d2 = _mm_or_si128(_mm_andnot_si128(_three, _d2), _three);
-    }
-    
-    s = minscoreidx;    // point to the dummy match transition
-    
-    auto i      = s / 2 - target_len;
-    auto y      = target_len;
-    auto x      = s - y;
-    auto alnidx = 0;
-    auto state  = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * matchLabel)) & 3;
-    
-    s -= 2;
-    
-    // this is 2*y (s even) or 2*y+1 (s odd)
-    while (y > 0) {
-        const auto new_state = (reinterpret_cast<short*>(_backpointers.data() + s)[i] >> (2 * state)) & 3;
-        
-        if (state == matchLabel) {
-            s -= 2;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = target[--y];
-        } else if (state == insertLabel) {
-            i += s & 1;
-            s -= 1;
-            aln1[alnidx] = gap;
-            aln2[alnidx] = target[--y];
-        } else {
-            s -= 1;
-            i -= s & 1;
-            aln1[alnidx] = truth[--x];
-            aln2[alnidx] = gap;
-        }
-        state = new_state;
-        alnidx++;
+    const auto problem = make_problem(truth, target, qualities, truth_len, target_len, gap_open, snv_mask, snv_prior);
+    return align_with_traceback<true>(problem, gap_extend, nuc_prior, aln1, aln2, first_pos);
+}
+
+InstructionSet best_instruction_set() noexcept
+{
+    static const auto result = detect_instruction_set();
+    return result;
+}
+
+bool is_supported(const InstructionSet isa) noexcept
+{
+    return static_cast<int>(isa) <= static_cast<int>(best_instruction_set());
+}
+
+unsigned max_concurrent_alignments(const InstructionSet isa) noexcept
+{
+    switch (isa) {
+        case InstructionSet::avx512: return 4;
+        case InstructionSet::avx2: return 2;
+        default: return 1;
     }
-    
-    aln1[alnidx] = 0;
-    aln2[alnidx] = 0;
-    first_pos = x;
-    
-    // reverse them
-    for (int j {alnidx - 1}, i = 0; i < j; ++i, j--) {
-        x = aln1[i];
-        y = aln2[i];
-        aln1[i] = aln1[j];
-        aln2[i] = aln2[j];
-        aln1[j] = x;
-        aln2[j] = y;
+}
+
+void align(const AlignmentProblem* problems, const std::size_t n,
+           const short gap_extend, const short nuc_prior,
+           int* scores) noexcept
+{
+    align(problems, n, gap_extend, nuc_prior, scores, best_instruction_set());
+}
+
+void align(const AlignmentProblem* problems, const std::size_t n,
+           const short gap_extend, const short nuc_prior,
+           int* scores, const InstructionSet isa) noexcept
+{
+    assert(is_supported(isa));
+    switch (isa) {
+        case InstructionSet::avx512:
+            detail::align_avx512(problems, n, gap_extend, nuc_prior, scores);
+            break;
+        case InstructionSet::avx2:
+            detail::align_avx2(problems, n, gap_extend, nuc_prior, scores);
+            break;
+        default:
+            detail::align_sse2(problems, n, gap_extend, nuc_prior, scores);
     }
-    
-    return (minscore + 0x8000) >> 2;
 }
 
+namespace detail {
+
+void align_sse2(const AlignmentProblem* problems, const std::size_t n,
+                const short gap_extend, const short nuc_prior, int* scores) noexcept
+{
+    align_batch<Sse2>(problems, n, gap_extend, nuc_prior, scores);
+}
+
+} // namespace detail
+
 int calculate_flank_score(const int truth_len, const int lhs_flank_len, const int rhs_flank_len,
                           const std::int8_t* quals, const std::int8_t* gap_open,
                           const short gap_extend, const short nuc_prior,
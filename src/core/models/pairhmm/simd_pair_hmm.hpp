@@ -5,6 +5,7 @@
 #define simd_pair_hmm_hpp
 
 #include <cstdint>
+#include <cstddef>
 
 namespace octopus { namespace hmm { namespace simd {
 
@@ -47,6 +48,40 @@ int calculate_flank_score(int truth_len, int lhs_flank_len, int rhs_flank_len,
                           int first_pos, const char* aln1, const char* aln2,
                           int& target_mask_size) noexcept;
 
+enum class InstructionSet { sse2, avx2, avx512 };
+
+// The widest instruction set supported by the running CPU; detected once
+InstructionSet best_instruction_set() noexcept;
+
+bool is_supported(InstructionSet isa) noexcept;
+
+// The number of alignments the instruction set computes at once. Each alignment band is
+// 8 cells wide, so wider registers hold several independent alignments rather than wider bands.
+unsigned max_concurrent_alignments(InstructionSet isa) noexcept;
+
+struct AlignmentProblem
+{
+    const char* truth;
+    const char* target;
+    const std::int8_t* qualities;
+    int truth_len, target_len;
+    const std::int8_t* gap_open;
+    const char* snv_mask = nullptr; // optional, but snv_prior is required if given
+    const std::int8_t* snv_prior = nullptr;
+};
+
+// Scores n independent alignments, packing as many into each instruction as possible. Each
+// problem has the same requirements as a single align call. Problems of similar target_len
+// should be adjacent as each packed group runs for as long as its longest target.
+void align(const AlignmentProblem* problems, std::size_t n,
+           short gap_extend, short nuc_prior,
+           int* scores) noexcept;
+
+// As above but using the given instruction set, which must be supported
+void align(const AlignmentProblem* problems, std::size_t n,
+           short gap_extend, short nuc_prior,
+           int* scores, InstructionSet isa) noexcept;
+
 } // namespace simd
 } // namespace hmm
 } // namespace octopus
@@ -0,0 +1,75 @@
+// Copyright (c) 2017 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// This translation unit is compiled with AVX2 enabled and must only be called on CPUs supporting it
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+#include "simd_pair_hmm_impl.hpp"
+
+#include <immintrin.h>
+
+namespace octopus { namespace hmm { namespace simd {
+
+namespace {
+
+// Two alignments per vector, one in each 128-bit lane
+struct Avx2
+{
+    using Vec = __m256i;
+    
+    static constexpr int blocks {2};
+    
+    static Vec set1(const short a) noexcept { return _mm256_set1_epi16(a); }
+    static Vec load(const short* a) noexcept { return _mm256_loadu_si256(reinterpret_cast<const Vec*>(a)); }
+    static Vec add(const Vec a, const Vec b) noexcept { return _mm256_add_epi16(a, b); }
+    static Vec min(const Vec a, const Vec b) noexcept { return _mm256_min_epi16(a, b); }
+    static Vec cmpeq(const Vec a, const Vec b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+    static Vec and_(const Vec a, const Vec b) noexcept { return _mm256_and_si256(a, b); }
+    static Vec andnot(const Vec a, const Vec b) noexcept { return _mm256_andnot_si256(a, b); }
+    static Vec or_(const Vec a, const Vec b) noexcept { return _mm256_or_si256(a, b); }
+    static Vec shift_up(const Vec a) noexcept { return _mm256_slli_si256(a, 2); }
+    static Vec shift_down(const Vec a) noexcept { return _mm256_srli_si256(a, 2); }
+    template <int n> static Vec shift_left(const Vec a) noexcept { return _mm256_slli_epi16(a, n); }
+    template <int n> static Vec shift_right(const Vec a) noexcept { return _mm256_srli_epi16(a, n); }
+    static Vec insert_front(const Vec a, const short b) noexcept
+    {
+        return _mm256_insert_epi16(_mm256_insert_epi16(a, b, 0), b, bandSize);
+    }
+    static Vec insert_front(const Vec a, const short* b) noexcept
+    {
+        return _mm256_insert_epi16(_mm256_insert_epi16(a, b[0], 0), b[1], bandSize);
+    }
+    static Vec insert_back(const Vec a, const short b) noexcept
+    {
+        return _mm256_insert_epi16(_mm256_insert_epi16(a, b, bandSize - 1), b, 2 * bandSize - 1);
+    }
+    static Vec insert_back(const Vec a, const short* b) noexcept
+    {
+        return _mm256_insert_epi16(_mm256_insert_epi16(a, b[0], bandSize - 1), b[1], 2 * bandSize - 1);
+    }
+    static short extract(const Vec a, const int block, const int idx) noexcept
+    {
+        alignas(32) short lanes[2 * bandSize];
+        _mm256_store_si256(reinterpret_cast<Vec*>(lanes), a);
+        return lanes[block * bandSize + idx];
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+void align_avx2(const AlignmentProblem* problems, const std::size_t n,
+                const short gap_extend, const short nuc_prior, int* scores) noexcept
+{
+    align_batch<Avx2>(problems, n, gap_extend, nuc_prior, scores);
+}
+
+} // namespace detail
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
@@ -0,0 +1,83 @@
+// Copyright (c) 2017 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// This translation unit is compiled with AVX-512BW enabled and must only be called on CPUs supporting it
+
+#if __GNUC__ >= 6
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+    // The AVX-512 intrinsic headers use self-initialised undefined vectors
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "simd_pair_hmm_impl.hpp"
+
+#include <immintrin.h>
+
+namespace octopus { namespace hmm { namespace simd {
+
+namespace {
+
+// Four alignments per vector, one in each 128-bit lane
+struct Avx512
+{
+    using Vec = __m512i;
+    
+    static constexpr int blocks {4};
+    
+    static constexpr __mmask32 frontLanes {0x01010101};
+    static constexpr __mmask32 backLanes  {0x80808080};
+    
+    static Vec set1(const short a) noexcept { return _mm512_set1_epi16(a); }
+    static Vec load(const short* a) noexcept { return _mm512_loadu_si512(a); }
+    static Vec add(const Vec a, const Vec b) noexcept { return _mm512_add_epi16(a, b); }
+    static Vec min(const Vec a, const Vec b) noexcept { return _mm512_min_epi16(a, b); }
+    static Vec cmpeq(const Vec a, const Vec b) noexcept { return _mm512_movm_epi16(_mm512_cmpeq_epi16_mask(a, b)); }
+    static Vec and_(const Vec a, const Vec b) noexcept { return _mm512_and_si512(a, b); }
+    static Vec andnot(const Vec a, const Vec b) noexcept { return _mm512_andnot_si512(a, b); }
+    static Vec or_(const Vec a, const Vec b) noexcept { return _mm512_or_si512(a, b); }
+    static Vec shift_up(const Vec a) noexcept { return _mm512_bslli_epi128(a, 2); }
+    static Vec shift_down(const Vec a) noexcept { return _mm512_bsrli_epi128(a, 2); }
+    template <int n> static Vec shift_left(const Vec a) noexcept { return _mm512_slli_epi16(a, n); }
+    template <int n> static Vec shift_right(const Vec a) noexcept { return _mm512_srli_epi16(a, n); }
+    static Vec insert_front(const Vec a, const short b) noexcept { return _mm512_mask_set1_epi16(a, frontLanes, b); }
+    static Vec insert_front(const Vec a, const short* b) noexcept
+    {
+        return _mm512_mask_mov_epi16(a, frontLanes, spread(b));
+    }
+    static Vec insert_back(const Vec a, const short b) noexcept { return _mm512_mask_set1_epi16(a, backLanes, b); }
+    static Vec insert_back(const Vec a, const short* b) noexcept
+    {
+        return _mm512_mask_mov_epi16(a, backLanes, spread(b));
+    }
+    // Broadcasts b[i] to every lane of block i
+    static Vec spread(const short* b) noexcept
+    {
+        return _mm512_permutexvar_epi16(_mm512_set_epi16(3, 3, 3, 3, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2, 2, 2,
+                                                         1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0),
+                                        _mm512_castsi128_si512(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(b))));
+    }
+    static short extract(const Vec a, const int block, const int idx) noexcept
+    {
+        alignas(64) short lanes[4 * bandSize];
+        _mm512_store_si512(lanes, a);
+        return lanes[block * bandSize + idx];
+    }
+};
+
+} // namespace
+
+namespace detail {
+
+void align_avx512(const AlignmentProblem* problems, const std::size_t n,
+                  const short gap_extend, const short nuc_prior, int* scores) noexcept
+{
+    align_batch<Avx512>(problems, n, gap_extend, nuc_prior, scores);
+}
+
+} // namespace detail
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
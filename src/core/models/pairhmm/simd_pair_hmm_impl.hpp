@@ -0,0 +1,378 @@
+// Copyright (c) 2017 Daniel Cooke and Gerton Lunter
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef simd_pair_hmm_impl_hpp
+#define simd_pair_hmm_impl_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+#include "simd_pair_hmm.hpp"
+
+// Instruction set independent pair HMM kernels.
+//
+// Each kernel is written in terms of an instruction set wrapper (Ops) whose vectors hold
+// Ops::blocks independent blocks of bandSize 16-bit lanes. Every block holds the band of a
+// different alignment, and the wrappers only provide operations that act on each block
+// independently, so a block computes exactly what the 128-bit kernel computes for the same
+// alignment.
+//
+// This header is only for the simd_pair_hmm translation units, which are compiled with
+// different instruction set flags. Everything here has internal linkage so code generated for
+// one instruction set can never be linked into a caller built for another, and the kernels
+// deliberately avoid library templates for the same reason.
+
+namespace octopus { namespace hmm { namespace simd {
+
+namespace detail {
+
+void align_sse2(const AlignmentProblem* problems, std::size_t n, short gap_extend, short nuc_prior, int* scores) noexcept;
+void align_avx2(const AlignmentProblem* problems, std::size_t n, short gap_extend, short nuc_prior, int* scores) noexcept;
+void align_avx512(const AlignmentProblem* problems, std::size_t n, short gap_extend, short nuc_prior, int* scores) noexcept;
+
+} // namespace detail
+
+namespace {
+
+constexpr short nScore {2 << 2};
+constexpr int bandSize {8};
+constexpr short inf {0x7800};
+constexpr char gap {'-'};
+
+struct Traceback
+{
+    char* aln1;
+    char* aln2;
+    int first_pos;
+};
+
+template <typename Ops>
+short extract_block_score(const typename Ops::Vec a, const int block, const int idx) noexcept
+{
+    // The final diagonal is one past the band; it reads the last lane
+    return Ops::extract(a, block, idx < bandSize ? idx : bandSize - 1);
+}
+
+template <typename Ops>
+short backpointer(const typename Ops::Vec* backpointers, const int s, const int block, const int i) noexcept
+{
+    // i may index one past the band, in which case the lane is the first of the next diagonal
+    return reinterpret_cast<const short*>(backpointers + s + i / bandSize)[block * bandSize + i % bandSize];
+}
+
+// Aligns Ops::blocks problems at once. If GapOpenArray is false then the constant gap_open is
+// used for every problem; if Snv is false the problems' snv_mask and snv_prior are not read.
+// Tracebacks require a buffer of 2 * (max truth_len + bandSize) vectors for the backpointers.
+template <typename Ops, bool GapOpenArray, bool Snv, bool Tracebacks>
+void align_packed(const AlignmentProblem* problems,
+                  short gap_open, short gap_extend, short nuc_prior,
+                  int* scores,
+                  typename Ops::Vec* backpointers = nullptr,
+                  Traceback* tracebacks = nullptr) noexcept
+{
+    // targets are the reads; the shorter of the sequences
+    // no checks for overflow are done
+    //
+    // the bottom-left and top-right corners of the DP table are just
+    // included at the extreme ends of the diagonal, which measures
+    // n=8 entries diagonally across.  This fixes the length of the
+    // longer (horizontal) sequence to 15 (2*8-1) more than the shorter
+    //
+    // the << 2's are because the lower two bits are reserved for back tracing
+
+    using Vec = typename Ops::Vec;
+    constexpr int numBlocks {Ops::blocks};
+    constexpr int numLanes {numBlocks * bandSize};
+    constexpr int matchLabel  {0};
+    constexpr int insertLabel {1};
+    constexpr int deleteLabel {3};
+
+    int max_target_len {0};
+    for (int b {0}; b < numBlocks; ++b) {
+        const auto& problem = problems[b];
+        assert(problem.truth_len > bandSize && (problem.truth_len == problem.target_len + 2 * bandSize - 1));
+        if (problem.target_len > max_target_len) max_target_len = problem.target_len;
+    }
+
+    gap_open <<= 2;
+    gap_extend <<= 2;
+    nuc_prior <<= 2;
+
+    Vec _m1 {Ops::set1(inf)};
+    auto _i1 = _m1;
+    auto _d1 = _m1;
+    auto _m2 = _m1;
+    auto _i2 = _m1;
+    auto _d2 = _m1;
+
+    const Vec _gap_extend {Ops::set1(gap_extend)};
+    const Vec _nuc_prior  {Ops::set1(nuc_prior)};
+    const Vec _three      {Ops::set1(3)};
+
+    alignas(64) short lanes[numLanes];
+    short front[numBlocks], back[numBlocks];
+
+    for (int lane {0}; lane < numLanes; ++lane) lanes[lane] = lane % bandSize == 0 ? -1 : 0;
+    Vec _initmask {Ops::load(lanes)};
+    for (int lane {0}; lane < numLanes; ++lane) lanes[lane] = lane % bandSize == 0 ? -0x8000 : 0;
+    Vec _initmask2 {Ops::load(lanes)};
+
+    // truth is initialized with the n-long prefix, in forward direction
+    // target is initialized as empty; reverse direction
+    for (int lane {0}; lane < numLanes; ++lane) lanes[lane] = problems[lane / bandSize].truth[lane % bandSize];
+    Vec _truthwin {Ops::load(lanes)};
+    Vec _targetwin {_m1};
+    Vec _qualitieswin {Ops::set1(64 << 2)};
+
+    Vec _snvmaskwin {}, _snv_priorwin {}, _snvmask {};
+    if (Snv) {
+        for (int lane {0}; lane < numLanes; ++lane) lanes[lane] = problems[lane / bandSize].snv_mask[lane % bandSize];
+        _snvmaskwin = Ops::load(lanes);
+        for (int lane {0}; lane < numLanes; ++lane) lanes[lane] = problems[lane / bandSize].snv_prior[lane % bandSize] << 2;
+        _snv_priorwin = Ops::load(lanes);
+    }
+
+    // if N, make nScore; if != N, make inf
+    Vec _truthnqual {Ops::add(Ops::and_(Ops::cmpeq(_truthwin, Ops::set1('N')), Ops::set1(nScore - inf)), Ops::set1(inf))};
+
+    Vec _gap_open {Ops::set1(gap_open)};
+    if (GapOpenArray) {
+        for (int lane {0}; lane < numLanes; ++lane) lanes[lane] = problems[lane / bandSize].gap_open[lane % bandSize] << 2;
+        _gap_open = Ops::load(lanes);
+    }
+
+    short minscore[numBlocks], minscoreidx[numBlocks];
+    for (int b {0}; b < numBlocks; ++b) {
+        minscore[b] = inf;
+        minscoreidx[b] = -1;
+    }
+
+    const auto update_minscores = [&] (const Vec& m, const int s) noexcept {
+        for (int b {0}; b < numBlocks; ++b) {
+            const auto target_len = problems[b].target_len;
+            if (s / 2 >= target_len && s / 2 <= target_len + bandSize) {
+                const auto score = extract_block_score<Ops>(m, b, s / 2 - target_len);
+                if (score < minscore[b]) {
+                    minscore[b] = score;
+                    minscoreidx[b] = s;
+                }
+            }
+        }
+    };
+    const auto add_emission = [&] (const Vec& m) noexcept {
+        auto qualities = _qualitieswin;
+        if (Snv) {
+            _snvmask = Ops::cmpeq(_targetwin, _snvmaskwin);
+            qualities = Ops::min(_qualitieswin, Ops::or_(Ops::and_(_snvmask, _snv_priorwin),
+                                                        Ops::andnot(_snvmask, _qualitieswin)));
+        }
+        return Ops::add(m, Ops::min(Ops::andnot(Ops::cmpeq(_targetwin, _truthwin), qualities), _truthnqual));
+    };
+    const auto make_backpointers = [&] (const Vec& m, const Vec& i, const Vec& d) noexcept {
+        return Ops::or_(Ops::or_(Ops::and_(_three, m),
+                                 Ops::template shift_left<2 * insertLabel>(Ops::and_(_three, i))),
+                        Ops::template shift_left<2 * deleteLabel>(Ops::and_(_three, d)));
+    };
+
+    // main loop. When tracing back, the final iteration has the nucs from the targets just moved
+    // out of the targetwin/qual arrays, to simplify getting back pointers
+    for (int s {0}; s <= 2 * (max_target_len + bandSize); s += 2) {
+        // truth is current; target needs updating
+        _targetwin    = Ops::shift_up(_targetwin);
+        _qualitieswin = Ops::shift_up(_qualitieswin);
+
+        for (int b {0}; b < numBlocks; ++b) {
+            const auto& problem = problems[b];
+            front[b] = s / 2 < problem.target_len ? problem.target[s / 2] : '0';
+        }
+        _targetwin = Ops::insert_front(_targetwin, front);
+        for (int b {0}; b < numBlocks; ++b) {
+            const auto& problem = problems[b];
+            front[b] = s / 2 < problem.target_len ? problem.qualities[s / 2] << 2 : 64 << 2;
+        }
+        _qualitieswin = Ops::insert_front(_qualitieswin, front);
+
+        // S even
+
+        _m1 = Ops::or_(_initmask2, Ops::andnot(_initmask, _m1));
+        _m2 = Ops::or_(_initmask2, Ops::andnot(_initmask, _m2));
+        _m1 = Ops::min(_m1, Ops::min(_i1, _d1));
+
+        // point back to the match state at this entry, so as not to have to store the state at s-2
+        update_minscores(_m1, s);
+
+        _m1 = add_emission(_m1);
+        _d1 = Ops::min(Ops::add(_d2, _gap_extend),
+                       Ops::add(Ops::min(_m2, _i2), Ops::shift_down(_gap_open))); // allow I->D
+        _d1 = Ops::insert_front(Ops::shift_up(_d1), inf);
+        _i1 = Ops::add(Ops::min(Ops::add(_i2, _gap_extend), Ops::add(_m2, _gap_open)), _nuc_prior);
+
+        if (Tracebacks) {
+            backpointers[s] = make_backpointers(_m1, _i1, _d1);
+            // set state labels
+            _m1 = Ops::andnot(_three, _m1);
+            _i1 = Ops::or_(Ops::andnot(_three, _i1), Ops::template shift_right<1>(_three));
+            _d1 = Ops::or_(Ops::andnot(_three, _d1), _three);
+        }
+
+        // S odd
+        // truth needs updating; target is current
+        const auto pos = bandSize + s / 2;
+
+        for (int b {0}; b < numBlocks; ++b) {
+            const auto& problem = problems[b];
+            back[b] = pos < problem.truth_len ? problem.truth[pos] : 'N';
+        }
+        _truthwin = Ops::insert_back(Ops::shift_down(_truthwin), back);
+        for (int b {0}; b < numBlocks; ++b) back[b] = back[b] == 'N' ? nScore : inf;
+        _truthnqual = Ops::insert_back(Ops::shift_down(_truthnqual), back);
+        if (Snv) {
+            for (int b {0}; b < numBlocks; ++b) {
+                const auto& problem = problems[b];
+                back[b] = pos < problem.truth_len ? problem.snv_mask[pos] : 'N';
+            }
+            _snvmaskwin = Ops::insert_back(Ops::shift_down(_snvmaskwin), back);
+            for (int b {0}; b < numBlocks; ++b) {
+                const auto& problem = problems[b];
+                back[b] = static_cast<short>((pos < problem.truth_len ? problem.snv_prior[pos] : inf) << 2);
+            }
+            _snv_priorwin = Ops::insert_back(Ops::shift_down(_snv_priorwin), back);
+        }
+        if (GapOpenArray) {
+            for (int b {0}; b < numBlocks; ++b) {
+                const auto& problem = problems[b];
+                back[b] = problem.gap_open[pos < problem.truth_len ? pos : problem.truth_len - 1] << 2;
+            }
+            _gap_open = Ops::insert_back(Ops::shift_down(_gap_open), back);
+        }
+
+        _initmask  = Ops::shift_up(_initmask);
+        _initmask2 = Ops::shift_up(_initmask2);
+
+        _m2 = Ops::min(_m2, Ops::min(_i2, _d2));
+
+        // at this point, extract minimum score.  Referred-to position must
+        // be y==target_len-1, so that current position has y==target_len; i==0 so d=0 and y=s/2
+        update_minscores(_m2, s + 1);
+
+        _m2 = add_emission(_m2);
+        _d2 = Ops::min(Ops::add(_d1, _gap_extend),
+                       Ops::add(Ops::min(_m1, _i1), _gap_open)); // allow I->D
+        _i2 = Ops::insert_back(Ops::add(Ops::min(Ops::add(Ops::shift_down(_i1), _gap_extend),
+                                                 Ops::add(Ops::shift_down(_m1), _gap_open)),
+                                        _nuc_prior), inf);
+
+        if (Tracebacks) {
+            backpointers[s + 1] = make_backpointers(_m2, _i2, _d2);
+            // set state labels
+            _m2 = Ops::andnot(_three, _m2);
+            _i2 = Ops::or_(Ops::andnot(_three, _i2), Ops::template shift_right<1>(_three));
+            _d2 = Ops::or_(Ops::andnot(_three, _d2), _three);
+        }
+    }
+
+    for (int b {0}; b < numBlocks; ++b) {
+        scores[b] = (minscore[b] + 0x8000) >> 2;
+    }
+
+    if (Tracebacks) {
+        for (int b {0}; b < numBlocks; ++b) {
+            const auto& problem = problems[b];
+            auto& traceback = tracebacks[b];
+            assert(traceback.aln1 != nullptr && traceback.aln2 != nullptr);
+
+            int s {minscoreidx[b]}; // point to the dummy match transition
+            auto i      = s / 2 - problem.target_len;
+            auto y      = problem.target_len;
+            auto x      = s - y;
+            auto alnidx = 0;
+            auto state  = (backpointer<Ops>(backpointers, s, b, i) >> (2 * matchLabel)) & 3;
+
+            s -= 2;
+
+            // this is 2*y (s even) or 2*y+1 (s odd)
+            while (y > 0) {
+                const auto new_state = (backpointer<Ops>(backpointers, s, b, i) >> (2 * state)) & 3;
+
+                if (state == matchLabel) {
+                    s -= 2;
+                    traceback.aln1[alnidx] = problem.truth[--x];
+                    traceback.aln2[alnidx] = problem.target[--y];
+                } else if (state == insertLabel) {
+                    i += s & 1;
+                    s -= 1;
+                    traceback.aln1[alnidx] = gap;
+                    traceback.aln2[alnidx] = problem.target[--y];
+                } else {
+                    s -= 1;
+                    i -= s & 1;
+                    traceback.aln1[alnidx] = problem.truth[--x];
+                    traceback.aln2[alnidx] = gap;
+                }
+                state = new_state;
+                alnidx++;
+            }
+
+            traceback.aln1[alnidx] = 0;
+            traceback.aln2[alnidx] = 0;
+            traceback.first_pos = x;
+
+            // reverse them
+            for (int j {alnidx - 1}, k = 0; k < j; ++k, j--) {
+                const auto c1 = traceback.aln1[k], c2 = traceback.aln2[k];
+                traceback.aln1[k] = traceback.aln1[j];
+                traceback.aln2[k] = traceback.aln2[j];
+                traceback.aln1[j] = c1;
+                traceback.aln2[j] = c2;
+            }
+        }
+    }
+}
+
+// Runs the score only kernels over any number of problems, Ops::blocks at a time. Problems
+// with and without SNV masks may be mixed; each kind is packed separately.
+template <typename Ops>
+void align_batch(const AlignmentProblem* problems, const std::size_t n,
+                 const short gap_extend, const short nuc_prior, int* scores) noexcept
+{
+    constexpr int numBlocks {Ops::blocks};
+    AlignmentProblem packed[numBlocks];
+    int packed_scores[numBlocks];
+    std::size_t packed_indices[numBlocks];
+    std::size_t next[2] {0, 0}; // next unprocessed problem without and with an SNV mask
+
+    const auto has_snv_mask = [] (const AlignmentProblem& problem) noexcept { return problem.snv_mask != nullptr; };
+
+    for (int kind {0}; kind < 2; ++kind) {
+        auto& i = next[kind];
+        while (true) {
+            int num_packed {0};
+            for (; i < n && num_packed < numBlocks; ++i) {
+                if (has_snv_mask(problems[i]) == (kind == 1)) {
+                    packed_indices[num_packed] = i;
+                    packed[num_packed++] = problems[i];
+                }
+            }
+            if (num_packed == 0) break;
+            // unused blocks repeat the last problem and are ignored
+            for (int b {num_packed}; b < numBlocks; ++b) packed[b] = packed[num_packed - 1];
+            if (kind == 1) {
+                align_packed<Ops, true, true, false>(packed, 0, gap_extend, nuc_prior, packed_scores);
+            } else {
+                align_packed<Ops, true, false, false>(packed, 0, gap_extend, nuc_prior, packed_scores);
+            }
+            for (int b {0}; b < num_packed; ++b) {
+                scores[packed_indices[b]] = packed_scores[b];
+            }
+        }
+    }
+}
+
+} // namespace
+
+} // namespace simd
+} // namespace hmm
+} // namespace octopus
+
+#endif
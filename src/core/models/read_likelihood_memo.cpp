@@ -0,0 +1,102 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_likelihood_memo.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <cstring>
+
+namespace octopus {
+
+boost::optional<double> ReadLikelihoodMemo::find(const Fingerprint& fingerprint) const noexcept
+{
+    const auto itr = memo_.find(fingerprint);
+    if (itr != std::cend(memo_)) return itr->second;
+    return boost::none;
+}
+
+void ReadLikelihoodMemo::insert(const Fingerprint& fingerprint, const double likelihood, const Position read_end)
+{
+    if (memo_.emplace(fingerprint, likelihood).second) {
+        eviction_heap_.push_back({read_end, fingerprint});
+        std::push_heap(std::begin(eviction_heap_), std::end(eviction_heap_), std::greater<> {});
+    }
+}
+
+void ReadLikelihoodMemo::evict_before(const Position position)
+{
+    while (!eviction_heap_.empty() && eviction_heap_.front().read_end < position) {
+        memo_.erase(eviction_heap_.front().fingerprint);
+        std::pop_heap(std::begin(eviction_heap_), std::end(eviction_heap_), std::greater<> {});
+        eviction_heap_.pop_back();
+    }
+}
+
+std::size_t ReadLikelihoodMemo::size() const noexcept
+{
+    return memo_.size();
+}
+
+void ReadLikelihoodMemo::clear() noexcept
+{
+    memo_.clear();
+    eviction_heap_.clear();
+}
+
+namespace {
+
+constexpr std::uint64_t rotl(const std::uint64_t x, const int r) noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// The MurmurHash3 finaliser
+constexpr std::uint64_t fmix(std::uint64_t x) noexcept
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    x ^= x >> 33;
+    return x;
+}
+
+} // namespace
+
+ReadLikelihoodMemo::FingerprintBuilder&
+ReadLikelihoodMemo::FingerprintBuilder::update(const void* data, std::size_t num_bytes) noexcept
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    num_bytes_ += num_bytes;
+    for (; num_bytes >= sizeof(std::uint64_t); num_bytes -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, sizeof(std::uint64_t));
+        mix(word);
+    }
+    if (num_bytes > 0) {
+        std::uint64_t word {0};
+        std::memcpy(&word, bytes, num_bytes);
+        mix(word);
+    }
+    return *this;
+}
+
+ReadLikelihoodMemo::Fingerprint ReadLikelihoodMemo::FingerprintBuilder::fingerprint() const noexcept
+{
+    auto lo = lo_ ^ num_bytes_, hi = hi_ ^ num_bytes_;
+    lo += hi;
+    hi += lo;
+    return {fmix(lo), fmix(hi)};
+}
+
+// private methods
+
+void ReadLikelihoodMemo::FingerprintBuilder::mix(const std::uint64_t word) noexcept
+{
+    // Two independent lanes, so a collision requires both 64-bit states to collide
+    lo_ = rotl(lo_ ^ (word * 0x87c37b91114253d5), 31) * 0x4cf5ad432745937f + 0x52dce729;
+    hi_ = rotl(hi_ + (rotl(word, 33) * 0x4cf5ad432745937f), 27) * 0x87c37b91114253d5 + 0x38495ab5;
+}
+
+} // namespace octopus
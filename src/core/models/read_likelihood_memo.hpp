@@ -0,0 +1,112 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_likelihood_memo_hpp
+#define read_likelihood_memo_hpp
+
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include <boost/optional.hpp>
+
+#include "basics/contig_region.hpp"
+
+namespace octopus {
+
+/*
+    ReadLikelihoodMemo remembers read likelihoods across HaplotypeLikelihoodCache populations.
+
+    Likelihoods are keyed by a 128-bit fingerprint of everything the likelihood depends on: the
+    read, and the haplotype sequence and error model penalties local to each position the read
+    is evaluated at. Haplotypes from successive active regions are often identical around a
+    read, in which case the read does not need to be re-evaluated.
+ */
+class ReadLikelihoodMemo
+{
+public:
+    using Position = ContigRegion::Position;
+
+    struct Fingerprint
+    {
+        std::uint64_t lo, hi;
+    };
+
+    class FingerprintBuilder;
+
+    ReadLikelihoodMemo() = default;
+
+    ReadLikelihoodMemo(const ReadLikelihoodMemo&)            = default;
+    ReadLikelihoodMemo& operator=(const ReadLikelihoodMemo&) = default;
+    ReadLikelihoodMemo(ReadLikelihoodMemo&&)                 = default;
+    ReadLikelihoodMemo& operator=(ReadLikelihoodMemo&&)      = default;
+
+    ~ReadLikelihoodMemo() = default;
+
+    boost::optional<double> find(const Fingerprint& fingerprint) const noexcept;
+
+    // read_end is the end of the read's mapped region, used for eviction
+    void insert(const Fingerprint& fingerprint, double likelihood, Position read_end);
+
+    // Removes the likelihoods of all reads ending before position. This is amortised
+    // O(log(size)) per evicted likelihood.
+    void evict_before(Position position);
+
+    std::size_t size() const noexcept;
+
+    void clear() noexcept;
+
+private:
+    // Evictions are found with a min-heap on read end alongside the memo
+    struct EvictionEntry
+    {
+        Position read_end;
+        Fingerprint fingerprint;
+        
+        bool operator>(const EvictionEntry& other) const noexcept { return read_end > other.read_end; }
+    };
+
+    struct FingerprintHash
+    {
+        std::size_t operator()(const Fingerprint& fingerprint) const noexcept { return fingerprint.lo; }
+    };
+
+    struct FingerprintEqual
+    {
+        bool operator()(const Fingerprint& lhs, const Fingerprint& rhs) const noexcept
+        {
+            return lhs.lo == rhs.lo && lhs.hi == rhs.hi;
+        }
+    };
+
+    std::unordered_map<Fingerprint, double, FingerprintHash, FingerprintEqual> memo_;
+    std::vector<EvictionEntry> eviction_heap_;
+};
+
+// Accumulates bytes into a Fingerprint
+class ReadLikelihoodMemo::FingerprintBuilder
+{
+public:
+    FingerprintBuilder() = default;
+
+    FingerprintBuilder& update(const void* data, std::size_t num_bytes) noexcept;
+
+    template <typename T>
+    FingerprintBuilder& update(const T& value) noexcept
+    {
+        return update(&value, sizeof(T));
+    }
+
+    Fingerprint fingerprint() const noexcept;
+
+private:
+    std::uint64_t lo_ = 0x9e3779b97f4a7c15, hi_ = 0xc2b2ae3d27d4eb4f;
+    std::uint64_t num_bytes_ = 0;
+
+    void mix(std::uint64_t word) noexcept;
+};
+
+} // namespace octopus
+
+#endif
@@ -8,8 +8,11 @@
 #include <queue>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
 #include <memory>
 #include <functional>
 #include <cstddef>
@@ -38,9 +41,11 @@
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
 #include "utils/append.hpp"
+#include "utils/work_stealing_thread_pool.hpp"
 #include "config/octopus_vcf.hpp"
 #include "core/callers/caller_factory.hpp"
 #include "core/callers/caller.hpp"
+#include "core/task_cost_model.hpp"
 #include "utils/maths.hpp"
 #include "logging/progress_meter.hpp"
 #include "logging/logging.hpp"
@@ -51,9 +56,10 @@
 #include "exceptions/program_error.hpp"
 #include "csr/filters/variant_call_filter.hpp"
 #include "csr/filters/variant_call_filter_factory.hpp"
+#include "csr/filters/single_pass_variant_call_filter.hpp"
 #include "readpipe/buffered_read_pipe.hpp"
 
-#include "timers.hpp" // BENCHMARK
+#include "timers.hpp"
 
 namespace octopus {
 
@@ -84,6 +90,38 @@ bool apply_csr(const GenomeCallingComponents& components) noexcept
     return static_cast<bool>(components.filtered_output());
 }
 
+// Set when calling tasks filter their own calls, rather than filtering them in a second pass
+using FusedCallFilter = boost::optional<const SinglePassVariantCallFilter&>;
+
+ContigCallingComponents make_contig_calling_components(const ContigName& contig,
+                                                       GenomeCallingComponents& components,
+                                                       FusedCallFilter call_filter)
+{
+    ContigCallingComponents result {contig, components};
+    result.call_filter = call_filter;
+    return result;
+}
+
+std::deque<VcfRecord> make_calls(const ContigCallingComponents& components, const GenomicRegion& region,
+                                 std::size_t& num_reads)
+{
+    ReadMap reads {};
+    auto calls = components.caller->call(region, components.progress_meter, reads);
+    num_reads = count_reads(reads);
+    if (components.call_filter) {
+        // The reads are still in memory, so filtering here saves fetching them again
+        return components.call_filter->filter(std::move(calls), reads, components.samples);
+    } else {
+        return calls;
+    }
+}
+
+std::deque<VcfRecord> make_calls(const ContigCallingComponents& components, const GenomicRegion& region)
+{
+    std::size_t num_reads;
+    return make_calls(components, region, num_reads);
+}
+
 using CallTypeSet = std::set<std::type_index>;
 
 std::string get_octopus_version()
@@ -142,10 +180,14 @@ auto get_call_types(const GenomeCallingComponents& components, const std::vector
     return result;
 }
 
-void write_caller_output_header(GenomeCallingComponents& components, const std::string& command)
+void write_caller_output_header(GenomeCallingComponents& components, const std::string& command,
+                                FusedCallFilter call_filter)
 {
     const auto call_types = get_call_types(components, components.contigs());
-    if (components.sites_only() && !apply_csr(components)) {
+    if (call_filter) {
+        components.output() << call_filter->make_header(make_vcf_header(components.samples(), components.contigs(),
+                                                                         components.reference(), call_types, command));
+    } else if (components.sites_only() && !apply_csr(components)) {
         components.output() << make_vcf_header({}, components.contigs(), components.reference(),
                                                call_types, command);
     } else {
@@ -195,7 +237,7 @@ void log_startup_info(const GenomeCallingComponents& components)
         stream(log) << "Processing " << search_size << "bp with automatic thread management";
     }
     auto sl = stream(log);
-    const bool is_filtered_run {components.filtered_output()};
+    const bool is_filtered_run {components.filtered_output() || components.fused_filtering()};
     if (is_filtered_run) {
         sl << "Writing filtered calls to ";
     } else {
@@ -216,6 +258,7 @@ void write_calls(std::deque<VcfRecord>&& calls, VcfWriter& out)
 {
     static auto debug_log = get_debug_log();
     if (debug_log) stream(*debug_log) << "Writing " << calls.size() << " calls to output";
+    profiling::StageTimer timer {profiling::Stage::output};
     write(calls, out);
     calls.clear();
     calls.shrink_to_fit();
@@ -327,7 +370,7 @@ void resolve_connecting_calls(std::vector<VcfRecord>& old_connecting_calls,
             const auto unresolved_region = encompassing_region(merged_calls);
             merged_calls.clear();
             merged_calls.shrink_to_fit();
-            auto new_calls = components.caller->call(unresolved_region, components.progress_meter);
+            auto new_calls = make_calls(components, unresolved_region);
             // TODO: we need to make sure the new calls don't contain any calls
             // outside the unresolved_region, and also possibly adjust phase regions
             // in calls past unresolved_region.
@@ -354,9 +397,9 @@ void run_octopus_on_contig(ContigCallingComponents&& components)
     
     while (first_input_region != last_input_region && !is_empty(subregion)) {
         if (debug_log) stream(*debug_log) << "Processing subregion " << subregion;
-        
+        profiling::TaskTimer task_timer {subregion};
         try {
-            calls = components.caller->call(subregion, components.progress_meter);
+            calls = make_calls(components, subregion);
         } catch(...) {
             // TODO: which exceptions can we recover from?
             throw;
@@ -385,56 +428,13 @@ void run_octopus_on_contig(ContigCallingComponents&& components)
     }
 }
 
-void run_octopus_single_threaded(GenomeCallingComponents& components)
+void run_octopus_single_threaded(GenomeCallingComponents& components, FusedCallFilter call_filter)
 {
-    #ifdef BENCHMARK
-    init_timers();
-    #endif
     components.progress_meter().start();
     for (const auto& contig : components.contigs()) {
-        run_octopus_on_contig(ContigCallingComponents {contig, components});
+        run_octopus_on_contig(make_contig_calling_components(contig, components, call_filter));
     }
     components.progress_meter().stop();
-    #ifdef BENCHMARK
-        print_all_timers();
-    #endif
-}
-
-VcfWriter create_unique_temp_output_file(const GenomicRegion& region,
-                                         const GenomeCallingComponents& components)
-{
-    auto path = *components.temp_directory();
-    const auto& contig = region.contig_name();
-    const auto begin   = std::to_string(region.begin());
-    const auto end     = std::to_string(region.end());
-    boost::filesystem::path file_name {contig + "_" + begin + "-" + end + "_temp.bcf"};
-    path /= file_name;
-    const auto call_types = get_call_types(components, {region.contig_name()});
-    auto header = make_vcf_header(components.samples(), contig, components.reference(), call_types,
-                                  "octopus-internal");
-    return VcfWriter {std::move(path), std::move(header)};
-}
-
-VcfWriter create_unique_temp_output_file(const GenomicRegion::ContigName& contig,
-                                         const GenomeCallingComponents& components)
-{
-    return create_unique_temp_output_file(components.reference().contig_region(contig),
-                                          components);
-}
-
-using TempVcfWriterMap = std::unordered_map<ContigName, VcfWriter>;
-
-TempVcfWriterMap make_temp_vcf_writers(const GenomeCallingComponents& components)
-{
-    if (!components.temp_directory()) {
-        throw std::runtime_error {"Could not make temp writers"};
-    }
-    TempVcfWriterMap result {};
-    result.reserve(components.contigs().size());
-    for (const auto& contig : components.contigs()) {
-        result.emplace(contig, create_unique_temp_output_file(contig, components));
-    }
-    return result;
 }
 
 struct Task : public Mappable<Task>
@@ -592,6 +592,15 @@ void make_tasks_helper(TaskMap& tasks, std::vector<ContigName> contigs, GenomeCa
             const auto& contig = contigs[i];
             if (debug_log) stream(*debug_log) << "Making tasks for contig " << contig;
             auto contig_components = make_contig_components(contig, components, num_threads);
+            if (contig_components.regions.empty()) {
+                // No tasks will be made, so the contig must be marked finished here for its output to be written
+                std::unique_lock<std::mutex> lock {sync.mutex};
+                sync.finished.at(contig) = true;
+                if (i == contigs.size() - 1) sync.all_done = true;
+                lock.unlock();
+                sync.cv.notify_one();
+                continue;
+            }
             make_contig_tasks(contig_components, execution_policy, tasks[contig], sync, i == contigs.size() - 1);
             if (debug_log) stream(*debug_log) << "Finished making tasks for contig " << contig;
         }
@@ -658,22 +667,25 @@ unsigned calculate_num_task_threads(const GenomeCallingComponents& components)
     }
 }
 
-Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
+// Pops up to max_tasks tasks, taking the task maker lock once for the whole batch
+std::deque<Task> pop(TaskMap& tasks, TaskMakerSyncPacket& sync, const std::size_t max_tasks)
 {
-    assert(!tasks.empty());
+    std::deque<Task> result {};
     std::unique_lock<std::mutex> lock {sync.mutex};
     sync.ready = false;
-    assert(sync.num_tasks > 0);
-    const auto contig_task_itr = std::begin(tasks);
-    assert(!contig_task_itr->second.empty());
-    const auto result = std::move(contig_task_itr->second.front());
-    contig_task_itr->second.pop();
-    if (sync.finished.at(contig_task_itr->first) && contig_task_itr->second.empty()) {
-        static auto debug_log = get_debug_log();
-        if (debug_log) stream(*debug_log) << "Finished calling contig " << contig_task_itr->first;
-        tasks.erase(contig_task_itr);
+    while (result.size() < max_tasks && sync.num_tasks > 0) {
+        assert(!tasks.empty());
+        const auto contig_task_itr = std::begin(tasks);
+        assert(!contig_task_itr->second.empty());
+        result.push_back(std::move(contig_task_itr->second.front()));
+        contig_task_itr->second.pop();
+        if (sync.finished.at(contig_task_itr->first) && contig_task_itr->second.empty()) {
+            static auto debug_log = get_debug_log();
+            if (debug_log) stream(*debug_log) << "Finished calling contig " << contig_task_itr->first;
+            tasks.erase(contig_task_itr);
+        }
+        --sync.num_tasks;
     }
-    --sync.num_tasks;
     sync.ready = true;
     lock.unlock();
     sync.cv.notify_one();
@@ -682,9 +694,10 @@ Task pop(TaskMap& tasks, TaskMakerSyncPacket& sync)
 
 struct CompletedTask : public Task
 {
-    CompletedTask(Task task) : Task {std::move(task)}, calls {}, runtime {} {}
+    CompletedTask(Task task) : Task {std::move(task)}, calls {}, runtime {}, num_reads {0} {}
     std::deque<VcfRecord> calls;
     utils::TimeInterval runtime;
+    std::size_t num_reads; // counted by the worker that called the task
 };
 
 std::string duration(const CompletedTask& task)
@@ -714,15 +727,99 @@ bool is_ready(const std::future<R>& f)
     return f.valid() && f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
 }
 
-auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync)
+// Tasks estimated to take longer than this are split when they are dispatched
+constexpr std::chrono::seconds targetTaskDuration {60};
+constexpr GenomicRegion::Size minSplitTaskSize {1'000};
+constexpr unsigned maxTaskSplits {64};
+// Running tasks that take this much longer than estimated are reported to the cost model
+constexpr double taskOverrunFactor {4};
+// Granularity of the read cache shared by calling tasks
+constexpr GenomicRegion::Size sharedReadCacheChunkSize {20'000};
+
+// The estimate only uses the read density of completed tasks, so no reads are fetched on the dispatcher
+std::deque<Task> split_to_target_duration(Task task, const TaskCostModel& cost_model)
 {
     static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Spawning task " << task;
-    return std::async(std::launch::async, [task = std::move(task), components = std::move(components), &sync] () {
+    std::deque<Task> result {};
+    const auto estimate = cost_model.estimate(task.region);
+    if (!estimate || *estimate <= targetTaskDuration || size(task.region) < 2 * minSplitTaskSize) {
+        result.push_back(std::move(task));
+        return result;
+    }
+    auto num_splits = std::min(static_cast<unsigned>(std::ceil(*estimate / targetTaskDuration)), maxTaskSplits);
+    num_splits = std::min(num_splits, static_cast<unsigned>(size(task.region) / minSplitTaskSize));
+    const auto split_size = size(task.region) / num_splits;
+    auto remaining = task.region;
+    while (!is_empty(remaining)) {
+        auto subregion = expand_rhs(head_region(remaining), split_size);
+        if (size(remaining) < 2 * split_size) {
+            subregion = remaining;
+        }
+        result.emplace_back(subregion, task.policy);
+        remaining = right_overhang_region(remaining, subregion);
+    }
+    if (debug_log) {
+        stream(*debug_log) << "Split task " << task << " into " << result.size() << " tasks as it is estimated to take "
+                           << estimate->count() << "s";
+    }
+    return result;
+}
+
+struct DispatchedTask
+{
+    GenomicRegion region;
+    std::chrono::system_clock::time_point dispatch_time;
+    TaskCostModel::Duration estimate;
+    bool overrun_reported;
+};
+
+auto make_dispatched_task(const Task& task, const TaskCostModel& cost_model)
+{
+    boost::optional<DispatchedTask> result {};
+    const auto estimate = cost_model.estimate(task.region);
+    if (estimate) {
+        result = DispatchedTask {task.region, std::chrono::system_clock::now(), *estimate, false};
+    }
+    return result;
+}
+
+void check_overrun(DispatchedTask& task, TaskCostModel& cost_model)
+{
+    if (task.overrun_reported) return;
+    const TaskCostModel::Duration elapsed {std::chrono::system_clock::now() - task.dispatch_time};
+    if (elapsed > taskOverrunFactor * task.estimate) {
+        static auto debug_log = get_debug_log();
+        if (debug_log) stream(*debug_log) << "Task " << task.region << " has run for " << elapsed.count()
+                                          << "s but was estimated to take " << task.estimate.count() << "s";
+        cost_model.add_overrun(task.region, elapsed);
+        task.overrun_reported = true;
+    }
+}
+
+using ContigAffinityMap = std::unordered_map<ContigName, WorkStealingThreadPool::Affinity>;
+
+// Tasks from the same contig are queued on the same worker so they reuse that worker's warm caches
+auto make_contig_affinity_map(const GenomeCallingComponents& components)
+{
+    ContigAffinityMap result {};
+    result.reserve(components.contigs().size());
+    for (const auto& contig : components.contigs()) {
+        result.emplace(contig, result.size());
+    }
+    return result;
+}
+
+auto run(Task task, ContigCallingComponents components, CallerSyncPacket& sync,
+         WorkStealingThreadPool& pool, const WorkStealingThreadPool::Affinity affinity)
+{
+    static auto debug_log = get_debug_log();
+    if (debug_log) stream(*debug_log) << "Queuing task " << task;
+    return pool.push_with_affinity(affinity, [task = std::move(task), components = std::move(components), &sync] () {
         try {
+            profiling::TaskTimer task_timer {task.region};
             CompletedTask result {task};
             result.runtime.start = std::chrono::system_clock::now();
-            result.calls = components.caller->call(task.region, components.progress_meter);
+            result.calls = make_calls(components, task.region, result.num_reads);
             result.runtime.end = std::chrono::system_clock::now();
             std::unique_lock<std::mutex> lock {sync.mutex};
             ++sync.num_finished;
@@ -773,12 +870,12 @@ auto get_writable_completed_tasks(CompletedTask&& task, CompletedTaskMap::mapped
 using ContigCallingComponentFactory    = std::function<ContigCallingComponents()>;
 using ContigCallingComponentFactoryMap = std::map<ContigName, ContigCallingComponentFactory>;
 
-auto make_contig_calling_component_factory_map(GenomeCallingComponents& components)
+auto make_contig_calling_component_factory_map(GenomeCallingComponents& components, FusedCallFilter call_filter)
 {
     ContigCallingComponentFactoryMap result {};
     for (const auto& contig : components.contigs()) {
-        result.emplace(contig, [&components, contig] () -> ContigCallingComponents
-                       { return ContigCallingComponents {contig, components}; });
+        result.emplace(contig, [&components, contig, call_filter] () -> ContigCallingComponents
+                       { return make_contig_calling_components(contig, components, call_filter); });
     }
     return result;
 }
@@ -836,7 +933,7 @@ void resolve_connecting_calls(CompletedTask& lhs, CompletedTask& rhs,
             logging::WarningLogger warn_log {};
             stream(warn_log) << "Recalling " << unresolved_region
                              << " due to call inconsistency between thread tasks. This may increase expected runtime";
-            auto resolved_calls = components.caller->call(unresolved_region, components.progress_meter);
+            auto resolved_calls = make_calls(components, unresolved_region);
             if (!resolved_calls.empty()) {
                 if (!contains(unresolved_region, encompassing_region(resolved_calls))) {
                     // TODO
@@ -865,40 +962,118 @@ void resolve_connecting_calls(std::deque<CompletedTask>& adjacent_tasks,
                   [&] (auto& rhs) { resolve_connecting_calls(*lhs++, rhs, calling_components); });
 }
 
+/*
+    Writes completed tasks straight to the final output in contig order. Tasks for each contig must be
+    given in order, but contigs may be interleaved; calls for contigs after the one being written are
+    held in memory until every preceding contig has been finished.
+ */
+class OrderedCallWriter
+{
+public:
+    OrderedCallWriter() = delete;
+    
+    OrderedCallWriter(VcfWriter& output, std::vector<ContigName> contigs)
+    : output_ {output}
+    , contigs_ {std::move(contigs)}
+    , current_contig_ {0}
+    , buffered_calls_ {}
+    , finished_contigs_ {}
+    , num_buffered_calls_ {0}
+    {}
+    
+    OrderedCallWriter(const OrderedCallWriter&)            = delete;
+    OrderedCallWriter& operator=(const OrderedCallWriter&) = delete;
+    OrderedCallWriter(OrderedCallWriter&&)                 = delete;
+    OrderedCallWriter& operator=(OrderedCallWriter&&)      = delete;
+    
+    ~OrderedCallWriter() = default;
+    
+    bool is_current(const ContigName& contig) const noexcept
+    {
+        return current_contig_ < contigs_.size() && contigs_[current_contig_] == contig;
+    }
+    
+    void write(CompletedTask&& task)
+    {
+        static auto debug_log = get_debug_log();
+        if (debug_log) stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
+        const auto& contig = contig_name(task);
+        if (is_current(contig)) {
+            write_calls(std::move(task.calls), output_.get());
+        } else {
+            num_buffered_calls_ += task.calls.size();
+            utils::append(std::move(task.calls), buffered_calls_[contig]);
+        }
+    }
+    
+    // No more tasks will be written for contig
+    void finish(const ContigName& contig)
+    {
+        finished_contigs_.insert(contig);
+        while (current_contig_ < contigs_.size() && finished_contigs_.count(contigs_[current_contig_]) == 1) {
+            ++current_contig_;
+            if (current_contig_ < contigs_.size()) {
+                const auto itr = buffered_calls_.find(contigs_[current_contig_]);
+                if (itr != std::end(buffered_calls_)) {
+                    num_buffered_calls_ -= itr->second.size();
+                    write_calls(std::move(itr->second), output_.get());
+                    buffered_calls_.erase(itr);
+                }
+            }
+        }
+    }
+    
+    // Thread safe
+    std::size_t num_buffered_calls() const noexcept
+    {
+        return num_buffered_calls_;
+    }
+    
+private:
+    std::reference_wrapper<VcfWriter> output_;
+    const std::vector<ContigName> contigs_;
+    std::size_t current_contig_;
+    std::unordered_map<ContigName, std::deque<VcfRecord>> buffered_calls_;
+    std::unordered_set<ContigName> finished_contigs_;
+    std::atomic<std::size_t> num_buffered_calls_;
+};
+
+// Tasks on contigs after the one being written are not dispatched while this many calls are buffered
+constexpr std::size_t maxBufferedOutOfOrderCalls {100'000};
+
 struct TaskWriterSyncPacket
 {
     std::condition_variable cv;
     std::mutex mutex;
     std::deque<CompletedTask> tasks = {};
+    std::deque<ContigName> finished_contigs = {}; // written after any queued tasks
+    bool writing = false;
     bool done = false;
 };
 
-void write(std::deque<CompletedTask>& tasks, TempVcfWriterMap& writers)
-{
-    static auto debug_log = get_debug_log();
-    for (auto&& task : tasks) {
-        if (debug_log) {
-            stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
-        }
-        auto& writer = writers.at(contig_name(task));
-        write_calls(std::move(task.calls), writer);
-    }
-    tasks.clear();
-}
-
-void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync)
+void write_ordered_calls_helper(OrderedCallWriter& writer, TaskWriterSyncPacket& sync)
 {
     try {
         std::unique_lock<std::mutex> lock {sync.mutex, std::defer_lock};
-        std::deque<CompletedTask> buffer {};
+        std::deque<CompletedTask> tasks {};
+        std::deque<ContigName> finished_contigs {};
         while (!sync.done) {
             lock.lock();
-            sync.cv.wait(lock, [&] () { return !sync.tasks.empty() || sync.done; });
-            assert(buffer.empty());
-            std::swap(sync.tasks, buffer);
+            sync.cv.wait(lock, [&] () { return !sync.tasks.empty() || !sync.finished_contigs.empty() || sync.done; });
+            assert(tasks.empty() && finished_contigs.empty());
+            std::swap(sync.tasks, tasks);
+            std::swap(sync.finished_contigs, finished_contigs);
+            sync.writing = true;
+            lock.unlock();
+            sync.cv.notify_one();
+            for (auto&& task : tasks) writer.write(std::move(task));
+            tasks.clear();
+            for (const auto& contig : finished_contigs) writer.finish(contig);
+            finished_contigs.clear();
+            lock.lock();
+            sync.writing = false;
             lock.unlock();
             sync.cv.notify_one();
-            write(buffer, writers);
         }
         logging::DebugLogger debug_log {};
         debug_log << "Task writer finished";
@@ -919,24 +1094,23 @@ void write_temp_vcf_helper(TempVcfWriterMap& writers, TaskWriterSyncPacket& sync
     }
 }
 
-std::thread make_task_writer_thread(TempVcfWriterMap& temp_writers, TaskWriterSyncPacket& writer_sync)
+std::thread make_task_writer_thread(OrderedCallWriter& writer, TaskWriterSyncPacket& writer_sync)
 {
-    return std::thread {write_temp_vcf_helper, std::ref(temp_writers), std::ref(writer_sync)};
+    return std::thread {write_ordered_calls_helper, std::ref(writer), std::ref(writer_sync)};
 }
 
-void write(std::deque<CompletedTask>&& tasks, VcfWriter& temp_vcf)
+void write(std::deque<CompletedTask>&& tasks, TaskWriterSyncPacket& sync)
 {
-    static auto debug_log = get_debug_log();
-    for (auto&& task : tasks) {
-        if (debug_log) stream(*debug_log) << "Writing completed task " << task << " that finished in " << duration(task);
-        write_calls(std::move(task.calls), temp_vcf);
-    }
+    std::unique_lock<std::mutex> lock {sync.mutex};
+    utils::append(std::move(tasks), sync.tasks);
+    lock.unlock();
+    sync.cv.notify_one();
 }
 
-void write(std::deque<CompletedTask>&& tasks, TaskWriterSyncPacket& sync)
+void finish(const ContigName& contig, TaskWriterSyncPacket& sync)
 {
     std::unique_lock<std::mutex> lock {sync.mutex};
-    utils::append(std::move(tasks), sync.tasks);
+    sync.finished_contigs.push_back(contig);
     lock.unlock();
     sync.cv.notify_one();
 }
@@ -965,10 +1139,25 @@ void write_or_buffer(CompletedTask&& task, CompletedTaskMap::mapped_type& buffer
     }
 }
 
+// Called once every task on the contig has completed, so the only buffered task is the holdback
+void finish_contig(const ContigName& contig, CompletedTaskMap::mapped_type& buffered_tasks,
+                   HoldbackTask& holdback, TaskWriterSyncPacket& sync)
+{
+    static auto debug_log = get_debug_log();
+    if (debug_log) stream(*debug_log) << "Finished all tasks on contig " << contig;
+    assert(buffered_tasks.size() <= 1);
+    holdback = boost::none;
+    std::deque<CompletedTask> tasks {};
+    for (auto& p : buffered_tasks) tasks.push_back(std::move(p.second));
+    buffered_tasks.clear();
+    write(std::move(tasks), sync);
+    finish(contig, sync);
+}
+
 void wait_until_finished(TaskWriterSyncPacket& sync)
 {
     std::unique_lock<std::mutex> lock {sync.mutex};
-    sync.cv.wait(lock, [&] () { return sync.tasks.empty(); });
+    sync.cv.wait(lock, [&] () { return sync.tasks.empty() && sync.finished_contigs.empty() && !sync.writing; });
     sync.done = true;
     lock.unlock();
     sync.cv.notify_one();
@@ -1027,48 +1216,34 @@ void resolve_connecting_calls(RemainingTaskMap& remaining_tasks,
     }
 }
 
-void write(RemainingTaskMap&& remaining_tasks, TempVcfWriterMap& temp_vcfs)
-{
-    for (auto& p : remaining_tasks) {
-        write(std::move(p.second), temp_vcfs.at(p.first));
-    }
-}
-
-void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, TempVcfWriterMap& temp_vcfs,
-                           const ContigCallingComponentFactoryMap& calling_components)
+// Must only be called once the task writer thread has finished
+void write_remaining_tasks(FutureCompletedTasks& futures, CompletedTaskMap& buffered_tasks, OrderedCallWriter& writer,
+                           const std::vector<ContigName>& contigs, const ContigCallingComponentFactoryMap& calling_components)
 {
     static auto debug_log = get_debug_log();
     if (debug_log) stream(*debug_log) << "Waiting for " << futures.size() << " running tasks to finish";
     auto remaining_tasks = extract_remaining_tasks(futures, buffered_tasks);
     resolve_connecting_calls(remaining_tasks, calling_components);
-    write(std::move(remaining_tasks), temp_vcfs);
-}
-
-auto extract_writers(TempVcfWriterMap&& vcfs)
-{
-    std::vector<VcfWriter> result {};
-    result.reserve(vcfs.size());
-    for (auto&& p : vcfs) {
-        result.push_back(std::move(p.second));
+    for (auto& p : remaining_tasks) {
+        for (auto&& task : p.second) writer.write(std::move(task));
+    }
+    for (const auto& contig : contigs) {
+        writer.finish(contig);
     }
-    vcfs.clear();
-    return result;
-}
-
-auto extract_as_readers(TempVcfWriterMap&& vcfs)
-{
-    return writers_to_readers(extract_writers(std::move(vcfs)));
 }
 
-void merge(TempVcfWriterMap&& temp_vcf_writers, GenomeCallingComponents& components)
+// A contig is complete once the task maker has finished it and all of its tasks have completed
+bool is_complete(const ContigName& contig, const TaskMap& pending_tasks, const TaskMap& running_tasks,
+                 TaskMakerSyncPacket& sync)
 {
-    static auto debug_log = get_debug_log();
-    if (debug_log) stream(*debug_log) << "Merging " << temp_vcf_writers.size() << " temporary VCF files";
-    auto temp_readers = extract_as_readers(std::move(temp_vcf_writers));
-    merge(temp_readers, components.output(), components.contigs());
+    if (!running_tasks.at(contig).empty()) return false;
+    std::lock_guard<std::mutex> lock {sync.mutex};
+    if (!sync.finished.at(contig)) return false;
+    const auto itr = pending_tasks.find(contig);
+    return itr == std::cend(pending_tasks) || itr->second.empty();
 }
 
-void run_octopus_multi_threaded(GenomeCallingComponents& components)
+void run_octopus_multi_threaded(GenomeCallingComponents& components, FusedCallFilter call_filter)
 {
     using namespace std::chrono_literals;
     static auto debug_log = get_debug_log();
@@ -1087,7 +1262,18 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     }
     task_maker_thread.detach();
     
-    FutureCompletedTasks futures(num_task_threads);
+    // Reads that straddle adjacent tasks are fetched and processed once rather than by each task. The
+    // cache holds reads for all running tasks, so it gets the whole read buffer footprint.
+    components.read_pipe().enable_shared_cache(sharedReadCacheChunkSize, components.read_buffer_size());
+    
+    WorkStealingThreadPool pool {num_task_threads};
+    const auto contig_affinities = make_contig_affinity_map(components);
+    // Keep more tasks in flight than there are workers so idle workers have queued tasks to steal
+    FutureCompletedTasks futures(2 * num_task_threads);
+    std::vector<boost::optional<DispatchedTask>> dispatched_tasks(futures.size());
+    TaskCostModel cost_model {};
+    // Tasks popped from the task maker, possibly split, but not yet dispatched to the pool
+    std::deque<Task> undispatched_tasks {};
     TaskMap running_tasks {ContigOrder {components.contigs()}};
     CompletedTaskMap buffered_tasks {};
     std::map<ContigName, HoldbackTask> holdbacks {};
@@ -1099,12 +1285,15 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     }
     
     CallerSyncPacket caller_sync {};
-    const auto calling_components = make_contig_calling_component_factory_map(components);
+    const auto calling_components = make_contig_calling_component_factory_map(components, call_filter);
     unsigned num_idle_futures {0};
     
-    auto temp_writers = make_temp_vcf_writers(components);
+    // Calls are written directly to the final output in contig order, rather than to temporary
+    // per-contig files which would need merging once calling is done
+    OrderedCallWriter call_writer {components.output(), components.contigs()};
+    std::size_t next_unfinished_contig {0};
     TaskWriterSyncPacket task_writer_sync {};
-    auto task_writer_thread = make_task_writer_thread(temp_writers, task_writer_sync);
+    auto task_writer_thread = make_task_writer_thread(call_writer, task_writer_sync);
     if (!task_writer_thread.joinable()) {
         logging::FatalLogger fatal_log {};
         fatal_log << "Unable to make task writer thread";
@@ -1113,8 +1302,8 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     task_writer_thread.detach();
     
     // Wait for the first task to be made
-    const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0; };
-    while(task_maker_sync.num_tasks == 0) {
+    const auto tasks_available = [&] () noexcept { return task_maker_sync.num_tasks > 0 || task_maker_sync.all_done; };
+    while (task_maker_sync.num_tasks == 0 && !task_maker_sync.all_done) {
         pending_task_lock.lock();
         task_maker_sync.cv.wait(pending_task_lock, tasks_available);
         pending_task_lock.unlock();
@@ -1123,10 +1312,10 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     
     components.progress_meter().start();
     
-    while (!task_maker_sync.all_done || task_maker_sync.num_tasks > 0) {
+    while (!task_maker_sync.all_done || task_maker_sync.num_tasks > 0 || !undispatched_tasks.empty()) {
         pending_task_lock.lock();
         assert(count_tasks(pending_tasks) == task_maker_sync.num_tasks);
-        if (!task_maker_sync.all_done && task_maker_sync.num_tasks == 0) {
+        if (!task_maker_sync.all_done && task_maker_sync.num_tasks == 0 && undispatched_tasks.empty()) {
             task_maker_sync.batch_size_hint = std::max(num_idle_futures, num_task_threads / 2);
             if (num_idle_futures < futures.size()) {
                 // If there are running futures then it's good periodically check to see if
@@ -1141,34 +1330,66 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
         }
         pending_task_lock.unlock();
         num_idle_futures = 0;
-        for (auto& future : futures) {
+        for (std::size_t i {0}; i < futures.size(); ++i) {
+            auto& future = futures[i];
             if (is_ready(future)) {
                 auto completed_task = future.get();
+                components.read_pipe().release(Caller::read_fetch_region(completed_task.region));
+                cost_model.add(completed_task.region, completed_task.num_reads,
+                               completed_task.runtime.end - completed_task.runtime.start);
+                dispatched_tasks[i] = boost::none;
                 const auto& contig = contig_name(completed_task.region);
                 write_or_buffer(std::move(completed_task), buffered_tasks.at(contig),
                                 running_tasks.at(contig), holdbacks.at(contig),
                                 task_writer_sync, calling_components.at(contig));
                 --caller_sync.num_finished;
+            } else if (dispatched_tasks[i]) {
+                check_overrun(*dispatched_tasks[i], cost_model);
             }
-            if (!future.valid()) {
-                pending_task_lock.lock();
-                if (task_maker_sync.num_tasks > 0) {
-                    pending_task_lock.unlock(); // As pop will need to lock the mutex too == deadlock
-                    auto task = pop(pending_tasks, task_maker_sync);
-                    future = run(task, calling_components.at(contig_name(task))(), caller_sync);
-                    running_tasks.at(contig_name(task)).push(std::move(task));
-                } else {
-                    pending_task_lock.unlock();
-                    ++num_idle_futures;
+            if (!future.valid()) ++num_idle_futures;
+        }
+        while (next_unfinished_contig < components.contigs().size()) {
+            const auto& contig = components.contigs()[next_unfinished_contig];
+            if (!is_complete(contig, pending_tasks, running_tasks, task_maker_sync)) break;
+            finish_contig(contig, buffered_tasks.at(contig), holdbacks.at(contig), task_writer_sync);
+            ++next_unfinished_contig;
+        }
+        if (num_idle_futures > undispatched_tasks.size() && task_maker_sync.num_tasks > 0) {
+            for (auto&& task : pop(pending_tasks, task_maker_sync, num_idle_futures - undispatched_tasks.size())) {
+                // Tasks are split here rather than when they are made so the split uses the latest cost estimates
+                auto split_tasks = split_to_target_duration(std::move(task), cost_model);
+                // Tasks are added to running_tasks in region order so completed tasks are written in order
+                for (const auto& split_task : split_tasks) {
+                    running_tasks.at(contig_name(split_task)).push(split_task);
+                    components.read_pipe().reserve(Caller::read_fetch_region(split_task.region));
                 }
+                utils::append(std::move(split_tasks), undispatched_tasks);
+            }
+        }
+        // Bound the calls held in memory for contigs after the one being written by only running tasks
+        // on the first unfinished contig until the writer catches up
+        const bool dispatch_blocked {call_writer.num_buffered_calls() > maxBufferedOutOfOrderCalls
+                                     && !undispatched_tasks.empty()
+                                     && next_unfinished_contig < components.contigs().size()
+                                     && contig_name(undispatched_tasks.front()) != components.contigs()[next_unfinished_contig]};
+        if (dispatch_blocked && debug_log) *debug_log << "Holding back tasks until out-of-order calls are written";
+        for (std::size_t i {0}; i < futures.size() && !undispatched_tasks.empty() && !dispatch_blocked; ++i) {
+            if (!futures[i].valid()) {
+                const auto task = std::move(undispatched_tasks.front());
+                undispatched_tasks.pop_front();
+                const auto& contig = contig_name(task);
+                dispatched_tasks[i] = make_dispatched_task(task, cost_model);
+                futures[i] = run(task, calling_components.at(contig)(), caller_sync, pool, contig_affinities.at(contig));
+                --num_idle_futures;
             }
         }
         // If there are no idle futures then all threads are busy and we must wait for one to finish,
         // otherwise we must have run out of tasks, so we should wait for new ones.
-        if (num_idle_futures == 0 && caller_sync.num_finished == 0) {
+        if ((num_idle_futures == 0 || dispatch_blocked) && caller_sync.num_finished == 0) {
             task_maker_sync.waiting = false;
             std::unique_lock<std::mutex> lock {caller_sync.mutex};
-            caller_sync.cv.wait(lock, [&] () { return caller_sync.num_finished > 0; });
+            // Wake periodically to check running tasks for overruns
+            caller_sync.cv.wait_for(lock, 10s, [&] () { return caller_sync.num_finished > 0; });
             task_maker_sync.waiting = true;
         } else {
             if (debug_log) stream(*debug_log) << "There are " << num_idle_futures << " idle futures";
@@ -1180,9 +1401,9 @@ void run_octopus_multi_threaded(GenomeCallingComponents& components)
     holdbacks.clear(); // holdbacks are just references to buffered tasks
     if (debug_log) *debug_log << "Finished making new tasks. Waiting for task writer to complete existing jobs";
     wait_until_finished(task_writer_sync);
-    write_remaining_tasks(futures, buffered_tasks, temp_writers, calling_components);
+    write_remaining_tasks(futures, buffered_tasks, call_writer, components.contigs(), calling_components);
+    components.read_pipe().disable_shared_cache();
     components.progress_meter().stop();
-    merge(std::move(temp_writers), components);
 }
 
 } // namespace
@@ -1192,16 +1413,16 @@ bool is_multithreaded(const GenomeCallingComponents& components)
     return !components.num_threads() || *components.num_threads() > 1;
 }
 
-void run_calling(GenomeCallingComponents& components)
+void run_calling(GenomeCallingComponents& components, FusedCallFilter call_filter)
 {
     if (is_multithreaded(components)) {
         if (DEBUG_MODE) {
             logging::WarningLogger warn_log {};
             warn_log << "Running in parallel mode can make debug log difficult to interpret";
         }
-        run_octopus_multi_threaded(components);
+        run_octopus_multi_threaded(components, call_filter);
     } else {
-        run_octopus_single_threaded(components);
+        run_octopus_single_threaded(components, call_filter);
     }
 }
 
@@ -1273,6 +1494,7 @@ void run_filtering(GenomeCallingComponents& components)
         BufferedReadPipe::Config buffer_config {components.read_buffer_size()};
         buffer_config.fetch_expansion = 100;
         buffer_config.max_hint_gap = 5'000;
+        buffer_config.prefetch = true;
         BufferedReadPipe buffered_rp {filter_read_pipe, buffer_config};
         if (use_unfiltered_call_region_hints_for_filtering(components)) {
             buffered_rp.hint(extract_call_regions(*input_path));
@@ -1347,6 +1569,39 @@ public:
     CallingBug(const std::exception& e) : what_ {e.what()} {}
 };
 
+class UnfusableCallFilter : public ProgramError
+{
+    std::string do_where() const override { return "make_fused_call_filter"; }
+    std::string do_why() const override
+    {
+        return "Fused filtering was requested but the call filter cannot classify calls independently";
+    }
+};
+
+std::unique_ptr<VariantCallFilter> make_fused_call_filter(GenomeCallingComponents& components)
+{
+    if (!components.fused_filtering()) return nullptr;
+    // Reads are supplied by the calling tasks, so this read pipe only provides the samples
+    BufferedReadPipe buffered_rp {components.read_pipe(), {components.read_buffer_size()}};
+    VariantCallFilter::OutputOptions output_config {};
+    if (components.sites_only()) {
+        output_config.emit_sites_only = true;
+    }
+    // Each calling task filters its own calls, so the filter itself does not need any threads
+    auto result = components.call_filter_factory().make(components.reference(), std::move(buffered_rp),
+                                                        output_config, boost::none, 1);
+    if (!dynamic_cast<const SinglePassVariantCallFilter*>(result.get())) {
+        throw UnfusableCallFilter {};
+    }
+    return result;
+}
+
+FusedCallFilter get_single_pass_filter(const std::unique_ptr<VariantCallFilter>& filter)
+{
+    if (filter) return static_cast<const SinglePassVariantCallFilter&>(*filter);
+    return boost::none;
+}
+
 void run_octopus(GenomeCallingComponents& components, std::string command)
 {
     static auto debug_log = get_debug_log();
@@ -1354,11 +1609,12 @@ void run_octopus(GenomeCallingComponents& components, std::string command)
     using utils::TimeInterval;
     
     log_run_start(components);
-    write_caller_output_header(components, command);
+    const auto fused_call_filter = make_fused_call_filter(components);
+    write_caller_output_header(components, command, get_single_pass_filter(fused_call_filter));
     const auto start = std::chrono::system_clock::now();
     try {
         if (!components.filter_request()) {
-            run_calling(components);
+            run_calling(components, get_single_pass_filter(fused_call_filter));
         }
     } catch (const ProgramError& e) {
         try {
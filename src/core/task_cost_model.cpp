@@ -0,0 +1,154 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "task_cost_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace octopus {
+
+namespace {
+
+constexpr double minCostRatio {0.1}, maxCostRatio {100.0};
+constexpr double costRatioDecay {0.5};
+
+auto make_features(const GenomicRegion& region, const std::size_t num_reads) noexcept
+{
+    return std::array<double, 3> {static_cast<double>(num_reads), static_cast<double>(size(region)), 1.0};
+}
+
+// Solves Ax = b by Gaussian elimination with partial pivoting
+template <std::size_t N>
+boost::optional<std::array<double, N>> solve(std::array<std::array<double, N>, N> A, std::array<double, N> b)
+{
+    for (std::size_t col {0}; col < N; ++col) {
+        std::size_t pivot {col};
+        for (std::size_t row {col + 1}; row < N; ++row) {
+            if (std::abs(A[row][col]) > std::abs(A[pivot][col])) pivot = row;
+        }
+        if (A[pivot][col] == 0) return boost::none;
+        std::swap(A[col], A[pivot]);
+        std::swap(b[col], b[pivot]);
+        for (std::size_t row {col + 1}; row < N; ++row) {
+            const auto f = A[row][col] / A[col][col];
+            for (std::size_t k {col}; k < N; ++k) A[row][k] -= f * A[col][k];
+            b[row] -= f * b[col];
+        }
+    }
+    std::array<double, N> result;
+    for (std::size_t i {N}; i-- > 0;) {
+        auto x = b[i];
+        for (std::size_t k {i + 1}; k < N; ++k) x -= A[i][k] * result[k];
+        result[i] = x / A[i][i];
+    }
+    return result;
+}
+
+} // namespace
+
+void TaskCostModel::add(const GenomicRegion& region, const std::size_t num_reads, const Duration runtime)
+{
+    const auto x = make_features(region, num_reads);
+    const auto y = runtime.count();
+    std::lock_guard<std::mutex> lock {mutex_};
+    update_contig_ratio(region, x, y, false);
+    for (auto* density : {&read_density_, &contig_read_densities_[region.contig_id()]}) {
+        density->num_reads += num_reads;
+        density->num_bases += size(region);
+    }
+    for (std::size_t i {0}; i < numFeatures; ++i) {
+        for (std::size_t j {0}; j < numFeatures; ++j) {
+            xtx_[i][j] += x[i] * x[j];
+        }
+        xty_[i] += x[i] * y;
+    }
+    ++num_observations_;
+}
+
+void TaskCostModel::add_overrun(const GenomicRegion& region, const Duration elapsed)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto x = make_features(region, estimate_num_reads(region));
+    update_contig_ratio(region, x, elapsed.count(), true);
+}
+
+boost::optional<TaskCostModel::Duration>
+TaskCostModel::estimate(const GenomicRegion& region, const std::size_t num_reads) const
+{
+    const auto x = make_features(region, num_reads);
+    std::lock_guard<std::mutex> lock {mutex_};
+    auto result = estimate_global(x);
+    if (!result) return boost::none;
+    const auto ratio_itr = contig_cost_ratios_.find(region.contig_id());
+    if (ratio_itr != std::cend(contig_cost_ratios_)) {
+        *result *= ratio_itr->second;
+    }
+    return Duration {*result};
+}
+
+boost::optional<TaskCostModel::Duration> TaskCostModel::estimate(const GenomicRegion& region) const
+{
+    std::size_t num_reads;
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        num_reads = estimate_num_reads(region);
+    }
+    return estimate(region, num_reads);
+}
+
+std::size_t TaskCostModel::num_observations() const noexcept
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return num_observations_;
+}
+
+// private methods
+
+boost::optional<double> TaskCostModel::estimate_global(const Features& x) const
+{
+    if (num_observations_ < minObservations) return boost::none;
+    // A little ridge regularisation keeps the fit stable when the features are collinear
+    auto A = xtx_;
+    for (std::size_t i {0}; i < numFeatures; ++i) {
+        A[i][i] += 1e-6 * A[i][i] + 1e-9;
+    }
+    const auto coefficients = solve(A, xty_);
+    if (coefficients) {
+        double result {0};
+        for (std::size_t i {0}; i < numFeatures; ++i) result += (*coefficients)[i] * x[i];
+        if (std::isfinite(result) && result > 0) return result;
+    }
+    // Fall back to the mean runtime per read, or per task if no reads have been seen
+    const auto total_runtime = xty_[2], total_reads = xtx_[0][2];
+    if (total_reads > 0) return total_runtime / total_reads * x[0];
+    return total_runtime / num_observations_;
+}
+
+std::size_t TaskCostModel::estimate_num_reads(const GenomicRegion& region) const
+{
+    const auto density_itr = contig_read_densities_.find(region.contig_id());
+    const auto& density = density_itr != std::cend(contig_read_densities_) ? density_itr->second : read_density_;
+    if (density.num_bases == 0) return 0;
+    return static_cast<std::size_t>(density.num_reads / density.num_bases * size(region));
+}
+
+void TaskCostModel::update_contig_ratio(const GenomicRegion& region, const Features& x,
+                                        const double runtime, const bool lower_bound)
+{
+    const auto predicted = estimate_global(x);
+    if (!predicted || *predicted <= 0) return;
+    const auto observed_ratio = std::max(minCostRatio, std::min(runtime / *predicted, maxCostRatio));
+    const auto p = contig_cost_ratios_.emplace(region.contig_id(), observed_ratio);
+    if (!p.second) {
+        auto& ratio = p.first->second;
+        if (lower_bound) {
+            ratio = std::max(ratio, observed_ratio);
+        } else {
+            ratio = costRatioDecay * ratio + (1 - costRatioDecay) * observed_ratio;
+        }
+    }
+}
+
+} // namespace octopus
@@ -0,0 +1,84 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef task_cost_model_hpp
+#define task_cost_model_hpp
+
+#include <array>
+#include <unordered_map>
+#include <cstddef>
+#include <chrono>
+#include <mutex>
+
+#include <boost/optional.hpp>
+
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+/*
+    TaskCostModel predicts the runtime of calling a region from the runtimes of completed tasks.
+
+    The global model is a least squares fit of runtime = a * reads + b * size + c. Because cost
+    per read varies greatly along the genome (e.g. in segmental duplications), each contig also
+    keeps a moving average of the ratio of the observed to the predicted runtime of its recent
+    tasks, which scales the global prediction for that contig.
+
+    The read counts of completed tasks also give the read density of each contig, so the cost of
+    a region can be estimated before any of its reads are fetched.
+
+    All methods are thread safe.
+ */
+class TaskCostModel
+{
+public:
+    using Duration = std::chrono::duration<double>;
+
+    TaskCostModel() = default;
+
+    TaskCostModel(const TaskCostModel&)            = delete;
+    TaskCostModel& operator=(const TaskCostModel&) = delete;
+    TaskCostModel(TaskCostModel&&)                 = delete;
+    TaskCostModel& operator=(TaskCostModel&&)      = delete;
+
+    ~TaskCostModel() = default;
+
+    void add(const GenomicRegion& region, std::size_t num_reads, Duration runtime);
+
+    // Reports a task which is still running but has already run for elapsed
+    void add_overrun(const GenomicRegion& region, Duration elapsed);
+
+    // boost::none until enough tasks have been added to fit the model
+    boost::optional<Duration> estimate(const GenomicRegion& region, std::size_t num_reads) const;
+    // As above, but the number of reads in region is estimated from the read density of completed tasks
+    boost::optional<Duration> estimate(const GenomicRegion& region) const;
+
+    std::size_t num_observations() const noexcept;
+
+private:
+    static constexpr std::size_t numFeatures {3};
+    static constexpr std::size_t minObservations {8};
+
+    using Features = std::array<double, numFeatures>;
+
+    struct ReadDensity
+    {
+        double num_reads = 0, num_bases = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::array<Features, numFeatures> xtx_ = {};
+    Features xty_ = {};
+    std::size_t num_observations_ = 0;
+    std::unordered_map<GenomicRegion::ContigId, double> contig_cost_ratios_;
+    ReadDensity read_density_;
+    std::unordered_map<GenomicRegion::ContigId, ReadDensity> contig_read_densities_;
+
+    std::size_t estimate_num_reads(const GenomicRegion& region) const;
+    boost::optional<double> estimate_global(const Features& x) const;
+    void update_contig_ratio(const GenomicRegion& region, const Features& x, double runtime, bool lower_bound);
+};
+
+} // namespace octopus
+
+#endif
@@ -281,6 +281,7 @@ bool has_rhs_sandwich_insertion(const MappableFlatSet<Allele>& alleles, const Ge
 
 HaplotypeGenerator::HaplotypePacket HaplotypeGenerator::generate()
 {
+    profiling::StageTimer timer {profiling::Stage::haplotype_generation};
     if (alleles_.empty()) {
         return std::make_tuple(std::vector<Haplotype> {}, boost::none, boost::none);
     }
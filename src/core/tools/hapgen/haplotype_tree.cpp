@@ -9,21 +9,23 @@
 #include <cassert>
 #include <iostream>
 
-#include <boost/property_map/property_map.hpp>
-#include <boost/graph/breadth_first_search.hpp>
-#include <boost/graph/depth_first_search.hpp>
-#include <boost/graph/visitors.hpp>
-#include <boost/graph/copy.hpp>
-
 #include "io/reference/reference_genome.hpp"
 #include "utils/mappable_algorithms.hpp"
 
 namespace octopus { namespace coretools {
 
+constexpr std::uint32_t HaplotypeTree::null_id;
+
 HaplotypeTree::HaplotypeTree(const GenomicRegion::ContigName& contig, const ReferenceGenome& reference)
 : reference_ {reference}
-, tree_ {}
-, root_ {boost::add_vertex(tree_)}
+, nodes_ {}
+, free_nodes_ {}
+, num_nodes_ {0}
+, alleles_ {}
+, allele_use_counts_ {}
+, free_alleles_ {}
+, allele_ids_ {}
+, root_ {add_vertex(null_id)}
 , haplotype_leafs_ {root_}
 , contig_ {contig}
 , haplotype_leaf_cache_ {}
@@ -35,75 +37,38 @@ HaplotypeTree::HaplotypeTree(const GenomicRegion::ContigName& contig, const Refe
     }
 }
 
-namespace debug {
-
-template <typename G, typename V, typename Container>
-bool is_tree(const G& graph, const V& root, const Container& leafs);
-
-} // namespace debug
-
-namespace {
-
-template <typename Graph>
-bool is_empty(const Graph& g)
-{
-    return boost::num_vertices(g) == 0 && boost::num_edges(g) == 0;
-}
-
-template <typename Graph>
-auto copy_graph(const Graph& src, Graph& dst)
-{
-    assert(is_empty(dst));
-    using Vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
-    std::unordered_map<Vertex, std::size_t> index_map {};
-    index_map.reserve(boost::num_vertices(src));
-    const auto p = boost::vertices(src);
-    std::size_t i {0};
-    std::for_each(p.first, p.second, [&i, &index_map] (const Vertex& v) { index_map.emplace(v, i++); });
-    std::unordered_map<Vertex, Vertex> vertex_copy_map {};
-    vertex_copy_map.reserve(boost::num_vertices(src));
-    boost::copy_graph(src, dst,
-                      boost::vertex_index_map(boost::make_assoc_property_map(index_map))
-                      .orig_to_copy(boost::make_assoc_property_map(vertex_copy_map)));
-    assert(vertex_copy_map.size() == boost::num_vertices(src));
-    return vertex_copy_map;
-}
-
-template <typename Container, typename Map>
-void copy_leafs(const Container& src, Container& dst, const Map& vertex_copy_map)
-{
-    assert(dst.empty());
-    std::transform(std::cbegin(src), std::cend(src), std::back_inserter(dst),
-                   [&vertex_copy_map] (const auto& v) { return vertex_copy_map.at(v); });
-}
-
-} // namespace
-
 HaplotypeTree::HaplotypeTree(const HaplotypeTree& other)
 : reference_ {other.reference_}
-, tree_ {}
-, root_ {}
-, haplotype_leafs_ {}
+, nodes_ {other.nodes_}
+, free_nodes_ {other.free_nodes_}
+, num_nodes_ {other.num_nodes_}
+, alleles_ {other.alleles_}
+, allele_use_counts_ {other.allele_use_counts_}
+, free_alleles_ {other.free_alleles_}
+, allele_ids_ {other.allele_ids_}
+, root_ {other.root_}
+, haplotype_leafs_ {other.haplotype_leafs_}
 , contig_ {other.contig_}
 , haplotype_leaf_cache_ {}
-{
-    const auto vertex_copy_map = copy_graph(other.tree_, tree_);
-    root_ = vertex_copy_map.at(other.root_);
-    copy_leafs(other.haplotype_leafs_, haplotype_leafs_, vertex_copy_map);
-}
+, tree_region_ {}
+{}
 
 HaplotypeTree& HaplotypeTree::operator=(const HaplotypeTree& other)
 {
     if (&other == this) return *this;
-    tree_.clear();
-    haplotype_leafs_.clear();
+    reference_         = other.reference_;
+    nodes_             = other.nodes_;
+    free_nodes_        = other.free_nodes_;
+    num_nodes_         = other.num_nodes_;
+    alleles_           = other.alleles_;
+    allele_use_counts_ = other.allele_use_counts_;
+    free_alleles_      = other.free_alleles_;
+    allele_ids_        = other.allele_ids_;
+    root_              = other.root_;
+    haplotype_leafs_   = other.haplotype_leafs_;
+    contig_            = other.contig_;
     haplotype_leaf_cache_.clear();
-    reference_ = other.reference_;
-    contig_    = other.contig_;
-    const auto vertex_copy_map = copy_graph(other.tree_, tree_);
-    root_ = vertex_copy_map.at(other.root_);
-    copy_leafs(other.haplotype_leafs_, haplotype_leafs_, vertex_copy_map);
-    assert(debug::is_tree(tree_, root_, haplotype_leafs_));
+    tree_region_ = boost::none;
     return *this;
 }
 
@@ -173,46 +138,6 @@ HaplotypeTree& HaplotypeTree::extend(const Allele& allele)
     return extend(demote(allele));
 }
 
-template <typename Container, typename V>
-struct Splicer : public boost::default_dfs_visitor
-{
-    Splicer(const ContigAllele& allele, std::stack<V>& candidate_splice_sites, Container& splice_sites,
-            V root)
-    : allele_ {allele}
-    , candidate_splice_sites_ {candidate_splice_sites}
-    , splice_sites_ {splice_sites}
-    , root_ {root}
-    {}
-    
-    template <typename G>
-    void finish_vertex(const V v, const G& tree)
-    {
-        if (!candidate_splice_sites_.empty() && v == candidate_splice_sites_.top()) {
-            candidate_splice_sites_.pop();
-            if (v == root_ || is_after(allele_.get(), tree[v])) {
-                splice_sites_.push_back(v);
-            } else {
-                const auto u = *boost::inv_adjacent_vertices(v, tree).first;
-                if (candidate_splice_sites_.empty() || candidate_splice_sites_.top() != u) {
-                    candidate_splice_sites_.push(u);
-                }
-            }
-        }
-    }
-private:
-    std::reference_wrapper<const ContigAllele> allele_;
-    std::stack<V>& candidate_splice_sites_;
-    Container& splice_sites_;
-    V root_;
-};
-
-template <typename Container, typename V>
-auto make_splicer(const ContigAllele& allele, std::stack<V>& candidate_splice_sites,
-                  Container& splice_sites, V root)
-{
-    return Splicer<Container, V> {allele, candidate_splice_sites, splice_sites, root};
-}
-
 bool can_add_to_branch(const ContigAllele& new_allele, const ContigAllele& leaf)
 {
     return !are_adjacent(leaf, new_allele)
@@ -225,33 +150,55 @@ void HaplotypeTree::splice(const ContigAllele& allele)
         extend(allele);
         return;
     }
-    std::unordered_map<Vertex, boost::default_color_type> colours {};
-    colours.reserve(boost::num_vertices(tree_));
     std::deque<Vertex> splice_sites {};
     std::stack<Vertex> candidate_splice_sites {};
-    boost::depth_first_visit(tree_, root_,
-                             make_splicer(allele, candidate_splice_sites, splice_sites, root_),
-                             boost::make_assoc_property_map(colours),
-                             [&] (const Vertex v, const Tree& tree) -> bool {
-                                 if (v != root_ && (begins_before(allele, tree[v])
-                                                    || (begins_equal(allele, tree[v]) && !is_empty_region(tree[v])))) {
-                                     const auto p = boost::inv_adjacent_vertices(v, tree);
-                                     if (p.first != p.second) {
-                                         const auto u = *p.first;
-                                         if (candidate_splice_sites.empty() || candidate_splice_sites.top() != u) {
-                                             candidate_splice_sites.push(u);
-                                         }
-                                     }
-                                     return true;
-                                 } else {
-                                     return false;
-                                 }
-                             });
+    // Branches are not searched past alleles that come after the new allele; the parents of these
+    // are the candidate splice sites
+    const auto is_search_end = [&] (const Vertex v) {
+        if (v != root_ && (begins_before(allele, this->allele(v))
+                           || (begins_equal(allele, this->allele(v)) && !is_empty_region(this->allele(v))))) {
+            const auto u = nodes_[v].parent;
+            if (u != null_id && (candidate_splice_sites.empty() || candidate_splice_sites.top() != u)) {
+                candidate_splice_sites.push(u);
+            }
+            return true;
+        } else {
+            return false;
+        }
+    };
+    const auto finish_vertex = [&] (const Vertex v) {
+        if (!candidate_splice_sites.empty() && v == candidate_splice_sites.top()) {
+            candidate_splice_sites.pop();
+            if (v == root_ || is_after(allele, this->allele(v))) {
+                splice_sites.push_back(v);
+            } else {
+                const auto u = nodes_[v].parent;
+                if (candidate_splice_sites.empty() || candidate_splice_sites.top() != u) {
+                    candidate_splice_sites.push(u);
+                }
+            }
+        }
+    };
+    // Depth first, visiting children in insertion order; each entry is a vertex and its next child
+    std::vector<std::pair<Vertex, Vertex>> search_stack {};
+    search_stack.emplace_back(root_, is_search_end(root_) ? null_id : nodes_[root_].first_child);
+    while (!search_stack.empty()) {
+        auto& top = search_stack.back();
+        if (top.second != null_id) {
+            const auto v = top.second;
+            top.second = nodes_[v].next_sibling;
+            search_stack.emplace_back(v, is_search_end(v) ? null_id : nodes_[v].first_child);
+        } else {
+            const auto v = top.first;
+            search_stack.pop_back();
+            finish_vertex(v);
+        }
+    }
     assert(candidate_splice_sites.empty());
     for (const auto v : splice_sites) {
-        if (can_add_to_branch(allele, tree_[v])) {
-            const auto spliced = boost::add_vertex(allele, tree_);
-            boost::add_edge(v, spliced, tree_);
+        if (v == root_ || can_add_to_branch(allele, this->allele(v))) {
+            const auto spliced = add_vertex(allele);
+            add_edge(v, spliced);
             haplotype_leafs_.push_back(spliced);
         }
     }
@@ -272,16 +219,15 @@ GenomicRegion HaplotypeTree::encompassing_region() const
     if (is_empty()) {
         throw std::runtime_error {"HaplotypeTree::encompassing_region called on empty tree"};
     }
-    const auto p = boost::adjacent_vertices(root_, tree_);
-    const auto leftmost = *std::min_element(p.first, p.second,
-                                            [this] (const auto& lhs, const auto& rhs) {
-                                                return begins_before(tree_[lhs], tree_[rhs]);
-                                            });
+    auto leftmost = nodes_[root_].first_child;
+    for (auto v = nodes_[leftmost].next_sibling; v != null_id; v = nodes_[v].next_sibling) {
+        if (begins_before(allele(v), allele(leftmost))) leftmost = v;
+    }
     const auto rightmost = *std::max_element(std::cbegin(haplotype_leafs_), std::cend(haplotype_leafs_),
                                              [this] (const auto& lhs, const auto& rhs) {
-                                                 return ends_before(tree_[lhs], tree_[rhs]);
+                                                 return ends_before(allele(lhs), allele(rhs));
                                              });
-    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(tree_[leftmost], tree_[rightmost])};
+    tree_region_ = GenomicRegion {contig_, octopus::encompassing_region(allele(leftmost), allele(rightmost))};
     return *tree_region_;
 }
 
@@ -300,13 +246,13 @@ std::vector<Haplotype> HaplotypeTree::extract_haplotypes(const GenomicRegion& re
     haplotype_leaf_cache_.reserve(num_haplotypes());
     std::vector<Haplotype> result {};
     if (is_empty() || !overlaps(region, encompassing_region())) return result;
-    result.reserve(num_haplotypes());
-    for (const auto leaf : haplotype_leafs_) {
-        auto haplotype = extract_haplotype(leaf, region);
-        // recently retreived haplotypes are added to the cache as it is likely these
-        // are the haplotypes that will be pruned next
-        haplotype_leaf_cache_.emplace(haplotype, leaf);
-        result.push_back(std::move(haplotype));
+    result = extract_all_haplotypes(region);
+    assert(result.size() == haplotype_leafs_.size());
+    // recently retreived haplotypes are added to the cache as it is likely these
+    // are the haplotypes that will be pruned next
+    auto leaf_itr = std::cbegin(haplotype_leafs_);
+    for (const auto& haplotype : result) {
+        haplotype_leaf_cache_.emplace(haplotype, *leaf_itr++);
     }
     return result;
 }
@@ -430,57 +376,172 @@ void HaplotypeTree::clear() noexcept
 {
     haplotype_leaf_cache_.clear();
     haplotype_leafs_.clear();
-    tree_.clear();
-    root_ = boost::add_vertex(tree_);
+    nodes_.clear();
+    free_nodes_.clear();
+    num_nodes_ = 0;
+    alleles_.clear();
+    allele_use_counts_.clear();
+    free_alleles_.clear();
+    allele_ids_.clear();
+    root_ = add_vertex(null_id);
     haplotype_leafs_.push_back(root_);
     tree_region_ = boost::none;
 }
 
 // Private methods
 
+HaplotypeTree::AlleleId HaplotypeTree::acquire_allele(const ContigAllele& allele)
+{
+    const auto itr = allele_ids_.find(allele);
+    if (itr != std::cend(allele_ids_)) {
+        ++allele_use_counts_[itr->second];
+        return itr->second;
+    }
+    AlleleId result;
+    if (free_alleles_.empty()) {
+        result = static_cast<AlleleId>(alleles_.size());
+        alleles_.push_back(allele);
+        allele_use_counts_.push_back(1);
+    } else {
+        result = free_alleles_.back();
+        free_alleles_.pop_back();
+        alleles_[result] = allele;
+        allele_use_counts_[result] = 1;
+    }
+    allele_ids_.emplace(allele, result);
+    return result;
+}
+
+void HaplotypeTree::release_allele(const AlleleId id) noexcept
+{
+    if (id != null_id && --allele_use_counts_[id] == 0) {
+        allele_ids_.erase(alleles_[id]);
+        free_alleles_.push_back(id);
+    }
+}
+
+HaplotypeTree::Vertex HaplotypeTree::add_vertex(const AlleleId allele)
+{
+    if (allele != null_id) ++allele_use_counts_[allele];
+    const Node node {allele, null_id, null_id, null_id, null_id, null_id};
+    Vertex result;
+    if (free_nodes_.empty()) {
+        result = static_cast<Vertex>(nodes_.size());
+        nodes_.push_back(node);
+    } else {
+        result = free_nodes_.back();
+        free_nodes_.pop_back();
+        nodes_[result] = node;
+    }
+    ++num_nodes_;
+    return result;
+}
+
+HaplotypeTree::Vertex HaplotypeTree::add_vertex(const ContigAllele& allele)
+{
+    const auto id = acquire_allele(allele);
+    const auto result = add_vertex(id);
+    release_allele(id); // add_vertex took its own reference
+    return result;
+}
+
+void HaplotypeTree::remove_vertex(const Vertex v) noexcept
+{
+    assert(nodes_[v].parent == null_id && !has_children(v));
+    release_allele(nodes_[v].allele);
+    nodes_[v].allele = null_id;
+    free_nodes_.push_back(v);
+    --num_nodes_;
+}
+
+void HaplotypeTree::add_edge(const Vertex u, const Vertex v) noexcept
+{
+    assert(nodes_[v].parent == null_id);
+    auto& node = nodes_[v];
+    node.parent = u;
+    node.prev_sibling = nodes_[u].last_child;
+    node.next_sibling = null_id;
+    if (nodes_[u].last_child != null_id) {
+        nodes_[nodes_[u].last_child].next_sibling = v;
+    } else {
+        nodes_[u].first_child = v;
+    }
+    nodes_[u].last_child = v;
+}
+
+void HaplotypeTree::remove_edge(const Vertex u, const Vertex v) noexcept
+{
+    if (nodes_[v].parent != u) return;
+    auto& node = nodes_[v];
+    if (node.prev_sibling != null_id) {
+        nodes_[node.prev_sibling].next_sibling = node.next_sibling;
+    } else {
+        nodes_[u].first_child = node.next_sibling;
+    }
+    if (node.next_sibling != null_id) {
+        nodes_[node.next_sibling].prev_sibling = node.prev_sibling;
+    } else {
+        nodes_[u].last_child = node.prev_sibling;
+    }
+    node.parent = node.prev_sibling = node.next_sibling = null_id;
+}
+
+const ContigAllele& HaplotypeTree::allele(const Vertex v) const noexcept
+{
+    assert(nodes_[v].allele != null_id);
+    return alleles_[nodes_[v].allele];
+}
+
+bool HaplotypeTree::has_children(const Vertex v) const noexcept
+{
+    return nodes_[v].first_child != null_id;
+}
+
+std::size_t HaplotypeTree::num_vertices() const noexcept
+{
+    return num_nodes_;
+}
+
 HaplotypeTree::Vertex HaplotypeTree::get_previous_allele(const Vertex allele) const
 {
-    const auto p = boost::inv_adjacent_vertices(allele, tree_);
-    assert(std::distance(p.first, p.second) == 1);
-    return *p.first;
+    assert(nodes_[allele].parent != null_id);
+    return nodes_[allele].parent;
 }
 
 bool HaplotypeTree::is_bifurcating(const Vertex v) const
 {
-    return boost::out_degree(v, tree_) > 1;
+    return nodes_[v].first_child != nodes_[v].last_child;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::remove_forward(const Vertex u)
 {
-    const auto p = boost::adjacent_vertices(u, tree_);
-    assert(std::distance(p.first, p.second) == 1);
-    const auto v = *p.first;
-    boost::remove_edge(u, v, tree_);
-    boost::remove_vertex(u, tree_);
+    assert(has_children(u) && nodes_[u].first_child == nodes_[u].last_child);
+    const auto v = nodes_[u].first_child;
+    remove_edge(u, v);
+    remove_vertex(u);
     return v;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::remove_backward(const Vertex v)
 {
     const auto u = get_previous_allele(v);
-    boost::remove_edge(u, v, tree_);
-    boost::remove_vertex(v, tree_);
+    remove_edge(u, v);
+    remove_vertex(v);
     return u;
 }
 
 bool HaplotypeTree::allele_exists(Vertex leaf, const ContigAllele& allele) const
 {
-    const auto vertex_range = boost::adjacent_vertices(leaf, tree_);
-    return std::any_of(vertex_range.first, vertex_range.second,
-                       [this, &allele] (const Vertex vertex) {
-                           return tree_[vertex] == allele;
-                       });
+    for (auto v = nodes_[leaf].first_child; v != null_id; v = nodes_[v].next_sibling) {
+        if (this->allele(v) == allele) return true;
+    }
+    return false;
 }
 
 HaplotypeTree::Vertex HaplotypeTree::find_allele_before(Vertex v, const ContigAllele& allele) const
 {
-    while (v != root_ && overlaps(allele, tree_[v])) {
-        if (is_same_region(allele, tree_[v])) { // for insertions
+    while (v != root_ && overlaps(allele, this->allele(v))) {
+        if (is_same_region(allele, this->allele(v))) { // for insertions
             v = get_previous_allele(v);
             break;
         }
@@ -493,24 +554,24 @@ HaplotypeTree::LeafIterator
 HaplotypeTree::extend_haplotype(LeafIterator leaf_itr, const ContigAllele& new_allele)
 {
     if (*leaf_itr == root_) {
-        const auto new_leaf = boost::add_vertex(new_allele, tree_);
-        boost::add_edge(*leaf_itr, new_leaf, tree_);
+        const auto new_leaf = add_vertex(new_allele);
+        add_edge(*leaf_itr, new_leaf);
         leaf_itr = haplotype_leafs_.erase(leaf_itr);
         return haplotype_leafs_.insert(leaf_itr, new_leaf);
     }
-    const auto& leaf_allele = tree_[*leaf_itr];
+    const auto& leaf_allele = allele(*leaf_itr);
     if (can_add_to_branch(new_allele, leaf_allele)) {
         if (is_after(new_allele, leaf_allele)) {
-            const auto new_leaf = boost::add_vertex(new_allele, tree_);
-            boost::add_edge(*leaf_itr, new_leaf, tree_);
+            const auto new_leaf = add_vertex(new_allele);
+            add_edge(*leaf_itr, new_leaf);
             leaf_itr = haplotype_leafs_.erase(leaf_itr);
             leaf_itr = haplotype_leafs_.insert(leaf_itr, new_leaf);
-        } else if (overlaps(new_allele, tree_[*leaf_itr])) {
+        } else if (overlaps(new_allele, allele(*leaf_itr))) {
             const auto branch_point = find_allele_before(*leaf_itr, new_allele);
-            if ((branch_point == root_ || can_add_to_branch(new_allele, tree_[branch_point]))
+            if ((branch_point == root_ || can_add_to_branch(new_allele, allele(branch_point)))
                 && !allele_exists(branch_point, new_allele)) {
-                const auto new_leaf = boost::add_vertex(new_allele, tree_);
-                boost::add_edge(branch_point, new_leaf, tree_);
+                const auto new_leaf = add_vertex(new_allele);
+                add_edge(branch_point, new_leaf);
                 haplotype_leafs_.insert(leaf_itr, new_leaf);
             }
         }
@@ -518,44 +579,185 @@ HaplotypeTree::extend_haplotype(LeafIterator leaf_itr, const ContigAllele& new_a
     return leaf_itr;
 }
 
-Haplotype HaplotypeTree::extract_haplotype(Vertex leaf, const GenomicRegion& region) const
+// Appends the allele at v to the branch sequence and segments, filling any gap from the previous
+// allele, or from the start of the region if v is the first allele, with reference sequence.
+void HaplotypeTree::append(const Vertex v, const GenomicRegion& region,
+                           const Haplotype::NucleotideSequence& reference_sequence,
+                           Haplotype::NucleotideSequence& sequence, std::vector<BranchSegment>& segments) const
+{
+    const auto& v_allele = allele(v);
+    const auto region_begin = region.begin();
+    if (segments.empty()) {
+        sequence.append(reference_sequence, 0, v_allele.mapped_region().begin() - region_begin);
+    } else if (segments.back().region.end() != v_allele.mapped_region().begin()) {
+        const ContigRegion gap {segments.back().region.end(), v_allele.mapped_region().begin()};
+        sequence.append(reference_sequence, gap.begin() - region_begin, size(gap));
+        segments.push_back({gap, null_id});
+    }
+    sequence += v_allele.sequence();
+    segments.push_back({v_allele.mapped_region(), nodes_[v].allele});
+}
+
+Haplotype HaplotypeTree::make_haplotype(const GenomicRegion& region,
+                                        const Haplotype::NucleotideSequence& reference_sequence,
+                                        Haplotype::NucleotideSequence sequence,
+                                        const std::vector<BranchSegment>& segments) const
+{
+    std::vector<ContigAllele> explicit_alleles {};
+    if (segments.empty()) {
+        sequence = reference_sequence;
+    } else {
+        const auto rhs_offset = segments.back().region.end() - region.begin();
+        sequence.append(reference_sequence, rhs_offset, reference_sequence.size() - rhs_offset);
+        explicit_alleles.reserve(segments.size());
+        for (const auto& segment : segments) {
+            if (segment.allele != null_id) {
+                explicit_alleles.push_back(alleles_[segment.allele]);
+            } else {
+                explicit_alleles.emplace_back(segment.region, reference_sequence.substr(segment.region.begin() - region.begin(),
+                                                                                        size(segment.region)));
+            }
+        }
+    }
+    return Haplotype {region, std::move(explicit_alleles), std::move(sequence), reference_};
+}
+
+namespace {
+
+struct SearchFrame
+{
+    std::uint32_t vertex, next_child;
+    std::size_t sequence_size, num_segments;
+};
+
+} // namespace
+
+/*
+    Builds the haplotypes of all leaves with a single depth first pass over the tree. The branch
+    down to the current vertex is kept in one shared buffer that grows as the search descends
+    and is truncated as it returns, so the sequence of an internal vertex is built once however
+    many leaves it is shared by.
+    A haplotype includes the run of alleles, ending at the deepest allele contained in the
+    region, that are all contained in the region. Alleles along a branch are sorted and do not
+    overlap, so the alleles contained in the region are always one run and the buffer never
+    needs resetting.
+ */
+std::vector<Haplotype> HaplotypeTree::extract_all_haplotypes(const GenomicRegion& region) const
+{
+    std::vector<Haplotype> result {};
+    result.reserve(haplotype_leafs_.size());
+    const auto reference_sequence = reference_.get().fetch_sequence(region);
+    if (reference_sequence.size() != size(region)) {
+        for (const auto leaf : haplotype_leafs_) {
+            result.push_back(extract_haplotype(leaf, region));
+        }
+        return result;
+    }
+    std::vector<std::size_t> leaf_indices(nodes_.size(), haplotype_leafs_.size());
+    std::size_t leaf_idx {0};
+    for (const auto leaf : haplotype_leafs_) {
+        assert(leaf_indices[leaf] == haplotype_leafs_.size());
+        leaf_indices[leaf] = leaf_idx++;
+    }
+    std::vector<boost::optional<Haplotype>> haplotypes(haplotype_leafs_.size());
+    const auto& contig_region = region.contig_region();
+    Haplotype::NucleotideSequence sequence {};
+    sequence.reserve(reference_sequence.size());
+    std::vector<BranchSegment> segments {};
+    std::vector<SearchFrame> search_stack {};
+    search_stack.push_back({root_, nodes_[root_].first_child, 0, 0});
+    while (!search_stack.empty()) {
+        auto& top = search_stack.back();
+        if (top.next_child != null_id) {
+            const auto v = top.next_child;
+            top.next_child = nodes_[v].next_sibling;
+            const SearchFrame frame {v, nodes_[v].first_child, sequence.size(), segments.size()};
+            if (octopus::contains(contig_region, allele(v))) {
+                assert(segments.empty() || segments.back().allele == nodes_[nodes_[v].parent].allele);
+                append(v, region, reference_sequence, sequence, segments);
+            }
+            if (leaf_indices[v] < haplotypes.size()) {
+                haplotypes[leaf_indices[v]] = make_haplotype(region, reference_sequence, sequence, segments);
+            }
+            search_stack.push_back(frame);
+        } else {
+            sequence.resize(top.sequence_size);
+            segments.resize(top.num_segments);
+            search_stack.pop_back();
+        }
+    }
+    for (auto& haplotype : haplotypes) {
+        assert(haplotype);
+        result.push_back(std::move(*haplotype));
+    }
+    return result;
+}
+
+Haplotype HaplotypeTree::extract_haplotype(const Vertex leaf, const GenomicRegion& region) const
 {
+    const auto reference_sequence = reference_.get().fetch_sequence(region);
+    if (reference_sequence.size() == size(region)) {
+        return extract_haplotype(leaf, region, reference_sequence);
+    }
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
-        leaf = get_previous_allele(leaf);
+    auto v = leaf;
+    while (v != root_ && !contains(contig_region, allele(v))) {
+        v = get_previous_allele(v);
     }
     Haplotype::Builder result {region, reference_};
-    while (leaf != root_ && contains(contig_region, tree_[leaf])) {
-        result.push_front(tree_[leaf]);
-        leaf = get_previous_allele(leaf);
+    while (v != root_ && contains(contig_region, allele(v))) {
+        result.push_front(allele(v));
+        v = get_previous_allele(v);
     }
     return result.build();
 }
 
+Haplotype HaplotypeTree::extract_haplotype(Vertex leaf, const GenomicRegion& region,
+                                           const Haplotype::NucleotideSequence& reference_sequence) const
+{
+    const auto& contig_region = region.contig_region();
+    using octopus::contains;
+    while (leaf != root_ && !contains(contig_region, allele(leaf))) {
+        leaf = get_previous_allele(leaf);
+    }
+    std::deque<Vertex> branch {};
+    while (leaf != root_ && contains(contig_region, allele(leaf))) {
+        branch.push_front(leaf);
+        leaf = get_previous_allele(leaf);
+    }
+    Haplotype::NucleotideSequence sequence {};
+    sequence.reserve(reference_sequence.size());
+    std::vector<BranchSegment> segments {};
+    for (const auto v : branch) {
+        append(v, region, reference_sequence, sequence, segments);
+    }
+    return make_haplotype(region, reference_sequence, std::move(sequence), segments);
+}
+
 HaplotypeTree::HaplotypeLength HaplotypeTree::extract_haplotype_length(Vertex leaf, const GenomicRegion& region) const
 {
     const auto& contig_region = region.contig_region();
     using octopus::contains;
-    while (leaf != root_ && !contains(contig_region, tree_[leaf])) {
+    while (leaf != root_ && !contains(contig_region, allele(leaf))) {
         leaf = get_previous_allele(leaf);
     }
     if (leaf == root_) {
         return size(contig_region);
     }
-    HaplotypeLength result {right_overhang_size(contig_region, tree_[leaf])};
+    HaplotypeLength result {right_overhang_size(contig_region, allele(leaf))};
     auto prev_node = leaf;
     while (true) {
-        result += sequence_size(tree_[leaf]);
+        result += sequence_size(allele(leaf));
         prev_node = leaf;
         leaf = get_previous_allele(leaf);
-        if (leaf != root_ && contains(contig_region, tree_[leaf])) {
-            result += inner_distance(tree_[leaf], tree_[prev_node]);
+        if (leaf != root_ && contains(contig_region, allele(leaf))) {
+            result += inner_distance(allele(leaf), allele(prev_node));
         } else {
             break;
         }
     }
-    result += left_overhang_size(contig_region, tree_[prev_node]);
+    result += left_overhang_size(contig_region, allele(prev_node));
     return result;
 }
 
@@ -565,7 +767,7 @@ bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const
         return true;
     }
     while (leaf1 != root_) {
-        if (leaf2 == root_ || tree_[leaf1] != tree_[leaf2]) return false;
+        if (leaf2 == root_ || nodes_[leaf1].allele != nodes_[leaf2].allele) return false;
         leaf1 = get_previous_allele(leaf1);
         leaf2 = get_previous_allele(leaf2);
     }
@@ -574,11 +776,11 @@ bool HaplotypeTree::define_same_haplotype(Vertex leaf1, Vertex leaf2) const
 
 bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& haplotype) const
 {
-    if (leaf == root_ || !overlaps(tree_[leaf], contig_region(haplotype))) {
+    if (leaf == root_ || !overlaps(allele(leaf), contig_region(haplotype))) {
         return false;
     }
     while (leaf != root_) {
-        if (!haplotype.includes(tree_[leaf])) {
+        if (!haplotype.includes(allele(leaf))) {
             return false;
         }
         leaf = get_previous_allele(leaf);
@@ -589,7 +791,7 @@ bool HaplotypeTree::is_branch_exact_haplotype(Vertex leaf, const Haplotype& hapl
 bool HaplotypeTree::is_branch_equal_haplotype(const Vertex leaf, const Haplotype& haplotype) const
 {
     // TODO: check if this is quicker than calling Haplotype::contains for each ContigAllele
-    return leaf != root_ && overlaps(contig_region(haplotype), tree_[leaf])
+    return leaf != root_ && overlaps(contig_region(haplotype), allele(leaf))
             && extract_haplotype(leaf, haplotype.mapped_region()) == haplotype;
 }
 
@@ -616,7 +818,7 @@ HaplotypeTree::find_equal_haplotype_leaf(const LeafIterator first, const LeafIte
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear(const Vertex leaf, const ContigRegion& region)
 {
-    if (overlaps(region, tree_[leaf])) {
+    if (overlaps(region, allele(leaf))) {
         return clear_external(leaf, region);
     } else {
         return clear_internal(leaf, region);
@@ -626,25 +828,25 @@ HaplotypeTree::clear(const Vertex leaf, const ContigRegion& region)
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear_external(Vertex leaf, const ContigRegion& region)
 {
-    assert(boost::out_degree(leaf, tree_) == 0);
+    assert(!has_children(leaf));
     while (leaf != root_) {
-        if (boost::out_degree(leaf, tree_) > 0) {
+        if (has_children(leaf)) {
             return std::make_pair(leaf, false);
-        } else if (begins_before(tree_[leaf], region)) {
+        } else if (begins_before(allele(leaf), region)) {
             return std::make_pair(leaf, true);
         } else {
             leaf = remove_backward(leaf);
         }
     }
     // the root should only be indicated as a leaf node if there are no other nodes in the tree
-    return std::make_pair(leaf, boost::num_vertices(tree_) == 1);
+    return std::make_pair(leaf, num_vertices() == 1);
 }
 
 std::pair<HaplotypeTree::Vertex, bool>
 HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
 {
     // TODO: we can optimise this for cases where region overlaps the leftmost alleles in the tree
-    if (leaf == root_ || is_after(region, tree_[leaf])) {
+    if (leaf == root_ || is_after(region, allele(leaf))) {
         return std::make_pair(leaf, true);
     }
     Vertex current_allele {leaf}, allele_to_move {leaf};
@@ -652,7 +854,7 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
     bool is_bifurcating_branch {false};
     while (true) {
         current_allele = get_previous_allele(current_allele);
-        if (current_allele == root_ || overlaps(tree_[current_allele], region)) {
+        if (current_allele == root_ || overlaps(allele(current_allele), region)) {
             break;
         }
         is_bifurcating_branch = is_bifurcating_branch || is_bifurcating(current_allele);
@@ -663,26 +865,26 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
         }
     }
     if (alleles_to_copy.empty()) {
-        boost::remove_edge(current_allele, allele_to_move, tree_);
+        remove_edge(current_allele, allele_to_move);
     } else {
         assert(alleles_to_copy.back() != allele_to_move);
-        boost::remove_edge(alleles_to_copy.back(), allele_to_move, tree_);
+        remove_edge(alleles_to_copy.back(), allele_to_move);
     }
-    while (current_allele != root_ && overlaps(region, tree_[current_allele])) {
+    while (current_allele != root_ && overlaps(region, allele(current_allele))) {
         const auto previous_allele = get_previous_allele(current_allele);
-        is_bifurcating_branch = is_bifurcating_branch || boost::out_degree(current_allele, tree_) > 0;
+        is_bifurcating_branch = is_bifurcating_branch || has_children(current_allele);
         if (!is_bifurcating_branch) {
-            assert(boost::out_degree(current_allele, tree_) <= 1);
-            boost::remove_edge(previous_allele, current_allele, tree_);
-            boost::remove_vertex(current_allele, tree_);
+            assert(!is_bifurcating(current_allele));
+            remove_edge(previous_allele, current_allele);
+            remove_vertex(current_allele);
         }
         current_allele = previous_allele;
     }
     // Simpler to prepend onto the movable branch and then call that moveable than treat each separately
     std::for_each(std::crbegin(alleles_to_copy), std::crend(alleles_to_copy),
                   [this, &allele_to_move] (const Vertex allele) {
-                      const auto v = boost::add_vertex(tree_[allele], tree_);
-                      boost::add_edge(v, allele_to_move, tree_);
+                      const auto v = add_vertex(nodes_[allele].allele);
+                      add_edge(v, allele_to_move);
                       allele_to_move = v;
                   });
     alleles_to_copy.clear();
@@ -690,26 +892,25 @@ HaplotypeTree::clear_internal(const Vertex leaf, const ContigRegion& region)
     auto allele_to_move_to = current_allele;
     // Now avoid duplicate branches
     while (true) {
-        const auto vertex_range = boost::adjacent_vertices(allele_to_move_to, tree_);
-        const auto it = std::find_if(vertex_range.first, vertex_range.second,
-                                     [this, allele_to_move] (const Vertex allele) {
-                                         return tree_[allele] == tree_[allele_to_move];
-                                     });
-        if (it == vertex_range.second) break;
-        allele_to_move_to = *it; // i.e. move forward
-        if (boost::out_degree(allele_to_move, tree_) == 0) break;
+        auto it = nodes_[allele_to_move_to].first_child;
+        while (it != null_id && nodes_[it].allele != nodes_[allele_to_move].allele) {
+            it = nodes_[it].next_sibling;
+        }
+        if (it == null_id) break;
+        allele_to_move_to = it; // i.e. move forward
+        if (!has_children(allele_to_move)) break;
         // Safe to remove forward as we made this branch earlier via copies
         allele_to_move = remove_forward(allele_to_move);
     }
-    if (allele_to_move_to == root_ || tree_[allele_to_move_to] != tree_[allele_to_move]) {
-        boost::add_edge(allele_to_move_to, allele_to_move, tree_);
+    if (allele_to_move_to == root_ || nodes_[allele_to_move_to].allele != nodes_[allele_to_move].allele) {
+        add_edge(allele_to_move_to, allele_to_move);
         return std::make_pair(leaf, true);
     } else {
         // Ditch the entire copied branch as it's already in the tree
-        while (boost::out_degree(allele_to_move, tree_) > 0) {
+        while (has_children(allele_to_move)) {
             allele_to_move = remove_forward(allele_to_move);
         }
-        boost::remove_vertex(allele_to_move, tree_);
+        remove_vertex(allele_to_move);
         return std::make_pair(allele_to_move_to, false);
     }
 }
@@ -780,44 +981,5 @@ minmax_haplotype_lengths(const HaplotypeTree& tree, const GenomicRegion& region)
     }
 }
 
-namespace debug {
-
-template <typename G, typename V, typename Container>
-bool is_tree(const G& graph, const V& root, const Container& leafs)
-{
-    if (boost::num_vertices(graph) == 1) {
-        return *boost::vertices(graph).first == root;
-    }
-    std::unordered_set<V> visited_vertices {};
-    visited_vertices.reserve(boost::num_vertices(graph));
-    auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<V>(),
-                                                             std::inserter(visited_vertices,
-                                                                           std::begin(visited_vertices)),
-                                                             boost::on_discover_vertex()));
-    std::unordered_map<V, std::size_t> index_map {};
-    index_map.reserve(boost::num_vertices(graph));
-    const auto p = boost::vertices(graph);
-    std::size_t i {0};
-    std::for_each(p.first, p.second, [&i, &index_map] (const auto& v) { index_map.emplace(v, i++); });
-    boost::breadth_first_search(graph, root,
-                                boost::visitor(vis)
-                                .vertex_index_map(boost::make_assoc_property_map(index_map)));
-    if (visited_vertices.size() != boost::num_vertices(graph) || visited_vertices.count(root) == 0) {
-        return false;
-    }
-    return std::all_of(std::cbegin(leafs), std::cend(leafs),
-                       [&graph, &root] (auto v) {
-                           if (boost::out_degree(v, graph) != 0) return false;
-                           while (v != root) {
-                               const auto p = boost::inv_adjacent_vertices(v, graph);
-                               if (std::distance(p.first, p.second) != 1) return false;
-                               v = *p.first;
-                           }
-                           return true;
-                       });
-}
-
-} // namespace debug
-
 } // namespace coretools
 } // namespace octopus
@@ -14,9 +14,10 @@
 #include <algorithm>
 #include <type_traits>
 #include <cmath>
+#include <limits>
 #include <cstddef>
+#include <cstdint>
 
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/optional.hpp>
 
 #include "basics/genomic_region.hpp"
@@ -86,17 +87,30 @@ public:
     void clear() noexcept;
     
 private:
-    using Tree = boost::adjacency_list<
-        boost::listS, boost::listS, boost::bidirectionalS, ContigAllele, boost::no_property
-    >;
+    // Nodes live in a single arena and refer to each other by index. Each node stores a compact
+    // id into a table of unique alleles, so the many copies of the same allele found in a dense
+    // tree share storage and compare by id. Children are kept in insertion order.
+    using Vertex   = std::uint32_t;
+    using AlleleId = std::uint32_t;
     
-    using Vertex = boost::graph_traits<Tree>::vertex_descriptor;
-    using Edge   = boost::graph_traits<Tree>::edge_descriptor;
+    static constexpr std::uint32_t null_id = std::numeric_limits<std::uint32_t>::max();
+    
+    struct Node
+    {
+        AlleleId allele;
+        Vertex parent, first_child, last_child, prev_sibling, next_sibling;
+    };
     
     using HaplotypeVertexMultiMap = std::unordered_multimap<Haplotype, Vertex>;
     
     std::reference_wrapper<const ReferenceGenome> reference_;
-    Tree tree_;
+    std::vector<Node> nodes_;
+    std::vector<Vertex> free_nodes_;
+    std::size_t num_nodes_;
+    std::vector<ContigAllele> alleles_;
+    std::vector<unsigned> allele_use_counts_;
+    std::vector<AlleleId> free_alleles_;
+    std::unordered_map<ContigAllele, AlleleId> allele_ids_;
     Vertex root_;
     std::list<Vertex> haplotype_leafs_;
     GenomicRegion::ContigName contig_;
@@ -107,6 +121,23 @@ private:
     using LeafIterator  = decltype(haplotype_leafs_)::const_iterator;
     using CacheIterator = decltype(haplotype_leaf_cache_)::iterator;
     
+    // A piece of a haplotype branch; either a tree allele or the reference between two tree alleles
+    struct BranchSegment
+    {
+        ContigRegion region;
+        AlleleId allele;
+    };
+    
+    AlleleId acquire_allele(const ContigAllele& allele);
+    void release_allele(AlleleId id) noexcept;
+    Vertex add_vertex(AlleleId allele);
+    Vertex add_vertex(const ContigAllele& allele);
+    void remove_vertex(Vertex v) noexcept;
+    void add_edge(Vertex u, Vertex v) noexcept;
+    void remove_edge(Vertex u, Vertex v) noexcept;
+    const ContigAllele& allele(Vertex v) const noexcept;
+    bool has_children(Vertex v) const noexcept;
+    std::size_t num_vertices() const noexcept;
     bool is_bifurcating(Vertex v) const;
     Vertex remove_forward(Vertex u);
     Vertex remove_backward(Vertex v);
@@ -114,7 +145,14 @@ private:
     Vertex find_allele_before(Vertex v, const ContigAllele& allele) const;
     bool allele_exists(Vertex leaf, const ContigAllele& allele) const;
     LeafIterator extend_haplotype(LeafIterator leaf, const ContigAllele& new_allele);
+    void append(Vertex v, const GenomicRegion& region, const Haplotype::NucleotideSequence& reference_sequence,
+                Haplotype::NucleotideSequence& sequence, std::vector<BranchSegment>& segments) const;
+    Haplotype make_haplotype(const GenomicRegion& region, const Haplotype::NucleotideSequence& reference_sequence,
+                             Haplotype::NucleotideSequence sequence, const std::vector<BranchSegment>& segments) const;
+    std::vector<Haplotype> extract_all_haplotypes(const GenomicRegion& region) const;
     Haplotype extract_haplotype(Vertex leaf, const GenomicRegion& region) const;
+    Haplotype extract_haplotype(Vertex leaf, const GenomicRegion& region,
+                                const Haplotype::NucleotideSequence& reference_sequence) const;
     HaplotypeLength extract_haplotype_length(Vertex leaf, const GenomicRegion& region) const;
     bool define_same_haplotype(Vertex leaf1, Vertex leaf2) const;
     bool is_branch_exact_haplotype(Vertex branch_vertex, const Haplotype& haplotype) const;
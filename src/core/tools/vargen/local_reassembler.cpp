@@ -6,9 +6,9 @@
 #include <algorithm>
 #include <iterator>
 #include <deque>
+#include <unordered_map>
+#include <string>
 #include <stdexcept>
-#include <thread>
-#include <future>
 #include <cassert>
 
 #include "tandem/tandem.hpp"
@@ -20,9 +20,11 @@
 #include "utils/mappable_algorithms.hpp"
 #include "utils/sequence_utils.hpp"
 #include "utils/append.hpp"
+#include "utils/work_stealing_thread_pool.hpp"
 #include "io/reference/reference_genome.hpp"
 #include "logging/logging.hpp"
 #include "utils/global_aligner.hpp"
+#include "timers.hpp"
 
 namespace octopus { namespace coretools {
 
@@ -385,35 +387,27 @@ std::vector<Variant> LocalReassembler::do_generate_variants(const GenomicRegion&
                 stream(*debug_log_) << "Assembling " << bin.read_sequences.size()
                                     << " reads in bin " << mapped_region(bin);
             }
-            const auto num_default_failures = try_assemble_with_defaults(bin, candidates);
-            if (num_default_failures == default_kmer_sizes_.size()) {
-                try_assemble_with_fallbacks(bin, candidates);
-            }
+            assemble(bin, candidates);
             bin.clear();
         }
     } else {
-        const std::size_t num_threads {4};
-        std::vector<std::future<std::deque<Variant>>> bin_futures(std::min(num_bins, num_threads));
-        for (auto first_bin = std::begin(active_bins), last_bin = std::end(active_bins); first_bin != last_bin; ) {
-            const auto batch_size = std::min(num_threads, static_cast<std::size_t>(std::distance(first_bin, last_bin)));
-            const auto next_bin = std::next(first_bin, batch_size);
-            auto last_future = std::transform(first_bin, next_bin, std::begin(bin_futures), [&] (Bin& bin) {
-                if (debug_log_) {
-                    stream(*debug_log_) << "Assembling " << bin.read_sequences.size()
-                                            << " reads in bin " << mapped_region(bin);
-                }
-                return std::async([&] () {
-                    std::deque<Variant> result {};
-                    const auto num_default_failures = try_assemble_with_defaults(bin, result);
-                    if (num_default_failures == default_kmer_sizes_.size()) {
-                        try_assemble_with_fallbacks(bin, result);
-                    }
-                    bin.clear();
-                    return result;
-                });
-            });
-            std::for_each(std::begin(bin_futures), last_future, [&] (auto& f) { utils::append(f.get(), candidates); });
-            first_bin = next_bin;
+        // Bins are assembled by this thread together with any idle workers of the pool running it,
+        // so assembly stays within the global thread budget
+        std::vector<std::reference_wrapper<Bin>> bins(std::begin(active_bins), std::end(active_bins));
+        if (debug_log_) {
+            for (const Bin& bin : bins) {
+                stream(*debug_log_) << "Assembling " << bin.read_sequences.size()
+                                    << " reads in bin " << mapped_region(bin);
+            }
+        }
+        std::vector<std::deque<Variant>> bin_candidates(bins.size());
+        parallel_for(WorkStealingThreadPool::current(), bins.size(), [&] (const std::size_t i) {
+            auto& bin = bins[i].get();
+            assemble(bin, bin_candidates[i]);
+            bin.clear();
+        });
+        for (auto& bin_result : bin_candidates) {
+            utils::append(std::move(bin_result), candidates);
         }
     }
     bins_.clear();
@@ -501,7 +495,80 @@ void log_failure(L& log, const char* type, const unsigned k)
 
 } // namespace
 
-unsigned LocalReassembler::try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const
+unsigned LocalReassembler::max_kmer_size() const noexcept
+{
+    unsigned result {0};
+    if (!default_kmer_sizes_.empty()) result = default_kmer_sizes_.back();
+    if (!fallback_kmer_sizes_.empty()) result = std::max(result, fallback_kmer_sizes_.back());
+    return result;
+}
+
+namespace {
+
+struct SequenceReferenceHash
+{
+    std::size_t operator()(const std::reference_wrapper<const std::string> sequence) const noexcept
+    {
+        return std::hash<std::string> {}(sequence.get());
+    }
+};
+
+struct SequenceReferenceEqual
+{
+    bool operator()(const std::reference_wrapper<const std::string> lhs,
+                    const std::reference_wrapper<const std::string> rhs) const noexcept
+    {
+        return lhs.get() == rhs.get();
+    }
+};
+
+} // namespace
+
+LocalReassembler::BinIndex LocalReassembler::index_bin(const Bin& bin) const
+{
+    profiling::StageTimer timer {profiling::Stage::assembly};
+    BinIndex result {};
+    result.region = bin.region;
+    result.max_read_size = 0;
+    // Duplicate read sequences add nothing new to an assembly graph except weight, so each unique
+    // sequence only needs to be threaded once, with its count, for every kmer size.
+    std::unordered_map<std::reference_wrapper<const NucleotideSequence>, std::size_t,
+                       SequenceReferenceHash, SequenceReferenceEqual> sequence_indices {};
+    sequence_indices.reserve(bin.read_sequences.size());
+    result.read_sequences.reserve(bin.read_sequences.size());
+    for (const auto& sequence : bin.read_sequences) {
+        const auto p = sequence_indices.emplace(sequence, result.read_sequences.size());
+        if (p.second) {
+            result.read_sequences.emplace_back(sequence, 1);
+            result.max_read_size = std::max(result.max_read_size, sequence.get().size());
+        } else {
+            ++result.read_sequences[p.first->second].second;
+        }
+    }
+    // The assembler region grows with the kmer size, so the region for the largest kmer size
+    // contains the reference for all the others
+    result.reference_region = propose_assembler_region(bin.region, max_kmer_size());
+    result.reference_sequence = reference_.get().fetch_sequence(result.reference_region);
+    if (contains(result.reference_region, bin.region)
+        && result.reference_sequence.size() == size(result.reference_region)) {
+        const auto offset = begin_distance(result.reference_region, bin.region);
+        result.is_canonical_region = utils::is_canonical_dna(result.reference_sequence.substr(offset, size(bin.region)));
+    } else {
+        result.is_canonical_region = true;
+    }
+    return result;
+}
+
+void LocalReassembler::assemble(const Bin& bin, std::deque<Variant>& result) const
+{
+    const auto index = index_bin(bin);
+    const auto num_default_failures = try_assemble_with_defaults(index, result);
+    if (num_default_failures == default_kmer_sizes_.size()) {
+        try_assemble_with_fallbacks(index, result);
+    }
+}
+
+unsigned LocalReassembler::try_assemble_with_defaults(const BinIndex& bin, std::deque<Variant>& result) const
 {
     unsigned num_failures {0};
     for (const auto k : default_kmer_sizes_) {
@@ -522,7 +589,7 @@ unsigned LocalReassembler::try_assemble_with_defaults(const Bin& bin, std::deque
     return num_failures;
 }
 
-void LocalReassembler::try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result) const
+void LocalReassembler::try_assemble_with_fallbacks(const BinIndex& bin, std::deque<Variant>& result) const
 {
     auto prev_k = default_kmer_sizes_.back();
     for (const auto k : fallback_kmer_sizes_) {
@@ -567,18 +634,33 @@ GenomicRegion LocalReassembler::propose_assembler_region(const GenomicRegion& in
     }
 }
 
+LocalReassembler::NucleotideSequence
+LocalReassembler::fetch_reference(const BinIndex& bin, const GenomicRegion& region) const
+{
+    if (contains(bin.reference_region, region) && bin.reference_sequence.size() == size(bin.reference_region)) {
+        return bin.reference_sequence.substr(begin_distance(bin.reference_region, region), size(region));
+    } else {
+        return reference_.get().fetch_sequence(region);
+    }
+}
+
 LocalReassembler::AssemblerStatus
-LocalReassembler::assemble_bin(const unsigned kmer_size, const Bin& bin, std::deque<Variant>& result) const
+LocalReassembler::assemble_bin(const unsigned kmer_size, const BinIndex& bin, std::deque<Variant>& result) const
 {
-    if (bin.empty()) return AssemblerStatus::success;
+    if (bin.read_sequences.empty()) return AssemblerStatus::success;
+    profiling::StageTimer timer {profiling::Stage::assembly};
     const auto assemble_region = propose_assembler_region(bin.region, kmer_size);
     if (size(assemble_region) < kmer_size) return AssemblerStatus::failed;
-    const auto reference_sequence = reference_.get().fetch_sequence(assemble_region);
+    // Every assembler region contains the bin region
+    if (!bin.is_canonical_region) return AssemblerStatus::failed;
+    const auto reference_sequence = fetch_reference(bin, assemble_region);
     if (!utils::is_canonical_dna(reference_sequence)) return AssemblerStatus::failed;
     Assembler assembler {kmer_size, reference_sequence};
     if (assembler.is_unique_reference()) {
-        for (const auto& sequence : bin.read_sequences) {
-            assembler.insert_read(sequence);
+        if (bin.max_read_size >= kmer_size) {
+            for (const auto& p : bin.read_sequences) {
+                assembler.insert_read(p.first, p.second);
+            }
         }
         return try_assemble_region(assembler, reference_sequence, assemble_region, result);
     } else {
@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <utility>
 
 #include <boost/optional.hpp>
 
@@ -99,6 +100,20 @@ private:
         std::deque<std::reference_wrapper<const NucleotideSequence>> read_sequences;
     };
     
+    // Everything about a bin that does not depend on the kmer size. It is built with a single
+    // pass over the bin reads and shared by every assembler tried on the bin.
+    struct BinIndex
+    {
+        using CountedSequence = std::pair<std::reference_wrapper<const NucleotideSequence>, unsigned>;
+        
+        GenomicRegion region;
+        GenomicRegion reference_region;
+        NucleotideSequence reference_sequence;
+        bool is_canonical_region;
+        std::vector<CountedSequence> read_sequences; // unique, in first seen order
+        NucleotideSequence::size_type max_read_size;
+    };
+    
     enum class AssemblerStatus { success, partial_success, failed };
     
     ExecutionPolicy execution_policy_;
@@ -124,10 +139,14 @@ private:
     void prepare_bins(const GenomicRegion& active_region);
     bool should_assemble_bin(const Bin& bin) const;
     void finalise_bins();
-    unsigned try_assemble_with_defaults(const Bin& bin, std::deque<Variant>& result) const;
-    void try_assemble_with_fallbacks(const Bin& bin, std::deque<Variant>& result) const;
+    unsigned max_kmer_size() const noexcept;
+    BinIndex index_bin(const Bin& bin) const;
+    void assemble(const Bin& bin, std::deque<Variant>& result) const;
+    unsigned try_assemble_with_defaults(const BinIndex& bin, std::deque<Variant>& result) const;
+    void try_assemble_with_fallbacks(const BinIndex& bin, std::deque<Variant>& result) const;
     GenomicRegion propose_assembler_region(const GenomicRegion& input_region, unsigned kmer_size) const;
-    AssemblerStatus assemble_bin(unsigned kmer_size, const Bin& bin, std::deque<Variant>& result) const;
+    NucleotideSequence fetch_reference(const BinIndex& bin, const GenomicRegion& region) const;
+    AssemblerStatus assemble_bin(unsigned kmer_size, const BinIndex& bin, std::deque<Variant>& result) const;
     AssemblerStatus try_assemble_region(Assembler& assembler, const NucleotideSequence& reference_sequence,
                                         const GenomicRegion& reference_region, std::deque<Variant>& result) const;
 };
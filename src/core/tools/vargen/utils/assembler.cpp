@@ -6,20 +6,19 @@
 #include <iterator>
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cmath>
 #include <numeric>
 #include <limits>
 #include <cassert>
 #include <iostream>
 
-#include <boost/functional/hash.hpp>
 #include <boost/property_map/property_map.hpp>
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/breadth_first_search.hpp>
 #include <boost/graph/visitors.hpp>
 #include <boost/graph/dag_shortest_paths.hpp>
 #include <boost/graph/dominator_tree.hpp>
-#include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/graph_utility.hpp>
 #include <boost/graph/exception.hpp>
@@ -27,13 +26,10 @@
 
 #include "ksp/yen_ksp.hpp"
 
-#include "utils/sequence_utils.hpp"
 #include "utils/append.hpp"
 
 #include "timers.hpp"
 
-#define _unused(x) ((void)(x))
-
 namespace octopus { namespace coretools {
 
 namespace {
@@ -50,6 +46,38 @@ std::size_t count_kmers(const T& sequence, const unsigned kmer_size) noexcept
     return sequence.size() >= kmer_size ? sequence.size() - kmer_size + 1 : 0;
 }
 
+constexpr unsigned basesPerKmerWord {32};
+
+std::uint64_t make_first_word_mask(const unsigned kmer_size) noexcept
+{
+    const auto first_word_bases = kmer_size % basesPerKmerWord;
+    return first_word_bases == 0 ? ~std::uint64_t {0} : (std::uint64_t {1} << (2 * first_word_bases)) - 1;
+}
+
+constexpr std::array<char, 4> kmerBases {'A', 'C', 'G', 'T'};
+
+// Maps canonical bases to their 2-bit code and everything else to 4
+const std::array<std::uint8_t, 256> baseCodes = [] () {
+    std::array<std::uint8_t, 256> result {};
+    result.fill(4);
+    for (std::uint8_t code {0}; code < kmerBases.size(); ++code) {
+        result[static_cast<unsigned char>(kmerBases[code])] = code;
+    }
+    return result;
+}();
+
+// Shifts the packed kmer in src left by one base and appends the given base code into dst,
+// which may alias src.
+void shift_in(const std::uint64_t* src, std::uint64_t* dst, const unsigned num_words,
+              const std::uint64_t first_word_mask, const std::uint64_t base) noexcept
+{
+    for (unsigned w {0}; w + 1 < num_words; ++w) {
+        dst[w] = (src[w] << 2) | (src[w + 1] >> 62);
+    }
+    dst[num_words - 1] = (src[num_words - 1] << 2) | base;
+    dst[0] &= first_word_mask;
+}
+
 } // namespace
 
 // public methods
@@ -66,16 +94,17 @@ const char* Assembler::NonCanonicalReferenceSequence::what() const noexcept
 
 Assembler::Assembler(const unsigned kmer_size)
 : k_ {kmer_size}
-, reference_kmers_ {}
+, kmer_words_ {(kmer_size + basesPerKmerWord - 1) / basesPerKmerWord}
+, first_word_mask_ {make_first_word_mask(kmer_size)}
 , reference_head_position_ {0}
+, kmer_codes_ {}
+, kmer_table_ {}
+, num_kmers_ {0}
 , reference_vertices_ {}
 {}
 
 Assembler::Assembler(const unsigned kmer_size, const NucleotideSequence& reference)
-: k_ {kmer_size}
-, reference_kmers_ {}
-, reference_head_position_ {0}
-, reference_vertices_ {}
+: Assembler {kmer_size}
 {
     insert_reference_into_empty_graph(reference);
 }
@@ -90,7 +119,7 @@ void Assembler::insert_reference(const NucleotideSequence& sequence)
     if (sequence.size() >= k_) {
         if (is_empty()) {
             insert_reference_into_empty_graph(sequence);
-        } else if (reference_kmers_.empty()) {
+        } else if (reference_vertices_.empty()) {
             insert_reference_into_populated_graph(sequence);
         } else {
             throw std::runtime_error {"Assembler: only one reference sequence can be inserted into the graph"};
@@ -100,114 +129,95 @@ void Assembler::insert_reference(const NucleotideSequence& sequence)
     }
 }
 
-void Assembler::insert_read(const NucleotideSequence& sequence)
+void Assembler::insert_read(const NucleotideSequence& sequence, const unsigned count)
 {
     if (sequence.size() >= k_) {
-        auto kmer_begin = std::cbegin(sequence);
-        auto kmer_end   = std::next(kmer_begin, k_);
-        Kmer prev_kmer {kmer_begin, kmer_end};
-        bool prev_kmer_good {true};
-        auto vertex_itr = vertex_cache_.find(prev_kmer);
-        auto ref_kmer_itr = std::cbegin(reference_kmers_);
-        if (vertex_itr == std::cend(vertex_cache_)) {
-            const auto u = add_vertex(prev_kmer);
-            if (!u) prev_kmer_good = false;
-        } else if (is_reference(vertex_itr->second)) {
-            ref_kmer_itr = std::find(std::cbegin(reference_kmers_), std::cend(reference_kmers_), prev_kmer);
-            assert(ref_kmer_itr != std::cend(reference_kmers_));
-            auto next_kmer_begin = std::next(kmer_begin);
-            auto next_kmer_end   = std::next(kmer_end);
-            const auto ref_offset = std::distance(std::cbegin(reference_kmers_), ref_kmer_itr);
-            auto ref_vertex_itr = std::next(std::cbegin(reference_vertices_), ref_offset);
-            auto ref_edge_itr = std::next(std::cbegin(reference_edges_), ref_offset);
-            ++ref_kmer_itr;
-            for (; next_kmer_end <= std::cend(sequence) && ref_kmer_itr < std::cend(reference_kmers_);
-                   ++next_kmer_begin, ++next_kmer_end, ++ref_kmer_itr, ++ref_vertex_itr, ++ref_edge_itr) {
-                if (std::equal(next_kmer_begin, next_kmer_end, std::cbegin(*ref_kmer_itr))) {
-                    assert(ref_edge_itr != std::cend(reference_edges_));
-                    increment_weight(*ref_edge_itr);
+        const auto num_sequence_kmers = encode_kmers(sequence);
+        // Follows the reference path from the reference kmer at ref_idx for as long as the read
+        // kmers match, returning the index of the last matching read kmer.
+        const auto follow_reference = [&] (std::size_t kmer_idx, std::size_t& ref_idx) {
+            ++kmer_idx;
+            ++ref_idx;
+            for (; kmer_idx < num_sequence_kmers && ref_idx < reference_vertices_.size(); ++kmer_idx, ++ref_idx) {
+                if (is_sequence_kmer(kmer_idx, reference_vertices_[ref_idx])) {
+                    assert(ref_idx - 1 < reference_edges_.size());
+                    increment_weight(reference_edges_[ref_idx - 1], count);
                 } else {
                     break;
                 }
             }
-            if (next_kmer_end > std::cend(sequence)) {
+            return kmer_idx - 1;
+        };
+        std::size_t kmer_idx {0}, ref_idx {0};
+        Vertex prev_vertex {find_sequence_kmer(kmer_idx)};
+        bool prev_kmer_good {true};
+        if (prev_vertex == null_vertex()) {
+            const auto u = add_sequence_kmer(kmer_idx);
+            if (u) {
+                prev_vertex = *u;
+            } else {
+                prev_kmer_good = false;
+            }
+        } else if (is_reference(prev_vertex)) {
+            const auto ref_itr = std::find(std::cbegin(reference_vertices_), std::cend(reference_vertices_), prev_vertex);
+            assert(ref_itr != std::cend(reference_vertices_));
+            ref_idx = std::distance(std::cbegin(reference_vertices_), ref_itr);
+            kmer_idx = follow_reference(kmer_idx, ref_idx);
+            if (kmer_idx + 1 == num_sequence_kmers) {
                 return;
             }
-            kmer_begin = std::prev(next_kmer_begin);
-            kmer_end   = std::prev(next_kmer_end);
-            assert(kmer_end <= std::cend(sequence));
-            prev_kmer = Kmer {kmer_begin, kmer_end};
+            prev_vertex = reference_vertices_[ref_idx - 1];
         }
-        ++kmer_begin;
-        ++kmer_end;
-        for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-            Kmer kmer {kmer_begin, kmer_end};
-            const auto kmer_itr = vertex_cache_.find(kmer);
-            if (kmer_itr == std::cend(vertex_cache_)) {
-                const auto v = add_vertex(kmer);
-                if (v) {
+        ++kmer_idx;
+        for (; kmer_idx < num_sequence_kmers; ++kmer_idx) {
+            auto v = find_sequence_kmer(kmer_idx);
+            if (v == null_vertex()) {
+                const auto new_v = add_sequence_kmer(kmer_idx);
+                if (new_v) {
                     if (prev_kmer_good) {
-                        const auto u = vertex_cache_.at(prev_kmer);
-                        add_edge(u, *v, 1);
+                        add_edge(prev_vertex, *new_v, count);
                     }
+                    v = *new_v;
                     prev_kmer_good = true;
                 } else {
                     prev_kmer_good = false;
                 }
             } else {
                 if (prev_kmer_good) {
-                    const auto u = vertex_cache_.at(prev_kmer);
-                    const auto v = kmer_itr->second;
                     Edge e; bool e_in_graph;
-                    std::tie(e, e_in_graph) = boost::edge(u, v, graph_);
+                    std::tie(e, e_in_graph) = graph_.edge(prev_vertex, v);
                     if (e_in_graph) {
-                        increment_weight(e);
+                        increment_weight(e, count);
                     } else {
-                        add_edge(u, v, 1);
+                        add_edge(prev_vertex, v, count);
                     }
                 }
-                if (is_reference(kmer_itr->second)) {
-                    ref_kmer_itr = std::find(ref_kmer_itr, std::cend(reference_kmers_), kmer);
-                    if (ref_kmer_itr != std::cend(reference_kmers_)) {
-                        auto next_kmer_begin = std::next(kmer_begin);
-                        auto next_kmer_end   = std::next(kmer_end);
-                        const auto ref_offset = std::distance(std::cbegin(reference_kmers_), ref_kmer_itr);
-                        auto ref_vertex_itr = std::next(std::cbegin(reference_vertices_), ref_offset);
-                        auto ref_edge_itr = std::next(std::cbegin(reference_edges_), ref_offset);
-                        ++ref_kmer_itr;
-                        for (; next_kmer_end <= std::cend(sequence) && ref_kmer_itr < std::cend(reference_kmers_);
-                               ++next_kmer_begin, ++next_kmer_end, ++ref_kmer_itr, ++ref_vertex_itr, ++ref_edge_itr) {
-                            if (std::equal(next_kmer_begin, next_kmer_end, std::cbegin(*ref_kmer_itr))) {
-                                assert(ref_edge_itr != std::cend(reference_edges_));
-                                increment_weight(*ref_edge_itr);
-                            } else {
-                                break;
-                            }
-                        }
-                        if (next_kmer_end > std::cend(sequence)) {
+                if (is_reference(v)) {
+                    const auto ref_itr = std::find(std::next(std::cbegin(reference_vertices_), ref_idx), std::cend(reference_vertices_), v);
+                    ref_idx = std::distance(std::cbegin(reference_vertices_), ref_itr);
+                    if (ref_itr != std::cend(reference_vertices_)) {
+                        kmer_idx = follow_reference(kmer_idx, ref_idx);
+                        if (kmer_idx + 1 == num_sequence_kmers) {
                             return;
                         }
-                        kmer_begin = std::prev(next_kmer_begin);
-                        kmer_end   = std::prev(next_kmer_end);
-                        assert(kmer_end <= std::cend(sequence));
-                        kmer = Kmer {kmer_begin, kmer_end};
+                        v = reference_vertices_[ref_idx - 1];
                     }
                 }
                 prev_kmer_good = true;
             }
-            prev_kmer = kmer;
+            prev_vertex = v;
         }
     }
 }
 
 std::size_t Assembler::num_kmers() const noexcept
 {
-    return vertex_cache_.size();
+    return num_kmers_;
 }
 
 bool Assembler::is_empty() const noexcept
 {
-    return vertex_cache_.empty();
+    return num_kmers_ == 0;
 }
 
 bool Assembler::is_acyclic() const
@@ -222,7 +232,7 @@ void Assembler::remove_nonreference_cycles(bool break_chains)
 
 bool Assembler::is_all_reference() const
 {
-    const auto p = boost::edges(graph_);
+    const auto p = graph_.edges();
     return std::all_of(p.first, p.second, [this] (const Edge& e) { return is_reference(e); });
 }
 
@@ -233,7 +243,7 @@ bool Assembler::is_unique_reference() const
 
 void Assembler::try_recover_dangling_branches()
 {
-    const auto p = boost::vertices(graph_);
+    const auto p = graph_.vertices();
     std::for_each(p.first, p.second, [this] (const Vertex& v) {
         if (is_dangling_branch(v)) {
             const auto joining_kmer = find_joining_kmer(v);
@@ -254,11 +264,11 @@ void Assembler::cleanup()
     if (!is_reference_unique_path()) {
         throw NonUniqueReferenceSequence {};
     }
-    auto old_size = boost::num_vertices(graph_);
+    auto old_size = graph_.num_vertices();
     if (old_size < 2) return;
     assert(is_reference_unique_path());
     remove_disconnected_vertices();
-    auto new_size = boost::num_vertices(graph_);
+    auto new_size = graph_.num_vertices();
     if (new_size != old_size) {
         regenerate_vertex_indices();
         if (new_size < 2) return;
@@ -266,7 +276,7 @@ void Assembler::cleanup()
     }
     assert(is_reference_unique_path());
     remove_vertices_that_cant_be_reached_from(reference_head());
-    new_size = boost::num_vertices(graph_);
+    new_size = graph_.num_vertices();
     if (new_size != old_size) {
         regenerate_vertex_indices();
         if (new_size < 2) return;
@@ -274,7 +284,7 @@ void Assembler::cleanup()
     }
     assert(is_reference_unique_path());
     remove_vertices_past(reference_tail());
-    new_size = boost::num_vertices(graph_);
+    new_size = graph_.num_vertices();
     if (new_size != old_size) {
         regenerate_vertex_indices();
         if (new_size < 2) return;
@@ -282,7 +292,7 @@ void Assembler::cleanup()
     }
     assert(is_reference_unique_path());
     remove_vertices_that_cant_reach(reference_tail());
-    new_size = boost::num_vertices(graph_);
+    new_size = graph_.num_vertices();
     if (new_size != old_size) {
         regenerate_vertex_indices();
         if (new_size < 2) return;
@@ -295,9 +305,9 @@ void Assembler::cleanup()
         clear();
         return;
     }
-    new_size = boost::num_vertices(graph_);
+    new_size = graph_.num_vertices();
     assert(new_size != 0);
-    assert(!(boost::num_edges(graph_) == 0 && new_size > 1));
+    assert(!(graph_.num_edges() == 0 && new_size > 1));
     assert(is_reference_unique_path());
     if (new_size != old_size) {
         regenerate_vertex_indices();
@@ -307,9 +317,9 @@ void Assembler::cleanup()
 void Assembler::clear()
 {
     graph_.clear();
-    vertex_cache_.clear();
-    reference_kmers_.clear();
-    reference_kmers_.shrink_to_fit();
+    kmer_codes_.clear();
+    kmer_table_.clear();
+    num_kmers_ = 0;
     reference_vertices_.clear();
     reference_vertices_.shrink_to_fit();
     reference_edges_.clear();
@@ -364,97 +374,153 @@ void Assembler::write_dot(std::ostream& out) const
     boost::write_graphviz(out, graph_, vertex_writer, edge_writer, graph_writer);
 }
 
-// Kmer
-Assembler::Kmer::Kmer(SequenceIterator first, SequenceIterator last) noexcept
-: first_ {first}
-, last_ {last}
-, hash_ {boost::hash_range(first_, last_)}
-{}
+//
+// Assembler private methods
+//
+std::size_t Assembler::encode_kmers(const NucleotideSequence& sequence)
+{
+    const auto num_sequence_kmers = count_kmers(sequence, k_);
+    sequence_kmer_codes_.assign(std::max(num_sequence_kmers, std::size_t {1}) * kmer_words_, 0);
+    sequence_kmer_canonical_.assign(num_sequence_kmers, false);
+    auto code = sequence_kmer_codes_.data();
+    unsigned canonical_run {0};
+    for (std::size_t pos {0}; pos < sequence.size(); ++pos) {
+        auto base = baseCodes[static_cast<unsigned char>(sequence[pos])];
+        if (base < kmerBases.size()) {
+            ++canonical_run;
+        } else {
+            canonical_run = 0;
+            base = 0;
+        }
+        if (pos < k_) {
+            shift_in(code, code, kmer_words_, first_word_mask_, base);
+        } else {
+            shift_in(code, code + kmer_words_, kmer_words_, first_word_mask_, base);
+            code += kmer_words_;
+        }
+        if (pos + 1 >= k_) {
+            sequence_kmer_canonical_[pos + 1 - k_] = canonical_run >= k_;
+        }
+    }
+    return num_sequence_kmers;
+}
 
-char Assembler::Kmer::front() const noexcept
+const Assembler::KmerWord* Assembler::sequence_kmer_code(const std::size_t kmer_index) const noexcept
 {
-    return *first_;
+    return sequence_kmer_codes_.data() + kmer_index * kmer_words_;
 }
 
-char Assembler::Kmer::back() const noexcept
+bool Assembler::is_canonical_sequence_kmer(const std::size_t kmer_index) const noexcept
 {
-    return *std::prev(last_);
+    return sequence_kmer_canonical_[kmer_index];
 }
 
-Assembler::Kmer::SequenceIterator Assembler::Kmer::begin() const noexcept
+bool Assembler::is_sequence_kmer(const std::size_t kmer_index, const Vertex v) const noexcept
 {
-    return first_;
+    return is_canonical_sequence_kmer(kmer_index) && are_equal_kmers(sequence_kmer_code(kmer_index), kmer_code_of(v));
 }
 
-Assembler::Kmer::SequenceIterator Assembler::Kmer::end() const noexcept
+std::size_t Assembler::hash_kmer(const KmerWord* code) const noexcept
 {
-    return last_;
+    std::uint64_t result {0};
+    for (unsigned w {0}; w < kmer_words_; ++w) {
+        result = (result ^ code[w]) * 0x9E3779B97F4A7C15ull;
+        result ^= result >> 29;
+    }
+    return static_cast<std::size_t>(result);
 }
 
-Assembler::Kmer::operator NucleotideSequence() const
+bool Assembler::are_equal_kmers(const KmerWord* lhs, const KmerWord* rhs) const noexcept
 {
-    return NucleotideSequence {first_, last_};
+    return std::equal(lhs, lhs + kmer_words_, rhs);
 }
 
-std::size_t Assembler::Kmer::hash() const noexcept
+Assembler::Vertex Assembler::find_kmer(const KmerWord* code) const noexcept
 {
-    return hash_;
+    if (kmer_table_.empty()) return null_vertex();
+    const auto mask = kmer_table_.size() - 1;
+    for (auto slot = hash_kmer(code) & mask; kmer_table_[slot] != null_vertex(); slot = (slot + 1) & mask) {
+        if (are_equal_kmers(kmer_code_of(kmer_table_[slot]), code)) {
+            return kmer_table_[slot];
+        }
+    }
+    return null_vertex();
 }
 
-bool operator==(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
+Assembler::Vertex Assembler::find_sequence_kmer(const std::size_t kmer_index) const noexcept
 {
-    return std::equal(lhs.first_, lhs.last_, rhs.first_);
+    return is_canonical_sequence_kmer(kmer_index) ? find_kmer(sequence_kmer_code(kmer_index)) : null_vertex();
 }
 
-bool operator<(const Assembler::Kmer& lhs, const Assembler::Kmer& rhs) noexcept
+void Assembler::reserve_kmers(const std::size_t n)
 {
-    return std::lexicographical_compare(lhs.first_, lhs.last_, rhs.first_, rhs.last_);
+    std::size_t capacity {16};
+    while (capacity < 2 * n) capacity *= 2;
+    if (capacity > kmer_table_.size()) {
+        auto old_table = std::move(kmer_table_);
+        kmer_table_.assign(capacity, null_vertex());
+        for (const auto v : old_table) {
+            if (v != null_vertex()) index_kmer(v);
+        }
+    }
 }
-//
-// Assembler private methods
-//
+
+void Assembler::index_kmer(const Vertex v) noexcept
+{
+    assert(2 * num_kmers_ <= kmer_table_.size());
+    const auto mask = kmer_table_.size() - 1;
+    auto slot = hash_kmer(kmer_code_of(v)) & mask;
+    while (kmer_table_[slot] != null_vertex()) slot = (slot + 1) & mask;
+    kmer_table_[slot] = v;
+}
+
+void Assembler::unindex_kmer(const Vertex v) noexcept
+{
+    const auto mask = kmer_table_.size() - 1;
+    auto slot = hash_kmer(kmer_code_of(v)) & mask;
+    while (kmer_table_[slot] != v) {
+        assert(kmer_table_[slot] != null_vertex());
+        slot = (slot + 1) & mask;
+    }
+    // Backward shift deletion keeps probe sequences unbroken without tombstones
+    for (auto next = (slot + 1) & mask; kmer_table_[next] != null_vertex(); next = (next + 1) & mask) {
+        const auto home = hash_kmer(kmer_code_of(kmer_table_[next])) & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            kmer_table_[slot] = kmer_table_[next];
+            slot = next;
+        }
+    }
+    kmer_table_[slot] = null_vertex();
+}
+
 void Assembler::insert_reference_into_empty_graph(const NucleotideSequence& sequence)
 {
     assert(sequence.size() >= k_);
-    vertex_cache_.reserve(sequence.size() + std::pow(4, 5));
-    auto kmer_begin = std::cbegin(sequence);
-    auto kmer_end   = std::next(kmer_begin, k_);
-    reference_kmers_.emplace_back(kmer_begin, kmer_end);
-    if (!contains_kmer(reference_kmers_.back())) {
-        const auto u = add_vertex(reference_kmers_.back(), true);
-        if (!u) {
+    const auto num_reference_kmers = encode_kmers(sequence);
+    reserve_kmers(sequence.size() + std::pow(4, 5));
+    graph_.reserve(sequence.size() + std::pow(4, 5), sequence.size() + std::pow(4, 5));
+    auto u = find_sequence_kmer(0);
+    if (u == null_vertex()) {
+        const auto new_u = add_sequence_kmer(0, true);
+        if (!new_u) {
             throw NonCanonicalReferenceSequence {sequence};
         }
-        reference_vertices_.push_back(*u);
-    } else {
-        reference_vertices_.push_back(vertex_cache_.at(reference_kmers_.back()));
-    }
-    ++kmer_begin;
-    ++kmer_end;
-    for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-        reference_kmers_.emplace_back(kmer_begin, kmer_end);
-        const auto& kmer = reference_kmers_.back();
-        if (!contains_kmer(kmer)) {
-            const auto v = add_vertex(kmer, true);
-            if (v) {
-                reference_vertices_.push_back(*v);
-                const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-                const auto e = add_reference_edge(u, *v);
-                reference_edges_.push_back(e);
-            } else {
+        u = *new_u;
+    }
+    reference_vertices_.push_back(u);
+    for (std::size_t kmer_idx {1}; kmer_idx < num_reference_kmers; ++kmer_idx) {
+        auto v = find_sequence_kmer(kmer_idx);
+        if (v == null_vertex()) {
+            const auto new_v = add_sequence_kmer(kmer_idx, true);
+            if (!new_v) {
                 throw NonCanonicalReferenceSequence {sequence};
             }
-        } else {
-            const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-            const auto v = vertex_cache_.at(kmer);
-            reference_vertices_.push_back(v);
-            const auto e = add_reference_edge(u, v);
-            reference_edges_.push_back(e);
+            v = *new_v;
         }
+        reference_edges_.push_back(add_reference_edge(reference_vertices_.back(), v));
+        reference_vertices_.push_back(v);
     }
-    assert(reference_vertices_.size() == reference_kmers_.size());
     assert(reference_edges_.size() == reference_vertices_.size() - 1);
-    reference_kmers_.shrink_to_fit();
     reference_vertices_.shrink_to_fit();
     reference_edges_.shrink_to_fit();
 }
@@ -462,78 +528,57 @@ void Assembler::insert_reference_into_empty_graph(const NucleotideSequence& sequ
 void Assembler::insert_reference_into_populated_graph(const NucleotideSequence& sequence)
 {
     assert(sequence.size() >= k_);
-    assert(reference_kmers_.empty());
-    vertex_cache_.reserve(vertex_cache_.size() + sequence.size() + std::pow(4, 5));
-    auto kmer_begin = std::cbegin(sequence);
-    auto kmer_end   = std::next(kmer_begin, k_);
-    reference_kmers_.emplace_back(kmer_begin, kmer_end);
-    if (!contains_kmer(reference_kmers_.back())) {
-        const auto u = add_vertex(reference_kmers_.back(), true);
-        if (!u) {
+    assert(reference_vertices_.empty());
+    const auto num_reference_kmers = encode_kmers(sequence);
+    reserve_kmers(num_kmers_ + sequence.size() + std::pow(4, 5));
+    auto u = find_sequence_kmer(0);
+    if (u == null_vertex()) {
+        const auto new_u = add_sequence_kmer(0, true);
+        if (!new_u) {
             throw NonCanonicalReferenceSequence {sequence};
         }
-        reference_vertices_.push_back(*u);
+        u = *new_u;
     } else {
-        set_vertex_reference(reference_kmers_.back());
-        reference_vertices_.push_back(vertex_cache_.at(reference_kmers_.back()));
-    }
-    ++kmer_begin;
-    ++kmer_end;
-    for (; kmer_end <= std::cend(sequence); ++kmer_begin, ++kmer_end) {
-        reference_kmers_.emplace_back(kmer_begin, kmer_end);
-        if (!contains_kmer(reference_kmers_.back())) {
-            const auto v = add_vertex(reference_kmers_.back(), true);
-            if (v) {
-                reference_vertices_.push_back(*v);
-                const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-                const auto e = add_reference_edge(u, *v);
-                reference_edges_.push_back(e);
-            } else {
+        set_vertex_reference(u);
+    }
+    reference_vertices_.push_back(u);
+    for (std::size_t kmer_idx {1}; kmer_idx < num_reference_kmers; ++kmer_idx) {
+        const auto prev = reference_vertices_.back();
+        auto v = find_sequence_kmer(kmer_idx);
+        if (v == null_vertex()) {
+            const auto new_v = add_sequence_kmer(kmer_idx, true);
+            if (!new_v) {
                 throw NonCanonicalReferenceSequence {sequence};
             }
+            reference_vertices_.push_back(*new_v);
+            reference_edges_.push_back(add_reference_edge(prev, *new_v));
         } else {
-            const auto u = vertex_cache_.at(std::crbegin(reference_kmers_)[1]);
-            const auto v = vertex_cache_.at(reference_kmers_.back());
             reference_vertices_.push_back(v);
             set_vertex_reference(v);
             Edge e; bool e_in_graph;
-            std::tie(e, e_in_graph) = boost::edge(u, v, graph_);
+            std::tie(e, e_in_graph) = graph_.edge(prev, v);
             if (e_in_graph) {
                 set_edge_reference(e);
             } else {
-                e = add_reference_edge(u, v);
+                e = add_reference_edge(prev, v);
             }
             reference_edges_.push_back(e);
         }
     }
-    vertex_cache_.rehash(vertex_cache_.size());
-    reference_kmers_.shrink_to_fit();
     reference_vertices_.shrink_to_fit();
     reference_edges_.shrink_to_fit();
     regenerate_vertex_indices();
     reference_head_position_ = 0;
 }
 
-bool Assembler::contains_kmer(const Kmer& kmer) const noexcept
-{
-    return vertex_cache_.count(kmer) == 1;
-}
-
-std::size_t Assembler::count_kmer(const Kmer& kmer) const noexcept
-{
-    return vertex_cache_.count(kmer);
-}
-
 std::size_t Assembler::reference_size() const noexcept
 {
-    return sequence_length(reference_kmers_.size(), k_);
+    return sequence_length(reference_vertices_.size(), k_);
 }
 
 void Assembler::regenerate_vertex_indices()
 {
-    const auto p = boost::vertices(graph_);
-    unsigned idx {0};
-    std::for_each(p.first, p.second, [this, &idx] (Vertex v) { graph_[v].index = idx++; });
+    graph_.reindex();
 }
 
 bool Assembler::is_reference_unique_path() const
@@ -545,47 +590,56 @@ bool Assembler::is_reference_unique_path() const
         const auto tail = reference_tail();
         const auto is_reference_edge = [this] (const Edge e) { return is_reference(e); };
         while (u != tail) {
-            const auto p = boost::out_edges(u, graph_);
+            const auto p = graph_.out_edges(u);
             const auto itr = std::find_if(p.first, p.second, is_reference_edge);
             assert(itr != p.second);
             if (std::any_of(boost::next(itr), p.second, is_reference_edge)) {
                 return false;
             }
-            u = boost::target(*itr, graph_);
+            u = graph_.target(*itr);
         }
-        const auto p = boost::out_edges(tail, graph_);
+        const auto p = graph_.out_edges(tail);
         return std::none_of(p.first, p.second, is_reference_edge);
     }
 }
 
 Assembler::Vertex Assembler::null_vertex() const
 {
-    return boost::graph_traits<KmerGraph>::null_vertex();
+    return KmerGraph::null_vertex();
+}
+
+boost::optional<Assembler::Vertex> Assembler::add_sequence_kmer(const std::size_t kmer_index, const bool is_reference)
+{
+    if (!is_canonical_sequence_kmer(kmer_index)) return boost::none;
+    return add_vertex(sequence_kmer_code(kmer_index), is_reference);
 }
 
-boost::optional<Assembler::Vertex> Assembler::add_vertex(const Kmer& kmer, const bool is_reference)
+Assembler::Vertex Assembler::add_vertex(const KmerWord* code, const bool is_reference)
 {
-    if (!utils::is_canonical_dna(kmer)) return boost::none;
-    const auto u = boost::add_vertex({boost::num_vertices(graph_), kmer, is_reference}, graph_);
-    vertex_cache_.emplace(kmer, u);
+    assert(find_kmer(code) == null_vertex());
+    if (2 * (num_kmers_ + 1) > kmer_table_.size()) {
+        reserve_kmers(2 * (num_kmers_ + 1));
+    }
+    const auto u = graph_.add_vertex({is_reference});
+    assert(kmer_codes_.size() == u * kmer_words_);
+    kmer_codes_.insert(std::cend(kmer_codes_), code, code + kmer_words_);
+    index_kmer(u);
+    ++num_kmers_;
     return u;
 }
 
 void Assembler::remove_vertex(const Vertex v)
 {
-    const auto c = vertex_cache_.erase(kmer_of(v));
-    assert(c == 1);
-    _unused(c); // make production build happy
-    boost::remove_vertex(v, graph_);
+    assert(find_kmer(kmer_code_of(v)) == v);
+    unindex_kmer(v);
+    --num_kmers_;
+    graph_.remove_vertex(v);
 }
 
 void Assembler::clear_and_remove_vertex(const Vertex v)
 {
-    const auto c = vertex_cache_.erase(kmer_of(v));
-    assert(c == 1);
-    _unused(c); // make production build happy
-    boost::clear_vertex(v, graph_);
-    boost::remove_vertex(v, graph_);
+    graph_.clear_vertex(v);
+    remove_vertex(v);
 }
 
 void Assembler::clear_and_remove_all(const std::unordered_set<Vertex>& vertices)
@@ -599,7 +653,7 @@ Assembler::Edge Assembler::add_edge(const Vertex u, const Vertex v,
                                     const GraphEdge::WeightType weight,
                                     const bool is_reference, const bool is_artificial)
 {
-    return boost::add_edge(u, v, {weight, is_reference, is_artificial}, graph_).first;
+    return graph_.add_edge(u, v, {weight, is_reference, is_artificial}).first;
 }
 
 Assembler::Edge Assembler::add_reference_edge(const Vertex u, const Vertex v)
@@ -609,17 +663,17 @@ Assembler::Edge Assembler::add_reference_edge(const Vertex u, const Vertex v)
 
 void Assembler::remove_edge(const Vertex u, const Vertex v)
 {
-    boost::remove_edge(u, v, graph_);
+    graph_.remove_edge(u, v);
 }
 
 void Assembler::remove_edge(const Edge e)
 {
-    boost::remove_edge(e, graph_);
+    graph_.remove_edge(e);
 }
 
-void Assembler::increment_weight(const Edge e)
+void Assembler::increment_weight(const Edge e, const GraphEdge::WeightType amount)
 {
-    ++graph_[e].weight;
+    graph_[e].weight += amount;
 }
 
 void Assembler::set_vertex_reference(const Vertex v)
@@ -627,39 +681,31 @@ void Assembler::set_vertex_reference(const Vertex v)
     graph_[v].is_reference = true;
 }
 
-void Assembler::set_vertex_reference(const Kmer& kmer)
-{
-    set_vertex_reference(vertex_cache_.at(kmer));
-}
-
 void Assembler::set_edge_reference(const Edge e)
 {
     graph_[e].is_reference = true;
 }
 
-const Assembler::Kmer& Assembler::kmer_of(const Vertex v) const
-{
-    return graph_[v].kmer;
-}
-
-char Assembler::front_base_of(const Vertex v) const
+const Assembler::KmerWord* Assembler::kmer_code_of(const Vertex v) const noexcept
 {
-    return kmer_of(v).front();
+    return kmer_codes_.data() + static_cast<std::size_t>(v) * kmer_words_;
 }
 
-char Assembler::back_base_of(const Vertex v) const
+Assembler::NucleotideSequence Assembler::kmer_of(const Vertex v) const
 {
-    return kmer_of(v).back();
-}
-
-const Assembler::Kmer& Assembler::source_kmer_of(const Edge e) const
-{
-    return kmer_of(boost::source(e, graph_));
+    const auto code = kmer_code_of(v);
+    NucleotideSequence result(k_, 'N');
+    for (unsigned i {0}; i < k_; ++i) {
+        const auto offset = k_ - 1 - i; // from the last base
+        const auto word = code[kmer_words_ - 1 - offset / basesPerKmerWord];
+        result[i] = kmerBases[(word >> (2 * (offset % basesPerKmerWord))) & 3];
+    }
+    return result;
 }
 
-const Assembler::Kmer& Assembler::target_kmer_of(const Edge e) const
+char Assembler::back_base_of(const Vertex v) const noexcept
 {
-    return kmer_of(boost::target(e, graph_));
+    return kmerBases[kmer_code_of(v)[kmer_words_ - 1] & 3];
 }
 
 bool Assembler::is_reference(const Vertex v) const
@@ -669,12 +715,12 @@ bool Assembler::is_reference(const Vertex v) const
 
 bool Assembler::is_source_reference(const Edge e) const
 {
-    return is_reference(boost::source(e, graph_));
+    return is_reference(graph_.source(e));
 }
 
 bool Assembler::is_target_reference(const Edge e) const
 {
-    return is_reference(boost::target(e, graph_));
+    return is_reference(graph_.target(e));
 }
 
 bool Assembler::is_reference(const Edge e) const
@@ -704,43 +750,39 @@ Assembler::Vertex Assembler::reference_tail() const
 
 Assembler::Vertex Assembler::next_reference(const Vertex u) const
 {
-    const auto p = boost::out_edges(u, graph_);
+    const auto p = graph_.out_edges(u);
     const auto itr = std::find_if(p.first, p.second, [this] (const Edge e) { return is_reference(e); });
     assert(itr != p.second);
-    return boost::target(*itr, graph_);
+    return graph_.target(*itr);
 }
 
 Assembler::Vertex Assembler::prev_reference(const Vertex v) const
 {
-    const auto p = boost::in_edges(v, graph_);
+    const auto p = graph_.in_edges(v);
     const auto itr = std::find_if(p.first, p.second, [this] (const Edge e) { return is_reference(e); });
     assert(itr != p.second);
-    return boost::source(*itr, graph_);
+    return graph_.source(*itr);
 }
 
 std::size_t Assembler::num_reference_kmers() const
 {
-    const auto p = boost::vertices(graph_);
+    const auto p = graph_.vertices();
     return std::count_if(p.first, p.second, [this] (const Vertex& v) { return is_reference(v); });
 }
 
 bool Assembler::is_dangling_branch(const Vertex v) const
 {
-    return !is_reference(v) && boost::in_degree(v, graph_) > 0 && boost::out_degree(v, graph_) == 0;
+    return !is_reference(v) && graph_.in_degree(v) > 0 && graph_.out_degree(v) == 0;
 }
 
 boost::optional<Assembler::Vertex> Assembler::find_joining_kmer(const Vertex v) const
 {
-    const auto& kmer = kmer_of(v);
-    NucleotideSequence adjacent_kmer {std::next(std::cbegin(kmer)), std::cend(kmer)};
-    adjacent_kmer.resize(k_);
-    constexpr std::array<NucleotideSequence::value_type, 4> bases {'A', 'C', 'G', 'T'};
-    for (const auto base : bases) {
-        adjacent_kmer.back() = base;
-        const Kmer k {std::cbegin(adjacent_kmer), std::cend(adjacent_kmer)};
-        const auto itr = vertex_cache_.find(k);
-        if (itr != std::cend(vertex_cache_)) {
-            return itr->second;
+    std::vector<KmerWord> adjacent_kmer(kmer_words_);
+    for (std::uint64_t base {0}; base < kmerBases.size(); ++base) {
+        shift_in(kmer_code_of(v), adjacent_kmer.data(), kmer_words_, first_word_mask_, base);
+        const auto u = find_kmer(adjacent_kmer.data());
+        if (u != null_vertex()) {
+            return u;
         }
     }
     return boost::none;
@@ -750,7 +792,7 @@ Assembler::NucleotideSequence Assembler::make_sequence(const Path& path) const
 {
     assert(!path.empty());
     NucleotideSequence result(k_ + path.size() - 1, 'N');
-    const auto& first_kmer = kmer_of(path.front());
+    const auto first_kmer = kmer_of(path.front());
     auto itr = std::copy(std::cbegin(first_kmer), std::cend(first_kmer), std::begin(result));
     std::transform(std::next(std::cbegin(path)), std::cend(path), itr,
                   [this] (const Vertex v) { return back_base_of(v); });
@@ -768,12 +810,12 @@ Assembler::NucleotideSequence Assembler::make_reference(Vertex from, const Verte
     auto last = to;
     if (last == null) {
         if (from == reference_tail()) {
-            return static_cast<NucleotideSequence>(kmer_of(from));
+            return kmer_of(from);
         }
         last = reference_tail();
     }
     result.reserve(2 * k_);
-    const auto& first_kmer = kmer_of(from);
+    const auto first_kmer = kmer_of(from);
     result.assign(std::cbegin(first_kmer), std::cend(first_kmer));
     from = next_reference(from);
     while (from != last) {
@@ -795,7 +837,7 @@ void Assembler::remove_path(const std::deque<Vertex>& path)
     if (path.size() == 1) {
         clear_and_remove_vertex(path.front());
     } else {
-        remove_edge(*boost::in_edges(path.front(), graph_).first);
+        remove_edge(*graph_.in_edges(path.front()).first);
         auto prev = path.front();
         std::for_each(std::next(std::cbegin(path)), std::cend(path),
                       [this, &prev] (const Vertex v) {
@@ -803,14 +845,14 @@ void Assembler::remove_path(const std::deque<Vertex>& path)
                           remove_vertex(prev);
                           prev = v;
                       });
-        remove_edge(*boost::out_edges(path.back(), graph_).first);
+        remove_edge(*graph_.out_edges(path.back()).first);
         remove_vertex(path.back());
     }
 }
 
 bool Assembler::is_bridge(const Vertex v) const
 {
-    return boost::in_degree(v, graph_) == 1 && boost::out_degree(v, graph_) == 1;
+    return graph_.in_degree(v) == 1 && graph_.out_degree(v) == 1;
 }
 
 bool Assembler::is_reference_bridge(const Vertex v) const
@@ -842,7 +884,7 @@ bool Assembler::is_bridge(const Path& path) const
 std::pair<bool, Assembler::Vertex> Assembler::is_bridge_to_reference(Vertex from) const
 {
     while (is_bridge(from)) {
-        from = *boost::adjacent_vertices(from, graph_).first;
+        from = *graph_.adjacent_vertices(from).first;
         if (is_reference(from)) {
             return std::make_pair(true, from);
         }
@@ -852,12 +894,12 @@ std::pair<bool, Assembler::Vertex> Assembler::is_bridge_to_reference(Vertex from
 
 bool Assembler::joins_reference_only(const Vertex v) const
 {
-    return boost::out_degree(v, graph_) == 1 && is_reference(*boost::out_edges(v, graph_).first);
+    return graph_.out_degree(v) == 1 && is_reference(*graph_.out_edges(v).first);
 }
 
 bool Assembler::joins_reference_only(Path::const_iterator first, Path::const_iterator last) const
 {
-    const auto itr = std::find_if(first, last, [this] (Vertex v) { return is_reference(v) || boost::out_degree(v, graph_) != 1; });
+    const auto itr = std::find_if(first, last, [this] (Vertex v) { return is_reference(v) || graph_.out_degree(v) != 1; });
     return itr == last || is_reference(*itr);
 }
 
@@ -871,7 +913,7 @@ struct CycleDetector : public boost::default_dfs_visitor
     template <typename Graph>
     void back_edge(typename boost::graph_traits<Graph>::edge_descriptor e, const Graph& g)
     {
-        if (boost::source(e, g) != boost::target(e, g) || !allow_self_edges_) {
+        if (source(e, g) != target(e, g) || !allow_self_edges_) {
             throw CycleDetectedException {};
         }
     }
@@ -888,7 +930,7 @@ struct CyclicEdgeDetector : public boost::default_dfs_visitor
     template <typename Graph>
     void back_edge(typename boost::graph_traits<Graph>::edge_descriptor e, const Graph& g)
     {
-        if (boost::source(e, g) != boost::target(e, g) || include_self_edges_) {
+        if (source(e, g) != target(e, g) || include_self_edges_) {
             result_.push_back(e);
         }
     }
@@ -901,18 +943,18 @@ protected:
 
 bool Assembler::is_trivial_cycle(const Edge e) const
 {
-    return boost::source(e, graph_) == boost::target(e, graph_);
+    return graph_.source(e) == graph_.target(e);
 }
 
 bool Assembler::graph_has_trivial_cycle() const
 {
-    const auto p = boost::edges(graph_);
+    const auto p = graph_.edges();
     return std::any_of(p.first, p.second, [this] (const Edge& e) { return is_trivial_cycle(e); });
 }
 
 bool Assembler::graph_has_nontrivial_cycle() const
 {
-    const auto index_map = boost::get(&GraphNode::index, graph_);
+    const auto index_map = graph_.vertex_index_map();
     try {
         boost::depth_first_search(graph_, boost::visitor(CycleDetector {}).root_vertex(reference_head()).vertex_index_map(index_map));
         return false;
@@ -923,12 +965,12 @@ bool Assembler::graph_has_nontrivial_cycle() const
 
 void Assembler::remove_trivial_nonreference_cycles()
 {
-    boost::remove_edge_if([this] (const Edge e) { return !is_reference(e) && is_trivial_cycle(e); }, graph_);
+    graph_.remove_edge_if([this] (const Edge e) { return !is_reference(e) && is_trivial_cycle(e); });
 }
 
 void Assembler::remove_nontrivial_nonreference_cycles()
 {
-    const auto index_map = boost::get(&GraphNode::index, graph_);
+    const auto index_map = graph_.vertex_index_map();
     std::deque<Edge> cyclic_edges {};
     CyclicEdgeDetector<decltype(cyclic_edges)> vis {cyclic_edges, false};
     boost::depth_first_search(graph_, boost::visitor(vis).root_vertex(reference_head()).vertex_index_map(index_map));
@@ -941,7 +983,7 @@ void Assembler::remove_nontrivial_nonreference_cycles()
 
 void Assembler::remove_all_nonreference_cycles(const bool break_chains)
 {
-    const auto index_map = boost::get(&GraphNode::index, graph_);
+    const auto index_map = graph_.vertex_index_map();
     std::deque<Edge> cyclic_edges {};
     CyclicEdgeDetector<decltype(cyclic_edges)> vis {cyclic_edges};
     boost::depth_first_search(graph_, boost::visitor(vis).root_vertex(reference_head()).vertex_index_map(index_map));
@@ -955,10 +997,10 @@ void Assembler::remove_all_nonreference_cycles(const bool break_chains)
     for (const Edge& back_edge : cyclic_edges) {
         if (!is_reference(back_edge)) {
             if (break_chains) {
-                Vertex cycle_origin {boost::source(back_edge, graph_)};
+                Vertex cycle_origin {graph_.source(back_edge)};
                 while (!is_reference(cycle_origin) && is_bridge(cycle_origin) && bad_kmers.count(cycle_origin) == 0) {
                     bad_kmers.insert(cycle_origin);
-                    cycle_origin = *boost::inv_adjacent_vertices(cycle_origin, graph_).first;
+                    cycle_origin = *graph_.inv_adjacent_vertices(cycle_origin).first;
                 }
                 bool refererence_origin {false};
                 if (is_reference(cycle_origin)) {
@@ -967,26 +1009,26 @@ void Assembler::remove_all_nonreference_cycles(const bool break_chains)
                 } else {
                     bad_kmers.insert(cycle_origin);
                 }
-                Vertex cycle_sink {boost::target(back_edge, graph_)};
+                Vertex cycle_sink {graph_.target(back_edge)};
                 while (!is_reference(cycle_sink) && is_bridge(cycle_sink) && bad_kmers.count(cycle_sink) == 0) {
                     bad_kmers.insert(cycle_origin);
-                    cycle_sink = *boost::adjacent_vertices(cycle_sink, graph_).first;
+                    cycle_sink = *graph_.adjacent_vertices(cycle_sink).first;
                 }
                 if (is_reference(cycle_sink)) {
                     reference_sinks.insert(cycle_sink);
                     if (refererence_origin) {
                         cyclic_reference_segments.emplace_back(cycle_sink, cycle_origin);
-                    } else if (boost::out_degree(cycle_origin, graph_) > 1) {
-                        const auto p = boost::out_edges(cycle_origin, graph_);
+                    } else if (graph_.out_degree(cycle_origin) > 1) {
+                        const auto p = graph_.out_edges(cycle_origin);
                         std::vector<Vertex> reference_tails {};
                         reference_tails.reserve(std::distance(p.first, p.second));
                         std::for_each(p.first, p.second, [&] (Edge tail_edge) {
                             if (tail_edge != back_edge) {
-                                auto tail = boost::target(tail_edge, graph_);
-                                while (!is_reference(tail) && boost::out_degree(tail, graph_) == 1
+                                auto tail = graph_.target(tail_edge);
+                                while (!is_reference(tail) && graph_.out_degree(tail) == 1
                                        && bad_kmers.count(tail) == 0) {
                                     bad_kmers.insert(tail);
-                                    tail = *boost::adjacent_vertices(tail, graph_).first;
+                                    tail = *graph_.adjacent_vertices(tail).first;
                                 }
                                 if (is_reference(tail)) {
                                     reference_tails.push_back(tail);
@@ -997,7 +1039,7 @@ void Assembler::remove_all_nonreference_cycles(const bool break_chains)
                             if (reference_tails.size() == 1) {
                                 const auto& cycle_tail = reference_tails.front();
                                 Edge e; bool present;
-                                std::tie(e, present) = boost::edge(cycle_origin, cycle_tail, graph_);
+                                std::tie(e, present) = graph_.edge(cycle_origin, cycle_tail);
                                 if (!present) {
                                     cyclic_reference_segments.emplace_back(cycle_sink, cycle_tail);
                                 } else {
@@ -1021,11 +1063,11 @@ void Assembler::remove_all_nonreference_cycles(const bool break_chains)
     }
     bool regenerate_indices {false};
     for (Vertex v : reference_origins) {
-        boost::remove_in_edge_if(v, [this] (Edge e) { return !is_reference(e); }, graph_);
+        graph_.remove_in_edge_if(v, [this] (Edge e) { return !is_reference(e); });
         regenerate_indices = true;
     }
     for (Vertex v : reference_sinks) {
-        boost::remove_out_edge_if(v, [this] (Edge e) { return !is_reference(e); }, graph_);
+        graph_.remove_out_edge_if(v, [this] (Edge e) { return !is_reference(e); });
         regenerate_indices = true;
     }
     if (!bad_kmers.empty()) {
@@ -1039,8 +1081,8 @@ void Assembler::remove_all_nonreference_cycles(const bool break_chains)
             const auto last_vertex_itr  = std::find(first_vertex_itr, std::cend(reference_vertices_), p.second);
             assert(last_vertex_itr != std::cend(reference_vertices_));
             std::for_each(first_vertex_itr, last_vertex_itr, [this] (Vertex v) {
-                boost::remove_in_edge_if(v, [this] (Edge e) { return !is_reference(e); }, graph_);
-                boost::remove_out_edge_if(v, [this] (Edge e) { return !is_reference(e); }, graph_);
+                graph_.remove_in_edge_if(v, [this] (Edge e) { return !is_reference(e); });
+                graph_.remove_out_edge_if(v, [this] (Edge e) { return !is_reference(e); });
             });
         }
         regenerate_indices = true;
@@ -1063,7 +1105,7 @@ bool Assembler::is_on_path(const Edge e, const Path& path) const
     const auto last_vertex = std::cend(path);
     Edge path_edge; bool good;
     for (; next_vertex != last_vertex; ++first_vertex, ++next_vertex) {
-        std::tie(path_edge, good) = boost::edge(*first_vertex, *next_vertex, graph_);
+        std::tie(path_edge, good) = graph_.edge(*first_vertex, *next_vertex);
         assert(good);
         if (path_edge == e) return true;
     }
@@ -1072,7 +1114,7 @@ bool Assembler::is_on_path(const Edge e, const Path& path) const
 
 bool Assembler::connects_to_path(Edge e, const Path& path) const
 {
-    return e == *boost::in_edges(path.front(), graph_).first || e == *boost::out_edges(path.back(), graph_).first;
+    return e == *graph_.in_edges(path.front()).first || e == *graph_.out_edges(path.back()).first;
 }
 
 bool Assembler::is_dependent_on_path(Edge e, const Path& path) const
@@ -1088,7 +1130,7 @@ Assembler::GraphEdge::WeightType Assembler::weight(const Path& path) const
                               std::plus<> {},
                               [this] (const auto& u, const auto& v) {
                                   Edge e; bool good;
-                                  std::tie(e, good) = boost::edge(u, v, graph_);
+                                  std::tie(e, good) = graph_.edge(u, v);
                                   assert(good);
                                   return graph_[e].weight;
                               });
@@ -1100,7 +1142,7 @@ unsigned Assembler::count_low_weights(const Path& path, const unsigned low_weigh
     return std::inner_product(std::cbegin(path), std::prev(std::cend(path)), std::next(std::cbegin(path)), 0u, std::plus<> {},
                               [this, low_weight] (const auto& u, const auto& v) {
                                   Edge e; bool good;
-                                  std::tie(e, good) = boost::edge(u, v, graph_);
+                                  std::tie(e, good) = graph_.edge(u, v);
                                   assert(good);
                                   return graph_[e].weight <= low_weight ? 1 : 0;
                               });
@@ -1110,10 +1152,10 @@ bool Assembler::has_low_weight_flanks(const Path& path, const unsigned low_weigh
 {
     if (path.size() < 2) return false;
     Edge e; bool good;
-    std::tie(e, good) = boost::edge(path[0], path[1], graph_);
+    std::tie(e, good) = graph_.edge(path[0], path[1]);
     assert(good);
     if (graph_[e].weight <= low_weight) return true;
-    std::tie(e, good) = boost::edge(std::crbegin(path)[1], std::crbegin(path)[0], graph_);
+    std::tie(e, good) = graph_.edge(std::crbegin(path)[1], std::crbegin(path)[0]);
     assert(good);
     return graph_[e].weight <= low_weight;
 }
@@ -1123,7 +1165,7 @@ unsigned Assembler::count_low_weight_flanks(const Path& path, unsigned low_weigh
     if (path.size() < 2) return 0;
     const auto is_low_weight = [this, low_weight] (const auto& u, const auto& v) {
         Edge e; bool good;
-        std::tie(e, good) = boost::edge(u, v, graph_);
+        std::tie(e, good) = graph_.edge(u, v);
         assert(good);
         return graph_[e].weight > low_weight ? 1 : 0;
     };
@@ -1139,7 +1181,7 @@ unsigned Assembler::count_low_weight_flanks(const Path& path, unsigned low_weigh
 
 Assembler::GraphEdge::WeightType Assembler::sum_source_in_edge_weight(const Edge e) const
 {
-    const auto p = boost::in_edges(boost::source(e, graph_), graph_);
+    const auto p = graph_.in_edges(graph_.source(e));
     using Weight = GraphEdge::WeightType;
     return std::accumulate(p.first, p.second, Weight {0},
                            [this] (const Weight curr, const Edge& e) {
@@ -1149,7 +1191,7 @@ Assembler::GraphEdge::WeightType Assembler::sum_source_in_edge_weight(const Edge
 
 Assembler::GraphEdge::WeightType Assembler::sum_target_out_edge_weight(const Edge e) const
 {
-    const auto p = boost::out_edges(boost::target(e, graph_), graph_);
+    const auto p = graph_.out_edges(graph_.target(e));
     using Weight = GraphEdge::WeightType;
     return std::accumulate(p.first, p.second, Weight {0},
                            [this] (const Weight curr, const Edge& e) {
@@ -1159,13 +1201,13 @@ Assembler::GraphEdge::WeightType Assembler::sum_target_out_edge_weight(const Edg
 
 bool Assembler::all_in_edges_low_weight(Vertex v, unsigned min_weight) const
 {
-    const auto p = boost::in_edges(v, graph_);
+    const auto p = graph_.in_edges(v);
     return std::all_of(p.first, p.second, [this, min_weight] (Edge e) { return graph_[e].weight < min_weight; });
 }
 
 bool Assembler::all_out_edges_low_weight(Vertex v, unsigned min_weight) const
 {
-    const auto p = boost::out_edges(v, graph_);
+    const auto p = graph_.out_edges(v);
     return std::all_of(p.first, p.second, [this, min_weight] (Edge e) { return graph_[e].weight < min_weight; });
 }
 
@@ -1176,14 +1218,14 @@ bool Assembler::is_low_weight(const Vertex v, const unsigned min_weight) const
 
 std::size_t Assembler::low_weight_out_degree(Vertex v, unsigned min_weight) const
 {
-    const auto p = boost::out_edges(v, graph_);
+    const auto p = graph_.out_edges(v);
     const auto d = std::count_if(p.first, p.second, [this, min_weight] (Edge e) { return graph_[e].weight < min_weight; });
     return static_cast<std::size_t>(d);
 }
 
 std::size_t Assembler::low_weight_in_degree(Vertex v, unsigned min_weight) const
 {
-    const auto p = boost::in_edges(v, graph_);
+    const auto p = graph_.in_edges(v);
     const auto d = std::count_if(p.first, p.second, [this, min_weight] (Edge e) { return graph_[e].weight < min_weight; });
     return static_cast<std::size_t>(d);
 }
@@ -1191,13 +1233,13 @@ std::size_t Assembler::low_weight_in_degree(Vertex v, unsigned min_weight) const
 bool Assembler::is_low_weight_source(Vertex v, unsigned min_weight) const
 {
     const auto num_low_weight = low_weight_out_degree(v, min_weight);
-    return num_low_weight > 0 && num_low_weight < boost::out_degree(v, graph_);
+    return num_low_weight > 0 && num_low_weight < graph_.out_degree(v);
 }
 
 bool Assembler::is_low_weight_sink(Vertex v, unsigned min_weight) const
 {
     const auto num_low_weight = low_weight_in_degree(v, min_weight);
-    return num_low_weight > 0 && num_low_weight < boost::in_degree(v, graph_);
+    return num_low_weight > 0 && num_low_weight < graph_.in_degree(v);
 }
 
 namespace {
@@ -1212,20 +1254,20 @@ bool all_in(Iterator first, Iterator last, const Set& values)
 
 void Assembler::remove_low_weight_edges(const unsigned min_weight)
 {
-    boost::remove_edge_if([this, min_weight] (const Edge& e) {
+    graph_.remove_edge_if([this, min_weight] (const Edge& e) {
         return !is_reference(e) && graph_[e].weight < min_weight
                && sum_source_in_edge_weight(e) < min_weight
                && sum_target_out_edge_weight(e) < min_weight;
-    }, graph_);
+    });
 }
 
 void Assembler::remove_disconnected_vertices()
 {
     VertexIterator vi, vi_end, vi_next;
-    std::tie(vi, vi_end) = boost::vertices(graph_);
+    std::tie(vi, vi_end) = graph_.vertices();
     for (vi_next = vi; vi != vi_end; vi = vi_next) {
         ++vi_next;
-        if (boost::degree(*vi, graph_) == 0) {
+        if (graph_.degree(*vi) == 0) {
             remove_vertex(*vi);
         }
     }
@@ -1234,20 +1276,34 @@ void Assembler::remove_disconnected_vertices()
 std::unordered_set<Assembler::Vertex> Assembler::find_reachable_kmers(const Vertex from) const
 {
     std::unordered_set<Vertex> result {};
-    result.reserve(boost::num_vertices(graph_));
+    result.reserve(graph_.num_vertices());
     auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
                                                              std::inserter(result, std::begin(result)),
                                                              boost::on_discover_vertex()));
     boost::breadth_first_search(graph_, from,
-                                boost::visitor(vis).vertex_index_map(boost::get(&GraphNode::index, graph_)));
+                                boost::visitor(vis).vertex_index_map(graph_.vertex_index_map()));
     return result;
 }
 
+void Assembler::insert_kmers_that_reach(const Vertex v, std::unordered_set<Vertex>& result) const
+{
+    if (!result.insert(v).second) return; // everything that reaches v is already in result
+    std::vector<Vertex> unexplored {v};
+    while (!unexplored.empty()) {
+        const auto u = unexplored.back();
+        unexplored.pop_back();
+        const auto p = graph_.inv_adjacent_vertices(u);
+        std::for_each(p.first, p.second, [&] (const Vertex w) {
+            if (result.insert(w).second) unexplored.push_back(w);
+        });
+    }
+}
+
 std::deque<Assembler::Vertex> Assembler::remove_vertices_that_cant_be_reached_from(const Vertex v)
 {
     const auto reachables = find_reachable_kmers(v);
     VertexIterator vi, vi_end, vi_next;
-    std::tie(vi, vi_end) = boost::vertices(graph_);
+    std::tie(vi, vi_end) = graph_.vertices();
     std::deque<Vertex> result {};
     for (vi_next = vi; vi != vi_end; vi = vi_next) {
         ++vi_next;
@@ -1262,15 +1318,11 @@ std::deque<Assembler::Vertex> Assembler::remove_vertices_that_cant_be_reached_fr
 void Assembler::remove_vertices_that_cant_reach(const Vertex v)
 {
     if (!is_reference_empty()) {
-        const auto transpose = boost::make_reverse_graph(graph_);
-        const auto index_map = boost::get(&GraphNode::index, transpose);
         std::unordered_set<Vertex> reachables {};
-        auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
-                                                                 std::inserter(reachables, std::begin(reachables)),
-                                                                 boost::on_discover_vertex()));
-        boost::breadth_first_search(transpose, v, boost::visitor(vis).vertex_index_map(index_map));
+        reachables.reserve(graph_.num_vertices());
+        insert_kmers_that_reach(v, reachables);
         VertexIterator vi, vi_end, vi_next;
-        std::tie(vi, vi_end) = boost::vertices(graph_);
+        std::tie(vi, vi_end) = graph_.vertices();
         for (vi_next = vi; vi != vi_end; vi = vi_next) {
             ++vi_next;
             if (reachables.count(*vi) == 0) {
@@ -1284,24 +1336,19 @@ void Assembler::remove_vertices_past(const Vertex v)
 {
     auto reachables = find_reachable_kmers(v);
     reachables.erase(v);
-    boost::clear_out_edges(v, graph_);
+    graph_.clear_out_edges(v);
     std::deque<Vertex> cycle_tails {};
     // Must check for cycles that lead back to v
     for (auto u : reachables) {
         Edge e; bool present;
-        std::tie(e, present) = boost::edge(u, v, graph_);
+        std::tie(e, present) = graph_.edge(u, v);
         if (present) cycle_tails.push_back(u);
     }
     if (!cycle_tails.empty()) {
         // We can check reachable back edges as the links from v were cut previously
-        const auto transpose = boost::make_reverse_graph(graph_);
-        const auto index_map = boost::get(&GraphNode::index, transpose);
         std::unordered_set<Vertex> back_reachables {};
-        auto vis = boost::make_bfs_visitor(boost::write_property(boost::typed_identity_property_map<Vertex>(),
-                                                                 std::inserter(back_reachables, std::begin(back_reachables)),
-                                                                 boost::on_discover_vertex()));
         for (auto u : cycle_tails) {
-            boost::breadth_first_search(transpose, u, boost::visitor(vis).vertex_index_map(index_map));
+            insert_kmers_that_reach(u, back_reachables);
             reachables.erase(u);
         }
         // The intersection of reachables & back_reachables are vertices part
@@ -1325,12 +1372,11 @@ void Assembler::remove_vertices_past(const Vertex v)
 
 bool Assembler::can_prune_reference_flanks() const
 {
-    return boost::out_degree(reference_head(), graph_) == 1 || boost::in_degree(reference_tail(), graph_) == 1;
+    return graph_.out_degree(reference_head()) == 1 || graph_.in_degree(reference_tail()) == 1;
 }
 
 void Assembler::pop_reference_head()
 {
-    reference_kmers_.pop_front();
     reference_vertices_.pop_front();
     if (!reference_edges_.empty()) {
         reference_edges_.pop_front();
@@ -1340,7 +1386,6 @@ void Assembler::pop_reference_head()
 
 void Assembler::pop_reference_tail()
 {
-    reference_kmers_.pop_back();
     reference_vertices_.pop_back();
     if (!reference_edges_.empty()) {
         reference_edges_.pop_back();
@@ -1352,21 +1397,21 @@ void Assembler::prune_reference_flanks()
     if (!is_reference_empty()) {
         auto new_head_itr = std::cbegin(reference_vertices_);
         const auto is_bridge_vertex = [this] (const Vertex v) { return is_bridge(v); };
-        if (boost::in_degree(reference_head(), graph_) == 0 && boost::out_degree(reference_head(), graph_) == 1) {
+        if (graph_.in_degree(reference_head()) == 0 && graph_.out_degree(reference_head()) == 1) {
             new_head_itr = std::find_if_not(std::next(new_head_itr), std::cend(reference_vertices_), is_bridge_vertex);
             std::for_each(std::cbegin(reference_vertices_), new_head_itr, [this] (const Vertex u) {
-                remove_edge(u, *boost::adjacent_vertices(u, graph_).first);
+                remove_edge(u, *graph_.adjacent_vertices(u).first);
                 remove_vertex(u);
                 pop_reference_head();
             });
         }
-        if (new_head_itr != std::cend(reference_vertices_) && boost::in_degree(reference_tail(), graph_) == 1
-            && boost::out_degree(reference_tail(), graph_) == 0) {
+        if (new_head_itr != std::cend(reference_vertices_) && graph_.in_degree(reference_tail()) == 1
+            && graph_.out_degree(reference_tail()) == 0) {
             const auto new_tail_itr = std::find_if_not(std::next(std::crbegin(reference_vertices_)),
                                                        std::make_reverse_iterator(new_head_itr),
                                                        is_bridge_vertex);
             std::for_each(std::crbegin(reference_vertices_), new_tail_itr, [this] (const Vertex u) {
-                remove_edge(*boost::inv_adjacent_vertices(u, graph_).first, u);
+                remove_edge(*graph_.inv_adjacent_vertices(u).first, u);
                 remove_vertex(u);
                 pop_reference_tail();
             });
@@ -1378,7 +1423,7 @@ Assembler::DominatorMap
 Assembler::build_dominator_tree(const Vertex from) const
 {
     DominatorMap result;
-    result.reserve(boost::num_vertices(graph_));
+    result.reserve(graph_.num_vertices());
     boost::lengauer_tarjan_dominator_tree(graph_, from,  boost::make_assoc_property_map(result));
     auto it = std::cbegin(result);
     for (; it != std::cend(result);) {
@@ -1430,11 +1475,11 @@ std::pair<Assembler::Vertex, unsigned> Assembler::find_bifurcation(Vertex from,
 {
     unsigned count {0};
     while (from != to) {
-        const auto d = boost::out_degree(from, graph_);
+        const auto d = graph_.out_degree(from);
         if (d == 0 || d > 1) {
             return std::make_pair(from, count);
         }
-        from = *boost::adjacent_vertices(from, graph_).first;
+        from = *graph_.adjacent_vertices(from).first;
         ++count;
     }
     return std::make_pair(from, count);
@@ -1444,7 +1489,7 @@ template <typename V, typename G>
 auto count_out_weight(const V& v, const G& g)
 {
     using T = decltype(g[typename boost::graph_traits<G>::edge_descriptor()].weight);
-    const auto p = boost::out_edges(v, g);
+    const auto p = out_edges(v, g);
     return std::accumulate(p.first, p.second, T {0},
                            [&g] (const auto curr, const auto& e) {
                                return curr + g[e].weight;
@@ -1468,46 +1513,22 @@ auto compute_transition_score(const T edge_weight, const T total_out_weight) noe
 void Assembler::set_out_edge_transition_scores(const Vertex v)
 {
     const auto total_out_weight = count_out_weight(v, graph_);
-    const auto p = boost::out_edges(v, graph_);
+    const auto p = graph_.out_edges(v);
     using R = GraphEdge::ScoreType;
     std::for_each(p.first, p.second, [this, total_out_weight] (const Edge& e) {
         graph_[e].transition_score = compute_transition_score<R>(graph_[e].weight, total_out_weight);
     });
 }
 
-template <typename R, typename G, typename PropertyMap>
-struct TransitionScorer : public boost::default_dfs_visitor
-{
-    using Vertex = typename boost::graph_traits<G>::vertex_descriptor;
-    
-    PropertyMap map;
-    
-    TransitionScorer(PropertyMap m) : map {m} {}
-    
-    void discover_vertex(Vertex v, const G& g)
-    {
-        const auto total_out_weight = count_out_weight(v, g);
-        const auto p = boost::out_edges(v, g);
-        std::for_each(p.first, p.second, [this, &g, total_out_weight] (const auto& e) {
-            boost::put(map, e, compute_transition_score<R>(g[e].weight, total_out_weight));
-        });
-    }
-};
-
-void Assembler::set_all_edge_transition_scores_from(const Vertex src)
+void Assembler::set_all_edge_transition_scores_from(const Vertex)
 {
-    auto score_map = boost::get(&GraphEdge::transition_score, graph_);
-    TransitionScorer<GraphEdge::ScoreType, KmerGraph, decltype(score_map)> vis {score_map};
-    boost::depth_first_search(graph_, boost::visitor(vis)
-                              .vertex_index_map(boost::get(&GraphNode::index, graph_)));
-    for (auto p = boost::edges(graph_); p.first != p.second; ++p.first) {
-        graph_[*p.first].transition_score = score_map[*p.first];
-    }
+    const auto p = graph_.vertices();
+    std::for_each(p.first, p.second, [this] (const Vertex v) { set_out_edge_transition_scores(v); });
 }
 
 void Assembler::set_all_in_edge_transition_scores(const Vertex v, const GraphEdge::ScoreType score)
 {
-    const auto p = boost::in_edges(v, graph_);
+    const auto p = graph_.in_edges(v);
     std::for_each(p.first, p.second, [this, score] (const Edge e) {
         graph_[e].transition_score = score;
     });
@@ -1522,62 +1543,56 @@ void Assembler::block_all_in_edges(const Vertex v)
 Assembler::PredecessorMap Assembler::find_shortest_scoring_paths(const Vertex from, const bool use_weights) const
 {
     assert(from != null_vertex());
-    std::unordered_map<Vertex, Vertex> result {};
-    result.reserve(boost::num_vertices(graph_));
+    PredecessorMap result(graph_.vertex_capacity());
+    std::iota(std::begin(result), std::end(result), Vertex {0});
+    const auto predecessors = boost::make_iterator_property_map(std::begin(result), boost::typed_identity_property_map<Vertex> {});
     if (use_weights) {
         boost::dag_shortest_paths(graph_, from,
-                                  boost::weight_map(boost::get(&GraphEdge::weight, graph_))
-                                  .predecessor_map(boost::make_assoc_property_map(result))
-                                  .vertex_index_map(boost::get(&GraphNode::index, graph_)));
+                                  boost::weight_map(graph_.edge_member_map(&GraphEdge::weight))
+                                  .predecessor_map(predecessors)
+                                  .vertex_index_map(graph_.vertex_index_map()));
     } else {
         boost::dag_shortest_paths(graph_, from,
-                                  boost::weight_map(boost::get(&GraphEdge::transition_score, graph_))
-                                  .predecessor_map(boost::make_assoc_property_map(result))
-                                  .vertex_index_map(boost::get(&GraphNode::index, graph_)));
+                                  boost::weight_map(graph_.edge_member_map(&GraphEdge::transition_score))
+                                  .predecessor_map(predecessors)
+                                  .vertex_index_map(graph_.vertex_index_map()));
     }
     return result;
 }
 
-bool Assembler::is_on_path(const Vertex v, const PredecessorMap& predecessors, const Vertex from) const
+bool Assembler::is_on_path(const Vertex v, const PredecessorMap& predecessors, Vertex from) const
 {
     if (v == from) return true;
-    assert(predecessors.count(from) == 1);
-    auto itr = predecessors.find(from);
-    while (itr != std::end(predecessors) && itr->first != itr->second) {
-        if (itr->second == v) return true;
-        itr = predecessors.find(itr->second);
+    assert(from < predecessors.size());
+    while (predecessors[from] != from) {
+        from = predecessors[from];
+        if (from == v) return true;
     }
     return false;
 }
 
-bool Assembler::is_on_path(const Edge e, const PredecessorMap& predecessors, const Vertex from) const
+bool Assembler::is_on_path(const Edge e, const PredecessorMap& predecessors, Vertex from) const
 {
-    assert(predecessors.count(from) == 1);
-    const auto last = std::cend(predecessors);
-    auto itr1 = predecessors.find(from);
-    assert(itr1 != last);
-    auto itr2 = predecessors.find(itr1->second);
+    assert(from < predecessors.size());
     Edge path_edge; bool good;
-    while (itr2 != last && itr1 != itr2) {
-        std::tie(path_edge, good) = boost::edge(itr2->second, itr1->second, graph_);
+    while (predecessors[from] != from) {
+        std::tie(path_edge, good) = graph_.edge(predecessors[from], from);
         assert(good);
         if (path_edge == e) {
             return true;
         }
-        itr1 = itr2;
-        itr2 = predecessors.find(itr1->second);
+        from = predecessors[from];
     }
     return false;
 }
 
-Assembler::Path Assembler::extract_full_path(const PredecessorMap& predecessors, const Vertex from) const
+Assembler::Path Assembler::extract_full_path(const PredecessorMap& predecessors, Vertex from) const
 {
-    assert(predecessors.count(from) == 1);
+    assert(from < predecessors.size());
     Path result {from};
-    auto itr = predecessors.find(from);
-    while (itr != std::end(predecessors) && itr->first != itr->second) {
-        result.push_front(itr->second);
-        itr = predecessors.find(itr->second);
+    while (predecessors[from] != from) {
+        from = predecessors[from];
+        result.push_front(from);
     }
     return result;
 }
@@ -1585,18 +1600,17 @@ Assembler::Path Assembler::extract_full_path(const PredecessorMap& predecessors,
 std::tuple<Assembler::Vertex, Assembler::Vertex, unsigned>
 Assembler::backtrack_until_nonreference(const PredecessorMap& predecessors, Vertex from) const
 {
-    assert(predecessors.count(from) == 1);
-    auto v = predecessors.at(from);
+    assert(from < predecessors.size());
+    auto v = predecessors[from];
     unsigned count {1};
     const auto head = reference_head();
     while (v != head) {
         assert(from != v); // was not reachable from source
-        const auto p = boost::edge(v, from, graph_);
+        const auto p = graph_.edge(v, from);
         assert(p.second);
         if (!is_reference(p.first)) break;
         from = v;
-        assert(predecessors.count(from) == 1);
-        v = predecessors.at(from);
+        v = predecessors[from];
         ++count;
     }
     return std::make_tuple(v, from, count);
@@ -1605,19 +1619,19 @@ Assembler::backtrack_until_nonreference(const PredecessorMap& predecessors, Vert
 Assembler::Path Assembler::extract_nonreference_path(const PredecessorMap& predecessors, Vertex from) const
 {
     Path result {from};
-    from = predecessors.at(from);
+    from = predecessors[from];
     while (!is_reference(from)) {
         result.push_front(from);
-        from = predecessors.at(from);
+        from = predecessors[from];
     }
     return result;
 }
 
-template <typename Map>
-auto count_unreachables(const Map& predecessors)
+template <typename Map, typename Graph>
+auto count_unreachables(const Map& predecessors, const Graph& g)
 {
-    return std::count_if(std::cbegin(predecessors), std::cend(predecessors),
-                         [] (const auto& p) { return p.first == p.second; });
+    const auto p = g.vertices();
+    return std::count_if(p.first, p.second, [&] (const auto v) { return predecessors[v] == v; });
 }
 
 template <typename Path, typename Map>
@@ -1649,8 +1663,8 @@ double Assembler::bubble_score(const Path& path) const
 
 std::vector<Assembler::EdgePath> Assembler::extract_k_shortest_paths(Vertex src, Vertex dst, unsigned k) const
 {
-    auto weights = boost::get(&GraphEdge::transition_score, graph_);
-    auto indices = boost::get(&GraphNode::index, graph_);
+    auto weights = graph_.edge_member_map(&GraphEdge::transition_score);
+    auto indices = graph_.vertex_index_map();
     const auto ksps = boost::yen_ksp(graph_, src, dst, std::move(weights), std::move(indices), k);
     std::vector<EdgePath> result {};
     result.reserve(k);
@@ -1691,7 +1705,7 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
     bool use_weights {false};
     while (k > 0 && num_remaining_alt_kmers > 0) {
         auto predecessors = find_shortest_scoring_paths(reference_head(), use_weights);
-        assert(count_unreachables(predecessors) == 1);
+        assert(count_unreachables(predecessors, graph_) == 1);
         Vertex ref, alt; unsigned rhs_kmer_count;
         std::tie(alt, ref, rhs_kmer_count) = backtrack_until_nonreference(predecessors, reference_tail());
         if (alt == reference_head()) {
@@ -1717,8 +1731,7 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
         while (alt != reference_head()) {
             auto alt_path = extract_nonreference_path(predecessors, alt);
             assert(!alt_path.empty());
-            assert(predecessors.count(alt_path.front()) == 1);
-            const auto ref_before_bubble = predecessors.at(alt_path.front());
+            const auto ref_before_bubble = predecessors[alt_path.front()];
             auto ref_seq = make_reference(ref_before_bubble, ref);
             alt_path.push_front(ref_before_bubble);
             const auto extractable = bubble_score(alt_path) >= min_bubble_score;
@@ -1731,7 +1744,7 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
             }
             --rhs_kmer_count; // because we padded one reference kmer to make ref_seq
             Edge edge_to_alt; bool good;
-            std::tie(edge_to_alt, good) = boost::edge(alt, ref, graph_);
+            std::tie(edge_to_alt, good) = graph_.edge(alt, ref);
             assert(good);
             if (alt_path.size() == 1 && is_simple_deletion(edge_to_alt)) {
                 remove_edge(alt_path.front(), ref);
@@ -1779,12 +1792,12 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
                     set_out_edge_transition_scores(vertex_before_bridge);
                     num_remaining_alt_kmers -= alt_path.size();
                     removed_bubble = true;
-                } else if (boost::in_degree(*bifurication_point_itr, graph_) == 1) {
+                } else if (graph_.in_degree(*bifurication_point_itr) == 1) {
                     const auto next_bifurication_point_itr = is_bridge_until(std::next(bifurication_point_itr), std::cend(alt_path));
                     if (next_bifurication_point_itr != std::cend(alt_path)) {
-                        if (boost::out_degree(*next_bifurication_point_itr, graph_) == 1) {
+                        if (graph_.out_degree(*next_bifurication_point_itr) == 1) {
                             if (joins_reference_only(next_bifurication_point_itr, std::cend(alt_path))) {
-                                const auto p = boost::adjacent_vertices(*bifurication_point_itr, graph_);
+                                const auto p = graph_.adjacent_vertices(*bifurication_point_itr);
                                 auto is_simple_bubble = std::all_of(p.first, p.second, [&] (Vertex v) {
                                     if (v == *std::next(bifurication_point_itr)) {
                                         return true;
@@ -1792,7 +1805,7 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
                                         try {
                                             boost::breadth_first_search(graph_, v,
                                                                         boost::visitor(make_bfs_searcher(*next_bifurication_point_itr)).
-                                                                        vertex_index_map(boost::get(&GraphNode::index, graph_)));
+                                                                        vertex_index_map(graph_.vertex_index_map()));
                                         } catch (const BfsSearcherSuccess&) {
                                             return true;
                                         }
@@ -1860,8 +1873,8 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
         } else if (!removed_bubble) {
             use_weights = true;
         }
-        assert(boost::out_degree(reference_head(), graph_) > 0);
-        assert(boost::in_degree(reference_tail(), graph_) > 0);
+        assert(graph_.out_degree(reference_head()) > 0);
+        assert(graph_.in_degree(reference_tail()) > 0);
         if (can_prune_reference_flanks()) {
             prune_reference_flanks();
             regenerate_vertex_indices();
@@ -1873,8 +1886,8 @@ Assembler::extract_bubble_paths(unsigned k, const double min_bubble_score)
 std::deque<Assembler::SubGraph> Assembler::find_independent_subgraphs() const
 {
     assert(!reference_vertices_.empty());
-    const auto diverges  = [this] (const Vertex& v) { return boost::out_degree(v, graph_) > 1; };
-    const auto coalesces = [this] (const Vertex& v) { return boost::in_degree(v, graph_) > 1; };
+    const auto diverges  = [this] (const Vertex& v) { return graph_.out_degree(v) > 1; };
+    const auto coalesces = [this] (const Vertex& v) { return graph_.in_degree(v) > 1; };
     auto subgraph_head_itr = std::find_if(std::cbegin(reference_vertices_), std::cend(reference_vertices_), diverges);
     if (subgraph_head_itr == std::cend(reference_vertices_)) {
         return {{reference_head(), reference_tail(), 0}};
@@ -1914,17 +1927,17 @@ std::deque<Assembler::Variant> Assembler::extract_bubble_paths_with_ksp(const un
             auto alt_head_itr = std::find_if(std::cbegin(path), std::cend(path), is_alt_edge);
             auto lhs_kmer_count = std::distance(std::cbegin(path), alt_head_itr);
             while (alt_head_itr != std::cend(path)) {
-                const auto ref_before_bubble = boost::source(*alt_head_itr, graph_);
+                const auto ref_before_bubble = graph_.source(*alt_head_itr);
                 assert(is_reference(ref_before_bubble));
                 const auto alt_tail_itr = std::find_if(alt_head_itr, std::cend(path), [this] (Edge e) { return is_target_reference(e); });
                 assert(alt_tail_itr != std::cend(path));
-                const auto ref_after_bubble = boost::target(*alt_tail_itr, graph_);
+                const auto ref_after_bubble = graph_.target(*alt_tail_itr);
                 assert(!is_reference(*alt_tail_itr));
                 assert(is_reference(ref_after_bubble));
                 auto ref_seq = make_reference(ref_before_bubble, ref_after_bubble);
                 Path alt_path {};
                 std::transform(alt_head_itr, std::next(alt_tail_itr), std::back_inserter(alt_path),
-                               [this] (Edge e) { return boost::source(e, graph_); });
+                               [this] (Edge e) { return graph_.source(e); });
                 const auto num_ref_kmers = count_kmers(ref_seq, k_);
                 if (bubble_score(alt_path) >= min_bubble_score) {
                     auto alt_seq = make_sequence(alt_path);
@@ -1941,12 +1954,6 @@ std::deque<Assembler::Variant> Assembler::extract_bubble_paths_with_ksp(const un
 
 // debug
 
-std::ostream& operator<<(std::ostream& os, const Assembler::Kmer& kmer)
-{
-    std::copy(std::cbegin(kmer), std::cend(kmer), std::ostreambuf_iterator<char> {os});
-    return os;
-}
-
 void Assembler::print_reference_head() const
 {
     std::cout << "reference head is " << kmer_of(reference_head()) << std::endl;
@@ -1964,13 +1971,13 @@ void Assembler::print_reference_path() const
 
 void Assembler::print(const Edge e) const
 {
-    std::cout << kmer_of(boost::source(e, graph_)) << "->" << kmer_of(boost::target(e, graph_));
+    std::cout << kmer_of(graph_.source(e)) << "->" << kmer_of(graph_.target(e));
 }
 
 void Assembler::print(const Path& path) const
 {
     assert(!path.empty());
-    std::transform(std::cbegin(path), std::prev(std::cend(path)), std::ostream_iterator<Kmer> {std::cout, "->"},
+    std::transform(std::cbegin(path), std::prev(std::cend(path)), std::ostream_iterator<NucleotideSequence> {std::cout, "->"},
                    [this] (const Vertex v) { return kmer_of(v); });
     std::cout << kmer_of(path.back());
 }
@@ -1982,9 +1989,9 @@ void Assembler::print_weighted(const Path& path) const
                    std::ostream_iterator<std::string> {std::cout, "->"},
                    [this] (const auto& u, const auto& v) {
                        Edge e; bool good;
-                       std::tie(e, good) = boost::edge(u, v, graph_);
+                       std::tie(e, good) = graph_.edge(u, v);
                        assert(good);
-                       return static_cast<std::string>(this->kmer_of(v)) + "(" + std::to_string(graph_[e].weight) + ")";
+                       return this->kmer_of(v) + "(" + std::to_string(graph_[e].weight) + ")";
                    });
     std::cout << kmer_of(path.back());
 }
@@ -10,25 +10,17 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <tuple>
 #include <stdexcept>
 #include <iosfwd>
 
-#include <boost/graph/adjacency_list.hpp>
 #include <boost/optional.hpp>
 
 #include "concepts/equitable.hpp"
-#include "concepts/comparable.hpp"
 
-namespace octopus { namespace coretools { class Assembler; }}
-
-namespace boost {
-
-template <typename G> static decltype(auto) get(vertex_index_t, G& g);
-template <typename G> static decltype(auto) get(vertex_index_t, const G& g);
-
-} // namespace boost
+#include "flat_digraph.hpp"
 
 namespace octopus { namespace coretools {
 
@@ -59,8 +51,9 @@ public:
     // Throws an exception if there is already reference sequence present.
     void insert_reference(const NucleotideSequence& sequence);
     
-    // Threads the given read sequence into the graph
-    void insert_read(const NucleotideSequence& sequence);
+    // Threads the given read sequence into the graph. The result is the same as inserting the
+    // sequence count times.
+    void insert_read(const NucleotideSequence& sequence, unsigned count = 1);
     
     // Returns the current number of unique kmers in the graph
     std::size_t num_kmers() const noexcept;
@@ -88,46 +81,9 @@ public:
     void write_dot(std::ostream& out) const;
     
 private:
-    class Kmer : public Comparable<Kmer>
-    {
-    public:
-        using NucleotideSequence = Assembler::NucleotideSequence;
-        using SequenceIterator   = NucleotideSequence::const_iterator;
-        
-        Kmer() = delete;
-        Kmer(SequenceIterator first, SequenceIterator last) noexcept;
-        
-        Kmer(const Kmer&)            = default;
-        Kmer& operator=(const Kmer&) = default;
-        Kmer(Kmer&&)                 = default;
-        Kmer& operator=(Kmer&&)      = default;
-        
-        ~Kmer() = default;
-        
-        char front() const noexcept;
-        char back() const noexcept;
-        
-        SequenceIterator begin() const noexcept;
-        SequenceIterator end() const noexcept;
-        
-        explicit operator NucleotideSequence() const;
-        
-        std::size_t hash() const noexcept;
-        
-        friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
-        friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
-    private:
-        SequenceIterator first_, last_;
-        std::size_t hash_;
-    };
-    
-    friend bool operator==(const Kmer& lhs, const Kmer& rhs) noexcept;
-    friend bool operator<(const Kmer& lhs, const Kmer& rhs) noexcept;
-    
-    struct KmerHash
-    {
-        std::size_t operator()(const Kmer& k) const noexcept { return k.hash(); }
-    };
+    // Kmers are packed two bits per base into ceil(k / 32) words, with the first base in the
+    // most significant bits of the first word.
+    using KmerWord = std::uint64_t;
     
     struct GraphEdge
     {
@@ -139,24 +95,22 @@ private:
     };
     struct GraphNode
     {
-        std::size_t index;
-        Kmer kmer;
         bool is_reference = false;
     };
     
-    using KmerGraph = boost::adjacency_list<boost::listS, boost::listS, boost::bidirectionalS, GraphNode, GraphEdge>;
+    using KmerGraph = FlatDigraph<GraphNode, GraphEdge>;
     
-    using Vertex = boost::graph_traits<KmerGraph>::vertex_descriptor;
-    using Edge   = boost::graph_traits<KmerGraph>::edge_descriptor;
+    using Vertex = KmerGraph::vertex_descriptor;
+    using Edge   = KmerGraph::edge_descriptor;
     
-    using VertexIterator = boost::graph_traits<KmerGraph>::vertex_iterator;
-    using EdgeIterator   = boost::graph_traits<KmerGraph>::edge_iterator;
+    using VertexIterator = KmerGraph::vertex_iterator;
+    using EdgeIterator   = KmerGraph::edge_iterator;
     
     using DominatorMap = std::unordered_map<Vertex, Vertex>;
     
     using Path = std::deque<Vertex>;
     using EdgePath = std::vector<Edge>;
-    using PredecessorMap = std::unordered_map<Vertex, Vertex>;
+    using PredecessorMap = std::vector<Vertex>; // indexed by vertex
     
     struct SubGraph
     {
@@ -164,28 +118,44 @@ private:
         std::size_t reference_offset;
     };
     
-    unsigned k_;
+    unsigned k_, kmer_words_;
+    KmerWord first_word_mask_;
     
-    std::deque<Kmer> reference_kmers_;
     std::size_t reference_head_position_;
     
     KmerGraph graph_;
     
-    std::unordered_map<Kmer, Vertex, KmerHash> vertex_cache_;
+    std::vector<KmerWord> kmer_codes_; // kmer_words_ per vertex
+    std::vector<Vertex> kmer_table_; // open addressing with linear probing
+    std::size_t num_kmers_;
+    
     Path reference_vertices_;
     std::deque<Edge> reference_edges_;
     
+    std::vector<KmerWord> sequence_kmer_codes_;
+    std::vector<char> sequence_kmer_canonical_;
+    
     // methods
     
+    std::size_t encode_kmers(const NucleotideSequence& sequence);
+    const KmerWord* sequence_kmer_code(std::size_t kmer_index) const noexcept;
+    bool is_canonical_sequence_kmer(std::size_t kmer_index) const noexcept;
+    bool is_sequence_kmer(std::size_t kmer_index, Vertex v) const noexcept;
+    std::size_t hash_kmer(const KmerWord* code) const noexcept;
+    bool are_equal_kmers(const KmerWord* lhs, const KmerWord* rhs) const noexcept;
+    Vertex find_kmer(const KmerWord* code) const noexcept;
+    Vertex find_sequence_kmer(std::size_t kmer_index) const noexcept;
+    void reserve_kmers(std::size_t n);
+    void index_kmer(Vertex v) noexcept;
+    void unindex_kmer(Vertex v) noexcept;
     void insert_reference_into_empty_graph(const NucleotideSequence& reference);
     void insert_reference_into_populated_graph(const NucleotideSequence& reference);
-    bool contains_kmer(const Kmer& kmer) const noexcept;
-    std::size_t count_kmer(const Kmer& kmer) const noexcept;
     std::size_t reference_size() const noexcept;
     void regenerate_vertex_indices();
     bool is_reference_unique_path() const;
     Vertex null_vertex() const;
-    boost::optional<Vertex> add_vertex(const Kmer& kmer, bool is_reference = false);
+    Vertex add_vertex(const KmerWord* code, bool is_reference = false);
+    boost::optional<Vertex> add_sequence_kmer(std::size_t kmer_index, bool is_reference = false);
     void remove_vertex(Vertex v);
     void clear_and_remove_vertex(Vertex v);
     void clear_and_remove_all(const std::unordered_set<Vertex>& vertices);
@@ -193,15 +163,12 @@ private:
     Edge add_reference_edge(Vertex u, Vertex v);
     void remove_edge(Vertex u, Vertex v);
     void remove_edge(Edge e);
-    void increment_weight(Edge e);
+    void increment_weight(Edge e, GraphEdge::WeightType amount = 1);
     void set_vertex_reference(Vertex v);
-    void set_vertex_reference(const Kmer& kmer);
     void set_edge_reference(Edge e);
-    const Kmer& kmer_of(Vertex v) const;
-    char front_base_of(Vertex v) const;
-    char back_base_of(Vertex v) const;
-    const Kmer& source_kmer_of(Edge e) const;
-    const Kmer& target_kmer_of(Edge e) const;
+    const KmerWord* kmer_code_of(Vertex v) const noexcept;
+    NucleotideSequence kmer_of(Vertex v) const;
+    char back_base_of(Vertex v) const noexcept;
     bool is_reference(Vertex v) const;
     bool is_source_reference(Edge e) const;
     bool is_target_reference(Edge e) const;
@@ -253,6 +220,7 @@ private:
     void remove_low_weight_edges(unsigned min_weight);
     void remove_disconnected_vertices();
     std::unordered_set<Vertex> find_reachable_kmers(Vertex from) const;
+    void insert_kmers_that_reach(Vertex v, std::unordered_set<Vertex>& result) const;
     std::deque<Vertex> remove_vertices_that_cant_be_reached_from(Vertex v);
     void remove_vertices_that_cant_reach(Vertex v);
     void remove_vertices_past(Vertex v);
@@ -283,7 +251,6 @@ private:
     
     // for debug
     
-    friend std::ostream& operator<<(std::ostream& os, const Kmer& kmer);
     void print_reference_head() const;
     void print_reference_tail() const;
     void print_reference_path() const;
@@ -291,12 +258,6 @@ private:
     void print(const Path& path) const;
     void print_weighted(const Path& path) const;
     void print_dominator_tree() const;
-    
-    friend struct boost::property_map<KmerGraph, boost::vertex_index_t>;
-    template <typename G>
-    friend decltype(auto) boost::get(boost::vertex_index_t, G&);
-    template <typename G>
-    friend decltype(auto) boost::get(boost::vertex_index_t, const G&);
 };
 
 struct Assembler::Variant : public Equitable<Variant>
@@ -330,30 +291,4 @@ bool operator==(const Assembler::Variant& lhs, const Assembler::Variant& rhs) no
 } // namespace coretools
 } // namespace octopus
 
-// Hack to make some older boost algorithms work with bundled properties
-namespace boost {
-
-using Assembler = octopus::coretools::Assembler;
-
-template <>
-struct property_map<Assembler::KmerGraph, vertex_index_t>
-{
-    using type       = property_map<Assembler::KmerGraph, std::size_t Assembler::GraphNode::*>::type;
-    using const_type = property_map<Assembler::KmerGraph, std::size_t Assembler::GraphNode::*>::const_type;
-};
-
-template <typename G>
-static decltype(auto) get(vertex_index_t, G& g)
-{
-    return get(&Assembler::GraphNode::index, g);
-}
-template <typename G>
-static decltype(auto)
-get(vertex_index_t, G const & g)
-{
-    return get(&Assembler::GraphNode::index, g);
-}
-
-} // namespace boost
-
 #endif
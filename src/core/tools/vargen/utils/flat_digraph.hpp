@@ -0,0 +1,611 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef flat_digraph_hpp
+#define flat_digraph_hpp
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <limits>
+#include <cassert>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/graph/adjacency_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+
+namespace octopus { namespace coretools {
+
+/*
+ A directed graph with vertices and edges held in contiguous arrays, with descriptors being
+ array positions. Each vertex's in and out edges are doubly-linked lists threaded through the
+ edge array, so adding or removing an edge is O(1) and never invalidates other descriptors.
+ Removed vertices and edges are tombstoned until clear().
+
+ The graph models the BGL BidirectionalGraph, VertexListGraph and EdgeListGraph concepts, and
+ visits vertices, edges, and incident edges in insertion order, as adjacency_list<listS, listS,
+ bidirectionalS> does. The vertex index property is not maintained on removal; call reindex()
+ before running any BGL algorithm that needs it.
+*/
+template <typename VertexProperty, typename EdgeProperty>
+class FlatDigraph
+{
+    using Id = std::uint32_t;
+    static constexpr Id null_id = std::numeric_limits<Id>::max();
+
+public:
+    using vertex_descriptor = Id;
+
+    class edge_descriptor
+    {
+    public:
+        edge_descriptor() = default;
+        explicit edge_descriptor(Id id) noexcept : id_ {id} {}
+        Id id() const noexcept { return id_; }
+        friend bool operator==(edge_descriptor lhs, edge_descriptor rhs) noexcept { return lhs.id_ == rhs.id_; }
+        friend bool operator!=(edge_descriptor lhs, edge_descriptor rhs) noexcept { return lhs.id_ != rhs.id_; }
+        friend bool operator<(edge_descriptor lhs, edge_descriptor rhs) noexcept { return lhs.id_ < rhs.id_; }
+    private:
+        Id id_ = null_id;
+    };
+
+    using directed_category      = boost::bidirectional_tag;
+    using edge_parallel_category = boost::allow_parallel_edge_tag;
+    struct traversal_category
+    : public boost::bidirectional_graph_tag
+    , public boost::adjacency_graph_tag
+    , public boost::vertex_list_graph_tag
+    , public boost::edge_list_graph_tag {};
+
+    using vertices_size_type = std::size_t;
+    using edges_size_type    = std::size_t;
+    using degree_size_type   = std::size_t;
+
+    class vertex_iterator;
+    class edge_iterator;
+    class out_edge_iterator;
+    class in_edge_iterator;
+    using adjacency_iterator     = boost::adjacency_iterator<FlatDigraph, vertex_descriptor, out_edge_iterator, std::ptrdiff_t>;
+    using inv_adjacency_iterator = boost::inv_adjacency_iterator<FlatDigraph, vertex_descriptor, in_edge_iterator, std::ptrdiff_t>;
+
+    class VertexIndexMap;
+    template <typename T> class EdgeMemberMap;
+
+    FlatDigraph() = default;
+
+    FlatDigraph(const FlatDigraph&)            = default;
+    FlatDigraph& operator=(const FlatDigraph&) = default;
+    FlatDigraph(FlatDigraph&&)                 = default;
+    FlatDigraph& operator=(FlatDigraph&&)      = default;
+
+    ~FlatDigraph() = default;
+
+    static vertex_descriptor null_vertex() noexcept { return null_id; }
+
+    void reserve(std::size_t num_vertices, std::size_t num_edges);
+    void clear() noexcept;
+
+    vertex_descriptor add_vertex(VertexProperty property);
+    // The vertex must not have any edges
+    void remove_vertex(vertex_descriptor v);
+    void clear_vertex(vertex_descriptor v);
+    void clear_out_edges(vertex_descriptor v);
+    // Number of vertex slots ever allocated; all vertex descriptors are less than this
+    std::size_t vertex_capacity() const noexcept { return vertices_.size(); }
+    bool is_alive(vertex_descriptor v) const noexcept { return vertices_[v].alive; }
+
+    std::pair<edge_descriptor, bool> add_edge(vertex_descriptor u, vertex_descriptor v, EdgeProperty property);
+    // Removes all edges from u to v
+    void remove_edge(vertex_descriptor u, vertex_descriptor v);
+    void remove_edge(edge_descriptor e);
+    template <typename Predicate> void remove_edge_if(Predicate pred);
+    template <typename Predicate> void remove_out_edge_if(vertex_descriptor u, Predicate pred);
+    template <typename Predicate> void remove_in_edge_if(vertex_descriptor v, Predicate pred);
+
+    std::pair<edge_descriptor, bool> edge(vertex_descriptor u, vertex_descriptor v) const noexcept;
+    vertex_descriptor source(edge_descriptor e) const noexcept { return edges_[e.id()].source; }
+    vertex_descriptor target(edge_descriptor e) const noexcept { return edges_[e.id()].target; }
+
+    std::size_t num_vertices() const noexcept { return num_vertices_; }
+    std::size_t num_edges() const noexcept { return num_edges_; }
+    std::size_t out_degree(vertex_descriptor v) const noexcept { return vertices_[v].out_degree; }
+    std::size_t in_degree(vertex_descriptor v) const noexcept { return vertices_[v].in_degree; }
+    std::size_t degree(vertex_descriptor v) const noexcept { return out_degree(v) + in_degree(v); }
+
+    std::pair<vertex_iterator, vertex_iterator> vertices() const noexcept;
+    std::pair<edge_iterator, edge_iterator> edges() const noexcept;
+    std::pair<out_edge_iterator, out_edge_iterator> out_edges(vertex_descriptor v) const noexcept;
+    std::pair<in_edge_iterator, in_edge_iterator> in_edges(vertex_descriptor v) const noexcept;
+    std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices(vertex_descriptor v) const noexcept;
+    std::pair<inv_adjacency_iterator, inv_adjacency_iterator> inv_adjacent_vertices(vertex_descriptor v) const noexcept;
+
+    VertexProperty& operator[](vertex_descriptor v) noexcept { return vertex_properties_[v]; }
+    const VertexProperty& operator[](vertex_descriptor v) const noexcept { return vertex_properties_[v]; }
+    EdgeProperty& operator[](edge_descriptor e) noexcept { return edge_properties_[e.id()]; }
+    const EdgeProperty& operator[](edge_descriptor e) const noexcept { return edge_properties_[e.id()]; }
+
+    // Numbers the live vertices 0, 1, ... in iteration order
+    void reindex() noexcept;
+    std::size_t index(vertex_descriptor v) const noexcept { return vertices_[v].index; }
+
+    VertexIndexMap vertex_index_map() const noexcept { return VertexIndexMap {*this}; }
+    template <typename T>
+    EdgeMemberMap<T> edge_member_map(T EdgeProperty::* member) const noexcept { return EdgeMemberMap<T> {*this, member}; }
+
+private:
+    struct VertexRecord
+    {
+        Id first_out = null_id, last_out = null_id, first_in = null_id, last_in = null_id;
+        Id out_degree = 0, in_degree = 0;
+        Id index;
+        bool alive = true;
+    };
+    struct EdgeRecord
+    {
+        Id source, target;
+        Id prev_out = null_id, next_out = null_id, prev_in = null_id, next_in = null_id;
+        bool alive = true;
+    };
+
+    std::vector<VertexRecord> vertices_;
+    std::vector<VertexProperty> vertex_properties_;
+    std::vector<EdgeRecord> edges_;
+    std::vector<EdgeProperty> edge_properties_;
+    std::size_t num_vertices_ = 0, num_edges_ = 0;
+
+    Id next_live_vertex(Id v) const noexcept;
+    Id next_live_edge(Id e) const noexcept;
+};
+
+template <typename V, typename E>
+constexpr typename FlatDigraph<V, E>::Id FlatDigraph<V, E>::null_id;
+
+template <typename V, typename E>
+class FlatDigraph<V, E>::vertex_iterator
+: public boost::iterator_facade<vertex_iterator, vertex_descriptor, boost::forward_traversal_tag, vertex_descriptor>
+{
+public:
+    vertex_iterator() = default;
+    vertex_iterator(const FlatDigraph& g, Id v) noexcept : g_ {&g}, v_ {v} {}
+private:
+    friend class boost::iterator_core_access;
+    const FlatDigraph* g_ = nullptr;
+    Id v_ = null_id;
+    vertex_descriptor dereference() const noexcept { return v_; }
+    bool equal(const vertex_iterator& other) const noexcept { return v_ == other.v_; }
+    void increment() noexcept { v_ = g_->next_live_vertex(v_ + 1); }
+};
+
+template <typename V, typename E>
+class FlatDigraph<V, E>::edge_iterator
+: public boost::iterator_facade<edge_iterator, edge_descriptor, boost::forward_traversal_tag, edge_descriptor>
+{
+public:
+    edge_iterator() = default;
+    edge_iterator(const FlatDigraph& g, Id e) noexcept : g_ {&g}, e_ {e} {}
+private:
+    friend class boost::iterator_core_access;
+    const FlatDigraph* g_ = nullptr;
+    Id e_ = null_id;
+    edge_descriptor dereference() const noexcept { return edge_descriptor {e_}; }
+    bool equal(const edge_iterator& other) const noexcept { return e_ == other.e_; }
+    void increment() noexcept { e_ = g_->next_live_edge(e_ + 1); }
+};
+
+template <typename V, typename E>
+class FlatDigraph<V, E>::out_edge_iterator
+: public boost::iterator_facade<out_edge_iterator, edge_descriptor, boost::forward_traversal_tag, edge_descriptor>
+{
+public:
+    out_edge_iterator() = default;
+    out_edge_iterator(const FlatDigraph& g, Id e) noexcept : g_ {&g}, e_ {e} {}
+private:
+    friend class boost::iterator_core_access;
+    const FlatDigraph* g_ = nullptr;
+    Id e_ = null_id;
+    edge_descriptor dereference() const noexcept { return edge_descriptor {e_}; }
+    bool equal(const out_edge_iterator& other) const noexcept { return e_ == other.e_; }
+    void increment() noexcept { e_ = g_->edges_[e_].next_out; }
+};
+
+template <typename V, typename E>
+class FlatDigraph<V, E>::in_edge_iterator
+: public boost::iterator_facade<in_edge_iterator, edge_descriptor, boost::forward_traversal_tag, edge_descriptor>
+{
+public:
+    in_edge_iterator() = default;
+    in_edge_iterator(const FlatDigraph& g, Id e) noexcept : g_ {&g}, e_ {e} {}
+private:
+    friend class boost::iterator_core_access;
+    const FlatDigraph* g_ = nullptr;
+    Id e_ = null_id;
+    edge_descriptor dereference() const noexcept { return edge_descriptor {e_}; }
+    bool equal(const in_edge_iterator& other) const noexcept { return e_ == other.e_; }
+    void increment() noexcept { e_ = g_->edges_[e_].next_in; }
+};
+
+template <typename V, typename E>
+class FlatDigraph<V, E>::VertexIndexMap : public boost::put_get_helper<std::size_t, VertexIndexMap>
+{
+public:
+    using key_type   = vertex_descriptor;
+    using value_type = std::size_t;
+    using reference  = std::size_t;
+    using category   = boost::readable_property_map_tag;
+    VertexIndexMap() = default;
+    explicit VertexIndexMap(const FlatDigraph& g) noexcept : g_ {&g} {}
+    reference operator[](key_type v) const noexcept { return g_->index(v); }
+private:
+    const FlatDigraph* g_ = nullptr;
+};
+
+template <typename V, typename E>
+template <typename T>
+class FlatDigraph<V, E>::EdgeMemberMap : public boost::put_get_helper<const T&, EdgeMemberMap<T>>
+{
+public:
+    using key_type   = edge_descriptor;
+    using value_type = T;
+    using reference  = const T&;
+    using category   = boost::readable_property_map_tag;
+    EdgeMemberMap() = default;
+    EdgeMemberMap(const FlatDigraph& g, T E::* member) noexcept : g_ {&g}, member_ {member} {}
+    reference operator[](key_type e) const noexcept { return (*g_)[e].*member_; }
+private:
+    const FlatDigraph* g_ = nullptr;
+    T E::* member_ = nullptr;
+};
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::reserve(const std::size_t num_vertices, const std::size_t num_edges)
+{
+    vertices_.reserve(num_vertices);
+    vertex_properties_.reserve(num_vertices);
+    edges_.reserve(num_edges);
+    edge_properties_.reserve(num_edges);
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::clear() noexcept
+{
+    vertices_.clear();
+    vertex_properties_.clear();
+    edges_.clear();
+    edge_properties_.clear();
+    num_vertices_ = 0;
+    num_edges_ = 0;
+}
+
+template <typename V, typename E>
+typename FlatDigraph<V, E>::vertex_descriptor FlatDigraph<V, E>::add_vertex(V property)
+{
+    assert(vertices_.size() < null_id);
+    VertexRecord record {};
+    record.index = static_cast<Id>(num_vertices_);
+    vertices_.push_back(record);
+    vertex_properties_.push_back(std::move(property));
+    ++num_vertices_;
+    return static_cast<Id>(vertices_.size() - 1);
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::remove_vertex(const vertex_descriptor v)
+{
+    assert(vertices_[v].alive);
+    assert(vertices_[v].out_degree == 0 && vertices_[v].in_degree == 0);
+    vertices_[v].alive = false;
+    --num_vertices_;
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::clear_vertex(const vertex_descriptor v)
+{
+    while (vertices_[v].first_out != null_id) remove_edge(edge_descriptor {vertices_[v].first_out});
+    while (vertices_[v].first_in != null_id) remove_edge(edge_descriptor {vertices_[v].first_in});
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::clear_out_edges(const vertex_descriptor v)
+{
+    while (vertices_[v].first_out != null_id) remove_edge(edge_descriptor {vertices_[v].first_out});
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::edge_descriptor, bool>
+FlatDigraph<V, E>::add_edge(const vertex_descriptor u, const vertex_descriptor v, E property)
+{
+    assert(edges_.size() < null_id);
+    const auto e = static_cast<Id>(edges_.size());
+    EdgeRecord record {};
+    record.source = u;
+    record.target = v;
+    auto& source = vertices_[u];
+    record.prev_out = source.last_out;
+    if (source.last_out != null_id) {
+        edges_[source.last_out].next_out = e;
+    } else {
+        source.first_out = e;
+    }
+    source.last_out = e;
+    ++source.out_degree;
+    auto& target = vertices_[v];
+    record.prev_in = target.last_in;
+    if (target.last_in != null_id) {
+        edges_[target.last_in].next_in = e;
+    } else {
+        target.first_in = e;
+    }
+    target.last_in = e;
+    ++target.in_degree;
+    edges_.push_back(record);
+    edge_properties_.push_back(std::move(property));
+    ++num_edges_;
+    return {edge_descriptor {e}, true};
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::remove_edge(const vertex_descriptor u, const vertex_descriptor v)
+{
+    remove_out_edge_if(u, [this, v] (edge_descriptor e) { return target(e) == v; });
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::remove_edge(const edge_descriptor e)
+{
+    auto& record = edges_[e.id()];
+    assert(record.alive);
+    auto& source = vertices_[record.source];
+    if (record.prev_out != null_id) {
+        edges_[record.prev_out].next_out = record.next_out;
+    } else {
+        source.first_out = record.next_out;
+    }
+    if (record.next_out != null_id) {
+        edges_[record.next_out].prev_out = record.prev_out;
+    } else {
+        source.last_out = record.prev_out;
+    }
+    --source.out_degree;
+    auto& target = vertices_[record.target];
+    if (record.prev_in != null_id) {
+        edges_[record.prev_in].next_in = record.next_in;
+    } else {
+        target.first_in = record.next_in;
+    }
+    if (record.next_in != null_id) {
+        edges_[record.next_in].prev_in = record.prev_in;
+    } else {
+        target.last_in = record.prev_in;
+    }
+    --target.in_degree;
+    record.alive = false;
+    --num_edges_;
+}
+
+template <typename V, typename E>
+template <typename Predicate>
+void FlatDigraph<V, E>::remove_edge_if(Predicate pred)
+{
+    for (Id e {next_live_edge(0)}; e != null_id; e = next_live_edge(e + 1)) {
+        if (pred(edge_descriptor {e})) remove_edge(edge_descriptor {e});
+    }
+}
+
+template <typename V, typename E>
+template <typename Predicate>
+void FlatDigraph<V, E>::remove_out_edge_if(const vertex_descriptor u, Predicate pred)
+{
+    for (Id e {vertices_[u].first_out}; e != null_id;) {
+        const auto next = edges_[e].next_out;
+        if (pred(edge_descriptor {e})) remove_edge(edge_descriptor {e});
+        e = next;
+    }
+}
+
+template <typename V, typename E>
+template <typename Predicate>
+void FlatDigraph<V, E>::remove_in_edge_if(const vertex_descriptor v, Predicate pred)
+{
+    for (Id e {vertices_[v].first_in}; e != null_id;) {
+        const auto next = edges_[e].next_in;
+        if (pred(edge_descriptor {e})) remove_edge(edge_descriptor {e});
+        e = next;
+    }
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::edge_descriptor, bool>
+FlatDigraph<V, E>::edge(const vertex_descriptor u, const vertex_descriptor v) const noexcept
+{
+    for (Id e {vertices_[u].first_out}; e != null_id; e = edges_[e].next_out) {
+        if (edges_[e].target == v) return {edge_descriptor {e}, true};
+    }
+    return {edge_descriptor {}, false};
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::vertex_iterator, typename FlatDigraph<V, E>::vertex_iterator>
+FlatDigraph<V, E>::vertices() const noexcept
+{
+    return {vertex_iterator {*this, next_live_vertex(0)}, vertex_iterator {*this, null_id}};
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::edge_iterator, typename FlatDigraph<V, E>::edge_iterator>
+FlatDigraph<V, E>::edges() const noexcept
+{
+    return {edge_iterator {*this, next_live_edge(0)}, edge_iterator {*this, null_id}};
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::out_edge_iterator, typename FlatDigraph<V, E>::out_edge_iterator>
+FlatDigraph<V, E>::out_edges(const vertex_descriptor v) const noexcept
+{
+    return {out_edge_iterator {*this, vertices_[v].first_out}, out_edge_iterator {*this, null_id}};
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::in_edge_iterator, typename FlatDigraph<V, E>::in_edge_iterator>
+FlatDigraph<V, E>::in_edges(const vertex_descriptor v) const noexcept
+{
+    return {in_edge_iterator {*this, vertices_[v].first_in}, in_edge_iterator {*this, null_id}};
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::adjacency_iterator, typename FlatDigraph<V, E>::adjacency_iterator>
+FlatDigraph<V, E>::adjacent_vertices(const vertex_descriptor v) const noexcept
+{
+    const auto p = out_edges(v);
+    return {adjacency_iterator {p.first, this}, adjacency_iterator {p.second, this}};
+}
+
+template <typename V, typename E>
+std::pair<typename FlatDigraph<V, E>::inv_adjacency_iterator, typename FlatDigraph<V, E>::inv_adjacency_iterator>
+FlatDigraph<V, E>::inv_adjacent_vertices(const vertex_descriptor v) const noexcept
+{
+    const auto p = in_edges(v);
+    return {inv_adjacency_iterator {p.first, this}, inv_adjacency_iterator {p.second, this}};
+}
+
+template <typename V, typename E>
+void FlatDigraph<V, E>::reindex() noexcept
+{
+    Id index {0};
+    for (auto& record : vertices_) {
+        if (record.alive) record.index = index++;
+    }
+}
+
+template <typename V, typename E>
+typename FlatDigraph<V, E>::Id FlatDigraph<V, E>::next_live_vertex(Id v) const noexcept
+{
+    const auto n = static_cast<Id>(vertices_.size());
+    while (v < n && !vertices_[v].alive) ++v;
+    return v < n ? v : null_id;
+}
+
+template <typename V, typename E>
+typename FlatDigraph<V, E>::Id FlatDigraph<V, E>::next_live_edge(Id e) const noexcept
+{
+    const auto n = static_cast<Id>(edges_.size());
+    while (e < n && !edges_[e].alive) ++e;
+    return e < n ? e : null_id;
+}
+
+// BGL graph interface
+
+template <typename V, typename E>
+auto source(typename FlatDigraph<V, E>::edge_descriptor e, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.source(e);
+}
+
+template <typename V, typename E>
+auto target(typename FlatDigraph<V, E>::edge_descriptor e, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.target(e);
+}
+
+template <typename V, typename E>
+auto out_edges(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.out_edges(v);
+}
+
+template <typename V, typename E>
+auto in_edges(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.in_edges(v);
+}
+
+template <typename V, typename E>
+auto adjacent_vertices(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.adjacent_vertices(v);
+}
+
+template <typename V, typename E>
+auto inv_adjacent_vertices(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.inv_adjacent_vertices(v);
+}
+
+template <typename V, typename E>
+auto out_degree(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.out_degree(v);
+}
+
+template <typename V, typename E>
+auto in_degree(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.in_degree(v);
+}
+
+template <typename V, typename E>
+auto degree(typename FlatDigraph<V, E>::vertex_descriptor v, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.degree(v);
+}
+
+template <typename V, typename E>
+auto vertices(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.vertices();
+}
+
+template <typename V, typename E>
+auto num_vertices(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.num_vertices();
+}
+
+template <typename V, typename E>
+auto edges(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.edges();
+}
+
+template <typename V, typename E>
+auto num_edges(const FlatDigraph<V, E>& g) noexcept
+{
+    return g.num_edges();
+}
+
+template <typename V, typename E>
+auto edge(typename FlatDigraph<V, E>::vertex_descriptor u, typename FlatDigraph<V, E>::vertex_descriptor v,
+          const FlatDigraph<V, E>& g) noexcept
+{
+    return g.edge(u, v);
+}
+
+template <typename V, typename E>
+auto get(boost::vertex_index_t, const FlatDigraph<V, E>& g) noexcept
+{
+    return g.vertex_index_map();
+}
+
+template <typename V, typename E>
+auto get(boost::vertex_index_t, const FlatDigraph<V, E>& g, typename FlatDigraph<V, E>::vertex_descriptor v) noexcept
+{
+    return g.index(v);
+}
+
+} // namespace coretools
+} // namespace octopus
+
+namespace boost {
+
+template <typename V, typename E>
+struct property_map<octopus::coretools::FlatDigraph<V, E>, vertex_index_t>
+{
+    using type       = typename octopus::coretools::FlatDigraph<V, E>::VertexIndexMap;
+    using const_type = type;
+};
+
+} // namespace boost
+
+#endif
@@ -3,7 +3,7 @@
 
 #include "somatic_call.hpp"
 
-#include "utils/string_utils.hpp"
+#include "utils/maths.hpp"
 
 namespace octopus {
 
@@ -14,13 +14,12 @@ void SomaticCall::decorate(VcfRecord::Builder& record) const
     
     for (const auto& p : credible_regions_) {
         if (p.second.somatic) {
-            using utils::to_string;
             record.set_format(p.first, "SCR", {
-                    to_string(p.second.somatic->first, 2),
-                    to_string(p.second.somatic->second, 2)
+                    maths::round(p.second.somatic->first, 2),
+                    maths::round(p.second.somatic->second, 2)
             });
         } else {
-            record.set_format(p.first, "SCR", {"0", "0"});
+            record.set_format(p.first, "SCR", {0, 0});
         }
     }
 }
@@ -0,0 +1,146 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "genotype_index.hpp"
+
+namespace octopus {
+
+// GenotypeIndex
+
+bool GenotypeIndex::contains(const unsigned index) const noexcept
+{
+    return std::binary_search(begin(), end(), index);
+}
+
+unsigned GenotypeIndex::count(const unsigned index) const noexcept
+{
+    const auto equal_range = std::equal_range(begin(), end(), index);
+    return static_cast<unsigned>(std::distance(equal_range.first, equal_range.second));
+}
+
+bool operator==(const GenotypeIndex& lhs, const GenotypeIndex& rhs) noexcept
+{
+    return lhs.ploidy() == rhs.ploidy() && std::equal(std::cbegin(lhs), std::cend(lhs), std::cbegin(rhs));
+}
+
+bool operator!=(const GenotypeIndex& lhs, const GenotypeIndex& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// GenotypeIndexVector
+
+GenotypeIndexVector::GenotypeIndexVector(const unsigned ploidy)
+: ploidy_ {ploidy}
+, indices_ {}
+, zygosities_ {}
+{}
+
+unsigned GenotypeIndexVector::ploidy() const noexcept
+{
+    return ploidy_;
+}
+
+GenotypeIndexVector::size_type GenotypeIndexVector::size() const noexcept
+{
+    return zygosities_.size();
+}
+
+bool GenotypeIndexVector::empty() const noexcept
+{
+    return zygosities_.empty();
+}
+
+void GenotypeIndexVector::reserve(const size_type n)
+{
+    indices_.reserve(n * ploidy_);
+    zygosities_.reserve(n);
+}
+
+GenotypeIndex GenotypeIndexVector::operator[](const size_type n) const noexcept
+{
+    return GenotypeIndex {indices_.data() + n * ploidy_, ploidy_, zygosities_[n]};
+}
+
+GenotypeIndex GenotypeIndexVector::front() const noexcept
+{
+    return (*this)[0];
+}
+
+GenotypeIndex GenotypeIndexVector::back() const noexcept
+{
+    return (*this)[size() - 1];
+}
+
+GenotypeIndexVector::const_iterator GenotypeIndexVector::begin() const noexcept
+{
+    return const_iterator {*this, 0};
+}
+
+GenotypeIndexVector::const_iterator GenotypeIndexVector::end() const noexcept
+{
+    return const_iterator {*this, size()};
+}
+
+GenotypeIndexVector::const_iterator GenotypeIndexVector::cbegin() const noexcept
+{
+    return begin();
+}
+
+GenotypeIndexVector::const_iterator GenotypeIndexVector::cend() const noexcept
+{
+    return end();
+}
+
+// non-member methods
+
+GenotypeIndexVector generate_all_genotype_indices(const unsigned num_elements, const unsigned ploidy)
+{
+    GenotypeIndexVector result {ploidy};
+    if (ploidy == 0 || num_elements == 0) return result;
+    result.reserve(num_genotypes(num_elements, ploidy));
+    // Same enumeration as detail::do_generate_all_genotypes
+    std::vector<unsigned> element_indicies(ploidy, 0);
+    while (true) {
+        if (element_indicies[0] == num_elements) {
+            unsigned i {0};
+            while (++i < ploidy && element_indicies[i] == num_elements - 1);
+            if (i == ploidy) break;
+            ++element_indicies[i];
+            std::fill_n(std::begin(element_indicies), i + 1, element_indicies[i]);
+        }
+        result.emplace_back(std::cbegin(element_indicies), std::cend(element_indicies));
+        ++element_indicies[0];
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<Haplotype>> make_shared_haplotypes(const std::vector<Haplotype>& haplotypes)
+{
+    std::vector<std::shared_ptr<Haplotype>> result(haplotypes.size());
+    std::transform(std::cbegin(haplotypes), std::cend(haplotypes), std::begin(result),
+                   [] (const auto& haplotype) { return std::make_shared<Haplotype>(haplotype); });
+    return result;
+}
+
+Genotype<Haplotype> materialise(const GenotypeIndex& genotype, const std::vector<std::shared_ptr<Haplotype>>& haplotypes)
+{
+    Genotype<Haplotype> result {genotype.ploidy()};
+    for (const auto index : genotype) {
+        result.emplace(haplotypes[index]);
+    }
+    return result;
+}
+
+std::vector<Genotype<Haplotype>> materialise(const GenotypeIndexVector& genotypes, const std::vector<Haplotype>& haplotypes)
+{
+    const auto haplotype_ptrs = make_shared_haplotypes(haplotypes);
+    std::vector<Genotype<Haplotype>> result {};
+    result.reserve(genotypes.size());
+    for (const auto& genotype : genotypes) {
+        result.push_back(materialise(genotype, haplotype_ptrs));
+    }
+    return result;
+}
+
+} // namespace octopus
@@ -0,0 +1,163 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef genotype_index_hpp
+#define genotype_index_hpp
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "haplotype.hpp"
+#include "genotype.hpp"
+
+namespace octopus {
+
+/*
+    GenotypeIndex is a compact representation of a Genotype<Haplotype>: the indices of the genotype's
+    haplotypes in some haplotype vector, in ascending order, together with the genotype's zygosity.
+
+    GenotypeIndex does not own its indices; these live in a GenotypeIndexVector, which stores the
+    indices of all genotypes in one flat buffer. This avoids allocating a vector of shared haplotype
+    pointers for every candidate genotype. Real genotypes can be made with materialise when needed.
+ */
+class GenotypeIndex
+{
+public:
+    using value_type     = unsigned;
+    using const_iterator = const unsigned*;
+    using iterator       = const_iterator;
+
+    GenotypeIndex() = delete;
+
+    GenotypeIndex(const unsigned* indices, unsigned ploidy, unsigned zygosity) noexcept
+    : indices_ {indices}, ploidy_ {ploidy}, zygosity_ {zygosity} {}
+
+    GenotypeIndex(const GenotypeIndex&)            = default;
+    GenotypeIndex& operator=(const GenotypeIndex&) = default;
+    GenotypeIndex(GenotypeIndex&&)                 = default;
+    GenotypeIndex& operator=(GenotypeIndex&&)      = default;
+
+    ~GenotypeIndex() = default;
+
+    unsigned ploidy() const noexcept { return ploidy_; }
+    unsigned zygosity() const noexcept { return zygosity_; }
+    bool is_homozygous() const noexcept { return zygosity_ == 1; }
+
+    unsigned operator[](unsigned n) const noexcept { return indices_[n]; }
+
+    bool contains(unsigned index) const noexcept;
+    unsigned count(unsigned index) const noexcept;
+
+    const_iterator begin() const noexcept { return indices_; }
+    const_iterator end() const noexcept { return indices_ + ploidy_; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+private:
+    const unsigned* indices_;
+    unsigned ploidy_, zygosity_;
+};
+
+bool operator==(const GenotypeIndex& lhs, const GenotypeIndex& rhs) noexcept;
+bool operator!=(const GenotypeIndex& lhs, const GenotypeIndex& rhs) noexcept;
+
+class GenotypeIndexVector
+{
+public:
+    using value_type = GenotypeIndex;
+    using size_type  = std::size_t;
+
+    class const_iterator;
+    using iterator = const_iterator;
+
+    GenotypeIndexVector() = default;
+
+    explicit GenotypeIndexVector(unsigned ploidy);
+
+    GenotypeIndexVector(const GenotypeIndexVector&)            = default;
+    GenotypeIndexVector& operator=(const GenotypeIndexVector&) = default;
+    GenotypeIndexVector(GenotypeIndexVector&&)                 = default;
+    GenotypeIndexVector& operator=(GenotypeIndexVector&&)      = default;
+
+    ~GenotypeIndexVector() = default;
+
+    unsigned ploidy() const noexcept;
+    size_type size() const noexcept;
+    bool empty() const noexcept;
+
+    void reserve(size_type n);
+
+    // The range must contain ploidy indices, in any order
+    template <typename ForwardIt> void emplace_back(ForwardIt first, ForwardIt last);
+
+    GenotypeIndex operator[](size_type n) const noexcept;
+    GenotypeIndex front() const noexcept;
+    GenotypeIndex back() const noexcept;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+private:
+    unsigned ploidy_ = 0;
+    std::vector<unsigned> indices_, zygosities_;
+};
+
+class GenotypeIndexVector::const_iterator
+: public boost::iterator_facade<const_iterator, GenotypeIndex, std::random_access_iterator_tag, GenotypeIndex>
+{
+public:
+    const_iterator() = default;
+    const_iterator(const GenotypeIndexVector& genotypes, std::size_t index) noexcept : genotypes_ {&genotypes}, index_ {index} {}
+
+private:
+    friend class boost::iterator_core_access;
+
+    const GenotypeIndexVector* genotypes_ = nullptr;
+    std::size_t index_ = 0;
+
+    GenotypeIndex dereference() const noexcept { return (*genotypes_)[index_]; }
+    bool equal(const const_iterator& other) const noexcept { return index_ == other.index_; }
+    void increment() noexcept { ++index_; }
+    void decrement() noexcept { --index_; }
+    void advance(std::ptrdiff_t n) noexcept { index_ += n; }
+    std::ptrdiff_t distance_to(const const_iterator& other) const noexcept
+    {
+        return static_cast<std::ptrdiff_t>(other.index_) - static_cast<std::ptrdiff_t>(index_);
+    }
+};
+
+template <typename ForwardIt>
+void GenotypeIndexVector::emplace_back(ForwardIt first, ForwardIt last)
+{
+    assert(static_cast<unsigned>(std::distance(first, last)) == ploidy_);
+    const auto genotype_begin = indices_.size();
+    indices_.insert(std::cend(indices_), first, last);
+    const auto genotype_first = std::next(std::begin(indices_), genotype_begin);
+    std::sort(genotype_first, std::end(indices_));
+    unsigned zygosity {0};
+    for (auto itr = genotype_first; itr != std::end(indices_); ++zygosity) {
+        itr = std::find_if(std::next(itr), std::end(indices_), [itr] (const auto index) { return index != *itr; });
+    }
+    zygosities_.push_back(zygosity);
+}
+
+// Generates all genotypes of the given ploidy from num_elements elements, in the same order
+// as generate_all_genotypes
+GenotypeIndexVector generate_all_genotype_indices(unsigned num_elements, unsigned ploidy);
+
+std::vector<std::shared_ptr<Haplotype>> make_shared_haplotypes(const std::vector<Haplotype>& haplotypes);
+
+Genotype<Haplotype> materialise(const GenotypeIndex& genotype, const std::vector<std::shared_ptr<Haplotype>>& haplotypes);
+std::vector<Genotype<Haplotype>> materialise(const GenotypeIndexVector& genotypes, const std::vector<Haplotype>& haplotypes);
+
+} // namespace octopus
+
+#endif
@@ -380,6 +380,22 @@ Haplotype::NucleotideSequence Haplotype::fetch_reference_sequence(const ContigRe
     return result;
 }
 
+bool Haplotype::is_explicit_allele_sequence_consistent() const
+{
+    if (explicit_alleles_.empty()) return sequence_.size() == size(region_);
+    if (!octopus::contains(region_.contig_region(), explicit_allele_region_)) return false;
+    // The explicit alleles must be sorted and leave no gaps, as the Builder makes them
+    const auto is_gap = [] (const ContigAllele& lhs, const ContigAllele& rhs) { return mapped_end(lhs) != mapped_begin(rhs); };
+    if (std::adjacent_find(std::cbegin(explicit_alleles_), std::cend(explicit_alleles_), is_gap) != std::cend(explicit_alleles_)) {
+        return false;
+    }
+    auto num_bases = size(region_) - region_size(explicit_allele_region_);
+    for (const auto& allele : explicit_alleles_) {
+        num_bases += octopus::sequence_size(allele);
+    }
+    return sequence_.size() == num_bases;
+}
+
 // Builder
 
 Haplotype::Builder::Builder(const GenomicRegion& region, const ReferenceGenome& reference)
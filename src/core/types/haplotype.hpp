@@ -5,12 +5,14 @@
 #define haplotype_hpp
 
 #include <deque>
+#include <vector>
 #include <cstddef>
 #include <functional>
 #include <type_traits>
 #include <utility>
 #include <numeric>
 #include <iosfwd>
+#include <cassert>
 
 #include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
@@ -33,6 +35,8 @@ class Variant;
  */
 class Haplotype;
 
+namespace coretools { class HaplotypeTree; }
+
 namespace debug {
 
 template <typename S> void print_alleles(S&& stream, const Haplotype& haplotype);
@@ -102,6 +106,7 @@ public:
     friend bool is_reference(const Haplotype& haplotype);
     friend Haplotype expand(const Haplotype& haplotype, MappingDomain::Position n);
     friend Haplotype remap(const Haplotype& haplotype, const GenomicRegion& region);
+    friend class coretools::HaplotypeTree;
     
     template <typename S> friend void debug::print_alleles(S&&, const Haplotype&);
     template <typename S> friend void debug::print_variant_alleles(S&&, const Haplotype&);
@@ -116,10 +121,17 @@ private:
     
     using AlleleIterator = decltype(explicit_alleles_)::const_iterator;
     
+    // For friends that have already built the haplotype sequence, which must be the reference
+    // sequence of region with the explicit alleles substituted in
+    template <typename R>
+    Haplotype(R&& region, std::vector<ContigAllele>&& explicit_alleles, NucleotideSequence&& sequence,
+              const ReferenceGenome& reference);
+    
     void append(NucleotideSequence& result, const ContigAllele& allele) const;
     void append(NucleotideSequence& result, AlleleIterator first, AlleleIterator last) const;
     void append_reference(NucleotideSequence& result, const ContigRegion& region) const;
     NucleotideSequence fetch_reference_sequence(const ContigRegion& region) const;
+    bool is_explicit_allele_sequence_consistent() const;
 };
 
 template <typename R>
@@ -192,6 +204,22 @@ Haplotype::Haplotype(R&& region, ForwardIt first_allele, ForwardIt last_allele,
     cached_hash_ = std::hash<NucleotideSequence>()(sequence_);
 }
 
+template <typename R>
+Haplotype::Haplotype(R&& region, std::vector<ContigAllele>&& explicit_alleles, NucleotideSequence&& sequence,
+                     const ReferenceGenome& reference)
+: region_ {std::forward<R>(region)}
+, explicit_alleles_ {std::move(explicit_alleles)}
+, explicit_allele_region_ {}
+, sequence_ {std::move(sequence)}
+, cached_hash_ {std::hash<NucleotideSequence>()(sequence_)}
+, reference_ {reference}
+{
+    if (!explicit_alleles_.empty()) {
+        explicit_allele_region_ = encompassing_region(explicit_alleles_.front(), explicit_alleles_.back());
+    }
+    assert(is_explicit_allele_sequence_consistent());
+}
+
 class Haplotype::Builder
 {
 public:
@@ -0,0 +1,56 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "htslib_thread_pool.hpp"
+
+#include <stdexcept>
+
+#include "htslib/thread_pool.h"
+
+namespace octopus { namespace io {
+
+namespace {
+
+struct HtslibThreadPool
+{
+    htsThreadPool pool = {nullptr, 0};
+    
+    ~HtslibThreadPool() noexcept
+    {
+        // All files using the pool are closed by now as they are owned by objects with automatic storage
+        if (pool.pool) hts_tpool_destroy(pool.pool);
+    }
+};
+
+HtslibThreadPool& get_htslib_thread_pool() noexcept
+{
+    static HtslibThreadPool result {};
+    return result;
+}
+
+} // namespace
+
+void init_htslib_thread_pool(const unsigned num_threads)
+{
+    auto& htslib_pool = get_htslib_thread_pool();
+    if (htslib_pool.pool.pool) {
+        throw std::logic_error {"init_htslib_thread_pool: pool is already initialised"};
+    }
+    if (num_threads > 0) {
+        htslib_pool.pool.pool = hts_tpool_init(static_cast<int>(num_threads));
+        if (!htslib_pool.pool.pool) {
+            throw std::runtime_error {"init_htslib_thread_pool: could not make htslib thread pool"};
+        }
+    }
+}
+
+void attach_htslib_thread_pool(htsFile* file) noexcept
+{
+    auto& htslib_pool = get_htslib_thread_pool();
+    if (file && htslib_pool.pool.pool) {
+        hts_set_thread_pool(file, &htslib_pool.pool);
+    }
+}
+
+} // namespace io
+} // namespace octopus
@@ -0,0 +1,25 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef htslib_thread_pool_hpp
+#define htslib_thread_pool_hpp
+
+#include "htslib/hts.h"
+
+namespace octopus { namespace io {
+
+/*
+    A process wide htslib thread pool shared by every open htslib file, so BGZF and CRAM
+    (de)compression runs in parallel with the threads reading and writing records.
+ */
+
+// Should be called once, before any files are opened. Zero threads means no pool.
+void init_htslib_thread_pool(unsigned num_threads);
+
+// Does nothing if there is no pool or the file is not compressed
+void attach_htslib_thread_pool(htsFile* file) noexcept;
+
+} // namespace io
+} // namespace octopus
+
+#endif
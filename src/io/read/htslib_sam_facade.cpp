@@ -19,6 +19,8 @@
 #include "exceptions/missing_file_error.hpp"
 #include "exceptions/missing_index_error.hpp"
 #include "exceptions/malformed_file_error.hpp"
+#include "utils/packed_sequence.hpp"
+#include "io/htslib_thread_pool.hpp"
 
 namespace octopus { namespace io {
 
@@ -149,7 +151,9 @@ namespace {
 auto open_hts_file(const boost::filesystem::path& file)
 {
     hts_verbose = 0; // disable hts error reporting
-    return sam_open(file.c_str(), "r");
+    const auto result = sam_open(file.c_str(), "r");
+    io::attach_htslib_thread_pool(result);
+    return result;
 }
 
 bool is_cram(const boost::filesystem::path& file)
@@ -165,7 +169,7 @@ HtslibSamFacade::HtslibSamFacade(Path file_path)
 , hts_header_ {(hts_file_) ? sam_hdr_read(hts_file_.get()) : nullptr, HtsHeaderDeleter {}}
 , hts_index_ {(hts_file_) ? sam_index_load(hts_file_.get(), file_path_.c_str()) : nullptr, HtsIndexDeleter {}}
 , hts_targets_ {}
-, contig_names_ {}
+, contig_ids_ {}
 , sample_names_ {}
 , samples_ {}
 {
@@ -214,7 +218,7 @@ bool HtslibSamFacade::is_open() const noexcept
 
 void HtslibSamFacade::open()
 {
-    hts_file_.reset(sam_open(file_path_.string().c_str(), "r"));
+    hts_file_.reset(open_hts_file(file_path_));
     
     if (hts_file_) {
         hts_header_.reset(sam_hdr_read(hts_file_.get()));
@@ -589,11 +593,11 @@ std::string extract_tag_value(const std::string& line, const std::string& tag)
 void HtslibSamFacade::init_maps()
 {
     hts_targets_.reserve(hts_header_->n_targets);
-    contig_names_.reserve(hts_header_->n_targets);
+    contig_ids_.reserve(hts_header_->n_targets);
     
     for (HtsTid target {0}; target < hts_header_->n_targets; ++target) {
         hts_targets_.emplace(hts_header_->target_name[target], target);
-        contig_names_.emplace(target, hts_header_->target_name[target]);
+        contig_ids_.push_back(intern_contig(hts_header_->target_name[target]));
     }
     
     const std::string header_text(hts_header_->text, hts_header_->l_text);
@@ -633,9 +637,14 @@ HtslibSamFacade::HtsTid HtslibSamFacade::get_htslib_target(const GenomicRegion::
     return hts_targets_.at(contig);
 }
 
+GenomicRegion::ContigId HtslibSamFacade::get_contig_id(const HtsTid target) const
+{
+    return contig_ids_.at(target);
+}
+
 const std::string& HtslibSamFacade::get_contig_name(HtsTid target) const
 {
-    return contig_names_.at(target);
+    return resolve_contig(get_contig_id(target));
 }
 
 // HtslibIterator
@@ -695,22 +704,10 @@ auto extract_sequence_length(const bam1_t* b) noexcept
     return b->core.l_qseq;
 }
 
-char extract_base(const std::uint8_t* hts_sequence, const std::uint32_t index) noexcept
+// The sequence stays in the record's 4-bit encoding until decoded
+utils::PackedSequenceView extract_packed_sequence(const bam1_t* b) noexcept
 {
-    static constexpr const char* symbolTable {"=ACMGRSVTWYHKDBN"};
-    return symbolTable[bam_seqi(hts_sequence, index)];
-}
-
-AlignedRead::NucleotideSequence extract_sequence(const bam1_t* b)
-{
-    using NucleotideSequence = AlignedRead::NucleotideSequence;
-    const auto sequence_length  = static_cast<NucleotideSequence::size_type>(extract_sequence_length(b));
-    const auto hts_sequence     = bam_get_seq(b);
-    NucleotideSequence result(sequence_length, 'N');
-    std::uint32_t i {0};
-    std::generate_n(std::begin(result), sequence_length,
-                    [&i, &hts_sequence] () { return extract_base(hts_sequence, i++); });
-    return result;
+    return utils::PackedSequenceView {bam_get_seq(b), static_cast<std::size_t>(extract_sequence_length(b))};
 }
 
 AlignedRead::BaseQualityVector extract_qualities(const bam1_t* b)
@@ -798,13 +795,13 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
     auto cigar = extract_cigar_string(hts_bam1_.get());
     const auto& info = hts_bam1_->core;
     auto read_begin_tmp = clipped_begin(cigar, info.pos);
-    auto sequence = extract_sequence(hts_bam1_.get());
+    auto packed_sequence = extract_packed_sequence(hts_bam1_.get());
     
     if (read_begin_tmp < 0) {
         // Then the read hangs off the left of the contig, and we must remove bases, base_qualities, and
         // adjust the cigar string as we cannot have a negative begin position
         const auto overhang_size = static_cast<unsigned>(std::abs(read_begin_tmp));
-        sequence.erase(begin(sequence), next(begin(sequence), overhang_size));
+        packed_sequence.remove_prefix(overhang_size);
         qualities.erase(begin(qualities), next(begin(qualities), overhang_size));
         
         auto soft_clip_size = cigar.front().size();
@@ -817,13 +814,14 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
     }
     
     const auto read_begin = static_cast<AlignedRead::MappingDomain::Position>(read_begin_tmp);
-    const auto& contig_name = hts_facade_.get_contig_name(info.tid);
+    const auto contig_id = hts_facade_.get_contig_id(info.tid);
+    auto sequence = utils::decode(packed_sequence);
     
     if (has_multiple_segments(info)) {
         return AlignedRead {
             extract_read_name(hts_bam1_.get()),
             GenomicRegion {
-                contig_name,
+                contig_id,
                 read_begin,
                 read_begin + octopus::reference_size<AlignedRead::MappingDomain::Position>(cigar)
             },
@@ -841,7 +839,7 @@ AlignedRead HtslibSamFacade::HtslibIterator::operator*() const
         return AlignedRead {
             extract_read_name(hts_bam1_.get()),
             GenomicRegion {
-                contig_name,
+                contig_id,
                 read_begin,
                 read_begin + octopus::reference_size<AlignedRead::MappingDomain::Size>(cigar)
             },
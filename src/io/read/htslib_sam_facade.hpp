@@ -152,13 +152,14 @@ private:
     std::unique_ptr<hts_idx_t, HtsIndexDeleter> hts_index_;
     
     std::unordered_map<GenomicRegion::ContigName, HtsTid> hts_targets_;
-    std::unordered_map<HtsTid, GenomicRegion::ContigName> contig_names_;
+    std::vector<GenomicRegion::ContigId> contig_ids_;
     std::unordered_map<ReadGroupIdType, SampleName> sample_names_;
     
     std::vector<SampleName> samples_;
     
     void init_maps();
     HtsTid get_htslib_target(const GenomicRegion::ContigName& contig) const;
+    GenomicRegion::ContigId get_contig_id(HtsTid target) const;
     const GenomicRegion::ContigName& get_contig_name(HtsTid target) const;
     std::uint64_t get_num_mapped_reads(const GenomicRegion::ContigName& contig) const;
     ReadContainer fetch_all_reads(const GenomicRegion& region) const;
@@ -0,0 +1,226 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "mapped_fasta.hpp"
+
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <boost/filesystem/operations.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "utils/sequence_utils.hpp"
+#include "exceptions/missing_file_error.hpp"
+#include "exceptions/missing_index_error.hpp"
+#include "exceptions/malformed_file_error.hpp"
+#include "exceptions/program_error.hpp"
+
+namespace octopus { namespace io {
+
+namespace {
+
+class MissingFasta : public MissingFileError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+public:
+    MissingFasta(MappedFasta::Path file) : MissingFileError {std::move(file), "fasta"} {}
+};
+
+class MalformedFasta : public MalformedFileError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+public:
+    MalformedFasta(MappedFasta::Path file) : MalformedFileError {std::move(file), "fasta"} {}
+};
+
+class MissingFastaIndex : public MissingIndexError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+
+    std::string do_help() const override
+    {
+        return "ensure that a valid fasta index (.fai) exists in the same directory as the given "
+        "fasta file. You can make one with the 'samtools faidx' command";
+    }
+public:
+    MissingFastaIndex(MappedFasta::Path file) : MissingIndexError {std::move(file), "fasta"} {}
+};
+
+class MalformedFastaIndex : public MalformedFileError
+{
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+public:
+    MalformedFastaIndex(MappedFasta::Path file) : MalformedFileError {std::move(file), "fasta"} {}
+};
+
+class BadReferenceRequestRegion : public ProgramError
+{
+    GenomicRegion region;
+
+    std::string do_why() const override
+    {
+        return "Requested bad reference region " + to_string(region);
+    }
+    std::string do_help() const override
+    {
+        return "Send a debug report";
+    }
+    std::string do_where() const override
+    {
+        return "MappedFasta";
+    }
+public:
+    BadReferenceRequestRegion(GenomicRegion region) : region {std::move(region)} {}
+};
+
+bool is_valid_fasta(const MappedFasta::Path& path)
+{
+    const auto extension = path.extension().string();
+    return extension == ".fa" || extension == ".fasta";
+}
+
+bool is_valid_fasta_index(const MappedFasta::Path& path)
+{
+    return path.extension().string() == ".fai";
+}
+
+} // namespace
+
+MappedFasta::MappedFasta(Path fasta_path)
+: MappedFasta {fasta_path, fasta_path.string() + ".fai", Options {}}
+{}
+
+MappedFasta::MappedFasta(Path fasta_path, Options options)
+: MappedFasta {fasta_path, fasta_path.string() + ".fai", options}
+{}
+
+MappedFasta::MappedFasta(Path fasta_path, Path fasta_index_path)
+: MappedFasta {std::move(fasta_path), std::move(fasta_index_path), Options {}}
+{}
+
+MappedFasta::MappedFasta(Path fasta_path, Path fasta_index_path, Options options)
+: path_ {std::move(fasta_path)}
+, index_path_ {std::move(fasta_index_path)}
+, fasta_ {}
+, fasta_index_ {}
+, options_ {options}
+{
+    using boost::filesystem::exists;
+    if (!exists(path_)) {
+        throw MissingFasta {path_};
+    }
+    if (!is_valid_fasta(path_)) {
+        throw MalformedFasta {path_};
+    }
+    if (!exists(index_path_)) {
+        index_path_ = path_;
+        index_path_.replace_extension("fai");
+        if (!exists(index_path_)) {
+            throw MissingFastaIndex {path_};
+        }
+    }
+    if (!is_valid_fasta_index(index_path_)) {
+        throw MalformedFastaIndex {index_path_};
+    }
+    // Throws std::ios_base::failure if the file cannot be mapped
+    fasta_       = std::make_shared<MappedFile>(path_.string());
+    fasta_index_ = std::make_shared<bioio::FastaIndex>(bioio::read_fasta_index(index_path_.string()));
+}
+
+// virtual private methods
+
+std::unique_ptr<ReferenceReader> MappedFasta::do_clone() const
+{
+    return std::make_unique<MappedFasta>(*this);
+}
+
+bool MappedFasta::do_is_open() const noexcept
+{
+    return fasta_ && fasta_->is_open();
+}
+
+std::string MappedFasta::do_fetch_reference_name() const
+{
+    return path_.stem().string();
+}
+
+std::vector<MappedFasta::ContigName> MappedFasta::do_fetch_contig_names() const
+{
+    return bioio::read_fasta_index_contig_names(index_path_.string());
+}
+
+MappedFasta::GenomicSize MappedFasta::do_fetch_contig_size(const ContigName& contig) const
+{
+    return static_cast<GenomicSize>(get_index(contig).length);
+}
+
+MappedFasta::GeneticSequence MappedFasta::do_fetch_sequence(const GenomicRegion& region) const
+{
+    const auto& index = get_index(contig_name(region));
+    GeneticSequence result {};
+    const std::size_t begin {mapped_begin(region)};
+    if (begin < index.length) {
+        result.resize(std::min(static_cast<std::size_t>(size(region)), index.length - begin));
+        result.resize(copy_bases(index, begin, result.size(), &result[0]));
+    }
+    if (options_.base_transform_policy == Options::BaseTransformPolicy::capitalise) {
+        utils::capitalise(result);
+    }
+    if (result.size() < size(region)) {
+        if (options_.base_fill_policy == Options::BaseFillPolicy::throw_exception) {
+            throw BadReferenceRequestRegion {region};
+        }
+        if (options_.base_fill_policy == Options::BaseFillPolicy::fill_with_ns) {
+            result.resize(size(region), 'N');
+        }
+    }
+    return result;
+}
+
+// private methods
+
+const bioio::FastaContigIndex& MappedFasta::get_index(const ContigName& contig) const
+{
+    const auto itr = fasta_index_->find(contig);
+    if (itr == std::cend(*fasta_index_)) {
+        throw std::runtime_error {"contig \"" + contig +
+            "\" not found in fasta index \"" + index_path_.string() + "\""};
+    }
+    return itr->second;
+}
+
+std::size_t MappedFasta::copy_bases(const bioio::FastaContigIndex& index, const std::size_t begin,
+                                    const std::size_t length, char* result) const noexcept
+{
+    // Bases are stored in lines of line_length bases, each followed by a line terminator
+    const auto terminator_length = index.line_byte_length - index.line_length;
+    auto offset = index.offset + (begin / index.line_length) * index.line_byte_length + begin % index.line_length;
+    auto line_remaining = index.line_length - begin % index.line_length;
+    const auto file_size = fasta_->size();
+    std::size_t num_copied {0};
+    while (num_copied < length && offset < file_size) {
+        const auto n = std::min({line_remaining, length - num_copied, file_size - offset});
+        std::memcpy(result + num_copied, fasta_->data() + offset, n);
+        num_copied += n;
+        offset += n + terminator_length;
+        line_remaining = index.line_length;
+    }
+    return num_copied;
+}
+
+} // namespace io
+} // namespace octopus
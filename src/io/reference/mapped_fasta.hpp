@@ -0,0 +1,83 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef mapped_fasta_hpp
+#define mapped_fasta_hpp
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "bioio.hpp"
+
+#include "reference_reader.hpp"
+#include "fasta.hpp"
+
+namespace octopus {
+
+class GenomicRegion;
+
+namespace io {
+
+/*
+    A Fasta reader that memory maps the file rather than streaming it.
+
+    Fetches are plain copies from the mapping, so no locks or file seeks are needed and any number
+    of threads can fetch concurrently. Clones share the same mapping, and the mapped pages live in
+    the OS page cache, so they are shared with every other process reading the same file.
+ */
+class MappedFasta : public ReferenceReader
+{
+public:
+    using Path = boost::filesystem::path;
+
+    using ContigName      = ReferenceReader::ContigName;
+    using GenomicSize     = ReferenceReader::GenomicSize;
+    using GeneticSequence = ReferenceReader::GeneticSequence;
+
+    using Options = Fasta::Options;
+
+    MappedFasta() = delete;
+
+    MappedFasta(Path fasta_path);
+    MappedFasta(Path fasta_path, Options options);
+    MappedFasta(Path fasta_path, Path fasta_index_path);
+    MappedFasta(Path fasta_path, Path fasta_index_path, Options options);
+
+    MappedFasta(const MappedFasta&)            = default;
+    MappedFasta& operator=(const MappedFasta&) = default;
+    MappedFasta(MappedFasta&&)                 = default;
+    MappedFasta& operator=(MappedFasta&&)      = default;
+
+    ~MappedFasta() = default;
+
+private:
+    using MappedFile = boost::iostreams::mapped_file_source;
+
+    Path path_;
+    Path index_path_;
+
+    std::shared_ptr<const MappedFile> fasta_;
+    std::shared_ptr<const bioio::FastaIndex> fasta_index_;
+
+    Options options_;
+
+    std::unique_ptr<ReferenceReader> do_clone() const override;
+    bool do_is_open() const noexcept override;
+    std::string do_fetch_reference_name() const override;
+    std::vector<ContigName> do_fetch_contig_names() const override;
+    GenomicSize do_fetch_contig_size(const ContigName& contig) const override;
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override;
+
+    const bioio::FastaContigIndex& get_index(const ContigName& contig) const;
+    std::size_t copy_bases(const bioio::FastaContigIndex& index, std::size_t begin, std::size_t length,
+                           char* result) const noexcept;
+};
+
+} // namespace io
+} // namespace octopus
+
+#endif
@@ -7,8 +7,10 @@
 #include <iterator>
 #include <utility>
 #include <numeric>
+#include <ios>
 
 #include "fasta.hpp"
+#include "mapped_fasta.hpp"
 #include "threadsafe_fasta.hpp"
 #include "caching_fasta.hpp"
 
@@ -23,6 +25,7 @@ ReferenceGenome::ReferenceGenome(std::unique_ptr<io::ReferenceReader> impl)
         try {
             name_ = impl_->fetch_reference_name();
             ordered_contigs_ = impl_->fetch_contig_names();
+            register_contigs(ordered_contigs_);
             contig_sizes_.reserve(ordered_contigs_.size());
             for (const auto& contig_name : ordered_contigs_) {
                 contig_sizes_.emplace(contig_name, impl_->fetch_contig_size(contig_name));
@@ -106,6 +109,12 @@ ReferenceGenome make_reference(boost::filesystem::path reference_path,
         options.base_transform_policy = Fasta::Options::BaseTransformPolicy::capitalise;
     }
     options.base_fill_policy = Fasta::Options::BaseFillPolicy::fill_with_ns;
+    try {
+        // Fetches from the mapping need no locks or seeks, and the OS page cache makes a cache of our own redundant
+        return ReferenceGenome {std::make_unique<MappedFasta>(reference_path, options)};
+    } catch (const std::ios_base::failure&) {
+        // The file could not be mapped (e.g. not enough address space), so fall back to streaming it
+    }
     if (is_threaded) {
         impl_ = std::make_unique<ThreadsafeFasta>(std::make_unique<Fasta>(reference_path, options));
     } else {
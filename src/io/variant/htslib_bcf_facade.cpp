@@ -22,6 +22,7 @@
 #include "vcf_spec.hpp"
 #include "vcf_header.hpp"
 #include "vcf_record.hpp"
+#include "io/htslib_thread_pool.hpp"
 
 #include <iostream> // TEST
 
@@ -33,6 +34,35 @@ static const std::string vcfMissingValue {vcfspec::missingValue};
 
 namespace bc = boost::container;
 
+template <typename T> VcfRecord::ValueType make_value(T value);
+
+template <>
+VcfRecord::ValueType make_value<int>(const int value)
+{
+    return value != bcf_int32_missing ? VcfRecord::ValueType {value} : VcfRecord::ValueType {};
+}
+
+template <>
+VcfRecord::ValueType make_value<float>(const float value)
+{
+    return !bcf_float_is_missing(value) ? VcfRecord::ValueType {value} : VcfRecord::ValueType {};
+}
+
+int get_int32(const VcfRecord::ValueType& value)
+{
+    return !value.is_missing() ? static_cast<int>(value.as_integer()) : bcf_int32_missing;
+}
+
+float get_float(const VcfRecord::ValueType& value)
+{
+    if (value.is_missing()) {
+        float result;
+        bcf_float_set_missing(result);
+        return result;
+    }
+    return static_cast<float>(value.as_real());
+}
+
 } // namespace
 
 char* convert(const std::string& source)
@@ -83,6 +113,7 @@ HtslibBcfFacade::HtslibBcfFacade()
     if (file_ == nullptr) {
         throw std::runtime_error {"HtslibBcfFacade: could not open stdout writer"};
     }
+    io::attach_htslib_thread_pool(file_.get());
     if (header_ == nullptr) {
         throw std::runtime_error {"HtslibBcfFacade: failed to initialise stdout header"};
     }
@@ -99,6 +130,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         if (boost::filesystem::exists(file_path_)) {
             file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
             if (file_ == nullptr) return;
+            io::attach_htslib_thread_pool(file_.get());
             header_.reset(bcf_hdr_read(file_.get()));
             if (header_ == nullptr) {
                 throw std::runtime_error {"HtslibBcfFacade: could not make header for file " + file_path_.string()};
@@ -109,6 +141,7 @@ HtslibBcfFacade::HtslibBcfFacade(Path file_path, Mode mode)
         }
     } else {
         file_.reset(bcf_open(file_path_.c_str(), hts_mode.c_str()));
+        io::attach_htslib_thread_pool(file_.get());
         header_.reset(bcf_hdr_init(hts_mode.c_str()));
     }
 }
@@ -576,25 +609,19 @@ void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& b
         }
         
         const char* key {header->id[BCF_DT_ID][key_id].key};
-        std::vector<std::string> values {};
+        std::vector<VcfRecord::ValueType> values {};
         
         switch (bcf_hdr_id2type(header, BCF_HL_INFO, key_id)) {
             case BCF_HT_INT:
                 if (bcf_get_info_int32(header, record, key, &intinfo, &nintinfo) > 0) {
                     values.reserve(nintinfo);
-                    std::transform(intinfo, intinfo + nintinfo, std::back_inserter(values),
-                                   [] (auto v) {
-                                       return v != bcf_int32_missing ? std::to_string(v) : vcfMissingValue;
-                                   });
+                    std::transform(intinfo, intinfo + nintinfo, std::back_inserter(values), make_value<int>);
                 }
                 break;
             case BCF_HT_REAL:
                 if (bcf_get_info_float(header, record, key, &floatinfo, &nfloatinfo) > 0) {
                     values.reserve(nfloatinfo);
-                    std::transform(floatinfo, floatinfo + nfloatinfo, std::back_inserter(values),
-                                   [] (auto v) {
-                                       return v != bcf_float_missing ? std::to_string(v) : vcfMissingValue;
-                                   });
+                    std::transform(floatinfo, floatinfo + nfloatinfo, std::back_inserter(values), make_value<float>);
                 }
                 break;
             case BCF_HT_STR:
@@ -602,13 +629,14 @@ void extract_info(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder& b
                 const auto nchars = bcf_get_info_string(header, record, key, &stringinfo, &nstringinfo);
                 if (nchars > 0) {
                     std::string tmp(stringinfo, nchars);
-                    values = utils::split(tmp, vcfspec::info::valueSeperator);
+                    auto strings = utils::split(tmp, vcfspec::info::valueSeperator);
+                    values.assign(std::make_move_iterator(std::begin(strings)), std::make_move_iterator(std::end(strings)));
                 }
                 break;
             }
             case BCF_HT_FLAG:
                 values.reserve(1);
-                values.emplace_back((bcf_get_info_flag(header, record, key, &flaginfo, &nflaginfo) == 1) ? "1" : "0");
+                values.emplace_back((bcf_get_info_flag(header, record, key, &flaginfo, &nflaginfo) == 1) ? 1 : 0);
                 break;
         }
         
@@ -633,33 +661,30 @@ void set_info(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source)
             case BCF_HT_INT:
             {
                 bc::small_vector<int, defaultBufferCapacity> vals(num_values);
-                std::transform(std::cbegin(values), std::cend(values), std::begin(vals),
-                               [] (const auto& v) {
-                                   return v != vcfMissingValue ? std::stoi(v) : bcf_int32_missing;
-                               });
+                std::transform(std::cbegin(values), std::cend(values), std::begin(vals), get_int32);
                 bcf_update_info_int32(header, dest, key.c_str(), vals.data(), num_values);
                 break;
             }
             case BCF_HT_REAL:
             {
                 bc::small_vector<float, defaultBufferCapacity> vals(num_values);
-                std::transform(std::cbegin(values), std::cend(values), std::begin(vals),
-                               [] (const auto& v) {
-                                   return v != vcfMissingValue ? std::stof(v) : bcf_float_missing;
-                               });
+                std::transform(std::cbegin(values), std::cend(values), std::begin(vals), get_float);
                 bcf_update_info_float(header, dest, key.c_str(), vals.data(), num_values);
                 break;
             }
             case BCF_HT_STR:
             {
-                // Can we also use small_vector here?
-                const auto vals = utils::join(values, vcfspec::info::valueSeperator);
+                std::string vals {};
+                for (const auto& value : values) {
+                    if (!vals.empty()) vals += vcfspec::info::valueSeperator;
+                    vals += value.to_string();
+                }
                 bcf_update_info_string(header, dest, key.c_str(), vals.c_str());
                 break;
             }
             case BCF_HT_FLAG:
             {
-                bcf_update_info_flag(header, dest, key.c_str(), "", values.empty() || values.front() == "1");
+                bcf_update_info_flag(header, dest, key.c_str(), "", values.empty() || values.front() == VcfRecord::ValueType {1});
                 break;
             }
         }
@@ -738,7 +763,7 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
     for (auto it = std::next(std::cbegin(format)), end = std::cend(format); it != end; ++it) {
         const auto& key = *it;
         
-        std::vector<std::vector<std::string>> values(num_samples, std::vector<std::string> {});
+        std::vector<std::vector<VcfRecord::ValueType>> values(num_samples, std::vector<VcfRecord::ValueType> {});
         
         switch (bcf_hdr_id2type(header, BCF_HL_FMT, bcf_hdr_id2int(header, BCF_DT_ID, key.c_str()))) {
             case BCF_HT_INT:
@@ -748,9 +773,7 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
                     for (unsigned sample {0}; sample < num_samples; ++sample, ptr += num_values_per_sample) {
                         values[sample].reserve(num_values_per_sample);
                         std::transform(ptr, ptr + num_values_per_sample, std::back_inserter(values[sample]),
-                                       [] (auto v) {
-                                           return v != bcf_int32_missing ? std::to_string(v) : vcfMissingValue;
-                                       });
+                                       make_value<int>);
                     }
                 }
                 break;
@@ -760,11 +783,8 @@ void extract_samples(const bcf_hdr_t* header, bcf1_t* record, VcfRecord::Builder
                     auto ptr = floatformat;
                     for (unsigned sample {0}; sample < num_samples; ++sample, ptr += num_values_per_sample) {
                         values[sample].reserve(num_values_per_sample);
-                        
-                        std::transform(ptr, ptr + num_samples, std::back_inserter(values[sample]),
-                                       [] (auto v) {
-                                           return v != bcf_float_missing ? std::to_string(v) : vcfMissingValue;
-                                       });
+                        std::transform(ptr, ptr + num_values_per_sample, std::back_inserter(values[sample]),
+                                       make_value<float>);
                     }
                 }
                 break;
@@ -835,7 +855,7 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
         
         for (const auto& sample : samples) {
             const bool is_phased {source.is_sample_phased(sample)};
-            const auto& genotype = source.get_sample_value(sample, vcfspec::format::genotype);
+            const auto& genotype = source.genotype(sample);
             const auto ploidy = static_cast<unsigned>(genotype.size());
             
             it = std::transform(std::cbegin(genotype), std::cend(genotype), it,
@@ -861,10 +881,7 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
               auto it = std::begin(typed_values);
               for (const auto& sample : samples) {
                   const auto& values = source.get_sample_value(sample, key);
-                  it = std::transform(std::cbegin(values), std::cend(values), it,
-                                      [] (const auto& v) {
-                                          return v != vcfMissingValue ? std::stoi(v) : bcf_int32_missing;
-                                      });
+                  it = std::transform(std::cbegin(values), std::cend(values), it, get_int32);
               }
               bcf_update_format_int32(header, dest, key.c_str(), typed_values.data(), num_values);
               break;
@@ -875,23 +892,23 @@ void set_samples(const bcf_hdr_t* header, bcf1_t* dest, const VcfRecord& source,
               auto it = std::begin(typed_values);
               for (const auto& sample : samples) {
                   const auto& values = source.get_sample_value(sample, key);
-                  it = std::transform(std::cbegin(values), std::cend(values), it,
-                                      [] (const auto& v) {
-                                          return v != vcfMissingValue ? std::stof(v) : bcf_float_missing;
-                                      });
+                  it = std::transform(std::cbegin(values), std::cend(values), it, get_float);
               }
               bcf_update_format_float(header, dest, key.c_str(), typed_values.data(), num_values);
               break;
           }
           case BCF_HT_STR:
           {
-              bc::small_vector<const char*, defaultValueCapacity> typed_values(num_values);
-              auto it = std::begin(typed_values);
+              std::vector<std::string> strings {};
+              strings.reserve(num_values);
               for (const auto& sample : samples) {
                   const auto& values = source.get_sample_value(sample, key);
-                  it = std::transform(std::cbegin(values), std::cend(values), it,
-                                      [] (const auto& value) { return value.c_str(); });
+                  std::transform(std::cbegin(values), std::cend(values), std::back_inserter(strings),
+                                 [] (const auto& value) { return value.to_string(); });
               }
+              bc::small_vector<const char*, defaultValueCapacity> typed_values(num_values);
+              std::transform(std::cbegin(strings), std::cend(strings), std::begin(typed_values),
+                             [] (const auto& value) { return value.c_str(); });
               bcf_update_format_string(header, dest, key.c_str(), typed_values.data(), num_values);
               break;
           }
@@ -5,6 +5,7 @@
 #define vcf_hpp
 
 #include "io/variant/vcf_type.hpp"
+#include "io/variant/vcf_value.hpp"
 #include "io/variant/vcf_header.hpp"
 #include "io/variant/vcf_record.hpp"
 #include "io/variant/vcf_reader.hpp"
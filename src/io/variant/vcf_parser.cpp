@@ -4,6 +4,7 @@
 #include "vcf_parser.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <stdexcept>
 
 #include <boost/optional.hpp>
@@ -297,13 +298,20 @@ std::vector<std::string> split(const std::string& str, char delim = ',')
     return result;
 }
 
+// Text values are kept as strings, and only parsed if a number is requested
+std::vector<VcfRecord::ValueType> split_values(const std::string& str, char delim = ',')
+{
+    auto values = split(str, delim);
+    return {std::make_move_iterator(std::begin(values)), std::make_move_iterator(std::end(values))};
+}
+
 void parse_info_field(const std::string& field, VcfRecord::Builder& rb)
 {
     const auto pos = field.find_first_of('=');
     if (pos == std::string::npos) {
         rb.set_info_flag(field);
     } else {
-        rb.set_info(field.substr(0, pos), split(field.substr(pos + 1), ','));
+        rb.set_info(field.substr(0, pos), split_values(field.substr(pos + 1), ','));
     }
 }
 
@@ -364,7 +372,7 @@ void parse_sample(const std::string& column, const VcfRecord::SampleName& sample
     }
     std::for_each(first_value, std::istream_iterator<SampleField> {},
                   [&rb, &sample, &first_key] (const std::string& value) {
-                      rb.set_format(sample, *first_key, split(value, ','));
+                      rb.set_format(sample, *first_key, split_values(value, ','));
                       ++first_key;
                   });
 }
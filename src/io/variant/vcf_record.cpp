@@ -6,8 +6,6 @@
 #include <algorithm>
 #include <iterator>
 
-#include <boost/lexical_cast.hpp>
-
 #include "vcf_spec.hpp"
 
 namespace octopus {
@@ -161,9 +159,14 @@ bool VcfRecord::has_alt_allele(const SampleName& sample) const
                             }) != std::cend(genotype);
 }
 
+const std::vector<VcfRecord::NucleotideSequence>& VcfRecord::genotype(const SampleName& sample) const
+{
+    return genotypes_.at(sample).first;
+}
+
 const std::vector<VcfRecord::ValueType>& VcfRecord::get_sample_value(const SampleName& sample, const KeyType& key) const
 {
-    return (key == vcfspec::format::genotype) ? genotypes_.at(sample).first : samples_.at(sample).at(key);
+    return samples_.at(sample).at(key);
 }
 
 // helper non-members needed for printing
@@ -307,7 +310,7 @@ void VcfRecord::print_sample_data(std::ostream& os) const
 
 std::vector<VcfRecord::NucleotideSequence> get_genotype(const VcfRecord& record, const VcfRecord::SampleName& sample)
 {
-    return record.get_sample_value(sample, vcfspec::format::genotype);
+    return record.genotype(sample);
 }
 
 bool is_filtered(const VcfRecord& record) noexcept
@@ -351,7 +354,7 @@ boost::optional<GenomicRegion> get_phase_region(const VcfRecord& record, const V
     if (record.is_sample_phased(sample) && record.has_format(vcfspec::format::phaseSet)) {
         return GenomicRegion {
         record.chrom(),
-        boost::lexical_cast<ContigRegion::Position>(record.get_sample_value(sample, vcfspec::format::phaseSet).front()) - 1,
+        static_cast<ContigRegion::Position>(record.get_sample_value(sample, vcfspec::format::phaseSet).front().as_integer()) - 1,
         static_cast<ContigRegion::Position>(record.pos() + record.ref().size()) - 1
         };
     } else {
@@ -628,7 +631,7 @@ VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample,
 VcfRecord::Builder& VcfRecord::Builder::set_format_missing(const SampleName& sample,
                                                            const KeyType& key)
 {
-    return this->set_format(sample, key, std::string {"."});
+    return this->set_format(sample, key, ValueType {});
 }
 
 VcfRecord::Builder& VcfRecord::Builder::clear_format() noexcept
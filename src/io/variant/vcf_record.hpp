@@ -21,6 +21,7 @@
 #include "concepts/mappable.hpp"
 #include "basics/genomic_region.hpp"
 #include "utils/string_utils.hpp"
+#include "vcf_value.hpp"
 
 namespace octopus {
 
@@ -35,7 +36,7 @@ public:
     using QualityType        = float;
     using SampleName         = std::string;
     using KeyType            = std::string;
-    using ValueType          = std::string;
+    using ValueType          = VcfValue;
     
     VcfRecord() = default;
     
@@ -95,7 +96,8 @@ public:
     bool is_homozygous_non_ref(const SampleName& sample) const;
     bool has_ref_allele(const SampleName& sample) const;
     bool has_alt_allele(const SampleName& sample) const;
-    const std::vector<ValueType>& get_sample_value(const SampleName& sample, const KeyType& key) const;
+    const std::vector<NucleotideSequence>& genotype(const SampleName& sample) const;
+    const std::vector<ValueType>& get_sample_value(const SampleName& sample, const KeyType& key) const; // not GT
     
     friend std::ostream& operator<<(std::ostream& os, const VcfRecord& record);
     friend Builder;
@@ -181,7 +183,7 @@ public:
     Builder& reserve_info(unsigned n);
     Builder& add_info(const KeyType& key); // flags
     Builder& set_info(const KeyType& key, const ValueType& value);
-    template <typename T> Builder& set_info(const KeyType& key, const T& value); // calls std::to_string
+    template <typename T> Builder& set_info(const KeyType& key, const T& value); // stored as ValueType
     Builder& set_info(const KeyType& key, std::vector<ValueType> values);
     Builder& set_info(const KeyType& key, std::initializer_list<ValueType> values);
     Builder& set_info_flag(KeyType key);
@@ -196,7 +198,7 @@ public:
     Builder& set_genotype(const SampleName& sample, const std::vector<boost::optional<unsigned>>& alleles, Phasing is_phased);
     Builder& set_format(const SampleName& sample, const KeyType& key, const ValueType& value);
     template <typename T>
-    Builder& set_format(const SampleName& sample, const KeyType& key, const T& value); // calls std::to_string
+    Builder& set_format(const SampleName& sample, const KeyType& key, const T& value); // stored as ValueType
     Builder& set_format(const SampleName& sample, const KeyType& key, std::vector<ValueType> values);
     Builder& set_format(const SampleName& sample, const KeyType& key, std::initializer_list<ValueType> values);
     Builder& set_format_missing(const SampleName& sample, const KeyType& key);
@@ -268,14 +270,14 @@ VcfRecord::VcfRecord(String1&& chrom, GenomicRegion::Position pos, String2&& id,
 template <typename T>
 VcfRecord::Builder& VcfRecord::Builder::set_info(const KeyType& key, const T& value)
 {
-    return set_info(key, std::to_string(value));
+    return set_info(key, ValueType {value});
 }
 
 template <typename T>
 VcfRecord::Builder& VcfRecord::Builder::set_format(const SampleName& sample, const KeyType& key,
                                                    const T& value)
 {
-    return set_format(sample, key, std::to_string(value));
+    return set_format(sample, key, ValueType {value});
 }
 
 } // namespace octopus
@@ -33,6 +33,19 @@ std::vector<std::string> get_contigs(const VcfHeader& header)
     return result;
 }
 
+namespace {
+
+std::vector<std::string> to_strings(const std::vector<VcfRecord::ValueType>& values)
+{
+    std::vector<std::string> result {};
+    result.reserve(values.size());
+    std::transform(std::cbegin(values), std::cend(values), std::back_inserter(result),
+                   [] (const auto& value) { return value.to_string(); });
+    return result;
+}
+
+} // namespace
+
 unsigned get_field_cardinality(const VcfHeader::StructuredKey& key, const VcfRecord& record)
 {
     return 0;
@@ -41,14 +54,14 @@ unsigned get_field_cardinality(const VcfHeader::StructuredKey& key, const VcfRec
 std::vector<VcfType> get_typed_info_values(const VcfHeader& header, const VcfRecord& record,
                                            const VcfHeader::StructuredKey& key)
 {
-    return get_typed_info_values(header, key, record.info_value(key.value));
+    return get_typed_info_values(header, key, to_strings(record.info_value(key.value)));
 }
 
 std::vector<VcfType> get_typed_format_values(const VcfHeader& header, const VcfRecord& record,
                                              const VcfRecord::SampleName sample,
                                              const VcfHeader::StructuredKey& key)
 {
-    return get_typed_format_values(header, key, record.get_sample_value(sample, key.value));
+    return get_typed_format_values(header, key, to_strings(record.get_sample_value(sample, key.value)));
 }
 
 bool is_indexable(const boost::filesystem::path& vcf_path)
@@ -458,7 +471,7 @@ VcfRecord convert_to_legacy(const VcfRecord& record, const std::vector<std::stri
         cb.set_alt(std::move(new_alt));
     }
     for (const auto& sample : samples) {
-        const auto& gt = record.get_sample_value(sample, vcfspec::format::genotype);
+        const auto& gt = record.genotype(sample);
         const auto first_non_legacy = std::find_if(std::cbegin(gt), std::cend(gt), is_missing_or_has_deleted);
         if (first_non_legacy != std::cend(gt)) {
             const auto& ref = record.ref();
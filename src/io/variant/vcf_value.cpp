@@ -0,0 +1,130 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "vcf_value.hpp"
+
+#include <utility>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+
+#include <boost/optional.hpp>
+
+#include "vcf_spec.hpp"
+
+namespace octopus {
+
+VcfValue::VcfValue(const float value) noexcept : VcfValue {static_cast<double>(value)} {}
+
+VcfValue::VcfValue(const double value) noexcept : value_ {value} {}
+
+VcfValue::VcfValue(std::string value) : value_ {std::move(value)} {}
+
+VcfValue::VcfValue(const char* value) : VcfValue {std::string {value}} {}
+
+VcfValue::Type VcfValue::type() const noexcept
+{
+    return static_cast<Type>(value_.which());
+}
+
+bool VcfValue::is_missing() const noexcept
+{
+    if (type() == Type::missing) return true;
+    const auto string = boost::get<std::string>(&value_);
+    return string && *string == vcfspec::missingValue;
+}
+
+VcfValue::Integer VcfValue::as_integer() const
+{
+    switch (type()) {
+        case Type::integer: return boost::get<Integer>(value_);
+        case Type::real: return static_cast<Integer>(boost::get<Real>(value_));
+        case Type::string: return std::stoll(boost::get<std::string>(value_));
+        default: throw std::invalid_argument {"VcfValue: cannot convert missing value to an integer"};
+    }
+}
+
+VcfValue::Real VcfValue::as_real() const
+{
+    switch (type()) {
+        case Type::integer: return static_cast<Real>(boost::get<Integer>(value_));
+        case Type::real: return boost::get<Real>(value_);
+        case Type::string: return std::stod(boost::get<std::string>(value_));
+        default: throw std::invalid_argument {"VcfValue: cannot convert missing value to a real"};
+    }
+}
+
+namespace {
+
+std::string to_shortest_string(const double value)
+{
+    // Values are mostly already rounded to a few decimal places, so 15 digits is nearly always enough
+    char buffer[32];
+    for (int precision {15}; ; ++precision) {
+        std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+        if (precision == 17 || std::strtod(buffer, nullptr) == value) return buffer;
+    }
+}
+
+} // namespace
+
+std::string VcfValue::to_string() const
+{
+    switch (type()) {
+        case Type::integer: return std::to_string(boost::get<Integer>(value_));
+        case Type::real: return to_shortest_string(boost::get<Real>(value_));
+        case Type::string: return boost::get<std::string>(value_);
+        default: return vcfspec::missingValue;
+    }
+}
+
+namespace {
+
+bool is_number(const VcfValue& value) noexcept
+{
+    return value.type() == VcfValue::Type::integer || value.type() == VcfValue::Type::real;
+}
+
+// boost::none unless the whole of value is a number
+boost::optional<VcfValue::Real> parse_real(const VcfValue& value)
+{
+    if (is_number(value)) return value.as_real();
+    const auto string = value.to_string();
+    if (string.empty()) return boost::none;
+    char* end;
+    errno = 0;
+    const auto result = std::strtod(string.c_str(), &end);
+    if (errno != 0 || end != string.c_str() + string.size()) return boost::none;
+    return result;
+}
+
+} // namespace
+
+bool operator==(const VcfValue& lhs, const VcfValue& rhs)
+{
+    if (lhs.is_missing() || rhs.is_missing()) {
+        return lhs.is_missing() && rhs.is_missing();
+    }
+    if (lhs.type() == VcfValue::Type::integer && rhs.type() == VcfValue::Type::integer) {
+        return lhs.as_integer() == rhs.as_integer();
+    }
+    if (is_number(lhs) || is_number(rhs)) {
+        const auto lhs_number = parse_real(lhs), rhs_number = parse_real(rhs);
+        return lhs_number && rhs_number && *lhs_number == *rhs_number;
+    }
+    return lhs.to_string() == rhs.to_string();
+}
+
+bool operator!=(const VcfValue& lhs, const VcfValue& rhs)
+{
+    return !(lhs == rhs);
+}
+
+std::ostream& operator<<(std::ostream& os, const VcfValue& value)
+{
+    os << value.to_string();
+    return os;
+}
+
+} // namespace octopus
@@ -0,0 +1,73 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef vcf_value_hpp
+#define vcf_value_hpp
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <ostream>
+
+#include <boost/variant.hpp>
+#include <boost/blank.hpp>
+
+namespace octopus {
+
+/*
+    A single INFO or FORMAT value, stored with the type it was created with.
+
+    Numbers are kept as numbers so records can be made by callers and written to BCF without going
+    through text. Values read from text VCF are strings, and are only parsed if a number is requested.
+ */
+class VcfValue
+{
+public:
+    // In the order of the Value alternatives
+    enum class Type : std::uint8_t { missing, integer, real, string };
+
+    using Integer = std::int64_t;
+    using Real    = double;
+
+    VcfValue() = default; // missing
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+    VcfValue(T value) noexcept : value_ {static_cast<Integer>(value)} {}
+    VcfValue(float value) noexcept;
+    VcfValue(double value) noexcept;
+    VcfValue(std::string value);
+    VcfValue(const char* value);
+
+    VcfValue(const VcfValue&)            = default;
+    VcfValue& operator=(const VcfValue&) = default;
+    VcfValue(VcfValue&&)                 = default;
+    VcfValue& operator=(VcfValue&&)      = default;
+
+    ~VcfValue() = default;
+
+    Type type() const noexcept;
+
+    bool is_missing() const noexcept; // true for a missing value or the string "."
+
+    // Strings are parsed. Throws std::invalid_argument if the value is missing or not a number
+    Integer as_integer() const;
+    Real as_real() const;
+
+    // Reals are written with the fewest significant digits that read back as the same number
+    std::string to_string() const;
+
+private:
+    using Value = boost::variant<boost::blank, Integer, Real, std::string>;
+    
+    Value value_ = {};
+};
+
+// Numbers are compared by value, including strings that hold numbers (so "0.5" == 0.5)
+bool operator==(const VcfValue& lhs, const VcfValue& rhs);
+bool operator!=(const VcfValue& lhs, const VcfValue& rhs);
+
+std::ostream& operator<<(std::ostream& os, const VcfValue& value);
+
+} // namespace octopus
+
+#endif
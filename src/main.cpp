@@ -5,6 +5,7 @@
 #include <cstdlib>
 #include <chrono>
 #include <exception>
+#include <thread>
 
 #include "config/config.hpp"
 #include "config/common.hpp"
@@ -13,10 +14,12 @@
 #include "config/option_parser.hpp"
 #include "config/option_collation.hpp"
 #include "core/octopus.hpp"
+#include "io/htslib_thread_pool.hpp"
 #include "utils/timing.hpp"
 #include "utils/string_utils.hpp"
 #include "exceptions/error.hpp"
 #include "logging/error_handler.hpp"
+#include "timers.hpp"
 
 using namespace octopus;
 using namespace octopus::options;
@@ -39,11 +42,20 @@ auto log_startup_exception(const E& e)
     return log_exception(e);
 }
 
+unsigned get_num_htslib_threads(const OptionMap& options)
+{
+    const auto num_threads = get_num_threads(options);
+    if (!num_threads) return std::thread::hardware_concurrency();
+    return *num_threads > 1 ? *num_threads : 0; // single threaded runs stay single threaded
+}
+
 void init_common(const OptionMap& options)
 {
     logging::init(get_debug_log_file_name(options), get_trace_log_file_name(options));
     DEBUG_MODE = options::is_debug_mode(options);
     TRACE_MODE = options::is_trace_mode(options);
+    io::init_htslib_thread_pool(get_num_htslib_threads(options));
+    profiling::init(get_profile_file_name(options));
 }
 
 std::string to_string(const int argc, const char** argv)
@@ -82,6 +94,7 @@ int main(const int argc, const char** argv)
             options.clear();
             if (validate(components)) {
                 run_octopus(components, to_string(argc, argv));
+                profiling::write_report();
             }
             log_program_end();
         } catch (const Error& e) {
@@ -7,6 +7,7 @@
 #include <limits>
 #include <algorithm>
 #include <iterator>
+#include <cassert>
 
 #include "utils/mappable_algorithms.hpp"
 #include "utils/read_stats.hpp"
@@ -32,11 +33,17 @@ const ReadPipe& BufferedReadPipe::source() const noexcept
     return source_.get();
 }
 
+const BufferedReadPipe::Config& BufferedReadPipe::config() const noexcept
+{
+    return config_;
+}
+
 void BufferedReadPipe::clear() noexcept
 {
     buffer_.clear();
     buffered_region_ = boost::none;
     hints_.clear();
+    prefetcher_.clear();
 }
 
 ReadMap BufferedReadPipe::fetch_reads(const GenomicRegion& region) const
@@ -60,6 +67,15 @@ void BufferedReadPipe::hint(std::vector<GenomicRegion> hints) const
     }
 }
 
+std::vector<GenomicRegion> BufferedReadPipe::hints() const
+{
+    std::vector<GenomicRegion> result {};
+    for (const auto& p : hints_) {
+        result.insert(std::cend(result), std::cbegin(p.second), std::cend(p.second));
+    }
+    return result;
+}
+
 bool BufferedReadPipe::is_cached(const GenomicRegion& region) const noexcept
 {
     return buffered_region_ && contains(*buffered_region_, region);
@@ -70,37 +86,102 @@ bool BufferedReadPipe::is_cached(const GenomicRegion& region) const noexcept
 void BufferedReadPipe::setup_buffer(const GenomicRegion& request) const
 {
     if (!is_cached(request)) {
-        auto max_region = get_max_fetch_region(request);
-        bool unchecked_fetch {false};
-        if (can_make_unchecked_fetch()) {
-            buffered_region_ = std::move(max_region);
-            unchecked_fetch = true;
-        } else {
-            buffered_region_ = source_.get().read_manager().find_covered_subregion(max_region, config_.max_buffer_size);
+        if (!take_prefetched_window(request)) {
+            fill_buffer(request);
         }
-        buffer_ = source_.get().fetch_reads(expand(*buffered_region_, config_.fetch_expansion));
-        if (unchecked_fetch) {
-            const auto fetch_size = count_reads(buffer_);
-            if (fetch_size > config_.max_buffer_size) {
-                if (default_unchecked_fetch_overflowed_) {
-                    adjusted_unchecked_fetch_overflowed_ = true;
-                } else {
-                    default_unchecked_fetch_overflowed_ = true;
-                }
-                // Clear buffer of reads to rhs of request
-                for (auto& p : buffer_) {
-                    const auto last_overlapped = find_first_after(p.second, request);
-                    p.second.erase(last_overlapped, std::cend(p.second));
-                }
-                buffered_region_ = request;
-            }
-        } else {
-            if (min_checked_fetch_size_) {
-                min_checked_fetch_size_ = std::min(size(*buffered_region_), *min_checked_fetch_size_);
+        if (config_.prefetch) {
+            prefetch_next_window();
+        }
+    }
+}
+
+void BufferedReadPipe::fill_buffer(const GenomicRegion& request) const
+{
+    // Release the old window first so the buffer budget is not exceeded during the fetch
+    buffer_.clear();
+    auto max_region = get_max_fetch_region(request);
+    bool unchecked_fetch {false};
+    if (can_make_unchecked_fetch()) {
+        buffered_region_ = std::move(max_region);
+        unchecked_fetch = true;
+    } else {
+        buffered_region_ = source_.get().read_manager().find_covered_subregion(max_region, window_size());
+    }
+    buffer_ = source_.get().fetch_reads(expand(*buffered_region_, config_.fetch_expansion));
+    if (unchecked_fetch) {
+        const auto fetch_size = count_reads(buffer_);
+        if (fetch_size > window_size()) {
+            if (default_unchecked_fetch_overflowed_) {
+                adjusted_unchecked_fetch_overflowed_ = true;
             } else {
-                min_checked_fetch_size_ = size(*buffered_region_);
+                default_unchecked_fetch_overflowed_ = true;
+            }
+            // Clear buffer of reads to rhs of request
+            for (auto& p : buffer_) {
+                const auto last_overlapped = find_first_after(p.second, request);
+                p.second.erase(last_overlapped, std::cend(p.second));
             }
+            buffered_region_ = request;
         }
+    } else {
+        update_min_checked_fetch_size();
+    }
+}
+
+bool BufferedReadPipe::take_prefetched_window(const GenomicRegion& request) const
+{
+    auto window = prefetcher_.take(request);
+    if (!window) return false;
+    buffered_region_ = std::move(window->region);
+    buffer_ = std::move(window->reads);
+    update_min_checked_fetch_size();
+    return true;
+}
+
+void BufferedReadPipe::prefetch_next_window() const
+{
+    const auto next_request = predict_next_request();
+    if (!next_request) return;
+    const ReadPipe& source {source_.get()};
+    const auto max_window_size = window_size();
+    const auto fetch_expansion = config_.fetch_expansion;
+    prefetcher_.prefetch(get_max_fetch_region(*next_request),
+                         [&source, max_window_size, fetch_expansion] (const GenomicRegion& max_region) {
+                             auto region = source.read_manager().find_covered_subregion(max_region, max_window_size);
+                             auto reads = source.fetch_reads(expand(region, fetch_expansion));
+                             return ReadWindowPrefetcher::Window {std::move(region), std::move(reads)};
+                         });
+}
+
+boost::optional<GenomicRegion> BufferedReadPipe::predict_next_request() const
+{
+    assert(buffered_region_);
+    const auto& contig = buffered_region_->contig_name();
+    const auto buffered_end = buffered_region_->end();
+    if (hints_.count(contig) == 1 && !hints_.at(contig).empty()) {
+        // Hints are sorted and non-overlapping, so the first hint not fully buffered is the next request
+        const auto& contig_hints = hints_.at(contig);
+        const auto next_hint_itr = std::partition_point(std::cbegin(contig_hints), std::cend(contig_hints),
+                                                        [buffered_end] (const auto& hint) { return hint.end() <= buffered_end; });
+        if (next_hint_itr == std::cend(contig_hints)) return boost::none;
+        return GenomicRegion {contig, std::max(next_hint_itr->begin(), buffered_end), next_hint_itr->end()};
+    } else {
+        // Otherwise assume requests move along the contig
+        return GenomicRegion {contig, buffered_end, buffered_end};
+    }
+}
+
+std::size_t BufferedReadPipe::window_size() const noexcept
+{
+    return config_.prefetch ? config_.max_buffer_size / 2 : config_.max_buffer_size;
+}
+
+void BufferedReadPipe::update_min_checked_fetch_size() const
+{
+    if (min_checked_fetch_size_) {
+        min_checked_fetch_size_ = std::min(size(*buffered_region_), *min_checked_fetch_size_);
+    } else {
+        min_checked_fetch_size_ = size(*buffered_region_);
     }
 }
 
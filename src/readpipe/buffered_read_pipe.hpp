@@ -10,6 +10,7 @@
 #include <boost/optional.hpp>
 
 #include "read_pipe.hpp"
+#include "read_window_prefetcher.hpp"
 #include "basics/genomic_region.hpp"
 #include "containers/mappable_map.hpp"
 
@@ -25,6 +26,12 @@ public:
         boost::optional<GenomicRegion::Size> max_fetch_size = boost::none;
         boost::optional<GenomicRegion::Size> max_hint_gap = boost::none;
         bool allow_unchecked_fetches = true;
+        // Fill the next buffer window on a background thread while the current one is in use. The
+        // current and prefetched windows share max_buffer_size, so each holds at most half of it.
+        // This only pays off for a pipe that is read sequentially by a single thread (i.e. filtering
+        // with one thread); calling tasks fetch through the shared read cache instead, and concurrent
+        // pipes already overlap fetching with work on other threads.
+        bool prefetch = false;
     };
     
     BufferedReadPipe() = delete;
@@ -40,6 +47,7 @@ public:
     ~BufferedReadPipe() = default;
     
     const ReadPipe& source() const noexcept;
+    const Config& config() const noexcept;
     
     void clear() noexcept;
     
@@ -49,6 +57,7 @@ public:
     // the object, but may allow improved performance through optimised read buffering. If the hints given are
     // inaccurate it will likely result in worse performance.
     void hint(std::vector<GenomicRegion> hints) const;
+    std::vector<GenomicRegion> hints() const;
     
     bool is_cached(const GenomicRegion& region) const noexcept;
     
@@ -63,8 +72,15 @@ private:
     mutable bool default_unchecked_fetch_overflowed_ = false;
     mutable bool adjusted_unchecked_fetch_overflowed_ = false;
     mutable boost::optional<GenomicRegion::Size> min_checked_fetch_size_ = boost::none;
+    mutable ReadWindowPrefetcher prefetcher_ = {};
     
     void setup_buffer(const GenomicRegion& request) const;
+    void fill_buffer(const GenomicRegion& request) const;
+    bool take_prefetched_window(const GenomicRegion& request) const;
+    void prefetch_next_window() const;
+    boost::optional<GenomicRegion> predict_next_request() const;
+    std::size_t window_size() const noexcept;
+    void update_min_checked_fetch_size() const;
     GenomicRegion get_max_fetch_region(const GenomicRegion& request) const;
     GenomicRegion get_default_max_fetch_region(const GenomicRegion& request) const;
     bool can_make_unchecked_fetch() const noexcept;
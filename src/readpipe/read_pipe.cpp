@@ -10,6 +10,7 @@
 
 #include "utils/read_stats.hpp"
 #include "utils/mappable_algorithms.hpp"
+#include "timers.hpp"
 
 namespace octopus {
 
@@ -28,6 +29,7 @@ ReadPipe::ReadPipe(const ReadManager& source, ReadTransformer transformer, ReadF
 , downsampler_ {std::move(downsampler)}
 , samples_ {std::move(samples)}
 , debug_log_ {}
+, cache_ {}
 {
     if (DEBUG_MODE) debug_log_ = logging::DebugLogger {};
 }
@@ -42,6 +44,7 @@ ReadPipe::ReadPipe(const ReadManager& source, ReadTransformer prefilter_transfor
 , downsampler_ {std::move(downsampler)}
 , samples_ {std::move(samples)}
 , debug_log_ {}
+, cache_ {}
 {
     if (DEBUG_MODE) debug_log_ = logging::DebugLogger {};
 }
@@ -129,6 +132,81 @@ void shrink_to_fit(ReadMap& reads)
 } // namespace
 
 ReadMap ReadPipe::fetch_reads(const GenomicRegion& region) const
+{
+    if (cache_) {
+        // Reads are cached before downsampling so each request is downsampled as if it were fetched directly
+        auto result = cache_->fetch(region, [this] (const GenomicRegion& chunk) {
+            return fetch_processed_reads(chunk, false);
+        });
+        if (downsampler_) {
+            const auto n = readpipe::downsample(result, *downsampler_);
+            if (debug_log_) stream(*debug_log_) << "Downsampling removed " << n << " reads from " << region;
+        }
+        shrink_to_fit(result);
+        return result;
+    } else {
+        return fetch_processed_reads(region, true);
+    }
+}
+
+ReadMap ReadPipe::fetch_reads(const std::vector<GenomicRegion>& regions) const
+{
+    assert(std::is_sorted(std::cbegin(regions), std::cend(regions)));
+    
+    const auto covered_regions = extract_covered_regions(regions);
+    const auto fetch_regions = join(covered_regions, 10000);
+    
+    ReadMap result {samples_.size()};
+    const auto total_fetch_bp = sum_region_sizes(fetch_regions);
+    for (const auto& sample : samples_) {
+        const auto p = result.emplace(std::piecewise_construct, std::forward_as_tuple(sample),
+                                      std::forward_as_tuple());
+        p.first->second.reserve(20 * total_fetch_bp); // TODO: use estimated coverage
+    }
+    
+    for (const auto& region : fetch_regions) {
+        auto reads = fetch_reads(region);
+        
+        const auto request_regions = contained_range(covered_regions, region);
+        const auto removal_regions = extract_intervening_regions(request_regions, region);
+        
+        std::for_each(std::crbegin(removal_regions), std::crend(removal_regions),
+                      [&reads] (const auto& region) {
+                          for (auto& p : reads) {
+                              p.second.erase_contained(region);
+                          }
+                      });
+        insert_each(std::move(reads), result);
+    }
+    
+    shrink_to_fit(result);
+    
+    return result;
+}
+
+void ReadPipe::enable_shared_cache(const GenomicRegion::Size chunk_size, const std::size_t max_cached_reads)
+{
+    cache_ = std::make_unique<SharedReadCache>(chunk_size, max_cached_reads);
+}
+
+void ReadPipe::disable_shared_cache() noexcept
+{
+    cache_ = nullptr;
+}
+
+void ReadPipe::reserve(const GenomicRegion& region) const
+{
+    if (cache_) cache_->reserve(region);
+}
+
+void ReadPipe::release(const GenomicRegion& region) const
+{
+    if (cache_) cache_->release(region);
+}
+
+// private methods
+
+ReadMap ReadPipe::fetch_processed_reads(const GenomicRegion& region, const bool apply_downsampling) const
 {
     using namespace readpipe;
     ReadMap result {samples_.size()};
@@ -136,7 +214,11 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region) const
         result.emplace(std::piecewise_construct, std::forward_as_tuple(sample), std::forward_as_tuple());
     }
     for (const auto& batch : batch_samples(samples_)) {
-        auto batch_reads = fetch_batch(source_, batch, region);
+        auto batch_reads = [&] () {
+            profiling::StageTimer timer {profiling::Stage::read_fetch};
+            return fetch_batch(source_, batch, region);
+        }();
+        profiling::StageTimer timer {profiling::Stage::read_transform};
         if (debug_log_) {
             stream(*debug_log_) << "Fetched " << count_reads(batch_reads) << " unfiltered reads from " << region;
         }
@@ -170,7 +252,7 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region) const
             stream(*debug_log_) << "There are " << count_reads(batch_reads) << " reads in " << region
                             << " after filtering";
         }
-        if (downsampler_) {
+        if (downsampler_ && apply_downsampling) {
             auto reads = make_mappable_map(std::move(batch_reads));
             const auto n = downsample(reads, *downsampler_);
             if (debug_log_) stream(*debug_log_) << "Downsampling removed " << n << " reads from " << region;
@@ -183,39 +265,4 @@ ReadMap ReadPipe::fetch_reads(const GenomicRegion& region) const
     return result;
 }
 
-ReadMap ReadPipe::fetch_reads(const std::vector<GenomicRegion>& regions) const
-{
-    assert(std::is_sorted(std::cbegin(regions), std::cend(regions)));
-    
-    const auto covered_regions = extract_covered_regions(regions);
-    const auto fetch_regions = join(covered_regions, 10000);
-    
-    ReadMap result {samples_.size()};
-    const auto total_fetch_bp = sum_region_sizes(fetch_regions);
-    for (const auto& sample : samples_) {
-        const auto p = result.emplace(std::piecewise_construct, std::forward_as_tuple(sample),
-                                      std::forward_as_tuple());
-        p.first->second.reserve(20 * total_fetch_bp); // TODO: use estimated coverage
-    }
-    
-    for (const auto& region : fetch_regions) {
-        auto reads = fetch_reads(region);
-        
-        const auto request_regions = contained_range(covered_regions, region);
-        const auto removal_regions = extract_intervening_regions(request_regions, region);
-        
-        std::for_each(std::crbegin(removal_regions), std::crend(removal_regions),
-                      [&reads] (const auto& region) {
-                          for (auto& p : reads) {
-                              p.second.erase_contained(region);
-                          }
-                      });
-        insert_each(std::move(reads), result);
-    }
-    
-    shrink_to_fit(result);
-    
-    return result;
-}
-
 } // namespace octopus
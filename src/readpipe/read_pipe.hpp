@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <cstddef>
 #include <functional>
+#include <memory>
 
 #include <boost/optional.hpp>
 
@@ -18,6 +19,7 @@
 #include "filtering/read_filterer.hpp"
 #include "transformers/read_transformer.hpp"
 #include "downsampling/downsampler.hpp"
+#include "shared_read_cache.hpp"
 
 namespace octopus {
 /*
@@ -69,6 +71,15 @@ public:
     ReadMap fetch_reads(const GenomicRegion& region) const;
     ReadMap fetch_reads(const std::vector<GenomicRegion>& regions) const;
     
+    // While enabled, processed reads are shared between concurrent fetches through a SharedReadCache.
+    // Regions are only cached while reserved, so callers should reserve regions they will fetch and
+    // release them when done. Downsampling is still applied to each fetched region. Reserved regions
+    // are fetched without caching once max_cached_reads reads are cached.
+    void enable_shared_cache(GenomicRegion::Size chunk_size, std::size_t max_cached_reads);
+    void disable_shared_cache() noexcept;
+    void reserve(const GenomicRegion& region) const;
+    void release(const GenomicRegion& region) const;
+    
     //Report get_report() const;
     
 private:
@@ -79,6 +90,9 @@ private:
     boost::optional<Downsampler> downsampler_;
     std::vector<SampleName> samples_;
     mutable boost::optional<logging::DebugLogger> debug_log_;
+    std::unique_ptr<SharedReadCache> cache_;
+    
+    ReadMap fetch_processed_reads(const GenomicRegion& region, bool apply_downsampling) const;
 };
 
 } // namespace octopus
@@ -0,0 +1,43 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "read_window_prefetcher.hpp"
+
+#include <utility>
+
+namespace octopus {
+
+void ReadWindowPrefetcher::prefetch(GenomicRegion max_region, WindowFetcher fetcher)
+{
+    if (!thread_) {
+        thread_ = std::make_unique<ThreadPool>(1);
+    }
+    window_ = thread_->push([max_region, fetcher = std::move(fetcher)] () { return fetcher(max_region); });
+    max_region_ = std::move(max_region);
+}
+
+bool ReadWindowPrefetcher::is_pending() const noexcept
+{
+    return static_cast<bool>(max_region_);
+}
+
+boost::optional<ReadWindowPrefetcher::Window> ReadWindowPrefetcher::take(const GenomicRegion& request)
+{
+    if (!max_region_) return boost::none;
+    const auto max_region = std::move(*max_region_);
+    max_region_ = boost::none;
+    auto window = std::move(window_);
+    // The window is a subregion of max_region, so there is no point waiting for it otherwise
+    if (!contains(max_region, request)) return boost::none;
+    auto result = window.get();
+    if (!contains(result.region, request)) return boost::none;
+    return result;
+}
+
+void ReadWindowPrefetcher::clear() noexcept
+{
+    max_region_ = boost::none;
+    window_ = {};
+}
+
+} // namespace octopus
@@ -0,0 +1,66 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef read_window_prefetcher_hpp
+#define read_window_prefetcher_hpp
+
+#include <functional>
+#include <memory>
+#include <future>
+
+#include <boost/optional.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "utils/thread_pool.hpp"
+
+namespace octopus {
+
+/*
+    ReadWindowPrefetcher fetches a single window of reads on a background thread.
+
+    A prefetch is given the largest region the window may cover; the fetcher decides the actual
+    window, which must be a subregion of it. A prefetched window is only handed over if it contains
+    the request, and a request outside the prefetch region is answered without waiting for the
+    prefetch. Either way the slot is emptied, and an abandoned prefetch finishes in the background
+    and is then discarded.
+ */
+class ReadWindowPrefetcher
+{
+public:
+    struct Window
+    {
+        GenomicRegion region;
+        ReadMap reads;
+    };
+
+    // Must not refer to the owner of the prefetcher, which may be moved while a prefetch is running
+    using WindowFetcher = std::function<Window(const GenomicRegion&)>;
+
+    ReadWindowPrefetcher() = default;
+
+    ReadWindowPrefetcher(const ReadWindowPrefetcher&)            = delete;
+    ReadWindowPrefetcher& operator=(const ReadWindowPrefetcher&) = delete;
+    ReadWindowPrefetcher(ReadWindowPrefetcher&&)                 = default;
+    ReadWindowPrefetcher& operator=(ReadWindowPrefetcher&&)      = default;
+
+    ~ReadWindowPrefetcher() = default;
+
+    // Replaces any pending prefetch
+    void prefetch(GenomicRegion max_region, WindowFetcher fetcher);
+
+    bool is_pending() const noexcept;
+
+    boost::optional<Window> take(const GenomicRegion& request);
+
+    void clear() noexcept;
+
+private:
+    std::unique_ptr<ThreadPool> thread_ = nullptr;
+    boost::optional<GenomicRegion> max_region_ = boost::none;
+    std::future<Window> window_;
+};
+
+} // namespace octopus
+
+#endif
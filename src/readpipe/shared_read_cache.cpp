@@ -0,0 +1,201 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "shared_read_cache.hpp"
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <exception>
+#include <algorithm>
+#include <iterator>
+
+#include <boost/optional.hpp>
+
+#include "utils/read_stats.hpp"
+
+namespace octopus {
+
+SharedReadCache::SharedReadCache(const GenomicRegion::Size chunk_size, const std::size_t max_cached_reads)
+: chunk_size_ {std::max(chunk_size, GenomicRegion::Size {1})}
+, max_cached_reads_ {max_cached_reads}
+, num_cached_reads_ {0}
+, mutex_ {}
+, chunks_ {}
+{}
+
+void SharedReadCache::reserve(const GenomicRegion& region)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    auto& contig_chunks = chunks_[region.contig_id()];
+    for (auto chunk = first_chunk(region); chunk <= last_chunk(region); ++chunk) {
+        ++contig_chunks[chunk].num_reservations;
+    }
+}
+
+void SharedReadCache::release(const GenomicRegion& region)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto contig_itr = chunks_.find(region.contig_id());
+    if (contig_itr == std::end(chunks_)) return;
+    auto& contig_chunks = contig_itr->second;
+    for (auto chunk = first_chunk(region); chunk <= last_chunk(region); ++chunk) {
+        const auto chunk_itr = contig_chunks.find(chunk);
+        if (chunk_itr != std::end(contig_chunks) && --chunk_itr->second.num_reservations == 0) {
+            // Fetches still reading the chunk hold their own reference to the reads
+            num_cached_reads_ -= chunk_itr->second.num_reads;
+            contig_chunks.erase(chunk_itr);
+        }
+    }
+    if (contig_chunks.empty()) chunks_.erase(contig_itr);
+}
+
+namespace {
+
+// A contiguous part of the requested region whose reads all come from one place
+struct Piece
+{
+    GenomicRegion region;
+    boost::optional<std::shared_future<ReadMap>> cached_reads;
+    // Set if this fetch must fill the cached chunk
+    std::shared_ptr<std::promise<ReadMap>> fill = nullptr;
+    boost::optional<GenomicRegion> fill_region = boost::none;
+};
+
+// Each read overlapping several pieces is taken from the piece containing its begin position
+bool owns(const Piece& piece, const AlignedRead& read, const bool is_first, const bool is_last) noexcept
+{
+    return (is_first || mapped_begin(read) >= mapped_begin(piece.region))
+        && (is_last || mapped_begin(read) < mapped_end(piece.region));
+}
+
+void append_owned(const ReadMap& reads, const Piece& piece, const GenomicRegion& region,
+                  const bool is_first, const bool is_last, std::unordered_map<SampleName, std::vector<AlignedRead>>& result)
+{
+    for (const auto& p : reads) {
+        auto& sample_result = result[p.first];
+        for (const auto& read : p.second.overlap_range(region)) {
+            if (owns(piece, read, is_first, is_last)) {
+                sample_result.push_back(read);
+            }
+        }
+    }
+}
+
+} // namespace
+
+ReadMap SharedReadCache::fetch(const GenomicRegion& region, const Fetcher& fetcher)
+{
+    std::vector<Piece> pieces {};
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        const auto contig_itr = chunks_.find(region.contig_id());
+        for (auto chunk = first_chunk(region); chunk <= last_chunk(region); ++chunk) {
+            const auto chunk_bounds = chunk_region(region, chunk);
+            GenomicRegion piece_region {region.contig_id(), std::max(region.begin(), chunk_bounds.begin()),
+                                        std::min(region.end(), chunk_bounds.end())};
+            ContigChunkMap::iterator chunk_itr {};
+            const bool is_reserved {contig_itr != std::end(chunks_)
+                                    && (chunk_itr = contig_itr->second.find(chunk)) != std::end(contig_itr->second)};
+            std::shared_ptr<std::promise<ReadMap>> fill {};
+            if (is_reserved && !chunk_itr->second.reads.valid() && num_cached_reads_ < max_cached_reads_) {
+                fill = std::make_shared<std::promise<ReadMap>>();
+                chunk_itr->second.reads = fill->get_future().share();
+                chunk_itr->second.fill_id = fill.get();
+            }
+            if (is_reserved && chunk_itr->second.reads.valid()) {
+                Piece piece {std::move(piece_region), chunk_itr->second.reads};
+                if (fill) {
+                    piece.fill = std::move(fill);
+                    piece.fill_region = chunk_bounds;
+                }
+                pieces.push_back(std::move(piece));
+            } else if (!pieces.empty() && !pieces.back().cached_reads) {
+                // Consecutive uncached chunks are fetched together
+                pieces.back().region = encompassing_region(pieces.back().region, piece_region);
+            } else {
+                pieces.push_back(Piece {std::move(piece_region), boost::none});
+            }
+        }
+    }
+    for (auto& piece : pieces) {
+        if (piece.fill) {
+            try {
+                auto chunk_reads = fetcher(*piece.fill_region);
+                const auto num_reads = count_reads(chunk_reads);
+                piece.fill->set_value(std::move(chunk_reads));
+                add_filled_chunk(*piece.fill_region, piece.fill.get(), num_reads);
+            } catch (...) {
+                piece.fill->set_exception(std::current_exception());
+                throw;
+            }
+        }
+    }
+    std::unordered_map<SampleName, std::vector<AlignedRead>> reads {};
+    for (std::size_t i {0}; i < pieces.size(); ++i) {
+        const auto& piece = pieces[i];
+        const bool is_first {i == 0}, is_last {i == pieces.size() - 1};
+        if (piece.cached_reads) {
+            append_owned(piece.cached_reads->get(), piece, region, is_first, is_last, reads);
+        } else {
+            append_owned(fetcher(piece.region), piece, region, is_first, is_last, reads);
+        }
+    }
+    ReadMap result {reads.size()};
+    for (auto& p : reads) {
+        auto& sample_result = result[p.first];
+        sample_result.insert(std::make_move_iterator(std::begin(p.second)), std::make_move_iterator(std::end(p.second)));
+    }
+    return result;
+}
+
+std::size_t SharedReadCache::num_cached_chunks() const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    std::size_t result {0};
+    for (const auto& p : chunks_) {
+        for (const auto& chunk : p.second) {
+            if (chunk.second.reads.valid()) ++result;
+        }
+    }
+    return result;
+}
+
+std::size_t SharedReadCache::num_cached_reads() const
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    return num_cached_reads_;
+}
+
+// private methods
+
+SharedReadCache::ChunkIndex SharedReadCache::first_chunk(const GenomicRegion& region) const noexcept
+{
+    return region.begin() / chunk_size_;
+}
+
+SharedReadCache::ChunkIndex SharedReadCache::last_chunk(const GenomicRegion& region) const noexcept
+{
+    return is_empty(region) ? first_chunk(region) : (region.end() - 1) / chunk_size_;
+}
+
+GenomicRegion SharedReadCache::chunk_region(const GenomicRegion& region, const ChunkIndex chunk) const
+{
+    const auto begin = chunk * chunk_size_;
+    return GenomicRegion {region.contig_id(), begin, begin + chunk_size_};
+}
+
+void SharedReadCache::add_filled_chunk(const GenomicRegion& chunk_region, const void* fill_id, const std::size_t num_reads)
+{
+    std::lock_guard<std::mutex> lock {mutex_};
+    const auto contig_itr = chunks_.find(chunk_region.contig_id());
+    if (contig_itr == std::end(chunks_)) return;
+    const auto chunk_itr = contig_itr->second.find(first_chunk(chunk_region));
+    // The chunk may have been evicted, and even reserved and filled again, during the fill
+    if (chunk_itr != std::end(contig_itr->second) && chunk_itr->second.fill_id == fill_id) {
+        chunk_itr->second.num_reads = num_reads;
+        num_cached_reads_ += num_reads;
+    }
+}
+
+} // namespace octopus
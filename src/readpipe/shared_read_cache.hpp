@@ -0,0 +1,87 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef shared_read_cache_hpp
+#define shared_read_cache_hpp
+
+#include <unordered_map>
+#include <cstddef>
+#include <limits>
+#include <functional>
+#include <future>
+#include <mutex>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+
+namespace octopus {
+
+/*
+    SharedReadCache lets concurrent tasks share the processed reads of overlapping regions.
+
+    Contigs are divided into fixed size chunks. Tasks reserve the regions they are going to fetch,
+    which reference counts every chunk the region overlaps. The first fetch of a reserved chunk
+    fetches all reads overlapping the chunk and caches them; concurrent fetches of the same chunk
+    wait for that fetch rather than repeating it. A chunk is evicted when every reservation
+    overlapping it has been released. Parts of a fetch that are not reserved are passed straight
+    through to the fetcher and are not cached.
+
+    Once max_cached_reads reads are cached, newly reserved chunks are also passed through until
+    evictions free up space. Concurrent fills are only counted when they finish, so the bound can
+    be exceeded by the reads of the chunks being filled.
+
+    All methods are thread safe.
+ */
+class SharedReadCache
+{
+public:
+    using Fetcher = std::function<ReadMap(const GenomicRegion&)>;
+    
+    SharedReadCache() = delete;
+    
+    SharedReadCache(GenomicRegion::Size chunk_size,
+                    std::size_t max_cached_reads = std::numeric_limits<std::size_t>::max());
+    
+    SharedReadCache(const SharedReadCache&)            = delete;
+    SharedReadCache& operator=(const SharedReadCache&) = delete;
+    SharedReadCache(SharedReadCache&&)                 = delete;
+    SharedReadCache& operator=(SharedReadCache&&)      = delete;
+    
+    ~SharedReadCache() = default;
+    
+    void reserve(const GenomicRegion& region);
+    void release(const GenomicRegion& region);
+    
+    // Returns the reads fetcher(region) would, provided fetcher processes reads independently of the region
+    ReadMap fetch(const GenomicRegion& region, const Fetcher& fetcher);
+    
+    std::size_t num_cached_chunks() const;
+    std::size_t num_cached_reads() const;
+    
+private:
+    using ChunkIndex = GenomicRegion::Position;
+    
+    struct Chunk
+    {
+        unsigned num_reservations;
+        std::shared_future<ReadMap> reads;
+        std::size_t num_reads = 0;
+        const void* fill_id = nullptr; // identifies the fetch filling reads
+    };
+    
+    using ContigChunkMap = std::unordered_map<ChunkIndex, Chunk>;
+    
+    GenomicRegion::Size chunk_size_;
+    std::size_t max_cached_reads_, num_cached_reads_;
+    mutable std::mutex mutex_;
+    std::unordered_map<GenomicRegion::ContigId, ContigChunkMap> chunks_;
+    
+    ChunkIndex first_chunk(const GenomicRegion& region) const noexcept;
+    ChunkIndex last_chunk(const GenomicRegion& region) const noexcept;
+    GenomicRegion chunk_region(const GenomicRegion& region, ChunkIndex chunk) const;
+    void add_filled_chunk(const GenomicRegion& chunk_region, const void* fill_id, std::size_t num_reads);
+};
+
+} // namespace octopus
+
+#endif
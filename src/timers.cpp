@@ -3,46 +3,291 @@
 
 #include "timers.hpp"
 
-#include <iostream>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
 
-boost::timer::cpu_timer init_timer {};
-boost::timer::cpu_timer haplotype_generation_timer {};
-boost::timer::cpu_timer haplotype_likelihood_timer {};
-boost::timer::cpu_timer haplotype_fitler_timer {};
-boost::timer::cpu_timer latent_timer {};
-boost::timer::cpu_timer calling_timer {};
-boost::timer::cpu_timer phasing_timer {};
-boost::timer::cpu_timer output_timer {};
+namespace octopus { namespace profiling {
 
-TimerArray misc_timer {};
+namespace {
 
-void init_timers()
+struct ThreadCounters
 {
-    init_timer.start(); init_timer.stop();
-    haplotype_likelihood_timer.start(); haplotype_likelihood_timer.stop();
-    latent_timer.start(); latent_timer.stop();
-    phasing_timer.start(); phasing_timer.stop();
-    calling_timer.start(); calling_timer.stop();
-    for (auto& timer : misc_timer) {
-        timer.start();
-        timer.stop();
+    // Only written by the owning thread, but read by write_report
+    std::array<std::atomic<std::uint64_t>, numStages> nanoseconds {}, calls {};
+};
+
+struct TaskProfile
+{
+    GenomicRegion region;
+    std::chrono::nanoseconds runtime;
+    StageTotals stages;
+};
+
+std::atomic<bool> enabled {false};
+boost::optional<boost::filesystem::path> report_path {};
+
+std::mutex registry_mutex {};
+std::vector<std::shared_ptr<const ThreadCounters>> thread_counters {};
+
+std::mutex task_mutex {};
+std::vector<TaskProfile> task_profiles {};
+
+thread_local StageTimer* current_timer {nullptr};
+
+std::shared_ptr<ThreadCounters> register_thread()
+{
+    auto result = std::make_shared<ThreadCounters>();
+    std::lock_guard<std::mutex> lock {registry_mutex};
+    thread_counters.push_back(result);
+    return result;
+}
+
+ThreadCounters& get_thread_counters()
+{
+    thread_local const auto result = register_thread();
+    return *result;
+}
+
+void add(std::atomic<std::uint64_t>& counter, const std::uint64_t n) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+StageTotals snapshot(const ThreadCounters& counters) noexcept
+{
+    StageTotals result {};
+    for (std::size_t s {0}; s < numStages; ++s) {
+        result.nanoseconds[s] = counters.nanoseconds[s].load(std::memory_order_relaxed);
+        result.calls[s] = counters.calls[s].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+StageTotals global_totals()
+{
+    StageTotals result {};
+    std::lock_guard<std::mutex> lock {registry_mutex};
+    for (const auto& counters : thread_counters) {
+        result += snapshot(*counters);
+    }
+    return result;
+}
+
+double to_seconds(const std::uint64_t nanoseconds) noexcept
+{
+    return static_cast<double>(nanoseconds) / 1e9;
+}
+
+std::string escape(const std::string& str)
+{
+    std::string result {};
+    result.reserve(str.size());
+    for (const char c : str) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default: result += c;
+        }
+    }
+    return result;
+}
+
+void write_stages(std::ostream& os, const StageTotals& stages)
+{
+    os << "{";
+    for (std::size_t s {0}; s < numStages; ++s) {
+        if (s > 0) os << ", ";
+        os << "\"" << name(static_cast<Stage>(s)) << "\": {\"seconds\": " << to_seconds(stages.nanoseconds[s])
+           << ", \"calls\": " << stages.calls[s] << "}";
+    }
+    os << "}";
+}
+
+struct ContigProfile
+{
+    std::size_t num_tasks = 0;
+    std::chrono::nanoseconds runtime {0};
+    StageTotals stages {};
+};
+
+} // namespace
+
+const char* name(const Stage stage) noexcept
+{
+    switch (stage) {
+        case Stage::read_fetch: return "read_fetch";
+        case Stage::read_transform: return "read_transform";
+        case Stage::candidate_generation: return "candidate_generation";
+        case Stage::assembly: return "assembly";
+        case Stage::haplotype_generation: return "haplotype_generation";
+        case Stage::likelihoods: return "likelihoods";
+        case Stage::latents: return "latents";
+        case Stage::phasing: return "phasing";
+        case Stage::output: return "output";
+        default: return "unknown";
     }
 }
 
-void print_all_timers()
+StageTotals& StageTotals::operator+=(const StageTotals& other) noexcept
 {
-    std::cout << "init timer" << '\n';
-    std::cout << init_timer.format() << std::endl;
-    std::cout << "likelihood timer" << '\n';
-    std::cout << haplotype_likelihood_timer.format() << std::endl;
-    std::cout << "latent timer" << '\n';
-    std::cout << latent_timer.format() << std::endl;
-    std::cout << "calling timer" << '\n';
-    std::cout << calling_timer.format() << std::endl;
-    std::cout << "phasing timer" << '\n';
-    std::cout << phasing_timer.format() << std::endl;
-    for (std::size_t i {0}; i < misc_timer.size(); ++i) {
-        std::cout << "misc timer " << i << '\n';
-        std::cout << misc_timer[i].format() << '\n';
+    for (std::size_t s {0}; s < numStages; ++s) {
+        nanoseconds[s] += other.nanoseconds[s];
+        calls[s] += other.calls[s];
     }
+    return *this;
 }
+
+StageTotals& StageTotals::operator-=(const StageTotals& other) noexcept
+{
+    for (std::size_t s {0}; s < numStages; ++s) {
+        nanoseconds[s] -= other.nanoseconds[s];
+        calls[s] -= other.calls[s];
+    }
+    return *this;
+}
+
+StageTotals operator-(StageTotals lhs, const StageTotals& rhs) noexcept
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+void init(boost::optional<boost::filesystem::path> path)
+{
+    report_path = std::move(path);
+    enabled.store(static_cast<bool>(report_path), std::memory_order_relaxed);
+}
+
+bool is_enabled() noexcept
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+StageTotals thread_totals()
+{
+    return snapshot(get_thread_counters());
+}
+
+// StageTimer
+
+StageTimer::StageTimer(const Stage stage) noexcept
+: active_ {is_enabled()}
+, stage_ {stage}
+, start_ {}
+, parent_ {nullptr}
+{
+    if (active_) {
+        start_ = Clock::now();
+        parent_ = current_timer;
+        if (parent_) parent_->charge(start_);
+        current_timer = this;
+        add(get_thread_counters().calls[static_cast<std::size_t>(stage_)], 1);
+    }
+}
+
+StageTimer::~StageTimer()
+{
+    if (active_) {
+        const auto now = Clock::now();
+        charge(now);
+        current_timer = parent_;
+        if (parent_) parent_->start_ = now;
+    }
+}
+
+void StageTimer::charge(const Clock::time_point now) noexcept
+{
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_);
+    add(get_thread_counters().nanoseconds[static_cast<std::size_t>(stage_)], duration.count());
+}
+
+// TaskTimer
+
+TaskTimer::TaskTimer(GenomicRegion region)
+: region_ {std::move(region)}
+, active_ {is_enabled()}
+, start_ {}
+, start_totals_ {}
+{
+    if (active_) {
+        start_ = std::chrono::steady_clock::now();
+        start_totals_ = thread_totals();
+    }
+}
+
+TaskTimer::~TaskTimer()
+{
+    if (active_) {
+        const auto runtime = std::chrono::steady_clock::now() - start_;
+        try {
+            record_task(region_, std::chrono::duration_cast<std::chrono::nanoseconds>(runtime),
+                        thread_totals() - start_totals_);
+        } catch (...) {}
+    }
+}
+
+void record_task(const GenomicRegion& region, const std::chrono::nanoseconds runtime, const StageTotals& stages)
+{
+    std::lock_guard<std::mutex> lock {task_mutex};
+    task_profiles.push_back({region, runtime, stages});
+}
+
+void write_report()
+{
+    if (!is_enabled()) return;
+    std::ofstream report {report_path->string()};
+    if (!report) {
+        throw std::runtime_error {"could not open profile report file " + report_path->string()};
+    }
+    std::lock_guard<std::mutex> lock {task_mutex};
+    std::sort(std::begin(task_profiles), std::end(task_profiles),
+              [] (const auto& lhs, const auto& rhs) { return lhs.region < rhs.region; });
+    std::vector<std::pair<GenomicRegion::ContigName, ContigProfile>> contig_profiles {};
+    for (const auto& task : task_profiles) {
+        if (contig_profiles.empty() || contig_profiles.back().first != task.region.contig_name()) {
+            contig_profiles.emplace_back(task.region.contig_name(), ContigProfile {});
+        }
+        auto& contig = contig_profiles.back().second;
+        ++contig.num_tasks;
+        contig.runtime += task.runtime;
+        contig.stages += task.stages;
+    }
+    report << std::setprecision(9);
+    report << "{\n\"stages\": ";
+    write_stages(report, global_totals());
+    report << ",\n\"contigs\": [";
+    for (std::size_t i {0}; i < contig_profiles.size(); ++i) {
+        const auto& contig = contig_profiles[i];
+        report << (i > 0 ? ",\n" : "\n") << "{\"contig\": \"" << escape(contig.first) << "\""
+               << ", \"tasks\": " << contig.second.num_tasks
+               << ", \"seconds\": " << to_seconds(contig.second.runtime.count())
+               << ", \"stages\": ";
+        write_stages(report, contig.second.stages);
+        report << "}";
+    }
+    report << "\n],\n\"tasks\": [";
+    for (std::size_t i {0}; i < task_profiles.size(); ++i) {
+        const auto& task = task_profiles[i];
+        report << (i > 0 ? ",\n" : "\n") << "{\"contig\": \"" << escape(task.region.contig_name()) << "\""
+               << ", \"begin\": " << task.region.begin() << ", \"end\": " << task.region.end()
+               << ", \"seconds\": " << to_seconds(task.runtime.count())
+               << ", \"stages\": ";
+        write_stages(report, task.stages);
+        report << "}";
+    }
+    report << "\n]\n}\n";
+}
+
+} // namespace profiling
+} // namespace octopus
@@ -4,40 +4,118 @@
 #ifndef timers_hpp
 #define timers_hpp
 
-//#define BENCHMARK
-
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+
+#include <boost/optional.hpp>
+#include <boost/filesystem/path.hpp>
 
-#include <boost/timer/timer.hpp>
+#include "basics/genomic_region.hpp"
 
-// variant caller timers
-extern boost::timer::cpu_timer init_timer;
-extern boost::timer::cpu_timer haplotype_likelihood_timer;
-extern boost::timer::cpu_timer latent_timer;
-extern boost::timer::cpu_timer calling_timer;
-extern boost::timer::cpu_timer phasing_timer;
-extern boost::timer::cpu_timer output_timer;
+namespace octopus {
 
-using TimerArray = std::array<boost::timer::cpu_timer, 12>;
+/*
+    Runtime profiling of the calling pipeline.
 
-extern TimerArray misc_timer;
+    Profiling is off unless init is given a report path, in which case every StageTimer adds the time
+    spent in its stage to counters owned by the calling thread. The counters are only written by
+    their own thread, so timing a stage never takes a lock. Stage times are exclusive: a stage nested
+    inside another (e.g. assembly inside candidate generation) pauses the outer stage while it runs.
 
-inline void resume(boost::timer::cpu_timer& timer)
+    Each calling task records the difference between its thread's totals at the start and end of the
+    task, and write_report writes the global, per-contig, and per-task breakdowns as JSON.
+ */
+namespace profiling {
+
+enum class Stage : std::uint8_t
 {
-    #ifdef BENCHMARK
-    timer.resume();
-    #endif
-}
+    read_fetch,
+    read_transform,
+    candidate_generation,
+    assembly,
+    haplotype_generation,
+    likelihoods,
+    latents,
+    phasing,
+    output
+};
+
+constexpr std::size_t numStages {9};
 
-inline void pause(boost::timer::cpu_timer& timer)
+const char* name(Stage stage) noexcept;
+
+struct StageTotals
 {
-    #ifdef BENCHMARK
-    timer.stop();
-    #endif
-}
+    std::array<std::uint64_t, numStages> nanoseconds, calls;
+
+    StageTotals& operator+=(const StageTotals& other) noexcept;
+    StageTotals& operator-=(const StageTotals& other) noexcept;
+};
+
+StageTotals operator-(StageTotals lhs, const StageTotals& rhs) noexcept;
+
+void init(boost::optional<boost::filesystem::path> report_path);
+
+bool is_enabled() noexcept;
+
+// Totals of all stages timed by the calling thread so far
+StageTotals thread_totals();
+
+class StageTimer
+{
+public:
+    StageTimer() = delete;
+
+    StageTimer(Stage stage) noexcept;
+
+    StageTimer(const StageTimer&)            = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+    StageTimer(StageTimer&&)                 = delete;
+    StageTimer& operator=(StageTimer&&)      = delete;
+
+    ~StageTimer();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    bool active_;
+    Stage stage_;
+    Clock::time_point start_;
+    StageTimer* parent_;
+
+    void charge(Clock::time_point now) noexcept;
+};
+
+// Records the stages run by the calling thread between construction and destruction as one task
+class TaskTimer
+{
+public:
+    TaskTimer() = delete;
+
+    TaskTimer(GenomicRegion region);
+
+    TaskTimer(const TaskTimer&)            = delete;
+    TaskTimer& operator=(const TaskTimer&) = delete;
+    TaskTimer(TaskTimer&&)                 = delete;
+    TaskTimer& operator=(TaskTimer&&)      = delete;
+
+    ~TaskTimer();
+
+private:
+    GenomicRegion region_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+    StageTotals start_totals_;
+};
+
+void record_task(const GenomicRegion& region, std::chrono::nanoseconds runtime, const StageTotals& stages);
 
-void init_timers();
+// Does nothing if profiling is not enabled
+void write_report();
 
-void print_all_timers();
+} // namespace profiling
+} // namespace octopus
 
 #endif
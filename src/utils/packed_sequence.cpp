@@ -0,0 +1,93 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "packed_sequence.hpp"
+
+#include <cstring>
+
+namespace octopus { namespace utils {
+
+namespace {
+
+constexpr const char* symbolTable {"=ACMGRSVTWYHKDBN"};
+
+// Both characters of each packed byte, so the scalar path decodes a byte with one lookup
+struct BytePairTable
+{
+    char pairs[512] {};
+    
+    constexpr BytePairTable() noexcept
+    {
+        for (unsigned byte {0}; byte < 256; ++byte) {
+            pairs[2 * byte]     = symbolTable[byte >> 4];
+            pairs[2 * byte + 1] = symbolTable[byte & 0xf];
+        }
+    }
+};
+
+constexpr BytePairTable bytePairTable {};
+
+bool use_ssse3() noexcept
+{
+    static const bool result {detail::has_ssse3()};
+    return result;
+}
+
+void decode_bytes(const std::uint8_t* packed, const std::size_t num_bytes, char* result) noexcept
+{
+    if (use_ssse3()) {
+        detail::decode_ssse3(packed, num_bytes, result);
+    } else {
+        detail::decode_scalar(packed, num_bytes, result);
+    }
+}
+
+} // namespace
+
+char decode(const PackedSequenceView::Code code) noexcept
+{
+    return symbolTable[code & 0xf];
+}
+
+void decode(const PackedSequenceView& sequence, char* result) noexcept
+{
+    auto n = sequence.size();
+    if (n == 0) return;
+    auto packed = sequence.data() + sequence.offset() / 2;
+    if (sequence.offset() % 2 == 1) {
+        // The view starts at a low nibble
+        *result++ = decode(static_cast<PackedSequenceView::Code>(*packed++ & 0xf));
+        --n;
+    }
+    decode_bytes(packed, n / 2, result);
+    if (n % 2 == 1) {
+        result[n - 1] = decode(static_cast<PackedSequenceView::Code>(packed[n / 2] >> 4));
+    }
+}
+
+std::string decode(const PackedSequenceView& sequence)
+{
+    std::string result(sequence.size(), 'N');
+    decode(sequence, &result[0]);
+    return result;
+}
+
+namespace detail {
+
+bool has_ssse3() noexcept
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+}
+
+void decode_scalar(const std::uint8_t* packed, const std::size_t num_bytes, char* result) noexcept
+{
+    for (std::size_t i {0}; i < num_bytes; ++i, result += 2) {
+        std::memcpy(result, bytePairTable.pairs + 2 * packed[i], 2);
+    }
+}
+
+} // namespace detail
+
+} // namespace utils
+} // namespace octopus
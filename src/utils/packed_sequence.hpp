@@ -0,0 +1,73 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef packed_sequence_hpp
+#define packed_sequence_hpp
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace octopus { namespace utils {
+
+/*
+    A non-owning view of a sequence packed two bases per byte in the 4-bit encoding used by
+    BAM ("=ACMGRSVTWYHKDBN", first base in the high nibble). The view may start at any base,
+    so trimming bases from the front (e.g. soft clips hanging off a contig) needs no copy.
+
+    Reads are still stored as characters (AlignedRead and ReadBatch), so sequences are decoded
+    once, when a read is made; the view just lets that decode write straight into its destination.
+ */
+class PackedSequenceView
+{
+public:
+    using Code = std::uint8_t;
+    
+    PackedSequenceView() = default;
+    
+    PackedSequenceView(const std::uint8_t* data, std::size_t size, std::size_t offset = 0) noexcept
+    : data_ {data}, offset_ {offset}, size_ {size}
+    {}
+    
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    
+    // The 4-bit code of base n
+    Code operator[](const std::size_t n) const noexcept
+    {
+        const auto i = offset_ + n;
+        return (data_[i >> 1] >> ((~i & 1) << 2)) & 0xf;
+    }
+    
+    // Removes the first n bases from the view
+    void remove_prefix(const std::size_t n) noexcept { offset_ += n; size_ -= n; }
+    
+    const std::uint8_t* data() const noexcept { return data_; }
+    std::size_t offset() const noexcept { return offset_; }
+    
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t offset_ = 0, size_ = 0;
+};
+
+char decode(PackedSequenceView::Code code) noexcept;
+
+// Writes sequence.size() characters to result
+void decode(const PackedSequenceView& sequence, char* result) noexcept;
+
+std::string decode(const PackedSequenceView& sequence);
+
+namespace detail {
+
+bool has_ssse3() noexcept;
+
+// Decodes 2 * num_bytes bases from whole packed bytes
+void decode_scalar(const std::uint8_t* packed, std::size_t num_bytes, char* result) noexcept;
+void decode_ssse3(const std::uint8_t* packed, std::size_t num_bytes, char* result) noexcept;
+
+} // namespace detail
+
+} // namespace utils
+} // namespace octopus
+
+#endif
@@ -0,0 +1,31 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+// This translation unit is compiled with SSSE3 enabled and must only be called on CPUs supporting it
+
+#include "packed_sequence.hpp"
+
+#include <tmmintrin.h>
+
+namespace octopus { namespace utils { namespace detail {
+
+void decode_ssse3(const std::uint8_t* packed, const std::size_t num_bytes, char* result) noexcept
+{
+    // Each nibble indexes the 16 symbols with a single shuffle
+    const auto symbols = _mm_setr_epi8('=', 'A', 'C', 'M', 'G', 'R', 'S', 'V', 'T', 'W', 'Y', 'H', 'K', 'D', 'B', 'N');
+    const auto low_mask = _mm_set1_epi8(0xf);
+    std::size_t i {0};
+    for (; i + 16 <= num_bytes; i += 16, result += 32) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed + i));
+        const auto high = _mm_shuffle_epi8(symbols, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask));
+        const auto low  = _mm_shuffle_epi8(symbols, _mm_and_si128(bytes, low_mask));
+        // The high nibble holds the first base of each pair
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + 16), _mm_unpackhi_epi8(high, low));
+    }
+    decode_scalar(packed + i, num_bytes - i, result);
+}
+
+} // namespace detail
+} // namespace utils
+} // namespace octopus
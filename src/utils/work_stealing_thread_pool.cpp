@@ -0,0 +1,125 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "work_stealing_thread_pool.hpp"
+
+namespace octopus {
+
+namespace {
+
+thread_local WorkStealingThreadPool* current_pool {nullptr};
+
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool() : WorkStealingThreadPool {0} {}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const std::size_t n_threads)
+: queues_ {}
+, workers_ {}
+, stop_ {false}
+, n_queued_ {0}
+, next_worker_ {0}
+{
+    queues_.reserve(n_threads);
+    for (std::size_t i {0}; i < n_threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(n_threads);
+    for (std::size_t i {0}; i < n_threads; ++i) {
+        workers_.emplace_back([this, i] { run(i); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lk {mutex_};
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+std::size_t WorkStealingThreadPool::size() const noexcept
+{
+    return workers_.size();
+}
+
+bool WorkStealingThreadPool::empty() const noexcept
+{
+    return workers_.empty();
+}
+
+std::size_t WorkStealingThreadPool::n_queued() const noexcept
+{
+    const auto result = n_queued_.load();
+    return result > 0 ? static_cast<std::size_t>(result) : 0;
+}
+
+WorkStealingThreadPool* WorkStealingThreadPool::current() noexcept
+{
+    return current_pool;
+}
+
+// private methods
+
+void WorkStealingThreadPool::enqueue(const std::size_t worker, Task task)
+{
+    {
+        std::lock_guard<std::mutex> lk {queues_[worker]->mutex};
+        queues_[worker]->tasks.push_back(std::move(task));
+    }
+    {
+        // Counting under mutex_ ensures a worker about to sleep sees the new task
+        std::lock_guard<std::mutex> lk {mutex_};
+        ++n_queued_;
+    }
+    cv_.notify_one();
+}
+
+bool WorkStealingThreadPool::try_pop(const std::size_t worker, Task& task)
+{
+    auto& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lk {queue.mutex};
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingThreadPool::try_steal(const std::size_t thief, Task& task)
+{
+    const auto n = queues_.size();
+    for (std::size_t i {1}; i < n; ++i) {
+        auto& queue = *queues_[(thief + i) % n];
+        std::unique_lock<std::mutex> lk {queue.mutex, std::try_to_lock};
+        if (lk.owns_lock() && !queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::run(const std::size_t worker)
+{
+    current_pool = this;
+    Task task;
+    while (true) {
+        if (try_pop(worker, task) || try_steal(worker, task)) {
+            --n_queued_;
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lk {mutex_};
+        // A steal attempt may have skipped a locked queue, so only sleep when nothing is queued
+        cv_.wait(lk, [this] () { return stop_ || n_queued_ > 0; });
+        if (stop_ && n_queued_ <= 0) return;
+    }
+}
+
+} // namespace octopus
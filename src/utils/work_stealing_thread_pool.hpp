@@ -0,0 +1,178 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef work_stealing_thread_pool_hpp
+#define work_stealing_thread_pool_hpp
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <stdexcept>
+#include <exception>
+#include <algorithm>
+
+namespace octopus {
+
+/*
+    A fixed set of persistent workers, each with its own task deque.
+
+    A worker runs tasks from the front of its own deque, and when that is empty steals from the
+    back of another worker's deque. Tasks pushed with an affinity always go to the same worker's
+    deque, so related tasks (e.g. from the same contig) tend to run on the same thread and
+    benefit from its warm caches. There is no lock shared by all workers on the task path.
+ */
+class WorkStealingThreadPool
+{
+public:
+    using Affinity = std::size_t;
+
+    WorkStealingThreadPool();
+    explicit WorkStealingThreadPool(std::size_t n_threads);
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&)            = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool(WorkStealingThreadPool&&)                 = delete;
+    WorkStealingThreadPool& operator=(WorkStealingThreadPool&&)      = delete;
+
+    ~WorkStealingThreadPool() noexcept;
+
+    std::size_t size() const noexcept;
+    bool empty() const noexcept;
+    std::size_t n_queued() const noexcept;
+
+    // Returns the pool that owns the calling thread, or nullptr if it is not a pool worker
+    static WorkStealingThreadPool* current() noexcept;
+
+    // Tasks are distributed to workers round-robin
+    template <typename F, typename... Args>
+    auto push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(Args...)>>;
+
+    // Tasks with the same affinity are queued on the same worker
+    template <typename F, typename... Args>
+    auto push_with_affinity(Affinity affinity, F&& f, Args&&... args) -> std::future<std::result_of_t<F(Args...)>>;
+
+private:
+    using Task = std::function<void()>;
+
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // Only used to put idle workers to sleep
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> stop_;
+    std::atomic<std::ptrdiff_t> n_queued_; // may be briefly negative as tasks are counted after they are queued
+    std::atomic<std::size_t> next_worker_;
+
+    void enqueue(std::size_t worker, Task task);
+    bool try_pop(std::size_t worker, Task& task);
+    bool try_steal(std::size_t thief, Task& task);
+    void run(std::size_t worker);
+
+    template <typename F, typename... Args>
+    auto package(F&& f, Args&&... args);
+};
+
+template <typename F, typename... Args>
+auto WorkStealingThreadPool::push(F&& f, Args&&... args) -> std::future<std::result_of_t<F(Args...)>>
+{
+    return push_with_affinity(next_worker_++, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <typename F, typename... Args>
+auto WorkStealingThreadPool::push_with_affinity(const Affinity affinity, F&& f, Args&&... args)
+-> std::future<std::result_of_t<F(Args...)>>
+{
+    if (stop_) throw std::runtime_error {"WorkStealingThreadPool: calling push on stopped pool"};
+    if (queues_.empty()) throw std::runtime_error {"WorkStealingThreadPool: calling push on empty pool"};
+    auto task = package(std::forward<F>(f), std::forward<Args>(args)...);
+    auto result = task->get_future();
+    enqueue(affinity % queues_.size(), [task] () { (*task)(); });
+    return result;
+}
+
+template <typename F, typename... Args>
+auto WorkStealingThreadPool::package(F&& f, Args&&... args)
+{
+    using f_result_type = std::result_of_t<F(Args...)>;
+    return std::make_shared<std::packaged_task<f_result_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+}
+
+namespace detail {
+
+template <typename F>
+struct ParallelForState
+{
+    ParallelForState(std::size_t n, F f) : f {std::move(f)}, n {n}, next {0}, n_done {0} {}
+    F f;
+    const std::size_t n;
+    std::atomic<std::size_t> next, n_done;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::exception_ptr error;
+};
+
+template <typename F>
+void claim_and_run(ParallelForState<F>& state)
+{
+    for (auto i = state.next++; i < state.n; i = state.next++) {
+        try {
+            state.f(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lk {state.mutex};
+            if (!state.error) state.error = std::current_exception();
+        }
+        if (++state.n_done == state.n) {
+            std::lock_guard<std::mutex> lk {state.mutex};
+            state.cv.notify_all();
+        }
+    }
+}
+
+} // namespace detail
+
+/*
+    Calls f(i) for every i in [0, n), in no particular order.
+
+    The calling thread takes part, and idle pool workers join in by claiming indices one at a
+    time, so a slow index never holds up the others. Only indices some thread has started are
+    waited on, so this is safe to call from a pool worker even when every other worker is busy,
+    and no threads are added beyond the pool's. With no pool it is a plain loop.
+    The first exception thrown by f is rethrown once every started index has finished.
+ */
+template <typename F>
+void parallel_for(WorkStealingThreadPool* pool, const std::size_t n, F f)
+{
+    if (n == 0) return;
+    auto state = std::make_shared<detail::ParallelForState<F>>(n, std::move(f));
+    if (pool != nullptr && n > 1) {
+        const auto n_helpers = std::min(n - 1, pool->size());
+        for (std::size_t i {0}; i < n_helpers; ++i) {
+            // Helpers that start after every index is claimed return straight away
+            pool->push([state] () { detail::claim_and_run(*state); });
+        }
+    }
+    detail::claim_and_run(*state);
+    std::unique_lock<std::mutex> lk {state->mutex};
+    state->cv.wait(lk, [&] () { return state->n_done == n; });
+    if (state->error) std::rethrow_exception(state->error);
+}
+
+} // namespace octopus
+
+#endif
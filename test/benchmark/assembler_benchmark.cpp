@@ -0,0 +1,95 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "config/common.hpp"
+#include "core/tools/vargen/utils/assembler.hpp"
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+using coretools::Assembler;
+
+constexpr unsigned kmerSize {25};
+
+struct AssemblyProblem
+{
+    Assembler::NucleotideSequence reference;
+    std::vector<Assembler::NucleotideSequence> reads;
+};
+
+// A typical assembly bin: 200 100bp reads from 4 haplotypes over a 400bp region
+const AssemblyProblem& assembly_problem()
+{
+    static const auto result = [] () {
+        const auto region = make_region(400);
+        const auto haplotypes = make_haplotypes(region, make_snvs(region, 10), 4);
+        const auto reads = simulate_reads(haplotypes, "benchmark", 200, 100);
+        AssemblyProblem result {reference().fetch_sequence(region), {}};
+        for (const auto& read : reads.at("benchmark")) {
+            result.reads.push_back(read.sequence());
+        }
+        return result;
+    }();
+    return result;
+}
+
+std::unique_ptr<Assembler> build_graph(const AssemblyProblem& problem)
+{
+    auto result = std::make_unique<Assembler>(kmerSize, problem.reference);
+    for (const auto& read : problem.reads) {
+        result->insert_read(read);
+    }
+    return result;
+}
+
+void assembler_build_graph(State& state)
+{
+    const auto& problem = assembly_problem();
+    std::unique_ptr<Assembler> assembler {};
+    while (state.keep_running()) {
+        assembler = build_graph(problem);
+        do_not_optimise(*assembler);
+        state.pause_timing();
+        assembler.reset();
+        state.resume_timing();
+    }
+    state.set_items_processed(problem.reads.size());
+}
+
+// Mirrors the graph processing LocalReassembler does before extracting variants
+void assembler_extract_variants(State& state)
+{
+    const auto& problem = assembly_problem();
+    std::unique_ptr<Assembler> assembler {};
+    std::size_t num_variants {0};
+    while (state.keep_running()) {
+        state.pause_timing();
+        assembler = build_graph(problem);
+        state.resume_timing();
+        assembler->try_recover_dangling_branches();
+        assembler->prune(2);
+        if (!assembler->is_acyclic()) {
+            assembler->remove_nonreference_cycles();
+        }
+        assembler->cleanup();
+        const auto variants = assembler->extract_variants(30, 2.0);
+        num_variants = variants.size();
+        do_not_optimise(variants);
+    }
+    state.set_label(std::to_string(num_variants) + " variants");
+}
+
+} // namespace
+
+OCTOPUS_BENCHMARK(assembler_build_graph);
+OCTOPUS_BENCHMARK(assembler_extract_variants);
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,220 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_data.hpp"
+
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <fstream>
+#include <stdexcept>
+#include <cctype>
+
+#include "io/reference/reference_reader.hpp"
+#include "basics/cigar_string.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+// Holds a whole (small) fasta in memory, so the benchmark reference does not need an index
+class InMemoryFasta : public io::ReferenceReader
+{
+public:
+    InMemoryFasta(const boost::filesystem::path& fasta);
+
+    InMemoryFasta(const InMemoryFasta&)            = default;
+    InMemoryFasta& operator=(const InMemoryFasta&) = default;
+    InMemoryFasta(InMemoryFasta&&)                 = default;
+    InMemoryFasta& operator=(InMemoryFasta&&)      = default;
+
+private:
+    std::string name_;
+    std::vector<std::pair<ContigName, GeneticSequence>> contigs_;
+
+    std::unique_ptr<ReferenceReader> do_clone() const override
+    {
+        return std::make_unique<InMemoryFasta>(*this);
+    }
+    bool do_is_open() const noexcept override
+    {
+        return true;
+    }
+    std::string do_fetch_reference_name() const override
+    {
+        return name_;
+    }
+    std::vector<ContigName> do_fetch_contig_names() const override
+    {
+        std::vector<ContigName> result(contigs_.size());
+        std::transform(std::cbegin(contigs_), std::cend(contigs_), std::begin(result),
+                       [] (const auto& contig) { return contig.first; });
+        return result;
+    }
+    GenomicSize do_fetch_contig_size(const ContigName& contig) const override
+    {
+        return static_cast<GenomicSize>(find(contig).size());
+    }
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override
+    {
+        const auto& contig = find(region.contig_name());
+        if (region.end() > contig.size()) {
+            throw std::out_of_range {"benchmark reference region out of range"};
+        }
+        return contig.substr(region.begin(), size(region));
+    }
+
+    const GeneticSequence& find(const ContigName& contig) const
+    {
+        const auto itr = std::find_if(std::cbegin(contigs_), std::cend(contigs_),
+                                      [&] (const auto& p) { return p.first == contig; });
+        if (itr == std::cend(contigs_)) {
+            throw std::invalid_argument {"contig " + contig + " is not in the benchmark reference"};
+        }
+        return itr->second;
+    }
+};
+
+InMemoryFasta::InMemoryFasta(const boost::filesystem::path& fasta)
+: name_ {fasta.stem().string()}
+, contigs_ {}
+{
+    std::ifstream file {fasta.string()};
+    if (!file) {
+        throw std::runtime_error {"could not open benchmark reference " + fasta.string()};
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        if (line.front() == '>') {
+            contigs_.emplace_back(line.substr(1, line.find_first_of(" \t\r") - 1), GeneticSequence {});
+        } else if (!contigs_.empty()) {
+            for (const char c : line) {
+                if (std::isalpha(c)) contigs_.back().second.push_back(std::toupper(c));
+            }
+        }
+    }
+    if (contigs_.empty()) {
+        throw std::runtime_error {"benchmark reference " + fasta.string() + " has no contigs"};
+    }
+}
+
+boost::filesystem::path fasta_path {};
+
+char random_other_base(const char base, std::mt19937& generator)
+{
+    static const std::string bases {"ACGT"};
+    std::uniform_int_distribution<int> offset {1, 3};
+    const auto itr = bases.find(base);
+    return bases[((itr == std::string::npos ? 0 : itr) + offset(generator)) % 4];
+}
+
+} // namespace
+
+void set_reference_path(boost::filesystem::path fasta)
+{
+    fasta_path = std::move(fasta);
+}
+
+const boost::filesystem::path& reference_path()
+{
+    return fasta_path;
+}
+
+const ReferenceGenome& reference()
+{
+    static const ReferenceGenome result {std::make_unique<InMemoryFasta>(fasta_path)};
+    return result;
+}
+
+GenomicRegion make_region(const GenomicRegion::Size size)
+{
+    const auto contigs = reference().contig_names();
+    const auto longest = *std::max_element(std::cbegin(contigs), std::cend(contigs), [] (const auto& lhs, const auto& rhs) {
+        return reference().contig_size(lhs) < reference().contig_size(rhs);
+    });
+    return GenomicRegion {longest, 0, std::min(size, reference().contig_size(longest))};
+}
+
+std::vector<Variant> make_snvs(const GenomicRegion& region, const std::size_t n, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::vector<GenomicRegion::Position> positions(size(region));
+    std::iota(std::begin(positions), std::end(positions), region.begin());
+    std::shuffle(std::begin(positions), std::end(positions), generator);
+    positions.resize(std::min(n, positions.size()));
+    std::sort(std::begin(positions), std::end(positions));
+    const auto sequence = reference().fetch_sequence(region);
+    std::vector<Variant> result {};
+    result.reserve(positions.size());
+    for (const auto position : positions) {
+        const auto ref = sequence[position - region.begin()];
+        result.emplace_back(region.contig_name(), position, std::string {ref},
+                            std::string {random_other_base(ref, generator)});
+    }
+    return result;
+}
+
+std::vector<Haplotype> make_haplotypes(const GenomicRegion& region, const std::vector<Variant>& variants,
+                                       const std::size_t n, const unsigned seed)
+{
+    std::mt19937 generator {seed};
+    std::bernoulli_distribution use_alt {0.5};
+    std::vector<Haplotype> result {};
+    result.reserve(n);
+    result.emplace_back(region, reference());
+    while (result.size() < n) {
+        Haplotype::Builder builder {region, reference()};
+        for (const auto& variant : variants) {
+            if (use_alt(generator)) builder.push_back(variant.alt_allele());
+        }
+        result.push_back(builder.build());
+    }
+    std::sort(std::begin(result), std::end(result));
+    result.erase(std::unique(std::begin(result), std::end(result)), std::end(result));
+    return result;
+}
+
+ReadMap simulate_reads(const std::vector<Haplotype>& haplotypes, const SampleName& sample,
+                       const std::size_t num_reads, const GenomicRegion::Size read_length,
+                       const double error_rate, const unsigned seed)
+{
+    if (haplotypes.empty()) {
+        throw std::invalid_argument {"simulate_reads requires haplotypes"};
+    }
+    const auto& region = haplotypes.front().mapped_region();
+    // Leave some flank so reads are well contained by the haplotypes
+    const GenomicRegion::Size flank {20};
+    if (size(region) < read_length + 2 * flank) {
+        throw std::invalid_argument {"simulate_reads haplotypes are too short for the read length"};
+    }
+    std::mt19937 generator {seed};
+    std::uniform_int_distribution<std::size_t> haplotype_index {0, haplotypes.size() - 1};
+    std::uniform_int_distribution<GenomicRegion::Position> offset {flank, size(region) - read_length - flank};
+    std::uniform_int_distribution<int> quality {20, 40};
+    std::bernoulli_distribution is_error {error_rate};
+    ReadMap result {};
+    auto& reads = result[sample];
+    for (std::size_t i {0}; i < num_reads; ++i) {
+        const auto& haplotype = haplotypes[haplotype_index(generator)];
+        const auto begin = region.begin() + offset(generator);
+        // SNV-only haplotypes have the same length as the reference
+        auto sequence = haplotype.sequence().substr(begin - region.begin(), read_length);
+        for (auto& base : sequence) {
+            if (is_error(generator)) base = random_other_base(base, generator);
+        }
+        AlignedRead::BaseQualityVector qualities(read_length);
+        std::generate(std::begin(qualities), std::end(qualities), [&] () { return quality(generator); });
+        reads.emplace("read" + std::to_string(i), GenomicRegion {region.contig_name(), begin, begin + read_length},
+                      std::move(sequence), std::move(qualities),
+                      CigarString {CigarOperation {read_length, CigarOperation::Flag::alignmentMatch}},
+                      60, AlignedRead::Flags {});
+    }
+    return result;
+}
+
+} // namespace benchmark
+} // namespace octopus
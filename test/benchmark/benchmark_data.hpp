@@ -0,0 +1,55 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#ifndef Octopus_benchmark_data_hpp
+#define Octopus_benchmark_data_hpp
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "core/types/variant.hpp"
+#include "core/types/haplotype.hpp"
+
+namespace octopus { namespace benchmark {
+
+/*
+    Synthetic benchmark inputs. Everything is generated from the benchmark reference with fixed
+    random seeds, so every run (and every release) benchmarks exactly the same data.
+ */
+
+// Must be called before reference() is first used
+void set_reference_path(boost::filesystem::path fasta);
+
+const boost::filesystem::path& reference_path();
+
+// The whole fasta is loaded into memory, so an index is not required
+const ReferenceGenome& reference();
+
+// A region of the given size (or the whole contig if smaller) in the longest reference contig
+GenomicRegion make_region(GenomicRegion::Size size);
+
+// Random SNVs in region, at most one per position
+std::vector<Variant> make_snvs(const GenomicRegion& region, std::size_t n, unsigned seed = 42);
+
+// Up to n distinct haplotypes over region, each containing a random subset of the variants.
+// One of them is the reference haplotype.
+std::vector<Haplotype> make_haplotypes(const GenomicRegion& region, const std::vector<Variant>& variants,
+                                       std::size_t n, unsigned seed = 42);
+
+// Error-free reads are sampled uniformly from the haplotypes, and sequencing errors are then added
+// at the given rate. Reads are contained within the haplotype region and have a plain match cigar.
+ReadMap simulate_reads(const std::vector<Haplotype>& haplotypes, const SampleName& sample,
+                       std::size_t num_reads, GenomicRegion::Size read_length,
+                       double error_rate = 0.01, unsigned seed = 42);
+
+} // namespace benchmark
+} // namespace octopus
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+#ifndef OCTOPUS_BENCHMARK_REFERENCE
+#define OCTOPUS_BENCHMARK_REFERENCE "test/data/reference.fa"
+#endif
+
+using namespace octopus::benchmark;
+
+namespace {
+
+void print_usage(std::ostream& os)
+{
+    os << "Usage: octopus-benchmarks [options]\n"
+       << "  --filter <string>      only run benchmarks whose names contain string\n"
+       << "  --min-time <seconds>   minimum time to run each benchmark for (default 0.5)\n"
+       << "  --out <file>           write the JSON report to file rather than stdout\n"
+       << "  --reference <fasta>    reference to generate inputs from (default " << OCTOPUS_BENCHMARK_REFERENCE << ")\n";
+}
+
+} // namespace
+
+int main(const int argc, const char** argv)
+{
+    RunOptions options {};
+    std::string out_path {}, reference {OCTOPUS_BENCHMARK_REFERENCE};
+    for (int i {1}; i < argc; ++i) {
+        const std::string arg {argv[i]};
+        if (arg == "--help") {
+            print_usage(std::cout);
+            return EXIT_SUCCESS;
+        }
+        if (i + 1 == argc) {
+            print_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+        const std::string value {argv[++i]};
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--min-time") {
+            const std::chrono::duration<double> min_time {std::stod(value)};
+            options.min_time = std::chrono::duration_cast<State::Duration>(min_time);
+        } else if (arg == "--out") {
+            out_path = value;
+        } else if (arg == "--reference") {
+            reference = value;
+        } else {
+            print_usage(std::cerr);
+            return EXIT_FAILURE;
+        }
+    }
+    set_reference_path(reference);
+    const auto results = run_benchmarks(options, std::clog);
+    if (out_path.empty()) {
+        write_json(results, reference, std::cout);
+    } else {
+        std::ofstream out {out_path};
+        write_json(results, reference, out);
+    }
+    const auto failed = std::any_of(std::cbegin(results), std::cend(results),
+                                    [] (const auto& result) { return !result.error.empty(); });
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
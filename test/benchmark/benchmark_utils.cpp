@@ -0,0 +1,216 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include "benchmark_utils.hpp"
+
+#include <utility>
+#include <algorithm>
+#include <numeric>
+#include <iomanip>
+#include <ctime>
+#include <thread>
+#include <exception>
+
+namespace octopus { namespace benchmark {
+
+// State
+
+State::State(const Duration min_time, const std::size_t max_iterations)
+: min_time_ {min_time}
+, max_iterations_ {std::max(max_iterations, std::size_t {1})}
+, iteration_times_ {}
+, total_time_ {0}
+, iteration_time_ {0}
+, start_ {}
+, started_ {false}
+, paused_ {false}
+, items_processed_ {0}
+, label_ {}
+, error_ {}
+{}
+
+bool State::keep_running()
+{
+    if (started_) {
+        if (!paused_) iteration_time_ += Clock::now() - start_;
+        iteration_times_.push_back(iteration_time_);
+        total_time_ += iteration_time_;
+        iteration_time_ = Duration {0};
+    }
+    started_ = true;
+    paused_ = false;
+    if (!error_.empty() || iteration_times_.size() >= max_iterations_
+        || (!iteration_times_.empty() && total_time_ >= min_time_)) {
+        return false;
+    }
+    start_ = Clock::now();
+    return true;
+}
+
+void State::pause_timing() noexcept
+{
+    if (!paused_) {
+        iteration_time_ += Clock::now() - start_;
+        paused_ = true;
+    }
+}
+
+void State::resume_timing() noexcept
+{
+    if (paused_) {
+        paused_ = false;
+        start_ = Clock::now();
+    }
+}
+
+void State::set_items_processed(const std::size_t n) noexcept
+{
+    items_processed_ = n;
+}
+
+void State::set_label(std::string label)
+{
+    label_ = std::move(label);
+}
+
+void State::skip_with_error(std::string error)
+{
+    error_ = std::move(error);
+}
+
+std::size_t State::iterations() const noexcept
+{
+    return iteration_times_.size();
+}
+
+const std::vector<State::Duration>& State::iteration_times() const noexcept
+{
+    return iteration_times_;
+}
+
+std::size_t State::items_processed() const noexcept
+{
+    return items_processed_;
+}
+
+const std::string& State::label() const noexcept
+{
+    return label_;
+}
+
+const std::string& State::error() const noexcept
+{
+    return error_;
+}
+
+namespace {
+
+using BenchmarkRegistry = std::vector<std::pair<std::string, BenchmarkFunction>>;
+
+BenchmarkRegistry& registry()
+{
+    static BenchmarkRegistry result {};
+    return result;
+}
+
+BenchmarkResult summarise(std::string name, const State& state)
+{
+    BenchmarkResult result {std::move(name), state.label(), state.error(), state.iterations(), state.items_processed(),
+                            0, 0, 0, 0};
+    std::vector<double> times(state.iterations());
+    std::transform(std::cbegin(state.iteration_times()), std::cend(state.iteration_times()), std::begin(times),
+                   [] (const auto duration) { return static_cast<double>(duration.count()); });
+    if (!times.empty()) {
+        std::sort(std::begin(times), std::end(times));
+        result.mean_ns = std::accumulate(std::cbegin(times), std::cend(times), 0.0) / times.size();
+        result.median_ns = times[times.size() / 2];
+        result.min_ns = times.front();
+        result.max_ns = times.back();
+    }
+    return result;
+}
+
+std::string escape(const std::string& str)
+{
+    std::string result {};
+    result.reserve(str.size());
+    for (const char c : str) {
+        if (c == '"' || c == '\\') result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+std::string current_date()
+{
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    return buffer;
+}
+
+} // namespace
+
+bool register_benchmark(std::string name, BenchmarkFunction function)
+{
+    registry().emplace_back(std::move(name), std::move(function));
+    return true;
+}
+
+std::vector<BenchmarkResult> run_benchmarks(const RunOptions& options, std::ostream& log)
+{
+    auto benchmarks = registry();
+    std::sort(std::begin(benchmarks), std::end(benchmarks),
+              [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    std::vector<BenchmarkResult> result {};
+    result.reserve(benchmarks.size());
+    for (const auto& benchmark : benchmarks) {
+        if (benchmark.first.find(options.filter) == std::string::npos) continue;
+        State state {options.min_time, options.max_iterations};
+        try {
+            benchmark.second(state);
+        } catch (const std::exception& e) {
+            state.skip_with_error(e.what());
+        }
+        result.push_back(summarise(benchmark.first, state));
+        const auto& summary = result.back();
+        log << std::left << std::setw(56) << summary.name;
+        if (summary.error.empty()) {
+            log << std::right << std::setw(16) << std::fixed << std::setprecision(0) << summary.mean_ns << " ns"
+                << std::setw(10) << summary.iterations << " iterations";
+            if (!summary.label.empty()) log << "  " << summary.label;
+        } else {
+            log << "ERROR: " << summary.error;
+        }
+        log << std::endl;
+    }
+    return result;
+}
+
+void write_json(const std::vector<BenchmarkResult>& results, const std::string& reference, std::ostream& os)
+{
+    os << std::setprecision(12);
+    os << "{\n  \"context\": {\"date\": \"" << current_date() << "\", \"num_cpus\": "
+       << std::thread::hardware_concurrency() << ", \"reference\": \"" << escape(reference) << "\"},\n";
+    os << "  \"benchmarks\": [";
+    for (std::size_t i {0}; i < results.size(); ++i) {
+        const auto& result = results[i];
+        os << (i > 0 ? ",\n" : "\n") << "    {\"name\": \"" << escape(result.name) << "\""
+           << ", \"iterations\": " << result.iterations
+           << ", \"real_time\": " << result.mean_ns
+           << ", \"median_time\": " << result.median_ns
+           << ", \"min_time\": " << result.min_ns
+           << ", \"max_time\": " << result.max_ns
+           << ", \"time_unit\": \"ns\"";
+        if (result.items_processed > 0 && result.mean_ns > 0) {
+            os << ", \"items_per_second\": " << result.items_processed / (result.mean_ns / 1e9);
+        }
+        if (!result.label.empty()) os << ", \"label\": \"" << escape(result.label) << "\"";
+        if (!result.error.empty()) os << ", \"error_occurred\": true, \"error_message\": \"" << escape(result.error) << "\"";
+        os << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+} // namespace benchmark
+} // namespace octopus
@@ -4,21 +4,110 @@
 #ifndef Octopus_benchmark_utils_hpp
 #define Octopus_benchmark_utils_hpp
 
+#include <cstddef>
 #include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
 
-template <typename D = std::chrono::nanoseconds, typename F>
-D benchmark(F f, unsigned num_tests)
+namespace octopus { namespace benchmark {
+
+/*
+    A minimal google-benchmark style harness. Each benchmark is a function taking a State, which
+    runs the timed code in a loop:
+
+        void my_benchmark(State& state)
+        {
+            const auto input = make_input(); // not timed
+            while (state.keep_running()) {
+                do_not_optimise(run(input));
+            }
+        }
+        OCTOPUS_BENCHMARK(my_benchmark);
+
+    Each iteration is timed separately so the report includes the spread as well as the mean.
+ */
+class State
+{
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Duration = std::chrono::nanoseconds;
+
+    State() = delete;
+
+    State(Duration min_time, std::size_t max_iterations);
+
+    State(const State&)            = delete;
+    State& operator=(const State&) = delete;
+    State(State&&)                 = default;
+    State& operator=(State&&)      = default;
+
+    ~State() = default;
+
+    // Returns false once enough iterations have been timed
+    bool keep_running();
+
+    // Excludes per-iteration setup from the timings
+    void pause_timing() noexcept;
+    void resume_timing() noexcept;
+
+    // The number of items (e.g. reads or alignments) processed by each iteration
+    void set_items_processed(std::size_t n) noexcept;
+    void set_label(std::string label);
+    // Stops the benchmark and reports it as failed
+    void skip_with_error(std::string error);
+
+    std::size_t iterations() const noexcept;
+    const std::vector<Duration>& iteration_times() const noexcept;
+    std::size_t items_processed() const noexcept;
+    const std::string& label() const noexcept;
+    const std::string& error() const noexcept;
+
+private:
+    Duration min_time_;
+    std::size_t max_iterations_;
+    std::vector<Duration> iteration_times_;
+    Duration total_time_, iteration_time_;
+    Clock::time_point start_;
+    bool started_, paused_;
+    std::size_t items_processed_;
+    std::string label_, error_;
+};
+
+// Stops the compiler optimising away the computation of value
+template <typename T>
+void do_not_optimise(T&& value) noexcept
 {
-    D total {0};
-    
-    for (; num_tests > 0; --num_tests) {
-        const auto start = std::chrono::system_clock::now();
-        f();
-        const auto end = std::chrono::system_clock::now();
-        total += std::chrono::duration_cast<D>(end - start);
-    }
-    
-    return D {total / num_tests};
+    asm volatile("" : : "g"(&value) : "memory");
 }
 
+using BenchmarkFunction = std::function<void(State&)>;
+
+bool register_benchmark(std::string name, BenchmarkFunction function);
+
+struct BenchmarkResult
+{
+    std::string name, label, error;
+    std::size_t iterations, items_processed;
+    double mean_ns, median_ns, min_ns, max_ns;
+};
+
+struct RunOptions
+{
+    std::string filter = {}; // only benchmarks with names containing filter are run
+    State::Duration min_time = std::chrono::milliseconds {500};
+    std::size_t max_iterations = 1'000'000;
+};
+
+std::vector<BenchmarkResult> run_benchmarks(const RunOptions& options, std::ostream& log);
+
+void write_json(const std::vector<BenchmarkResult>& results, const std::string& reference, std::ostream& os);
+
+} // namespace benchmark
+} // namespace octopus
+
+#define OCTOPUS_BENCHMARK(function) \
+static const bool function##_is_registered {::octopus::benchmark::register_benchmark(#function, function)}
+
 #endif
@@ -0,0 +1,153 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <vector>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+
+#include "config/common.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/types/genotype.hpp"
+#include "core/types/genotype_index.hpp"
+#include "core/models/haplotype_likelihood_cache.hpp"
+#include "core/models/genotype/germline_likelihood_model.hpp"
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+const SampleName sample {"benchmark"};
+
+const std::vector<Haplotype>& genotype_haplotypes()
+{
+    static const auto result = [] () {
+        const auto region = make_region(500);
+        return make_haplotypes(region, make_snvs(region, 20), 20);
+    }();
+    return result;
+}
+
+void generate_genotypes(State& state, const unsigned ploidy)
+{
+    const auto& haplotypes = genotype_haplotypes();
+    std::size_t num_genotypes {0};
+    while (state.keep_running()) {
+        const auto genotypes = generate_all_genotypes(haplotypes, ploidy);
+        num_genotypes = genotypes.size();
+        do_not_optimise(genotypes);
+    }
+    state.set_items_processed(num_genotypes);
+}
+
+void generate_all_genotypes_diploid(State& state)
+{
+    generate_genotypes(state, 2);
+}
+
+void generate_all_genotypes_triploid(State& state)
+{
+    generate_genotypes(state, 3);
+}
+
+void generate_genotype_indices(State& state, const unsigned ploidy)
+{
+    const auto num_haplotypes = static_cast<unsigned>(genotype_haplotypes().size());
+    std::size_t num_genotypes {0};
+    while (state.keep_running()) {
+        const auto genotypes = generate_all_genotype_indices(num_haplotypes, ploidy);
+        num_genotypes = genotypes.size();
+        do_not_optimise(genotypes);
+    }
+    state.set_items_processed(num_genotypes);
+}
+
+void generate_all_genotype_indices_diploid(State& state)
+{
+    generate_genotype_indices(state, 2);
+}
+
+void generate_all_genotype_indices_triploid(State& state)
+{
+    generate_genotype_indices(state, 3);
+}
+
+void germline_likelihood_model_evaluate(State& state, const unsigned ploidy)
+{
+    const auto& haplotypes = genotype_haplotypes();
+    const auto reads = simulate_reads(haplotypes, sample, 500, 100);
+    HaplotypeLikelihoodCache likelihoods {static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(reads, haplotypes);
+    likelihoods.prime(sample);
+    const model::GermlineLikelihoodModel model {likelihoods};
+    const auto genotypes = generate_all_genotypes(haplotypes, ploidy);
+    std::vector<double> log_likelihoods(genotypes.size());
+    while (state.keep_running()) {
+        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(log_likelihoods),
+                       [&] (const auto& genotype) { return model.evaluate(genotype); });
+        do_not_optimise(log_likelihoods);
+    }
+    state.set_items_processed(genotypes.size());
+}
+
+void germline_likelihood_model_evaluate_diploid(State& state)
+{
+    germline_likelihood_model_evaluate(state, 2);
+}
+
+void germline_likelihood_model_evaluate_triploid(State& state)
+{
+    germline_likelihood_model_evaluate(state, 3);
+}
+
+void germline_likelihood_model_evaluate_indices(State& state, const unsigned ploidy)
+{
+    const auto& haplotypes = genotype_haplotypes();
+    const auto reads = simulate_reads(haplotypes, sample, 500, 100);
+    HaplotypeLikelihoodCache likelihoods {static_cast<unsigned>(haplotypes.size()), {sample}};
+    likelihoods.populate(reads, haplotypes);
+    likelihoods.prime(sample);
+    const model::GermlineLikelihoodModel model {likelihoods, haplotypes};
+    const auto genotypes = generate_all_genotype_indices(static_cast<unsigned>(haplotypes.size()), ploidy);
+    std::vector<double> log_likelihoods(genotypes.size());
+    while (state.keep_running()) {
+        std::transform(std::cbegin(genotypes), std::cend(genotypes), std::begin(log_likelihoods),
+                       [&] (const auto& genotype) { return model.evaluate(genotype); });
+        do_not_optimise(log_likelihoods);
+    }
+    state.set_items_processed(genotypes.size());
+    const auto materialised_genotypes = materialise(genotypes, haplotypes);
+    for (std::size_t i {0}; i < genotypes.size(); ++i) {
+        if (std::abs(model.evaluate(materialised_genotypes[i]) - log_likelihoods[i]) > 1e-6) {
+            state.skip_with_error("index and materialised genotype likelihoods differ");
+            break;
+        }
+    }
+}
+
+void germline_likelihood_model_evaluate_indices_diploid(State& state)
+{
+    germline_likelihood_model_evaluate_indices(state, 2);
+}
+
+void germline_likelihood_model_evaluate_indices_triploid(State& state)
+{
+    germline_likelihood_model_evaluate_indices(state, 3);
+}
+
+} // namespace
+
+OCTOPUS_BENCHMARK(generate_all_genotypes_diploid);
+OCTOPUS_BENCHMARK(generate_all_genotypes_triploid);
+OCTOPUS_BENCHMARK(generate_all_genotype_indices_diploid);
+OCTOPUS_BENCHMARK(generate_all_genotype_indices_triploid);
+OCTOPUS_BENCHMARK(germline_likelihood_model_evaluate_diploid);
+OCTOPUS_BENCHMARK(germline_likelihood_model_evaluate_triploid);
+OCTOPUS_BENCHMARK(germline_likelihood_model_evaluate_indices_diploid);
+OCTOPUS_BENCHMARK(germline_likelihood_model_evaluate_indices_triploid);
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,65 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <vector>
+#include <string>
+
+#include "core/types/variant.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+using coretools::HaplotypeTree;
+
+// 10 bi-allelic SNVs give 1'024 haplotypes
+const std::vector<Variant>& tree_variants()
+{
+    static const auto result = make_snvs(make_region(1'000), 10);
+    return result;
+}
+
+void extend(HaplotypeTree& tree, const std::vector<Variant>& variants)
+{
+    for (const auto& variant : variants) {
+        tree.extend(variant.ref_allele());
+        tree.extend(variant.alt_allele());
+    }
+}
+
+void haplotype_tree_extend(State& state)
+{
+    const auto& variants = tree_variants();
+    HaplotypeTree tree {contig_name(variants.front()), reference()};
+    while (state.keep_running()) {
+        extend(tree, variants);
+        do_not_optimise(tree);
+        state.pause_timing();
+        tree.clear();
+        state.resume_timing();
+    }
+    state.set_items_processed(2 * variants.size());
+}
+
+void haplotype_tree_extract_haplotypes(State& state)
+{
+    const auto& variants = tree_variants();
+    HaplotypeTree tree {contig_name(variants.front()), reference()};
+    extend(tree, variants);
+    while (state.keep_running()) {
+        const auto haplotypes = tree.extract_haplotypes();
+        do_not_optimise(haplotypes);
+    }
+    state.set_items_processed(tree.num_haplotypes());
+}
+
+} // namespace
+
+OCTOPUS_BENCHMARK(haplotype_tree_extend);
+OCTOPUS_BENCHMARK(haplotype_tree_extract_haplotypes);
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,91 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <vector>
+#include <string>
+#include <iterator>
+#include <algorithm>
+#include <memory>
+
+#include "config/common.hpp"
+#include "utils/kmer_mapper.hpp"
+#include "core/models/haplotype_likelihood_cache.hpp"
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+const SampleName sample {"benchmark"};
+
+struct LikelihoodProblem
+{
+    std::vector<Haplotype> haplotypes;
+    ReadMap reads;
+};
+
+// 2'000 100bp reads over a 1'000bp region, so about 200x coverage, from 16 haplotypes
+const LikelihoodProblem& likelihood_problem()
+{
+    static const auto result = [] () {
+        const auto region = make_region(1'000);
+        auto haplotypes = make_haplotypes(region, make_snvs(region, 20), 16);
+        auto reads = simulate_reads(haplotypes, sample, 2'000, 100);
+        return LikelihoodProblem {std::move(haplotypes), std::move(reads)};
+    }();
+    return result;
+}
+
+void map_query_to_target_reads(State& state)
+{
+    constexpr unsigned char K {6}; // as HaplotypeLikelihoodCache
+    const auto& problem = likelihood_problem();
+    std::vector<KmerPerfectHashes> read_hashes {};
+    for (const auto& read : problem.reads.at(sample)) {
+        read_hashes.push_back(compute_kmer_hashes<K>(read.sequence()));
+    }
+    std::vector<KmerHashTable> haplotype_hashes {};
+    for (const auto& haplotype : problem.haplotypes) {
+        haplotype_hashes.push_back(make_kmer_hash_table<K>(haplotype.sequence()));
+    }
+    std::vector<std::size_t> mapping_positions {};
+    while (state.keep_running()) {
+        for (const auto& haplotype_table : haplotype_hashes) {
+            auto mapping_counts = init_mapping_counts(haplotype_table);
+            mapping_positions.clear();
+            for (const auto& hashes : read_hashes) {
+                map_query_to_target(hashes, haplotype_table, mapping_counts, std::back_inserter(mapping_positions), 10);
+                reset_mapping_counts(mapping_counts);
+            }
+            do_not_optimise(mapping_positions);
+        }
+    }
+    state.set_items_processed(read_hashes.size() * haplotype_hashes.size());
+}
+
+void haplotype_likelihood_cache_populate(State& state)
+{
+    const auto& problem = likelihood_problem();
+    const std::vector<SampleName> samples {sample};
+    std::unique_ptr<HaplotypeLikelihoodCache> cache {};
+    while (state.keep_running()) {
+        // Read likelihoods are memoised by the cache, so each iteration needs a new one
+        state.pause_timing();
+        cache = std::make_unique<HaplotypeLikelihoodCache>(problem.haplotypes.size(), samples);
+        state.resume_timing();
+        cache->populate(problem.reads, problem.haplotypes);
+        do_not_optimise(*cache);
+    }
+    state.set_items_processed(problem.reads.at(sample).size() * problem.haplotypes.size());
+    state.set_label(std::to_string(problem.reads.at(sample).size()) + " reads, "
+                    + std::to_string(problem.haplotypes.size()) + " haplotypes");
+}
+
+} // namespace
+
+OCTOPUS_BENCHMARK(map_query_to_target_reads);
+OCTOPUS_BENCHMARK(haplotype_likelihood_cache_populate);
+
+} // namespace benchmark
+} // namespace octopus
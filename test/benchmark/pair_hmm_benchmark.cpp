@@ -0,0 +1,171 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <cstdint>
+
+#include "core/models/pairhmm/pair_hmm.hpp"
+#include "core/models/pairhmm/simd_pair_hmm.hpp"
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+using namespace octopus::hmm::simd;
+
+struct ProblemSet
+{
+    std::vector<std::string> truths, targets, snv_masks;
+    std::vector<std::vector<std::int8_t>> qualities, gap_opens, snv_priors;
+    std::vector<AlignmentProblem> problems;
+};
+
+// Truths are reference windows, and targets are mutated copies of their middles
+ProblemSet make_problems(const std::size_t n, const int min_read_length, const int max_read_length)
+{
+    static const std::string bases {"ACGT"};
+    const auto contig = reference().fetch_sequence(make_region(1'000'000));
+    std::mt19937 generator {42};
+    std::uniform_int_distribution<int> base {0, 3}, quality {2, 40}, gap_open {5, 45}, mutation {0, 50};
+    std::uniform_int_distribution<int> read_length {min_read_length, max_read_length};
+    const auto max_truth_len = max_read_length + 2 * min_flank_pad() - 1;
+    std::uniform_int_distribution<std::size_t> truth_begin {0, contig.size() - max_truth_len};
+    ProblemSet result {};
+    result.truths.reserve(n); result.targets.reserve(n); result.snv_masks.reserve(n);
+    result.qualities.reserve(n); result.gap_opens.reserve(n); result.snv_priors.reserve(n);
+    for (std::size_t i {0}; i < n; ++i) {
+        const auto target_len = read_length(generator);
+        const auto truth_len = target_len + 2 * min_flank_pad() - 1;
+        auto truth = contig.substr(truth_begin(generator), truth_len);
+        std::string snv_mask(truth_len, 'N');
+        for (auto& b : snv_mask) b = bases[base(generator)];
+        auto target = truth.substr(min_flank_pad(), target_len);
+        for (auto& b : target) if (mutation(generator) == 0) b = bases[base(generator)];
+        std::vector<std::int8_t> qualities(target_len), gap_opens(truth_len), snv_priors(truth_len);
+        for (auto& q : qualities) q = quality(generator);
+        for (auto& q : gap_opens) q = gap_open(generator);
+        for (auto& q : snv_priors) q = quality(generator);
+        result.truths.push_back(std::move(truth));
+        result.targets.push_back(std::move(target));
+        result.snv_masks.push_back(std::move(snv_mask));
+        result.qualities.push_back(std::move(qualities));
+        result.gap_opens.push_back(std::move(gap_opens));
+        result.snv_priors.push_back(std::move(snv_priors));
+        AlignmentProblem problem {result.truths.back().data(), result.targets.back().data(),
+                                  result.qualities.back().data(), truth_len, target_len,
+                                  result.gap_opens.back().data()};
+        if (i % 2 == 1) {
+            problem.snv_mask  = result.snv_masks.back().data();
+            problem.snv_prior = result.snv_priors.back().data();
+        }
+        result.problems.push_back(problem);
+    }
+    return result;
+}
+
+const std::size_t numProblems {10'000};
+
+const ProblemSet& problem_set()
+{
+    static const auto result = make_problems(numProblems, 100, 150);
+    return result;
+}
+
+int align_one(const AlignmentProblem& problem)
+{
+    if (problem.snv_mask) {
+        return align(problem.truth, problem.target, problem.qualities, problem.truth_len, problem.target_len,
+                     problem.snv_mask, problem.snv_prior, problem.gap_open, 3, 2);
+    } else {
+        return align(problem.truth, problem.target, problem.qualities, problem.truth_len, problem.target_len,
+                     problem.gap_open, 3, 2);
+    }
+}
+
+void pair_hmm_align_unbatched(State& state)
+{
+    const auto& problems = problem_set().problems;
+    std::vector<int> scores(problems.size());
+    while (state.keep_running()) {
+        std::transform(std::cbegin(problems), std::cend(problems), std::begin(scores), align_one);
+        do_not_optimise(scores);
+    }
+    state.set_items_processed(problems.size());
+}
+
+void align_batched(State& state, const InstructionSet isa)
+{
+    if (!is_supported(isa)) {
+        state.set_label("not supported by this CPU");
+        return;
+    }
+    const auto& problems = problem_set().problems;
+    std::vector<int> expected(problems.size()), scores(problems.size());
+    std::transform(std::cbegin(problems), std::cend(problems), std::begin(expected), align_one);
+    while (state.keep_running()) {
+        align(problems.data(), problems.size(), 3, 2, scores.data(), isa);
+        do_not_optimise(scores);
+    }
+    state.set_items_processed(problems.size());
+    const auto num_mismatches = problems.size() - std::inner_product(std::cbegin(scores), std::cend(scores),
+                                                                     std::cbegin(expected), std::size_t {0},
+                                                                     std::plus<> {}, std::equal_to<> {});
+    if (num_mismatches > 0) {
+        state.skip_with_error(std::to_string(num_mismatches) + " scores differ from unbatched SSE2");
+    }
+}
+
+void pair_hmm_align_batched_sse2(State& state)
+{
+    align_batched(state, InstructionSet::sse2);
+}
+
+void pair_hmm_align_batched_avx2(State& state)
+{
+    align_batched(state, InstructionSet::avx2);
+}
+
+void pair_hmm_align_batched_avx512(State& state)
+{
+    align_batched(state, InstructionSet::avx512);
+}
+
+void pair_hmm_evaluate(State& state)
+{
+    const auto& set = problem_set();
+    std::vector<std::vector<std::uint8_t>> qualities(numProblems);
+    std::vector<std::vector<char>> snv_masks(numProblems);
+    std::vector<hmm::MutationModel> models {};
+    models.reserve(numProblems);
+    for (std::size_t i {0}; i < numProblems; ++i) {
+        qualities[i].assign(std::cbegin(set.qualities[i]), std::cend(set.qualities[i]));
+        snv_masks[i].assign(std::cbegin(set.snv_masks[i]), std::cend(set.snv_masks[i]));
+        models.push_back({snv_masks[i], set.snv_priors[i], set.gap_opens[i], 3});
+    }
+    std::vector<double> likelihoods(numProblems);
+    while (state.keep_running()) {
+        for (std::size_t i {0}; i < numProblems; ++i) {
+            likelihoods[i] = hmm::evaluate(set.targets[i], set.truths[i], qualities[i], hmm::min_flank_pad(), models[i]);
+        }
+        do_not_optimise(likelihoods);
+    }
+    state.set_items_processed(numProblems);
+}
+
+} // namespace
+
+OCTOPUS_BENCHMARK(pair_hmm_align_unbatched);
+OCTOPUS_BENCHMARK(pair_hmm_align_batched_sse2);
+OCTOPUS_BENCHMARK(pair_hmm_align_batched_avx2);
+OCTOPUS_BENCHMARK(pair_hmm_align_batched_avx512);
+OCTOPUS_BENCHMARK(pair_hmm_evaluate);
+
+} // namespace benchmark
+} // namespace octopus
@@ -0,0 +1,111 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <vector>
+#include <string>
+#include <random>
+
+#include <boost/filesystem.hpp>
+
+#include "config/common.hpp"
+#include "config/octopus_vcf.hpp"
+#include "io/variant/vcf_header.hpp"
+#include "io/variant/vcf_record.hpp"
+#include "io/variant/vcf_writer.hpp"
+#include "io/variant/vcf_parser.hpp"
+#include "benchmark_utils.hpp"
+#include "benchmark_data.hpp"
+
+namespace octopus { namespace benchmark {
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+const SampleName sample {"benchmark"};
+
+VcfHeader make_header()
+{
+    auto builder = vcf::make_header_template().set_samples({sample});
+    for (const auto& contig : reference().contig_names()) {
+        builder.add_contig(contig, {{"length", std::to_string(reference().contig_size(contig))}});
+    }
+    return builder.build_once();
+}
+
+// One record per SNV in the longest contig, with the kind of fields octopus writes
+std::vector<VcfRecord> make_records()
+{
+    const auto region = make_region(1'000'000);
+    const auto variants = make_snvs(region, size(region) / 2);
+    std::mt19937 generator {42};
+    std::uniform_int_distribution<int> depth {10, 100}, quality {1, 99}, genotype {0, 2};
+    std::vector<VcfRecord> result {};
+    result.reserve(variants.size());
+    for (const auto& variant : variants) {
+        VcfRecord::Builder builder {};
+        builder.set_chrom(contig_name(variant)).set_pos(mapped_begin(variant) + 1);
+        builder.set_ref(ref_sequence(variant)).set_alt(alt_sequence(variant));
+        builder.set_qual(quality(generator)).set_passed();
+        builder.set_info("DP", depth(generator));
+        builder.set_format({"GT", "GQ", "DP"});
+        const auto num_alts = genotype(generator);
+        std::vector<VcfRecord::NucleotideSequence> alleles {ref_sequence(variant), ref_sequence(variant)};
+        for (int i {0}; i < num_alts; ++i) alleles[i] = alt_sequence(variant);
+        builder.set_genotype(sample, std::move(alleles), VcfRecord::Builder::Phasing::unphased);
+        builder.set_format(sample, "GQ", quality(generator));
+        builder.set_format(sample, "DP", depth(generator));
+        result.push_back(builder.build_once());
+    }
+    return result;
+}
+
+struct TempVcf
+{
+    TempVcf() : path {fs::temp_directory_path() / fs::unique_path("octopus-benchmark-%%%%-%%%%.vcf")} {}
+    ~TempVcf() { fs::remove(path); }
+    fs::path path;
+};
+
+void write_vcf(const fs::path& path, const VcfHeader& header, const std::vector<VcfRecord>& records)
+{
+    VcfWriter writer {path, header};
+    write(records, writer);
+}
+
+void vcf_write(State& state)
+{
+    const auto header = make_header();
+    const auto records = make_records();
+    const TempVcf vcf {};
+    while (state.keep_running()) {
+        write_vcf(vcf.path, header, records);
+    }
+    state.set_items_processed(records.size());
+}
+
+void vcf_parse(State& state)
+{
+    const auto records = make_records();
+    const TempVcf vcf {};
+    write_vcf(vcf.path, make_header(), records);
+    std::size_t num_parsed {0};
+    while (state.keep_running()) {
+        const VcfParser parser {vcf.path};
+        const auto parsed = parser.fetch_records(VcfParser::UnpackPolicy::all);
+        num_parsed = parsed.size();
+        do_not_optimise(parsed);
+    }
+    state.set_items_processed(records.size());
+    if (num_parsed != records.size()) {
+        state.skip_with_error("parsed " + std::to_string(num_parsed) + " of " + std::to_string(records.size()) + " records");
+    }
+}
+
+} // namespace
+
+OCTOPUS_BENCHMARK(vcf_write);
+OCTOPUS_BENCHMARK(vcf_parse);
+
+} // namespace benchmark
+} // namespace octopus
@@ -32,6 +32,20 @@ BOOST_AUTO_TEST_CASE(some_operations_are_well_defined_on_different_contigs)
     BOOST_CHECK_NO_THROW(contains(r1, r2));
 }
 
+BOOST_AUTO_TEST_CASE(contig_names_are_interned)
+{
+    const std::string contig {"interned"};
+    const GenomicRegion r1 {contig, 0, 1}, r2 {"interned", 5, 10}, r3 {"other", 0, 1};
+    BOOST_CHECK_EQUAL(r1.contig_id(), r2.contig_id());
+    BOOST_CHECK_NE(r1.contig_id(), r3.contig_id());
+    BOOST_CHECK_EQUAL(r1.contig_name(), contig);
+    BOOST_CHECK_EQUAL(&r1.contig_name(), &r2.contig_name());
+    BOOST_CHECK_EQUAL(GenomicRegion {}.contig_name(), "");
+    const auto r4 = expand_rhs(r1, 1);
+    BOOST_CHECK_EQUAL(r4.contig_id(), r1.contig_id());
+    BOOST_CHECK_EQUAL(r4, (GenomicRegion {r1.contig_id(), 0, 2}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
     
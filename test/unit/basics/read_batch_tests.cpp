@@ -0,0 +1,110 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include "basics/genomic_region.hpp"
+#include "basics/cigar_string.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/read_batch.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(basics)
+BOOST_AUTO_TEST_SUITE(read_batch)
+
+std::vector<AlignedRead> make_mock_reads()
+{
+    return {
+        AlignedRead {
+            "read1", GenomicRegion {"1", 0, 4}, "ACGT", AlignedRead::BaseQualityVector {1, 2, 3, 4},
+            parse_cigar("4M"), 10, AlignedRead::Flags {}
+        },
+        AlignedRead {
+            "read2", GenomicRegion {"1", 2, 7}, "AACCGG", AlignedRead::BaseQualityVector {10, 20, 30, 40, 50, 60},
+            parse_cigar("1S2M1I2M"), 60, AlignedRead::Flags {}, "2", 100, 300, AlignedRead::Segment::Flags {}
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(can_be_default_constructed)
+{
+    BOOST_CHECK_NO_THROW(ReadBatch {});
+    BOOST_CHECK(ReadBatch {}.empty());
+}
+
+BOOST_AUTO_TEST_CASE(views_refer_to_batch_storage)
+{
+    const auto reads = make_mock_reads();
+    const auto batch = make_read_batch(reads);
+    BOOST_REQUIRE_EQUAL(batch.size(), reads.size());
+    BOOST_CHECK_EQUAL(batch.num_bases(), 10);
+    BOOST_CHECK_EQUAL(batch.contig_name(), "1");
+    const auto read = batch[1];
+    BOOST_CHECK_EQUAL(read.name(), "read2");
+    BOOST_CHECK_EQUAL(read.sequence(), "AACCGG");
+    BOOST_CHECK_EQUAL(read.mapped_region(), reads[1].mapped_region());
+    BOOST_CHECK_EQUAL(read.mapping_quality(), 60);
+    BOOST_CHECK(read.has_other_segment());
+    BOOST_CHECK(!batch[0].has_other_segment());
+    BOOST_CHECK(std::equal(std::cbegin(read.cigar()), std::cend(read.cigar()), std::cbegin(reads[1].cigar())));
+    BOOST_CHECK(std::equal(std::cbegin(read.base_qualities()), std::cend(read.base_qualities()),
+                           std::cbegin(reads[1].base_qualities())));
+}
+
+BOOST_AUTO_TEST_CASE(materialised_reads_equal_original_reads)
+{
+    const auto reads = make_mock_reads();
+    const auto batch = make_read_batch(reads);
+    const auto materialised_reads = materialise(batch);
+    BOOST_REQUIRE_EQUAL(materialised_reads.size(), reads.size());
+    for (std::size_t i {0}; i < reads.size(); ++i) {
+        BOOST_CHECK_EQUAL(materialised_reads[i], reads[i]);
+        BOOST_REQUIRE_EQUAL(materialised_reads[i].has_other_segment(), reads[i].has_other_segment());
+        if (reads[i].has_other_segment()) {
+            BOOST_CHECK_EQUAL(materialised_reads[i].next_segment().contig_name(), reads[i].next_segment().contig_name());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merge_preserves_position_order)
+{
+    const auto reads = make_mock_reads();
+    ReadBatch lhs {"1"}, rhs {"1"};
+    rhs.push_back(reads[0]);
+    lhs.push_back(reads[1]);
+    const auto merged = merge(lhs, rhs);
+    BOOST_REQUIRE_EQUAL(merged.size(), 2);
+    BOOST_CHECK_EQUAL(merged[0].name(), "read1");
+    BOOST_CHECK_EQUAL(merged[1].name(), "read2");
+    BOOST_CHECK(merged[1].has_other_segment());
+    BOOST_CHECK(std::is_sorted(std::cbegin(merged), std::cend(merged),
+                               [] (const auto& a, const auto& b) { return a.contig_region() < b.contig_region(); }));
+}
+
+BOOST_AUTO_TEST_CASE(reads_can_be_appended_from_the_same_batch)
+{
+    const auto reads = make_mock_reads();
+    auto batch = make_read_batch(reads);
+    batch.shrink_to_fit();
+    batch.push_back(batch[1]);
+    BOOST_REQUIRE_EQUAL(batch.size(), 3);
+    BOOST_CHECK_EQUAL(batch[2].materialise(), reads[1]);
+    BOOST_CHECK(batch[2].has_other_segment());
+    batch.shrink_to_fit();
+    batch.append(batch);
+    BOOST_REQUIRE_EQUAL(batch.size(), 6);
+    BOOST_CHECK_EQUAL(batch[3].materialise(), reads[0]);
+    BOOST_CHECK_EQUAL(batch[4].materialise(), reads[1]);
+    BOOST_CHECK_EQUAL(batch[5].materialise(), reads[1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,58 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <numeric>
+
+#include "utils/maths.hpp"
+#include "core/models/genotype/log_sum_exp_kernels.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(log_sum_exp_kernels)
+
+using model::simd::InstructionSet;
+
+BOOST_AUTO_TEST_CASE(sum_log_sum_exp_agrees_with_scalar_log_sum_exp)
+{
+    std::mt19937 generator {0};
+    std::uniform_real_distribution<double> log_likelihood {-200, 0};
+    for (std::size_t num_components {1}; num_components <= 8; ++num_components) {
+        for (const std::size_t num_reads : {0, 1, 3, 5, 100, 1001}) {
+            std::vector<std::vector<double>> log_likelihoods(num_components, std::vector<double>(num_reads));
+            std::vector<const double*> columns {};
+            std::vector<double> log_weights {};
+            for (auto& likelihoods : log_likelihoods) {
+                for (auto& l : likelihoods) l = log_likelihood(generator);
+                columns.push_back(likelihoods.data());
+                log_weights.push_back(-std::log(static_cast<double>(num_components)));
+            }
+            double expected {0};
+            std::vector<double> tmp(num_components);
+            for (std::size_t i {0}; i < num_reads; ++i) {
+                for (std::size_t k {0}; k < num_components; ++k) tmp[k] = log_likelihoods[k][i] + log_weights[k];
+                expected += maths::log_sum_exp(tmp);
+            }
+            for (const auto isa : {InstructionSet::sse2, InstructionSet::avx2}) {
+                if (!model::simd::is_supported(isa)) continue;
+                const auto result = model::simd::sum_log_sum_exp(columns.data(), log_weights.data(),
+                                                                  num_components, num_reads, isa);
+                BOOST_CHECK_SMALL(result - expected, 1e-12 * (num_reads + 1));
+                const auto sum = model::simd::sum(log_likelihoods.front().data(), num_reads, isa);
+                BOOST_CHECK_SMALL(sum - std::accumulate(std::cbegin(log_likelihoods.front()), std::cend(log_likelihoods.front()), 0.0),
+                                  1e-9);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
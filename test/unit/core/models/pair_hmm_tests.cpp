@@ -1,4 +1,64 @@
 // Copyright (c) 2017 Daniel Cooke
 // Use of this source code is governed by the MIT license that can be found in the LICENSE file.
 
-#include <stdio.h>
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "core/models/pairhmm/pair_hmm.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(pair_hmm)
+
+BOOST_AUTO_TEST_CASE(batched_evaluate_is_equivalent_to_evaluating_each_target)
+{
+    const std::string bases {"ACGT"};
+    std::mt19937 generator {0};
+    std::uniform_int_distribution<int> base {0, 3}, quality {2, 40}, mutation {0, 15}, read_size {20, 60};
+
+    std::string truth(300, 'A');
+    for (auto& b : truth) b = bases[base(generator)];
+    std::vector<char> snv_mask(truth.size(), 'N');
+    std::vector<std::int8_t> snv_priors(truth.size(), 40), gap_open(truth.size(), 30);
+    const hmm::MutationModel model {snv_mask, snv_priors, gap_open, 3, 2, 20, 20};
+
+    const std::size_t num_targets {200};
+    std::vector<std::string> targets {};
+    std::vector<std::vector<std::uint8_t>> qualities {};
+    std::vector<std::size_t> offsets {};
+    targets.reserve(num_targets);
+    qualities.reserve(num_targets);
+    for (std::size_t i {0}; i < num_targets; ++i) {
+        const auto size = static_cast<std::size_t>(read_size(generator));
+        const auto offset = static_cast<std::size_t>(std::uniform_int_distribution<int> {0, static_cast<int>(truth.size() - size)}(generator));
+        auto target = truth.substr(offset, size);
+        for (auto& b : target) if (mutation(generator) == 0) b = bases[base(generator)];
+        if (mutation(generator) < 4) target.erase(size / 2, 1).push_back('A');
+        std::vector<std::uint8_t> target_qualities(size);
+        for (auto& q : target_qualities) q = static_cast<std::uint8_t>(quality(generator));
+        targets.push_back(std::move(target));
+        qualities.push_back(std::move(target_qualities));
+        offsets.push_back(offset);
+    }
+    std::vector<hmm::Target> batch {};
+    for (std::size_t i {0}; i < num_targets; ++i) {
+        batch.push_back({targets[i].data(), targets[i].size(), qualities[i].data(), offsets[i], &model});
+    }
+    std::vector<double> batched_likelihoods {};
+    BOOST_REQUIRE_NO_THROW(hmm::evaluate(batch, truth, batched_likelihoods));
+    BOOST_REQUIRE_EQUAL(batched_likelihoods.size(), num_targets);
+    for (std::size_t i {0}; i < num_targets; ++i) {
+        BOOST_CHECK_EQUAL(batched_likelihoods[i], hmm::evaluate(targets[i], truth, qualities[i], offsets[i], model));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
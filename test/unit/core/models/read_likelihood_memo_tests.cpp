@@ -0,0 +1,87 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "core/models/read_likelihood_memo.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(read_likelihood_memo)
+
+namespace {
+
+auto make_fingerprint(const std::string& bytes)
+{
+    ReadLikelihoodMemo::FingerprintBuilder builder {};
+    return builder.update(bytes.data(), bytes.size()).fingerprint();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fingerprints_depend_on_all_bytes)
+{
+    const std::string bytes {"ACGTACGTACGTACGTACGTA"};
+    const auto fingerprint = make_fingerprint(bytes);
+    for (std::size_t i {0}; i < bytes.size(); ++i) {
+        auto mutated_bytes = bytes;
+        mutated_bytes[i] = 'N';
+        const auto mutated_fingerprint = make_fingerprint(mutated_bytes);
+        BOOST_CHECK(mutated_fingerprint.lo != fingerprint.lo || mutated_fingerprint.hi != fingerprint.hi);
+    }
+    const auto extended_fingerprint = make_fingerprint(bytes + '\0');
+    BOOST_CHECK(extended_fingerprint.lo != fingerprint.lo || extended_fingerprint.hi != fingerprint.hi);
+    const auto same_fingerprint = make_fingerprint(bytes);
+    BOOST_CHECK(same_fingerprint.lo == fingerprint.lo && same_fingerprint.hi == fingerprint.hi);
+}
+
+BOOST_AUTO_TEST_CASE(evict_before_removes_reads_ending_before_position)
+{
+    ReadLikelihoodMemo memo {};
+    const auto fingerprint1 = make_fingerprint("read1"), fingerprint2 = make_fingerprint("read2");
+    BOOST_CHECK(!memo.find(fingerprint1));
+    memo.insert(fingerprint1, -1.0, 100);
+    memo.insert(fingerprint2, -2.0, 200);
+    BOOST_REQUIRE_EQUAL(memo.size(), 2);
+    BOOST_REQUIRE(memo.find(fingerprint1));
+    BOOST_CHECK_EQUAL(*memo.find(fingerprint1), -1.0);
+    memo.evict_before(150);
+    BOOST_CHECK(!memo.find(fingerprint1));
+    BOOST_REQUIRE(memo.find(fingerprint2));
+    BOOST_CHECK_EQUAL(*memo.find(fingerprint2), -2.0);
+    memo.clear();
+    BOOST_CHECK_EQUAL(memo.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(evict_before_handles_reads_inserted_out_of_order)
+{
+    ReadLikelihoodMemo memo {};
+    const std::vector<unsigned> read_ends {500, 100, 300, 200, 400};
+    for (const auto read_end : read_ends) {
+        memo.insert(make_fingerprint(std::to_string(read_end)), -1.0 * read_end, read_end);
+    }
+    memo.insert(make_fingerprint("300"), -1.0, 50); // already memoised so ignored
+    BOOST_REQUIRE_EQUAL(memo.size(), read_ends.size());
+    BOOST_CHECK_EQUAL(*memo.find(make_fingerprint("300")), -300.0);
+    memo.evict_before(250);
+    BOOST_CHECK_EQUAL(memo.size(), 3);
+    BOOST_CHECK(!memo.find(make_fingerprint("100")));
+    BOOST_CHECK(!memo.find(make_fingerprint("200")));
+    BOOST_CHECK(memo.find(make_fingerprint("300")));
+    memo.insert(make_fingerprint("100"), -100.0, 100);
+    memo.evict_before(450);
+    BOOST_CHECK_EQUAL(memo.size(), 1);
+    BOOST_CHECK(memo.find(make_fingerprint("500")));
+    memo.evict_before(1000);
+    BOOST_CHECK_EQUAL(memo.size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,76 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+
+#include "basics/genomic_region.hpp"
+#include "core/task_cost_model.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(task_cost_model)
+
+using Duration = TaskCostModel::Duration;
+
+BOOST_AUTO_TEST_CASE(estimates_are_only_given_once_enough_tasks_are_added)
+{
+    TaskCostModel model {};
+    BOOST_CHECK(!model.estimate(GenomicRegion {"1", 0, 10'000}, 1'000));
+    for (unsigned i {0}; i < 20; ++i) {
+        model.add(GenomicRegion {"1", i * 10'000, (i + 1) * 10'000}, 1'000, Duration {1.0});
+    }
+    BOOST_REQUIRE(model.estimate(GenomicRegion {"1", 0, 10'000}, 1'000));
+    BOOST_CHECK_CLOSE(model.estimate(GenomicRegion {"1", 0, 10'000}, 1'000)->count(), 1.0, 1);
+}
+
+BOOST_AUTO_TEST_CASE(estimates_fit_linear_costs)
+{
+    TaskCostModel model {};
+    for (unsigned i {0}; i < 50; ++i) {
+        const GenomicRegion::Size size {5'000 + 1'000 * (i % 7)};
+        const std::size_t num_reads {100 + 250 * (i % 11)};
+        model.add(GenomicRegion {"2", 0, size}, num_reads, Duration {0.01 * num_reads + 0.0001 * size + 0.5});
+    }
+    const auto estimate = model.estimate(GenomicRegion {"3", 0, 8'000}, 2'000);
+    BOOST_REQUIRE(estimate);
+    BOOST_CHECK_CLOSE(estimate->count(), 0.01 * 2'000 + 0.0001 * 8'000 + 0.5, 1);
+}
+
+BOOST_AUTO_TEST_CASE(expensive_contigs_have_higher_estimates)
+{
+    TaskCostModel model {};
+    for (unsigned i {0}; i < 20; ++i) {
+        model.add(GenomicRegion {"4", i * 10'000, (i + 1) * 10'000}, 1'000, Duration {1.0});
+    }
+    model.add_overrun(GenomicRegion {"5", 0, 10'000}, Duration {10.0});
+    const auto cheap = model.estimate(GenomicRegion {"4", 0, 10'000}, 1'000);
+    const auto expensive = model.estimate(GenomicRegion {"5", 0, 10'000}, 1'000);
+    BOOST_REQUIRE(cheap && expensive);
+    BOOST_CHECK_GT(expensive->count(), 5 * cheap->count());
+}
+
+BOOST_AUTO_TEST_CASE(read_counts_are_estimated_from_contig_read_density)
+{
+    TaskCostModel model {};
+    for (unsigned i {0}; i < 20; ++i) {
+        const std::size_t num_reads {i % 2 == 0 ? 500u : 4'000u};
+        model.add(GenomicRegion {i % 2 == 0 ? "6" : "7", i * 10'000, (i + 1) * 10'000}, num_reads,
+                  Duration {0.001 * num_reads});
+    }
+    const auto sparse = model.estimate(GenomicRegion {"6", 0, 20'000});
+    const auto dense = model.estimate(GenomicRegion {"7", 0, 20'000});
+    const auto unseen = model.estimate(GenomicRegion {"8", 0, 20'000});
+    BOOST_REQUIRE(sparse && dense && unseen);
+    BOOST_CHECK_CLOSE(sparse->count(), 1.0, 1);
+    BOOST_CHECK_CLOSE(dense->count(), 8.0, 1);
+    BOOST_CHECK_CLOSE(unseen->count(), 4.5, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
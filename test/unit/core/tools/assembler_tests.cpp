@@ -4,6 +4,11 @@
 #include <boost/test/unit_test.hpp>
 
 #include <exception>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstddef>
 
 #include "core/tools/vargen/utils/assembler.hpp"
 
@@ -14,6 +19,29 @@ using octopus::coretools::Assembler;
 BOOST_AUTO_TEST_SUITE(core)
 BOOST_AUTO_TEST_SUITE(assembler)
 
+namespace {
+
+// mt19937 output is fully specified, so the sequences are the same on every platform
+Assembler::NucleotideSequence make_random_sequence(const std::size_t length, std::mt19937& generator)
+{
+    Assembler::NucleotideSequence result(length, 'N');
+    std::generate(std::begin(result), std::end(result), [&] () { return "ACGT"[generator() % 4]; });
+    return result;
+}
+
+Assembler::NucleotideSequence make_snv(Assembler::NucleotideSequence sequence, const std::size_t pos)
+{
+    sequence[pos] = sequence[pos] == 'A' ? 'C' : 'A';
+    return sequence;
+}
+
+Assembler::NucleotideSequence apply(const Assembler::Variant& variant, Assembler::NucleotideSequence reference)
+{
+    return reference.replace(variant.begin_pos, variant.ref.size(), variant.alt);
+}
+
+} // namespace
+
 BOOST_AUTO_TEST_CASE(assembler_can_be_constructed_with_reference_sequence)
 {
     const Assembler::NucleotideSequence reference {"AAAAACCCCC"};
@@ -72,7 +100,100 @@ BOOST_AUTO_TEST_CASE(assembler_throws_if_reference_sequence_is_inserted_twice)
     BOOST_CHECK_THROW(assembler.insert_reference(reference), std::exception);
 }
 
+BOOST_AUTO_TEST_CASE(inserting_a_read_with_a_count_is_the_same_as_inserting_it_count_times)
+{
+    const Assembler::NucleotideSequence reference {"ACGTTGCAAGCTTACGGATCCTAGCATGACTGAC"};
+    const Assembler::NucleotideSequence read1    {"ACGTTGCAAGCTTACGCATCCTAGCATGACTGAC"};
+    const Assembler::NucleotideSequence read2    {"GCAAGCTTACGCATCCTAGCA"};
+    
+    constexpr unsigned kmerSize {7};
+    
+    Assembler repeated {kmerSize, reference}, counted {kmerSize, reference};
+    
+    for (int i {0}; i < 3; ++i) {
+        repeated.insert_read(read1);
+        repeated.insert_read(read2);
+    }
+    counted.insert_read(read1, 3);
+    counted.insert_read(read2, 3);
+    
+    BOOST_REQUIRE_EQUAL(repeated.num_kmers(), counted.num_kmers());
+    
+    repeated.prune(4);
+    counted.prune(4);
+    
+    BOOST_REQUIRE_EQUAL(repeated.num_kmers(), counted.num_kmers());
+    
+    const auto repeated_variants = repeated.extract_variants(10, 0);
+    const auto counted_variants  = counted.extract_variants(10, 0);
+    
+    BOOST_REQUIRE_EQUAL(repeated_variants.size(), 1);
+    BOOST_CHECK(repeated_variants == counted_variants);
+}
 
+BOOST_AUTO_TEST_CASE(kmers_can_be_found_after_removals_that_wrap_around_the_kmer_table)
+{
+    // With this seed a probe cluster wraps from the end of the kmer table to the start. Pruning removes
+    // the noise kmers, including some in that cluster, so surviving kmers must be shifted back across
+    // the wrap or they can no longer be found.
+    std::mt19937 generator {43};
+    constexpr unsigned kmerSize {15};
+    const auto reference = make_random_sequence(1000, generator);
+    Assembler assembler {kmerSize, reference};
+    for (int i {0}; i < 11; ++i) {
+        assembler.insert_read(make_random_sequence(100, generator));
+    }
+    const std::vector<std::size_t> snv_positions {20, 500, 980};
+    std::vector<Assembler::NucleotideSequence> reads {};
+    for (const auto pos : snv_positions) {
+        reads.push_back(make_snv(reference, pos));
+        assembler.insert_read(reads.back(), 5);
+    }
+    const auto num_kmers_with_noise = assembler.num_kmers();
+    assembler.prune(2);
+    assembler.cleanup();
+    const auto num_kmers = assembler.num_kmers();
+    BOOST_REQUIRE_LT(num_kmers, num_kmers_with_noise);
+    // Every kmer between the outer bubbles survived cleanup, so reinserting them must find them all
+    assembler.insert_read(reference.substr(30, 940));
+    for (std::size_t i {0}; i < snv_positions.size(); ++i) {
+        assembler.insert_read(reads[i].substr(snv_positions[i] - (kmerSize - 1), 2 * kmerSize - 1));
+    }
+    BOOST_CHECK_EQUAL(assembler.num_kmers(), num_kmers);
+    const auto variants = assembler.extract_variants(10, 0);
+    BOOST_REQUIRE_EQUAL(variants.size(), snv_positions.size());
+    for (std::size_t i {0}; i < variants.size(); ++i) {
+        BOOST_CHECK_EQUAL(apply(variants[i], reference), reads[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(kmers_longer_than_one_word_are_assembled)
+{
+    // k = 33 leaves one base in the first packed word, and k = 64 fills two words exactly
+    std::mt19937 generator {42};
+    const auto reference = make_random_sequence(300, generator);
+    const auto snv_read = make_snv(reference, 150);
+    auto insertion_read = reference;
+    insertion_read.insert(220, "TTG");
+    for (const unsigned kmer_size : {33u, 64u}) {
+        BOOST_TEST_CONTEXT("k = " << kmer_size) {
+            Assembler assembler {kmer_size, reference};
+            BOOST_CHECK_EQUAL(assembler.num_kmers(), reference.size() - kmer_size + 1);
+            BOOST_CHECK(assembler.is_all_reference());
+            assembler.insert_read(snv_read, 5);
+            assembler.insert_read(insertion_read, 5);
+            assembler.prune(2);
+            assembler.cleanup();
+            const auto variants = assembler.extract_variants(10, 0);
+            BOOST_REQUIRE_EQUAL(variants.size(), 2);
+            for (const auto& variant : variants) {
+                BOOST_CHECK_EQUAL(reference.substr(variant.begin_pos, variant.ref.size()), variant.ref);
+            }
+            BOOST_CHECK_EQUAL(apply(variants[0], reference), snv_read);
+            BOOST_CHECK_EQUAL(apply(variants[1], reference), insertion_read);
+        }
+    }
+}
 
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,165 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <boost/graph/topological_sort.hpp>
+
+#include "core/tools/vargen/utils/flat_digraph.hpp"
+
+namespace octopus { namespace test {
+
+using octopus::coretools::FlatDigraph;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(flat_digraph)
+
+namespace {
+
+struct Edge
+{
+    int weight;
+};
+
+using Graph  = FlatDigraph<char, Edge>;
+using Vertex = Graph::vertex_descriptor;
+
+template <typename Range>
+auto to_vector(const Range& range)
+{
+    return std::vector<typename Range::first_type::value_type> {range.first, range.second};
+}
+
+auto targets(const Graph& g, const Vertex v)
+{
+    std::vector<Vertex> result {};
+    for (const auto e : to_vector(g.out_edges(v))) result.push_back(g.target(e));
+    return result;
+}
+
+auto sources(const Graph& g, const Vertex v)
+{
+    std::vector<Vertex> result {};
+    for (const auto e : to_vector(g.in_edges(v))) result.push_back(g.source(e));
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(edges_are_visited_in_insertion_order)
+{
+    Graph g {};
+    const auto a = g.add_vertex('a'), b = g.add_vertex('b'), c = g.add_vertex('c'), d = g.add_vertex('d');
+    g.add_edge(a, c, {1});
+    g.add_edge(a, b, {2});
+    g.add_edge(b, c, {3});
+    g.add_edge(c, d, {4});
+    BOOST_CHECK_EQUAL(g.num_vertices(), 4);
+    BOOST_CHECK_EQUAL(g.num_edges(), 4);
+    BOOST_CHECK(to_vector(g.vertices()) == (std::vector<Vertex> {a, b, c, d}));
+    BOOST_CHECK(targets(g, a) == (std::vector<Vertex> {c, b}));
+    BOOST_CHECK(sources(g, c) == (std::vector<Vertex> {a, b}));
+    BOOST_CHECK_EQUAL(g.out_degree(a), 2);
+    BOOST_CHECK_EQUAL(g.in_degree(c), 2);
+    BOOST_CHECK_EQUAL(g.degree(b), 2);
+    const auto ab = g.edge(a, b);
+    BOOST_REQUIRE(ab.second);
+    BOOST_CHECK_EQUAL(g[ab.first].weight, 2);
+    BOOST_CHECK(!g.edge(b, a).second);
+}
+
+BOOST_AUTO_TEST_CASE(removing_edges_keeps_other_descriptors_valid)
+{
+    Graph g {};
+    const auto a = g.add_vertex('a'), b = g.add_vertex('b'), c = g.add_vertex('c');
+    const auto ab = g.add_edge(a, b, {1}).first;
+    g.add_edge(a, c, {2});
+    const auto bc = g.add_edge(b, c, {3}).first;
+    g.add_edge(a, c, {4});
+    g.remove_edge(a, c); // removes both parallel edges
+    BOOST_CHECK_EQUAL(g.num_edges(), 2);
+    BOOST_CHECK(!g.edge(a, c).second);
+    BOOST_CHECK(targets(g, a) == (std::vector<Vertex> {b}));
+    BOOST_CHECK(sources(g, c) == (std::vector<Vertex> {b}));
+    BOOST_CHECK_EQUAL(g[ab].weight, 1);
+    BOOST_CHECK_EQUAL(g[bc].weight, 3);
+    g.remove_edge(ab);
+    BOOST_CHECK_EQUAL(g.num_edges(), 1);
+    BOOST_CHECK_EQUAL(g.out_degree(a), 0);
+    BOOST_CHECK_EQUAL(g.in_degree(b), 0);
+    BOOST_CHECK(to_vector(g.edges()) == (std::vector<Graph::edge_descriptor> {bc}));
+}
+
+BOOST_AUTO_TEST_CASE(cleared_vertices_can_be_removed)
+{
+    Graph g {};
+    const auto a = g.add_vertex('a'), b = g.add_vertex('b'), c = g.add_vertex('c'), d = g.add_vertex('d');
+    g.add_edge(a, b, {1});
+    g.add_edge(b, c, {2});
+    g.add_edge(d, b, {3});
+    g.add_edge(c, d, {4});
+    g.clear_vertex(b);
+    BOOST_CHECK_EQUAL(g.degree(b), 0);
+    BOOST_CHECK_EQUAL(g.num_edges(), 1);
+    BOOST_CHECK_EQUAL(g.out_degree(a), 0);
+    BOOST_CHECK_EQUAL(g.out_degree(d), 0);
+    BOOST_CHECK(targets(g, c) == (std::vector<Vertex> {d}));
+    g.remove_vertex(b);
+    BOOST_CHECK_EQUAL(g.num_vertices(), 3);
+    BOOST_CHECK(!g.is_alive(b));
+    BOOST_CHECK_EQUAL(g.vertex_capacity(), 4);
+    BOOST_CHECK(to_vector(g.vertices()) == (std::vector<Vertex> {a, c, d}));
+    BOOST_CHECK_EQUAL(g[a], 'a');
+    BOOST_CHECK_EQUAL(g[d], 'd');
+    const auto e = g.add_vertex('e');
+    BOOST_CHECK_EQUAL(g[e], 'e');
+    BOOST_CHECK(to_vector(g.vertices()) == (std::vector<Vertex> {a, c, d, e}));
+}
+
+BOOST_AUTO_TEST_CASE(reindex_numbers_live_vertices_for_bgl_algorithms)
+{
+    Graph g {};
+    const auto a = g.add_vertex('a'), b = g.add_vertex('b'), c = g.add_vertex('c'), d = g.add_vertex('d');
+    g.add_edge(a, b, {1});
+    g.add_edge(b, d, {2});
+    g.add_edge(a, c, {3});
+    g.add_edge(c, d, {4});
+    g.clear_vertex(b);
+    g.remove_vertex(b);
+    g.reindex();
+    BOOST_CHECK_EQUAL(g.index(a), 0);
+    BOOST_CHECK_EQUAL(g.index(c), 1);
+    BOOST_CHECK_EQUAL(g.index(d), 2);
+    BOOST_CHECK_EQUAL(get(boost::vertex_index, g)[d], 2);
+    std::vector<Vertex> order {};
+    boost::topological_sort(g, std::back_inserter(order), boost::vertex_index_map(g.vertex_index_map()));
+    std::reverse(std::begin(order), std::end(order));
+    BOOST_CHECK(order == (std::vector<Vertex> {a, c, d}));
+}
+
+BOOST_AUTO_TEST_CASE(cleared_graphs_can_be_reused)
+{
+    Graph g {};
+    const auto a = g.add_vertex('a'), b = g.add_vertex('b');
+    g.add_edge(a, b, {1});
+    g.clear();
+    BOOST_CHECK_EQUAL(g.num_vertices(), 0);
+    BOOST_CHECK_EQUAL(g.num_edges(), 0);
+    BOOST_CHECK(to_vector(g.vertices()).empty());
+    BOOST_CHECK(to_vector(g.edges()).empty());
+    const auto c = g.add_vertex('c'), d = g.add_vertex('d');
+    g.add_edge(d, c, {2});
+    BOOST_CHECK_EQUAL(g.num_vertices(), 2);
+    BOOST_CHECK(targets(g, d) == (std::vector<Vertex> {c}));
+    BOOST_CHECK_EQUAL(g.index(d), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,182 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+
+#include "basics/genomic_region.hpp"
+#include "io/reference/reference_genome.hpp"
+#include "io/reference/reference_reader.hpp"
+#include "core/types/allele.hpp"
+#include "core/types/haplotype.hpp"
+#include "core/tools/hapgen/haplotype_tree.hpp"
+
+#include "mock/mock_reference.hpp"
+
+namespace octopus { namespace test {
+
+using octopus::coretools::HaplotypeTree;
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(haplotype_tree_extraction)
+
+namespace {
+
+// Returns what there is of the contig rather than throwing when a fetch runs off the end
+class TruncatingReference : public io::ReferenceReader
+{
+public:
+    TruncatingReference(ContigName contig, GeneticSequence sequence)
+    : contig_ {std::move(contig)}
+    , sequence_ {std::move(sequence)}
+    {}
+    
+private:
+    ContigName contig_;
+    GeneticSequence sequence_;
+    
+    std::unique_ptr<ReferenceReader> do_clone() const override
+    {
+        return std::make_unique<TruncatingReference>(*this);
+    }
+    bool do_is_open() const noexcept override { return true; }
+    std::string do_fetch_reference_name() const override { return "truncating"; }
+    std::vector<ContigName> do_fetch_contig_names() const override { return {contig_}; }
+    GenomicSize do_fetch_contig_size(const ContigName&) const override
+    {
+        return static_cast<GenomicSize>(sequence_.size());
+    }
+    GeneticSequence do_fetch_sequence(const GenomicRegion& region) const override
+    {
+        const auto begin = std::min<std::size_t>(region.begin(), sequence_.size());
+        const auto end   = std::min<std::size_t>(region.end(), sequence_.size());
+        return sequence_.substr(begin, end - begin);
+    }
+};
+
+Haplotype make_haplotype(const GenomicRegion& region, const std::vector<Allele>& alleles,
+                         const ReferenceGenome& reference)
+{
+    Haplotype::Builder builder {region, reference};
+    for (const auto& allele : alleles) builder.push_back(allele);
+    return builder.build();
+}
+
+void check_equal(const std::vector<Haplotype>& haplotypes, const std::vector<Haplotype>& expected)
+{
+    BOOST_REQUIRE_EQUAL(haplotypes.size(), expected.size());
+    for (std::size_t i {0}; i < haplotypes.size(); ++i) {
+        BOOST_TEST_CONTEXT("haplotype " << i) {
+            BOOST_CHECK(haplotypes[i] == expected[i]);
+            BOOST_CHECK(have_same_alleles(haplotypes[i], expected[i]));
+            BOOST_CHECK_EQUAL(haplotypes[i].get_hash(), expected[i].get_hash());
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(haplotypes_extracted_from_a_sub_region_only_include_the_alleles_contained_in_the_region)
+{
+    const auto reference = mock::make_reference();
+    
+    const Allele lhs_deletion {GenomicRegion {"1", 100, 103}, ""};
+    const Allele snv1 {GenomicRegion {"1", 110, 111}, "A"};
+    const Allele snv2 {GenomicRegion {"1", 110, 111}, "C"};
+    const Allele insertion {GenomicRegion {"1", 120, 120}, "TT"};
+    const Allele spliced_snv {GenomicRegion {"1", 130, 131}, "G"};
+    const Allele rhs_deletion {GenomicRegion {"1", 138, 145}, ""};
+    
+    HaplotypeTree haplotype_tree {"1", reference};
+    haplotype_tree.extend(lhs_deletion).extend(snv1).extend(snv2).extend(insertion).extend(rhs_deletion);
+    haplotype_tree.splice(spliced_snv);
+    
+    BOOST_REQUIRE_EQUAL(haplotype_tree.num_haplotypes(), 4);
+    
+    // Both deletions overhang the region
+    const GenomicRegion region1 {"1", 101, 140};
+    check_equal(haplotype_tree.extract_haplotypes(region1), {
+        make_haplotype(region1, {snv2, insertion}, reference),
+        make_haplotype(region1, {snv1, insertion}, reference),
+        make_haplotype(region1, {snv1, insertion, spliced_snv}, reference),
+        make_haplotype(region1, {snv2, insertion, spliced_snv}, reference)
+    });
+    
+    // Only the right deletion overhangs the region
+    const GenomicRegion region2 {"1", 95, 140};
+    check_equal(haplotype_tree.extract_haplotypes(region2), {
+        make_haplotype(region2, {lhs_deletion, snv2, insertion}, reference),
+        make_haplotype(region2, {lhs_deletion, snv1, insertion}, reference),
+        make_haplotype(region2, {lhs_deletion, snv1, insertion, spliced_snv}, reference),
+        make_haplotype(region2, {lhs_deletion, snv2, insertion, spliced_snv}, reference)
+    });
+    
+    // The right deletion is the only allele contained in the region
+    const GenomicRegion region3 {"1", 135, 150};
+    const auto deletion_haplotype = make_haplotype(region3, {rhs_deletion}, reference);
+    const Haplotype reference_haplotype {region3, reference};
+    check_equal(haplotype_tree.extract_haplotypes(region3), {
+        deletion_haplotype, deletion_haplotype, reference_haplotype, reference_haplotype
+    });
+}
+
+BOOST_AUTO_TEST_CASE(haplotypes_extracted_after_clearing_merged_branches_match_those_built_directly)
+{
+    const auto reference = mock::make_reference();
+    
+    const Allele snv1 {GenomicRegion {"1", 110, 111}, "A"};
+    const Allele snv2 {GenomicRegion {"1", 110, 111}, "C"};
+    const Allele snv3 {GenomicRegion {"1", 120, 121}, "G"};
+    const Allele deletion {GenomicRegion {"1", 130, 133}, ""};
+    const Allele snv4 {GenomicRegion {"1", 130, 131}, "A"};
+    
+    HaplotypeTree haplotype_tree {"1", reference};
+    haplotype_tree.extend(snv1).extend(snv2).extend(snv3).extend(deletion).extend(snv4);
+    
+    BOOST_REQUIRE_EQUAL(haplotype_tree.num_haplotypes(), 4);
+    
+    // The branches through snv1 and snv2 are the same without them
+    haplotype_tree.clear(GenomicRegion {"1", 110, 111});
+    
+    BOOST_REQUIRE_EQUAL(haplotype_tree.num_haplotypes(), 2);
+    
+    const GenomicRegion region {"1", 105, 140};
+    check_equal(haplotype_tree.extract_haplotypes(region), {
+        make_haplotype(region, {snv3, snv4}, reference),
+        make_haplotype(region, {snv3, deletion}, reference)
+    });
+}
+
+BOOST_AUTO_TEST_CASE(haplotypes_can_be_extracted_from_regions_that_run_off_the_end_of_the_contig)
+{
+    const ReferenceGenome reference {std::make_unique<TruncatingReference>("1", "ACGTTGCAAGCTTACGGATCCTAGCATGACTGACCATGGA")};
+    
+    const Allele snv1 {GenomicRegion {"1", 20, 21}, "A"};
+    const Allele snv2 {GenomicRegion {"1", 20, 21}, "G"};
+    const Allele insertion {GenomicRegion {"1", 30, 30}, "TT"};
+    const Allele deletion {GenomicRegion {"1", 35, 38}, ""};
+    
+    HaplotypeTree haplotype_tree {"1", reference};
+    haplotype_tree.extend(snv1).extend(snv2).extend(insertion).extend(deletion);
+    
+    const GenomicRegion region {"1", 15, 50};
+    
+    BOOST_REQUIRE_LT(reference.fetch_sequence(region).size(), size(region));
+    
+    check_equal(haplotype_tree.extract_haplotypes(region), {
+        make_haplotype(region, {snv2, insertion, deletion}, reference),
+        make_haplotype(region, {snv1, insertion, deletion}, reference)
+    });
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,83 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <set>
+#include <iterator>
+#include <algorithm>
+
+#include "core/types/genotype.hpp"
+#include "core/types/genotype_index.hpp"
+
+namespace octopus { namespace test {
+
+namespace {
+
+auto to_vector(const GenotypeIndex& genotype)
+{
+    return std::vector<unsigned> {std::cbegin(genotype), std::cend(genotype)};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(core)
+BOOST_AUTO_TEST_SUITE(genotype_index)
+
+BOOST_AUTO_TEST_CASE(generate_all_genotype_indices_enumerates_genotypes_in_generate_all_genotypes_order)
+{
+    const auto genotypes = generate_all_genotype_indices(3, 2);
+    BOOST_REQUIRE_EQUAL(genotypes.size(), 6);
+    BOOST_CHECK_EQUAL(genotypes.ploidy(), 2);
+    const std::vector<std::vector<unsigned>> expected {{0, 0}, {0, 1}, {0, 2}, {1, 1}, {1, 2}, {2, 2}};
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        const auto actual = to_vector(genotypes[i]);
+        BOOST_CHECK_EQUAL_COLLECTIONS(std::cbegin(actual), std::cend(actual), std::cbegin(expected[i]), std::cend(expected[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(generate_all_genotype_indices_generates_each_genotype_once)
+{
+    for (unsigned num_elements {1}; num_elements <= 6; ++num_elements) {
+        for (unsigned ploidy {1}; ploidy <= 5; ++ploidy) {
+            const auto genotypes = generate_all_genotype_indices(num_elements, ploidy);
+            BOOST_REQUIRE_EQUAL(genotypes.size(), num_genotypes(num_elements, ploidy));
+            std::set<std::vector<unsigned>> unique {};
+            for (const auto& genotype : genotypes) {
+                BOOST_REQUIRE_EQUAL(genotype.ploidy(), ploidy);
+                BOOST_CHECK(std::is_sorted(std::cbegin(genotype), std::cend(genotype)));
+                BOOST_CHECK(genotype[ploidy - 1] < num_elements);
+                unique.insert(to_vector(genotype));
+            }
+            BOOST_CHECK_EQUAL(unique.size(), genotypes.size());
+        }
+    }
+    BOOST_CHECK(generate_all_genotype_indices(0, 2).empty());
+    BOOST_CHECK(generate_all_genotype_indices(3, 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(genotype_index_zygosity_is_the_number_of_distinct_indices)
+{
+    GenotypeIndexVector genotypes {4};
+    const std::vector<unsigned> homozygous {2, 2, 2, 2}, heterozygous {3, 0, 3, 1};
+    genotypes.emplace_back(std::cbegin(homozygous), std::cend(homozygous));
+    genotypes.emplace_back(std::cbegin(heterozygous), std::cend(heterozygous));
+    BOOST_REQUIRE_EQUAL(genotypes.size(), 2);
+    BOOST_CHECK_EQUAL(genotypes[0].zygosity(), 1);
+    BOOST_CHECK(genotypes[0].is_homozygous());
+    BOOST_CHECK_EQUAL(genotypes[1].zygosity(), 3);
+    BOOST_CHECK(!genotypes[1].is_homozygous());
+    BOOST_CHECK(genotypes[1].contains(3));
+    BOOST_CHECK(!genotypes[1].contains(2));
+    BOOST_CHECK_EQUAL(genotypes[1].count(3), 2);
+    BOOST_CHECK_EQUAL(genotypes[1].count(0), 1);
+    BOOST_CHECK(genotypes[0] != genotypes[1]);
+    BOOST_CHECK(genotypes[1] == genotypes.back());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,117 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "io/reference/fasta.hpp"
+#include "io/reference/mapped_fasta.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(reference)
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+// Writes a small fasta with short lines, so fetches cross many line boundaries
+class TempFasta
+{
+public:
+    TempFasta(const std::string& line_terminator)
+    : directory_ {fs::temp_directory_path() / fs::unique_path()}
+    , path_ {directory_ / "reference.fa"}
+    {
+        fs::create_directories(directory_);
+        std::ofstream fasta {path_.string(), std::ios::binary}, index {path_.string() + ".fai"};
+        std::size_t offset {0};
+        for (const auto& contig : contigs()) {
+            const std::string header {">" + contig.first + line_terminator};
+            fasta << header;
+            offset += header.size();
+            index << contig.first << '\t' << contig.second.size() << '\t' << offset << '\t' << lineLength
+                  << '\t' << lineLength + line_terminator.size() << '\n';
+            for (std::size_t pos {0}; pos < contig.second.size(); pos += lineLength) {
+                const auto line = contig.second.substr(pos, lineLength) + line_terminator;
+                fasta << line;
+                offset += line.size();
+            }
+        }
+    }
+
+    ~TempFasta() { fs::remove_all(directory_); }
+
+    const fs::path& path() const noexcept { return path_; }
+
+    static std::vector<std::pair<std::string, std::string>> contigs()
+    {
+        return {{"1", "ACGTacgtNNACGTTTGACCAGTAGGATACCCAGTTGA"}, {"2", "GGGCCCAAATTT"}, {"3", "T"}};
+    }
+
+private:
+    static constexpr std::size_t lineLength {7};
+
+    fs::path directory_, path_;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(mapped_fasta_fetches_match_streamed_fasta_fetches)
+{
+    for (const std::string terminator : {"\n", "\r\n"}) {
+        const TempFasta fasta {terminator};
+        octopus::io::Fasta::Options options {};
+        options.base_transform_policy = octopus::io::Fasta::Options::BaseTransformPolicy::capitalise;
+        options.base_fill_policy = octopus::io::Fasta::Options::BaseFillPolicy::fill_with_ns;
+        const octopus::io::Fasta streamed {fasta.path(), options};
+        const octopus::io::MappedFasta mapped {fasta.path(), options};
+        BOOST_REQUIRE(mapped.is_open());
+        BOOST_CHECK(mapped.fetch_contig_names() == streamed.fetch_contig_names());
+        for (const auto& contig : TempFasta::contigs()) {
+            const auto contig_size = mapped.fetch_contig_size(contig.first);
+            BOOST_REQUIRE_EQUAL(contig_size, contig.second.size());
+            // Includes regions that overhang the end of the contig
+            for (GenomicRegion::Position begin {0}; begin <= contig_size + 2; ++begin) {
+                for (GenomicRegion::Position end {begin}; end <= contig_size + 2; ++end) {
+                    const GenomicRegion region {contig.first, begin, end};
+                    BOOST_REQUIRE_EQUAL(mapped.fetch_sequence(region), streamed.fetch_sequence(region));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mapped_fasta_clones_can_fetch_concurrently)
+{
+    const TempFasta fasta {"\n"};
+    const octopus::io::MappedFasta mapped {fasta.path()};
+    const auto expected = TempFasta::contigs().front().second;
+    const GenomicRegion region {"1", 0, static_cast<GenomicRegion::Position>(expected.size())};
+    std::vector<std::thread> threads {};
+    std::vector<int> matches(4, 0);
+    for (std::size_t i {0}; i < matches.size(); ++i) {
+        threads.emplace_back([&, i] () {
+            const auto clone = mapped.clone();
+            for (int j {0}; j < 100; ++j) {
+                matches[i] += clone->fetch_sequence(region) == expected;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (const auto n : matches) BOOST_CHECK_EQUAL(n, 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,91 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "io/variant/vcf_value.hpp"
+#include "io/variant/vcf_record.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(io)
+BOOST_AUTO_TEST_SUITE(variant)
+
+BOOST_AUTO_TEST_CASE(vcf_values_keep_the_type_they_are_made_with)
+{
+    const VcfValue missing {}, integer {42u}, real {0.5}, string {"ACGT"};
+    BOOST_CHECK(missing.type() == VcfValue::Type::missing);
+    BOOST_CHECK(integer.type() == VcfValue::Type::integer);
+    BOOST_CHECK(real.type() == VcfValue::Type::real);
+    BOOST_CHECK(string.type() == VcfValue::Type::string);
+    BOOST_CHECK_EQUAL(integer.as_integer(), 42);
+    BOOST_CHECK_EQUAL(integer.as_real(), 42.0);
+    BOOST_CHECK_EQUAL(real.as_real(), 0.5);
+    BOOST_CHECK_EQUAL(integer.to_string(), "42");
+    BOOST_CHECK_EQUAL(real.to_string(), "0.5");
+    BOOST_CHECK_EQUAL(missing.to_string(), ".");
+    BOOST_CHECK_THROW(missing.as_integer(), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(vcf_string_values_are_parsed_on_request)
+{
+    BOOST_CHECK_EQUAL(VcfValue {"110"}.as_integer(), 110);
+    BOOST_CHECK_EQUAL(VcfValue {"0.25"}.as_real(), 0.25);
+    BOOST_CHECK(VcfValue {"."}.is_missing());
+    BOOST_CHECK(VcfValue {"."} == VcfValue {});
+    BOOST_CHECK(VcfValue {"1"} == VcfValue {1});
+    BOOST_CHECK(VcfValue {1} == VcfValue {1.0});
+    BOOST_CHECK(VcfValue {1} != VcfValue {2});
+    BOOST_CHECK_THROW(VcfValue {"ACGT"}.as_integer(), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(vcf_reals_are_written_with_the_shortest_round_trip_representation)
+{
+    BOOST_CHECK_EQUAL(VcfValue {0.99}.to_string(), "0.99");
+    BOOST_CHECK_EQUAL(VcfValue {100.0}.to_string(), "100");
+    BOOST_CHECK_EQUAL(VcfValue {1e-300}.to_string(), "1e-300");
+    BOOST_CHECK_EQUAL(VcfValue {0.5f}.to_string(), "0.5");
+    for (const double value : {0.1 + 0.2, 1.0 / 3, 123456.789, 2.5e-7}) {
+        BOOST_CHECK_EQUAL(VcfValue {value}.as_real(), VcfValue {VcfValue {value}.to_string()}.as_real());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(vcf_values_compare_numbers_by_value)
+{
+    BOOST_CHECK(VcfValue {"0.5"} == VcfValue {0.5});
+    BOOST_CHECK(VcfValue {0.5} == VcfValue {"0.50"});
+    BOOST_CHECK(VcfValue {"1.0"} == VcfValue {1});
+    BOOST_CHECK(VcfValue {"0.5"} != VcfValue {0.25});
+    BOOST_CHECK(VcfValue {"0.5x"} != VcfValue {0.5});
+    BOOST_CHECK(VcfValue {"ACGT"} != VcfValue {0});
+    BOOST_CHECK(VcfValue {"1.0"} != VcfValue {"1"}); // strings are compared as text
+}
+
+BOOST_AUTO_TEST_CASE(vcf_records_store_typed_info_and_format_values)
+{
+    VcfRecord::Builder builder {};
+    builder.set_chrom("1").set_pos(100).set_ref("A").set_alt("C");
+    builder.set_info("DP", 30u).set_info("MP", 0.99).set_info("AC", {1, 2}).set_info("AA", "A");
+    builder.set_format({"GT", "GQ"});
+    builder.set_genotype("sample", std::vector<std::string> {"A", "C"}, VcfRecord::Builder::Phasing::unphased);
+    builder.set_format("sample", "GQ", 50);
+    const auto record = builder.build_once();
+    BOOST_CHECK_EQUAL(record.info_value("DP").front().as_integer(), 30);
+    BOOST_CHECK_EQUAL(record.info_value("MP").front().as_real(), 0.99);
+    BOOST_CHECK_EQUAL(record.info_value("AC").size(), 2);
+    BOOST_CHECK_EQUAL(record.info_value("AC").back().as_integer(), 2);
+    BOOST_CHECK_EQUAL(record.info_value("AA").front().to_string(), "A");
+    BOOST_CHECK(record.info_value("DP").front().type() == VcfValue::Type::integer);
+    BOOST_CHECK_EQUAL(record.get_sample_value("sample", "GQ").front().as_integer(), 50);
+    BOOST_CHECK(record.genotype("sample") == (std::vector<std::string> {"A", "C"}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,106 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <future>
+#include <atomic>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "readpipe/read_window_prefetcher.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(readpipe)
+BOOST_AUTO_TEST_SUITE(read_window_prefetcher)
+
+namespace {
+
+using Window = ReadWindowPrefetcher::Window;
+
+// Fetches the first window_size bases of the max region, with one read covering the window
+auto make_fetcher(const GenomicRegion::Size window_size, std::atomic<unsigned>& num_fetches)
+{
+    return [window_size, &num_fetches] (const GenomicRegion& max_region) {
+        ++num_fetches;
+        const auto region = expand_rhs(head_region(max_region), std::min(window_size, size(max_region)));
+        ReadMap reads {};
+        reads["sample"].emplace("read", region, std::string(size(region), 'A'),
+                                AlignedRead::BaseQualityVector(size(region), 30),
+                                CigarString {CigarOperation {size(region), CigarOperation::Flag::alignmentMatch}},
+                                60, AlignedRead::Flags {});
+        return Window {region, std::move(reads)};
+    };
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(contained_requests_take_the_prefetched_window)
+{
+    std::atomic<unsigned> num_fetches {0};
+    ReadWindowPrefetcher prefetcher {};
+    BOOST_CHECK(!prefetcher.take(GenomicRegion {"1", 0, 10}));
+    prefetcher.prefetch(GenomicRegion {"1", 100, 1'000}, make_fetcher(200, num_fetches));
+    BOOST_CHECK(prefetcher.is_pending());
+    const auto window = prefetcher.take(GenomicRegion {"1", 120, 250});
+    BOOST_REQUIRE(window);
+    BOOST_CHECK_EQUAL(window->region, (GenomicRegion {"1", 100, 300}));
+    BOOST_CHECK_EQUAL(window->reads.at("sample").size(), 1);
+    BOOST_CHECK(!prefetcher.is_pending());
+    BOOST_CHECK(!prefetcher.take(GenomicRegion {"1", 120, 250}));
+    BOOST_CHECK_EQUAL(num_fetches, 1);
+}
+
+BOOST_AUTO_TEST_CASE(requests_outside_the_prefetch_region_abandon_the_prefetch_without_waiting)
+{
+    std::atomic<unsigned> num_fetches {0};
+    std::promise<void> release_fetch {};
+    auto fetch_released = release_fetch.get_future().share();
+    const auto fetcher = make_fetcher(200, num_fetches);
+    ReadWindowPrefetcher prefetcher {};
+    prefetcher.prefetch(GenomicRegion {"1", 100, 1'000}, [fetch_released, fetcher] (const GenomicRegion& max_region) {
+        fetch_released.wait();
+        return fetcher(max_region);
+    });
+    // Would deadlock if take waited for the blocked fetch
+    BOOST_CHECK(!prefetcher.take(GenomicRegion {"1", 50, 150}));
+    BOOST_CHECK(!prefetcher.is_pending());
+    BOOST_CHECK(!prefetcher.take(GenomicRegion {"1", 120, 250}));
+    release_fetch.set_value();
+    // The abandoned prefetch does not stop new ones
+    prefetcher.prefetch(GenomicRegion {"2", 0, 1'000}, fetcher);
+    const auto window = prefetcher.take(GenomicRegion {"2", 0, 100});
+    BOOST_REQUIRE(window);
+    BOOST_CHECK_EQUAL(window->region, (GenomicRegion {"2", 0, 200}));
+}
+
+BOOST_AUTO_TEST_CASE(requests_not_contained_in_the_prefetched_window_are_rejected)
+{
+    std::atomic<unsigned> num_fetches {0};
+    ReadWindowPrefetcher prefetcher {};
+    prefetcher.prefetch(GenomicRegion {"1", 100, 1'000}, make_fetcher(200, num_fetches));
+    // Inside the prefetch region but beyond the window the fetcher chose
+    BOOST_CHECK(!prefetcher.take(GenomicRegion {"1", 250, 350}));
+    BOOST_CHECK(!prefetcher.is_pending());
+    BOOST_CHECK_EQUAL(num_fetches, 1);
+}
+
+BOOST_AUTO_TEST_CASE(clear_discards_pending_prefetches)
+{
+    std::atomic<unsigned> num_fetches {0};
+    ReadWindowPrefetcher prefetcher {};
+    prefetcher.prefetch(GenomicRegion {"1", 100, 1'000}, make_fetcher(200, num_fetches));
+    prefetcher.clear();
+    BOOST_CHECK(!prefetcher.is_pending());
+    BOOST_CHECK(!prefetcher.take(GenomicRegion {"1", 120, 250}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,114 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "config/common.hpp"
+#include "basics/genomic_region.hpp"
+#include "basics/aligned_read.hpp"
+#include "basics/cigar_string.hpp"
+#include "readpipe/shared_read_cache.hpp"
+#include "utils/read_stats.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(readpipe)
+BOOST_AUTO_TEST_SUITE(shared_read_cache)
+
+namespace {
+
+// Reads of different lengths starting every 7bp, so many reads span chunk boundaries
+ReadMap make_mock_reads()
+{
+    ReadMap result {};
+    auto& sample_reads = result["sample"];
+    for (GenomicRegion::Position begin {0}; begin < 1'000; begin += 7) {
+        const GenomicRegion::Size length {10 + begin % 50};
+        sample_reads.emplace(std::to_string(begin), GenomicRegion {"1", begin, begin + length}, std::string(length, 'A'),
+                             AlignedRead::BaseQualityVector(length, 30), CigarString {CigarOperation {length, CigarOperation::Flag::alignmentMatch}},
+                             60, AlignedRead::Flags {});
+    }
+    // An insertion-only read on a chunk boundary
+    sample_reads.emplace("empty", GenomicRegion {"1", 100, 100}, "AA", AlignedRead::BaseQualityVector(2, 30),
+                         CigarString {CigarOperation {2, CigarOperation::Flag::insertion}}, 60, AlignedRead::Flags {});
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(cached_fetches_match_direct_fetches)
+{
+    const auto reads = make_mock_reads();
+    const auto fetcher = [&reads] (const GenomicRegion& region) { return copy_overlapped(reads, region); };
+    SharedReadCache cache {100};
+    cache.reserve(GenomicRegion {"1", 150, 420});
+    cache.reserve(GenomicRegion {"1", 600, 650});
+    for (GenomicRegion::Position begin {0}; begin < 1'050; begin += 13) {
+        for (GenomicRegion::Position end {begin}; end < begin + 400; end += 37) {
+            const GenomicRegion region {"1", begin, end};
+            BOOST_REQUIRE(cache.fetch(region, fetcher) == fetcher(region));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reserved_chunks_are_fetched_once_and_evicted_on_release)
+{
+    const auto reads = make_mock_reads();
+    std::atomic<unsigned> num_fetches {0};
+    const auto fetcher = [&] (const GenomicRegion& region) { ++num_fetches; return copy_overlapped(reads, region); };
+    SharedReadCache cache {100};
+    const GenomicRegion lhs {"1", 0, 250}, rhs {"1", 250, 500};
+    cache.reserve(lhs);
+    cache.reserve(rhs);
+    cache.fetch(lhs, fetcher);
+    BOOST_CHECK_EQUAL(num_fetches, 3);
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 3);
+    cache.fetch(rhs, fetcher); // the chunk at 200-300 is shared
+    BOOST_CHECK_EQUAL(num_fetches, 5);
+    cache.release(lhs);
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 3);
+    cache.release(rhs);
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 0);
+    cache.fetch(lhs, fetcher); // unreserved regions are fetched directly
+    BOOST_CHECK_EQUAL(num_fetches, 6);
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(reserved_chunks_are_not_cached_beyond_the_read_budget)
+{
+    const auto reads = make_mock_reads();
+    std::atomic<unsigned> num_fetches {0};
+    const auto fetcher = [&] (const GenomicRegion& region) { ++num_fetches; return copy_overlapped(reads, region); };
+    const auto count_chunk_reads = [&] (GenomicRegion::Position chunk) {
+        return count_reads(copy_overlapped(reads, GenomicRegion {"1", 100 * chunk, 100 * (chunk + 1)}));
+    };
+    SharedReadCache cache {100, 1};
+    const GenomicRegion lhs {"1", 0, 250}, rhs {"1", 250, 500};
+    cache.reserve(lhs);
+    cache.reserve(rhs);
+    // The budget is checked when a fetch starts, so all chunks of the first fetch are cached
+    BOOST_CHECK(cache.fetch(lhs, fetcher) == fetcher(lhs));
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 3);
+    BOOST_CHECK_EQUAL(cache.num_cached_reads(), count_chunk_reads(0) + count_chunk_reads(1) + count_chunk_reads(2));
+    num_fetches = 0;
+    const auto rhs_reads = cache.fetch(rhs, fetcher);
+    BOOST_CHECK_EQUAL(num_fetches, 1); // the uncached chunks are fetched together
+    BOOST_CHECK(rhs_reads == fetcher(rhs));
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 3);
+    cache.release(lhs);
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 1);
+    BOOST_CHECK_EQUAL(cache.num_cached_reads(), count_chunk_reads(2));
+    cache.release(rhs);
+    BOOST_CHECK_EQUAL(cache.num_cached_chunks(), 0);
+    BOOST_CHECK_EQUAL(cache.num_cached_reads(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
@@ -0,0 +1,92 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include "utils/packed_sequence.hpp"
+#include "basics/read_batch.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(packed_sequence)
+
+namespace {
+
+const std::string symbols {"=ACMGRSVTWYHKDBN"};
+
+// Packs bases two per byte, first base in the high nibble, as in BAM
+std::vector<std::uint8_t> pack(const std::string& sequence)
+{
+    std::vector<std::uint8_t> result((sequence.size() + 1) / 2, 0);
+    for (std::size_t i {0}; i < sequence.size(); ++i) {
+        const auto code = static_cast<std::uint8_t>(symbols.find(sequence[i]));
+        result[i / 2] |= (i % 2 == 0) ? code << 4 : code;
+    }
+    return result;
+}
+
+std::string random_sequence(const std::size_t length, std::mt19937& generator)
+{
+    std::uniform_int_distribution<std::size_t> dist {0, symbols.size() - 1};
+    std::string result(length, 'N');
+    for (auto& base : result) base = symbols[dist(generator)];
+    return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(decode_recovers_packed_bases_from_any_offset)
+{
+    std::mt19937 generator {42};
+    for (std::size_t length {0}; length < 100; ++length) {
+        const auto sequence = random_sequence(length, generator);
+        const auto packed = pack(sequence);
+        for (std::size_t offset {0}; offset <= length; ++offset) {
+            octopus::utils::PackedSequenceView view {packed.data(), length};
+            view.remove_prefix(offset);
+            BOOST_REQUIRE_EQUAL(octopus::utils::decode(view), sequence.substr(offset));
+            for (std::size_t i {0}; i < view.size(); ++i) {
+                BOOST_REQUIRE_EQUAL(octopus::utils::decode(view[i]), sequence[offset + i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(simd_decoding_matches_scalar_decoding)
+{
+    if (!octopus::utils::detail::has_ssse3()) return;
+    std::vector<std::uint8_t> packed(1000);
+    for (std::size_t i {0}; i < packed.size(); ++i) packed[i] = static_cast<std::uint8_t>(i * 37);
+    for (std::size_t num_bytes {0}; num_bytes < 100; ++num_bytes) {
+        std::string scalar(2 * num_bytes, ' '), simd(2 * num_bytes, ' ');
+        octopus::utils::detail::decode_scalar(packed.data(), num_bytes, &scalar[0]);
+        octopus::utils::detail::decode_ssse3(packed.data(), num_bytes, &simd[0]);
+        BOOST_REQUIRE_EQUAL(scalar, simd);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_batch_decodes_packed_sequences)
+{
+    const std::string sequence {"NACGTTGCAACGTACGTACGTACGTTTTTGGGCCCAAAN"};
+    const auto packed = pack(sequence);
+    octopus::utils::PackedSequenceView view {packed.data(), sequence.size()};
+    view.remove_prefix(3);
+    const std::vector<AlignedRead::BaseQuality> qualities(view.size(), 30);
+    const CigarString cigar {CigarOperation {static_cast<CigarOperation::Size>(view.size()), CigarOperation::Flag::alignmentMatch}};
+    ReadBatch batch {"1"};
+    batch.emplace_back("read", 10, view, qualities.cbegin(), view.size(), cigar.cbegin(), cigar.cend(), 60, AlignedRead::Flags {});
+    BOOST_REQUIRE_EQUAL(batch.size(), 1);
+    BOOST_CHECK_EQUAL(batch[0].sequence(), sequence.substr(3));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
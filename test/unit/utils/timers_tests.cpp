@@ -0,0 +1,81 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+
+#include <boost/filesystem.hpp>
+
+#include "basics/genomic_region.hpp"
+#include "timers.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+
+namespace {
+
+namespace fs = boost::filesystem;
+
+auto index(const profiling::Stage stage) noexcept
+{
+    return static_cast<std::size_t>(stage);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(stage_timers_do_nothing_unless_profiling_is_enabled)
+{
+    profiling::init(boost::none);
+    const auto before = profiling::thread_totals();
+    {
+        profiling::StageTimer timer {profiling::Stage::assembly};
+    }
+    const auto after = profiling::thread_totals();
+    BOOST_CHECK_EQUAL(after.calls[index(profiling::Stage::assembly)], before.calls[index(profiling::Stage::assembly)]);
+}
+
+BOOST_AUTO_TEST_CASE(nested_stage_timers_record_exclusive_times_and_tasks_are_reported)
+{
+    using namespace std::chrono_literals;
+    const auto report_path = fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.json");
+    profiling::init(report_path);
+    const GenomicRegion region {"chr\"1", 10, 20};
+    const auto before = profiling::thread_totals();
+    {
+        profiling::TaskTimer task_timer {region};
+        profiling::StageTimer outer {profiling::Stage::candidate_generation};
+        std::this_thread::sleep_for(5ms);
+        {
+            profiling::StageTimer inner {profiling::Stage::assembly};
+            std::this_thread::sleep_for(20ms);
+        }
+    }
+    const auto totals = profiling::thread_totals() - before;
+    const auto outer_time = totals.nanoseconds[index(profiling::Stage::candidate_generation)];
+    const auto inner_time = totals.nanoseconds[index(profiling::Stage::assembly)];
+    BOOST_CHECK_EQUAL(totals.calls[index(profiling::Stage::candidate_generation)], 1);
+    BOOST_CHECK_EQUAL(totals.calls[index(profiling::Stage::assembly)], 1);
+    BOOST_CHECK_GE(inner_time, 20'000'000);
+    BOOST_CHECK_GE(outer_time, 5'000'000);
+    BOOST_CHECK_LT(outer_time, inner_time);
+    profiling::write_report();
+    profiling::init(boost::none);
+    std::ifstream report {report_path.string()};
+    std::stringstream ss {};
+    ss << report.rdbuf();
+    const auto json = ss.str();
+    fs::remove(report_path);
+    BOOST_CHECK(json.find("\"contig\": \"chr\\\"1\", \"begin\": 10, \"end\": 20") != std::string::npos);
+    BOOST_CHECK(json.find("\"assembly\": {\"seconds\": ") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus
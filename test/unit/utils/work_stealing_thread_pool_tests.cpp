@@ -0,0 +1,98 @@
+// Copyright (c) 2017 Daniel Cooke
+// Use of this source code is governed by the MIT license that can be found in the LICENSE file.
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <atomic>
+
+#include "utils/work_stealing_thread_pool.hpp"
+
+namespace octopus { namespace test {
+
+BOOST_AUTO_TEST_SUITE(utils)
+BOOST_AUTO_TEST_SUITE(work_stealing_thread_pool)
+
+BOOST_AUTO_TEST_CASE(all_pushed_tasks_are_run)
+{
+    WorkStealingThreadPool pool {4};
+    std::vector<std::future<int>> results {};
+    for (int i {0}; i < 1000; ++i) {
+        results.push_back(pool.push([] (const int x) { return 2 * x; }, i));
+    }
+    for (int i {0}; i < 1000; ++i) {
+        BOOST_CHECK_EQUAL(results[i].get(), 2 * i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(idle_workers_steal_tasks_queued_on_a_busy_worker)
+{
+    using namespace std::chrono_literals;
+    WorkStealingThreadPool pool {4};
+    std::vector<std::future<std::thread::id>> results {};
+    for (int i {0}; i < 16; ++i) {
+        results.push_back(pool.push_with_affinity(0, [] () {
+            std::this_thread::sleep_for(10ms);
+            return std::this_thread::get_id();
+        }));
+    }
+    std::vector<std::thread::id> ids {};
+    for (auto& result : results) ids.push_back(result.get());
+    const auto first_id = ids.front();
+    BOOST_CHECK(std::any_of(std::cbegin(ids), std::cend(ids), [=] (const auto& id) { return id != first_id; }));
+}
+
+BOOST_AUTO_TEST_CASE(task_exceptions_are_propagated_to_futures)
+{
+    WorkStealingThreadPool pool {2};
+    auto result = pool.push([] () -> int { throw std::runtime_error {"failed"}; });
+    BOOST_CHECK_THROW(result.get(), std::runtime_error);
+    BOOST_CHECK_EQUAL(pool.push([] () { return 1; }).get(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_calls_every_index_once)
+{
+    WorkStealingThreadPool pool {4};
+    std::vector<std::atomic<int>> counts(1000);
+    for (auto& count : counts) count = 0;
+    parallel_for(&pool, counts.size(), [&] (const std::size_t i) { ++counts[i]; });
+    BOOST_CHECK(std::all_of(std::cbegin(counts), std::cend(counts), [] (const auto& count) { return count == 1; }));
+    parallel_for(nullptr, counts.size(), [&] (const std::size_t i) { ++counts[i]; });
+    BOOST_CHECK(std::all_of(std::cbegin(counts), std::cend(counts), [] (const auto& count) { return count == 2; }));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_completes_when_called_from_every_pool_worker)
+{
+    WorkStealingThreadPool pool {4};
+    std::vector<std::future<int>> results {};
+    for (int i {0}; i < 4; ++i) {
+        results.push_back(pool.push([] () {
+            std::atomic<int> sum {0};
+            parallel_for(WorkStealingThreadPool::current(), 100, [&] (const std::size_t i) { sum += static_cast<int>(i); });
+            return sum.load();
+        }));
+    }
+    for (auto& result : results) {
+        BOOST_CHECK_EQUAL(result.get(), 4950);
+    }
+    BOOST_CHECK(WorkStealingThreadPool::current() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_rethrows_exceptions)
+{
+    WorkStealingThreadPool pool {2};
+    const auto f = [] (const std::size_t i) { if (i == 5) throw std::runtime_error {"failed"}; };
+    BOOST_CHECK_THROW(parallel_for(&pool, 10, f), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace test
+} // namespace octopus